@@ -0,0 +1,48 @@
+#ifndef HOST_FREERTOS_CONFIG_H
+#define HOST_FREERTOS_CONFIG_H
+
+/*
+ * -----------------------------------------------------------------------------
+ * Configuração do FreeRTOS para o build de host (porta POSIX)
+ * -----------------------------------------------------------------------------
+ * Parte da configuração do firmware (lib/FreeRTOSConfig.h) e só desfaz o que a
+ * porta POSIX não suporta: ela é de um núcleo, cada task é uma pthread e o
+ * tick é um SIGALRM. As tasks, filas e prioridades do firmware ficam iguais.
+ *
+ * Este diretório vem antes de lib/ nos includes, então é este arquivo que o
+ * kernel e o firmware enxergam no host.
+ */
+
+// Nominal RP2040 clock; the simulated HAL measures time with the host's monotonic clock
+#define configCPU_CLOCK_HZ                      125000000
+
+#include "../lib/FreeRTOSConfig.h"
+
+/* Single core: the POSIX port runs one task at a time */
+#undef FREE_RTOS_KERNEL_SMP
+#define FREE_RTOS_KERNEL_SMP 0
+#undef configNUMBER_OF_CORES
+#define configNUMBER_OF_CORES                   1
+#undef configTICK_CORE
+#undef configRUN_MULTIPLE_PRIORITIES
+#undef configUSE_CORE_AFFINITY
+#define configUSE_CORE_AFFINITY                 0
+
+// Affinity calls of the firmware become no-ops
+#define vTaskCoreAffinitySet(task, mask)        do { (void)(task); (void)(mask); } while(0)
+
+/* RP2040 specific: no pico_sync/pico_time interop on the host */
+#undef configSUPPORT_PICO_SYNC_INTEROP
+#undef configSUPPORT_PICO_TIME_INTEROP
+
+/* Stacks are pthread stacks: at least PTHREAD_STACK_MIN (16 KiB) each */
+#undef configMINIMAL_STACK_SIZE
+#define configMINIMAL_STACK_SIZE                ( configSTACK_DEPTH_TYPE ) 2048
+#undef configTIMER_TASK_STACK_DEPTH
+#define configTIMER_TASK_STACK_DEPTH            configMINIMAL_STACK_SIZE
+
+// The top priority belongs to the simulated interrupt task (host/sim/sim_core.c)
+#undef configTIMER_TASK_PRIORITY
+#define configTIMER_TASK_PRIORITY               ( configMAX_PRIORITIES - 2 )
+
+#endif /* HOST_FREERTOS_CONFIG_H */
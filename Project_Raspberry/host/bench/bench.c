@@ -0,0 +1,443 @@
+/**
+ * @file bench.c
+ * @brief Micro-benchmarks (host) dos kernels de cálculo do firmware.
+ * @note Cada kernel roda muitas vezes com entradas representativas, dentro de uma
+ * task do FreeRTOS sobre a HAL simulada (o mesmo ambiente do filtercore_host).
+ * O tempo é o de CPU da thread da task (CLOCK_THREAD_CPUTIME_ID): esperas pelo
+ * barramento I2C e outras tasks não entram na conta. As instruções vêm do contador
+ * de hardware do Linux (perf_event_open, só modo usuário); sem acesso a ele
+ * (perf_event_paranoid, contêineres) a coluna fica vazia.
+ * Os números são do processador do host (x86, com cache, preditor de desvios e
+ * FPU), não ciclos do Cortex-M0+ do RP2040: servem para comparar kernels e
+ * versões entre si, não para prever o tempo na placa. Meça com
+ * -DCMAKE_BUILD_TYPE=Release; sem tipo de build o código não é otimizado.
+ *
+ * Saída em CSV no stdout, um kernel por linha:
+ *   kernel,iterations,ns_per_op,ops_per_s,instructions_per_op
+ *
+ * Uso:
+ *   ./filtercore_bench [filtro] > bench.csv
+ * Com um filtro, só rodam os kernels cujo nome o contém.
+ */
+#include "events.h"
+#include "queue.h"
+#include "sample_filter.h"
+#include "sample_estimator.h"
+#include "sensor_analyzer.h"
+#include "sensor_configs.h"
+#include "tds_meter.h"
+#include "oled_environment.h"
+#include "oled_prints.h"
+#include "ssd1306_symbols_large.h"
+#include "default_screen.h"
+#include "ph_screen.h"
+#include "tds_screen.h"
+#include "temperature_screen.h"
+#include "notifications_screen.h"
+#include "diagnostics_screen.h"
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BENCH_STACK_SIZE (configMINIMAL_STACK_SIZE * 4)
+#define BENCH_READINGS 16               // representative readings cycled by the kernels
+#define BENCH_SAMPLES 256               // ADC codes cycled by the filters
+#define BENCH_TDS_WINDOW 30             // TDS median window (NUM_SAMPLES of tds_meter.c)
+#define BENCH_PH_WINDOW 10              // pH trimmed mean window of the baseline ph4502c.c
+#define BENCH_PH_TRIM 2
+
+// Um kernel medido
+typedef struct {
+    const char *name;
+    uint32_t iterations;
+    void (*run)(uint32_t i);            // one operation; 'i' selects the input
+} bench_kernel_t;
+
+// Latest-value mailboxes, defined by main.c in the firmware (unused by the kernels)
+mailbox_t mailbox_sensors_data;
+mailbox_t mailbox_normalized_sensors_data;
+
+static StaticTask_t bench_task_buffer;
+static StackType_t bench_task_stack[BENCH_STACK_SIZE];
+
+static const char *bench_filter;
+static int instructions_fd = -1;
+
+// Results consumed here are not optimized away
+static volatile int32_t sink;
+
+static sensors_data_t readings[BENCH_READINGS];
+static int16_t samples[BENCH_SAMPLES];
+static fixed_t voltages[BENCH_SAMPLES];
+static notification_t notifications[MAX_NOTIFICATIONS];
+static diagnostics_t diagnostics;
+
+static sample_filter_t tds_filter;
+static sample_filter_t ph_filter;
+static sample_estimator_t estimator;
+
+// Latest-value exchange of the normalized data: the mailbox and the original length-1 queue
+static normalized_sensors_data_t exchange_buffers[2];
+static mailbox_t exchange_mailbox;
+static uint32_t exchange_publication;
+static StaticQueue_t exchange_queue_buffer;
+static uint8_t exchange_queue_storage[sizeof(normalized_sensors_data_t)];
+static QueueHandle_t exchange_queue;
+static normalized_sensors_data_t exchange_value;
+
+/**
+ * @brief Entradas dos kernels: leituras que cruzam os limites do analisador e
+ * códigos do ADC com ruído e picos ocasionais (como os do ADS1115 no campo).
+ */
+static void bench_inputs_init(void){
+    uint32_t state = 0x2545F491u;
+
+    for(uint8_t i = 0; i < BENCH_READINGS; i++){
+        float temperature = 22.0f + 0.6f * i;
+        float ph = 5.6f + 0.19f * ((i * 7) % BENCH_READINGS);
+        float tds = 150.0f + 61.3f * ((i * 5) % BENCH_READINGS);
+        readings[i] = (sensors_data_t){ FIXED_FROM_FLOAT(temperature), FIXED_FROM_FLOAT(ph), FIXED_FROM_FLOAT(tds), i % 4 == 0 };
+    }
+
+    for(uint16_t i = 0; i < BENCH_SAMPLES; i++){
+        // xorshift32
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+
+        int16_t noise = (int16_t)(state % 61) - 30;
+        samples[i] = (int16_t)(20000 + noise + (i % 64 == 63 ? 4000 : 0));
+        voltages[i] = (fixed_t)(state % (4u << FIXED_FRACTION_BITS));
+    }
+
+    static char *messages[MAX_NOTIFICATIONS] = { "FP Connected", "Temp High!", "PH Acidic!", "HS Retry...", "TDS High!" };
+    for(uint8_t i = 0; i < MAX_NOTIFICATIONS; i++){
+        notifications[i] = (notification_t){ (notification_type_t)(i % 3), messages[i], (uint16_t)(i * 4) };
+    }
+
+    static const char *names[] = { "Sensors", "Display", "I2C0", "I2C1", "ADS Scan", "Handshake", "Log", "Diagnostics", "IDLE0", "IDLE1" };
+    diagnostics.window_us = 1000000;
+    diagnostics.core_load_permille[0] = 234;
+    diagnostics.core_load_permille[1] = 118;
+    diagnostics.context_switches[0] = 1520;
+    diagnostics.context_switches[1] = 830;
+    diagnostics.heap_min_free = 180 * 1024;
+    diagnostics.task_count = sizeof(names) / sizeof(names[0]);
+    for(uint8_t i = 0; i < diagnostics.task_count; i++){
+        strncpy(diagnostics.tasks[i].name, names[i], DIAGNOSTICS_NAME_LEN - 1);
+        diagnostics.tasks[i].core = i % 3 == 2 ? DIAGNOSTICS_ANY_CORE : i % 2;
+        diagnostics.tasks[i].priority = (uint8_t)(4 - i % 4);
+        diagnostics.tasks[i].cpu_permille = (uint16_t)(120 - 11 * i);
+        diagnostics.tasks[i].stack_free_words = (uint16_t)(90 + 13 * i);
+    }
+}
+
+// --- Baseline ---
+
+/**
+ * @brief Mediana da versão original do tds_meter.c: bubble sort da janela inteira.
+ * @note Cópia para comparação; o firmware agora usa o estimador recursivo.
+ */
+static int16_t baseline_get_median_value(int16_t *window){
+    // Simple bubble sort
+    for (int i = 0; i < BENCH_TDS_WINDOW - 1; i++) {
+        for (int j = 0; j < BENCH_TDS_WINDOW - i - 1; j++) {
+            if (window[j] > window[j + 1]) {
+                int16_t temp = window[j];
+                window[j] = window[j + 1];
+                window[j + 1] = temp;
+            }
+        }
+    }
+
+    return window[(BENCH_TDS_WINDOW - 1) / 2];
+}
+
+/**
+ * @brief Média aparada da versão original do ph4502c.c: sort_samples (bubble sort)
+ * e média das amostras centrais.
+ * @note Cópia para comparação, como baseline_get_median_value().
+ */
+static int16_t baseline_sort_samples_mean(int16_t *window){
+    // Simple bubble sort
+    for (int i = 0; i < BENCH_PH_WINDOW - 1; i++) {
+        for (int j = 0; j < BENCH_PH_WINDOW - i - 1; j++) {
+            if (window[j] > window[j + 1]) {
+                int16_t temp = window[j];
+                window[j] = window[j + 1];
+                window[j + 1] = temp;
+            }
+        }
+    }
+
+    int32_t total = 0;
+    for (int i = BENCH_PH_TRIM; i < BENCH_PH_WINDOW - BENCH_PH_TRIM; i++) total += window[i];
+    return (int16_t)(total / (BENCH_PH_WINDOW - 2 * BENCH_PH_TRIM));
+}
+
+// --- Kernels ---
+
+// The baseline sorted a fresh array per reading; a reading here is the window ending at sample i
+static void run_baseline_get_median_value(uint32_t i){
+    int16_t window[BENCH_TDS_WINDOW];
+    for(uint8_t k = 0; k < BENCH_TDS_WINDOW; k++) window[k] = samples[(i + k) % BENCH_SAMPLES];
+    sink = baseline_get_median_value(window);
+}
+
+static void run_baseline_sort_samples_mean(uint32_t i){
+    int16_t window[BENCH_PH_WINDOW];
+    for(uint8_t k = 0; k < BENCH_PH_WINDOW; k++) window[k] = samples[(i + k) % BENCH_SAMPLES];
+    sink = baseline_sort_samples_mean(window);
+}
+
+static void run_filter_median(uint32_t i){
+    sample_filter_push(&tds_filter, samples[i % BENCH_SAMPLES]);
+    sink = sample_filter_median(&tds_filter);
+}
+
+static void run_filter_trimmed_mean(uint32_t i){
+    sample_filter_push(&ph_filter, samples[i % BENCH_SAMPLES]);
+    sink = sample_filter_trimmed_mean(&ph_filter);
+}
+
+// A whole reading, as the baseline took it: a window of fresh samples, then the value
+static void run_filter_median_reading(uint32_t i){
+    for(uint8_t k = 0; k < BENCH_TDS_WINDOW; k++) sample_filter_push(&tds_filter, samples[(i + k) % BENCH_SAMPLES]);
+    sink = sample_filter_median(&tds_filter);
+}
+
+static void run_filter_trimmed_mean_reading(uint32_t i){
+    for(uint8_t k = 0; k < BENCH_PH_WINDOW; k++) sample_filter_push(&ph_filter, samples[(i + k) % BENCH_SAMPLES]);
+    sink = sample_filter_trimmed_mean(&ph_filter);
+}
+
+static void run_estimator_update(uint32_t i){
+    sink = sample_estimator_update(&estimator, samples[i % BENCH_SAMPLES]);
+}
+
+// A publication and its read: task_sensors -> task_handshake
+static void run_mailbox_publish_read(uint32_t i){
+    exchange_value.trace.id = i;
+    mailbox_publish(&exchange_mailbox, &exchange_value);
+    sink = mailbox_read_if_new(&exchange_mailbox, &exchange_value, &exchange_publication);
+}
+
+static void run_queue_overwrite_receive(uint32_t i){
+    exchange_value.trace.id = i;
+    xQueueOverwrite(exchange_queue, &exchange_value);
+    sink = xQueueReceive(exchange_queue, &exchange_value, 0);
+}
+
+// A reader that finds nothing new (the display between publications)
+static void run_mailbox_read_if_new_empty(uint32_t i){
+    (void)i;
+    sink = mailbox_read_if_new(&exchange_mailbox, &exchange_value, &exchange_publication);
+}
+
+static void run_queue_receive_empty(uint32_t i){
+    (void)i;
+    sink = xQueueReceive(exchange_queue, &exchange_value, 0);
+}
+
+static void run_tds_polynomial(uint32_t i){
+    sink = (int32_t)tds_polynomial(fixed_to_float(voltages[i % BENCH_SAMPLES]));
+}
+
+static void run_tds_curve_lookup(uint32_t i){
+    sink = tds_curve_lookup(voltages[i % BENCH_SAMPLES]);
+}
+
+static void run_analyzer_is_tds_alert(uint32_t i){
+    sink = analyzer_is_tds_alert(readings[i % BENCH_READINGS]);
+}
+
+static void run_draw_utf8_multiline(uint32_t i){
+    static const char *lines[] = { "pH LEVEL", "(ºC) I NORMAL", "Temperatura 25,3ºC", "(PPM) I ALERT" };
+    ssd1306_draw_utf8_multiline(oled.ram_buffer, 0, (int16_t)((i % 8) * SSD1306_CHAR_HEIGHT), lines[i % 4],
+                                oled.width, oled.height);
+}
+
+static void run_print_large_symbol(uint32_t i){
+    print_large_symbol(&oled, large_numbers[i % 10], (uint8_t)((i % 7) * SSD1306_CHAR_LARGE_WIDTH), 4);
+}
+
+static void run_print_large_text_center(uint32_t i){
+    static const char *values[] = { "25.31", "7.02", "612.50", "-1.25" };
+    print_large_text_center(&oled, values[i % 4], 4);
+}
+
+static void run_default_screen(uint32_t i){ show_default_screen(readings[i % BENCH_READINGS]); }
+static void run_ph_screen(uint32_t i){ show_ph_screen(readings[i % BENCH_READINGS]); }
+static void run_tds_screen(uint32_t i){ show_tds_screen(readings[i % BENCH_READINGS]); }
+static void run_temperature_screen(uint32_t i){ show_temperature_screen(readings[i % BENCH_READINGS]); }
+
+static void run_notifications_screen(uint32_t i){
+    notifications[0].count = (uint16_t)(2 + i % 8); // a different marker, so a new frame, every time
+    show_notifications_screen(notifications);
+}
+
+static void run_diagnostics_screen(uint32_t i){
+    diagnostics.core_load_permille[0] = (uint16_t)(200 + (i % 50) * 10); // a new frame every time
+    show_diagnostics_screen(&diagnostics);
+}
+
+/**
+ * @brief Kernels medidos. Os de base (baseline_*) são as ordenações originais,
+ * com a mesma janela do filtro listado logo abaixo deles: uma operação do
+ * filtro é uma amostra nova (aquisição contínua) e a de *_reading é uma leitura
+ * inteira como a original (a janela toda de amostras novas e o valor). A fila (queue_*) é a
+ * troca original entre as tasks, com uma posição, comparada ao mailbox: no host
+ * as seções críticas do port POSIX mascaram sinais (chamadas de sistema), então
+ * a diferença é maior que no RP2040, onde custam algumas instruções. As telas enviam um quadro por operação; o tempo do
+ * barramento não conta, mas limita o ritmo (cerca de 25 ms por quadro a 400 kHz).
+ */
+static const bench_kernel_t kernels[] = {
+    { "baseline_get_median_value",           200000, run_baseline_get_median_value },
+    { "sample_filter_median",                200000, run_filter_median },
+    { "sample_filter_median_reading",         50000, run_filter_median_reading },
+    { "baseline_sort_samples_mean",          200000, run_baseline_sort_samples_mean },
+    { "sample_filter_trimmed_mean",          200000, run_filter_trimmed_mean },
+    { "sample_filter_trimmed_mean_reading",   50000, run_filter_trimmed_mean_reading },
+    { "sample_estimator_update",             200000, run_estimator_update },
+    { "mailbox_publish_read",                200000, run_mailbox_publish_read },
+    { "queue_overwrite_receive",             200000, run_queue_overwrite_receive },
+    { "mailbox_read_if_new_empty",           200000, run_mailbox_read_if_new_empty },
+    { "queue_receive_empty",                 200000, run_queue_receive_empty },
+    { "tds_polynomial",                      200000, run_tds_polynomial },
+    { "tds_curve_lookup",                    200000, run_tds_curve_lookup },
+    { "analyzer_is_tds_alert",               200000, run_analyzer_is_tds_alert },
+    { "ssd1306_draw_utf8_multiline",          50000, run_draw_utf8_multiline },
+    { "print_large_symbol",                   50000, run_print_large_symbol },
+    { "print_large_text_center",              50000, run_print_large_text_center },
+    { "show_default_screen",                     50, run_default_screen },
+    { "show_ph_screen",                          50, run_ph_screen },
+    { "show_tds_screen",                         50, run_tds_screen },
+    { "show_temperature_screen",                 50, run_temperature_screen },
+    { "show_notifications_screen",               50, run_notifications_screen },
+    { "show_diagnostics_screen",                 50, run_diagnostics_screen },
+};
+
+// --- Medição ---
+
+static uint64_t thread_cpu_ns(void){
+    struct timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+/**
+ * @brief Abre o contador de instruções da thread atual (modo usuário).
+ * @note Chamada pela task do benchmark: o contador segue só a sua thread.
+ * @return O descritor do contador, ou -1 se o kernel não o oferece.
+ */
+static int instructions_open(void){
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+static void instructions_start(void){
+    if(instructions_fd < 0) return;
+    ioctl(instructions_fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(instructions_fd, PERF_EVENT_IOC_ENABLE, 0);
+}
+
+static bool instructions_stop(uint64_t *count){
+    if(instructions_fd < 0) return false;
+    ioctl(instructions_fd, PERF_EVENT_IOC_DISABLE, 0);
+    return read(instructions_fd, count, sizeof(*count)) == sizeof(*count);
+}
+
+/**
+ * @brief Mede um kernel: aquecimento (1/10 das iterações) e a medição em si.
+ * @note O custo do laço e da chamada indireta entra na conta de todos os kernels igualmente.
+ * * @param kernel O kernel.
+ */
+static void bench_run(const bench_kernel_t *kernel){
+    for(uint32_t i = 0; i < kernel->iterations / 10; i++) kernel->run(i);
+
+    uint64_t instructions = 0;
+    instructions_start();
+    uint64_t start_ns = thread_cpu_ns();
+
+    for(uint32_t i = 0; i < kernel->iterations; i++) kernel->run(i);
+
+    uint64_t elapsed_ns = thread_cpu_ns() - start_ns;
+    bool counted = instructions_stop(&instructions);
+
+    double ns_per_op = (double)elapsed_ns / kernel->iterations;
+    printf("%s,%lu,%.2f,%.0f,", kernel->name, (unsigned long)kernel->iterations, ns_per_op,
+           ns_per_op > 0 ? 1e9 / ns_per_op : 0.0);
+    if(counted) printf("%.1f", (double)instructions / kernel->iterations);
+    printf("\n");
+}
+
+/**
+ * @brief Task do benchmark: prepara os módulos, mede os kernels e encerra o processo.
+ */
+static void task_bench(void *params){
+    (void)params;
+
+    bench_inputs_init();
+    sample_filter_init(&tds_filter, BENCH_TDS_WINDOW, 0);
+    sample_filter_init(&ph_filter, BENCH_PH_WINDOW, BENCH_PH_TRIM);
+    sample_estimator_init(&estimator, TDS_MEASUREMENT_NOISE, TDS_OUTLIER_GATE, TDS_MAX_REJECTS, BENCH_TDS_WINDOW);
+    tds_meter_init();
+    mailbox_init(&exchange_mailbox, &exchange_buffers[0], &exchange_buffers[1], sizeof(normalized_sensors_data_t));
+    exchange_queue = xQueueCreateStatic(1, sizeof(normalized_sensors_data_t), exchange_queue_storage,
+                                        &exchange_queue_buffer);
+    analyzer_init();
+
+    instructions_fd = instructions_open();
+    if(instructions_fd < 0) fprintf(stderr, "[bench] instruction counter unavailable\n");
+
+    printf("kernel,iterations,ns_per_op,ops_per_s,instructions_per_op\n");
+    for(size_t k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++){
+        if(bench_filter && !strstr(kernels[k].name, bench_filter)) continue;
+        bench_run(&kernels[k]);
+    }
+
+    fflush(stdout);
+    exit(0);
+}
+
+int main(int argc, char **argv){
+    stdio_init_all();
+    bench_filter = argc > 1 ? argv[1] : NULL;
+
+    // The screens render through the I2C1 transaction manager, as on the board
+    if(!oled_init(&oled)){
+        printf("Error starting OLED display!\n");
+        return 1;
+    }
+
+    TaskHandle_t handle = xTaskCreateStatic(
+        task_bench,
+        "Task Bench",
+        BENCH_STACK_SIZE,
+        NULL,
+        tskIDLE_PRIORITY + 2,
+        bench_task_stack,
+        &bench_task_buffer
+    );
+
+    if(handle == NULL){
+        printf("Error creating bench task!\n");
+        return 1;
+    }
+
+    vTaskStartScheduler();
+
+    return 0;
+}
@@ -0,0 +1,56 @@
+#ifndef _HARDWARE_DMA_H
+#define _HARDWARE_DMA_H
+
+/**
+ * @file dma.h
+ * @brief hardware/dma.h do build de host.
+ * @note Só há um destino/origem simulado: o IC_DATA_CMD dos controladores I2C.
+ * Uma transferência disparada para ele é executada pelo controlador simulado,
+ * que sinaliza o fim (IRQ1 do canal) após o tempo de fio da transação.
+ */
+
+#include "pico/platform.h"
+
+#define NUM_DMA_CHANNELS 12
+
+enum dma_channel_transfer_size {
+    DMA_SIZE_8 = 0,
+    DMA_SIZE_16 = 1,
+    DMA_SIZE_32 = 2
+};
+
+typedef struct {
+    enum dma_channel_transfer_size size;
+    bool read_increment;
+    bool write_increment;
+    uint dreq;
+} dma_channel_config;
+
+int dma_claim_unused_channel(bool required);
+
+void dma_channel_unclaim(uint channel);
+
+dma_channel_config dma_channel_get_default_config(uint channel);
+
+void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size);
+
+void channel_config_set_read_increment(dma_channel_config *c, bool incr);
+
+void channel_config_set_write_increment(dma_channel_config *c, bool incr);
+
+void channel_config_set_dreq(dma_channel_config *c, uint dreq);
+
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint transfer_count, bool trigger);
+
+void dma_channel_abort(uint channel);
+
+bool dma_channel_is_busy(uint channel);
+
+void dma_channel_set_irq1_enabled(uint channel, bool enabled);
+
+bool dma_channel_get_irq1_status(uint channel);
+
+void dma_channel_acknowledge_irq1(uint channel);
+
+#endif //_HARDWARE_DMA_H
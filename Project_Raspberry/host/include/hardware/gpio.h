@@ -0,0 +1,68 @@
+#ifndef _HARDWARE_GPIO_H
+#define _HARDWARE_GPIO_H
+
+/**
+ * @file gpio.h
+ * @brief hardware/gpio.h do build de host: pinos ligados aos modelos do simulador.
+ */
+
+#include "pico/platform.h"
+#include "hardware/irq.h"
+
+#define NUM_BANK0_GPIOS 30
+
+#define GPIO_OUT 1
+#define GPIO_IN 0
+
+typedef enum gpio_function {
+    GPIO_FUNC_XIP = 0,
+    GPIO_FUNC_SPI = 1,
+    GPIO_FUNC_UART = 2,
+    GPIO_FUNC_I2C = 3,
+    GPIO_FUNC_PWM = 4,
+    GPIO_FUNC_SIO = 5,
+    GPIO_FUNC_PIO0 = 6,
+    GPIO_FUNC_PIO1 = 7,
+    GPIO_FUNC_GPCK = 8,
+    GPIO_FUNC_USB = 9,
+    GPIO_FUNC_NULL = 0x1f
+} gpio_function_t;
+
+enum gpio_irq_level {
+    GPIO_IRQ_LEVEL_LOW = 0x1u,
+    GPIO_IRQ_LEVEL_HIGH = 0x2u,
+    GPIO_IRQ_EDGE_FALL = 0x4u,
+    GPIO_IRQ_EDGE_RISE = 0x8u
+};
+
+void gpio_init(uint gpio);
+
+void gpio_init_mask(uint32_t gpio_mask);
+
+void gpio_set_function(uint gpio, gpio_function_t fn);
+
+void gpio_set_dir(uint gpio, bool out);
+
+void gpio_set_dir_out_masked(uint32_t mask);
+
+void gpio_put(uint gpio, bool value);
+
+void gpio_put_masked(uint32_t mask, uint32_t value);
+
+bool gpio_get(uint gpio);
+
+void gpio_pull_up(uint gpio);
+
+void gpio_pull_down(uint gpio);
+
+void gpio_disable_pulls(uint gpio);
+
+void gpio_set_irq_enabled(uint gpio, uint32_t event_mask, bool enabled);
+
+void gpio_add_raw_irq_handler(uint gpio, irq_handler_t handler);
+
+uint32_t gpio_get_irq_event_mask(uint gpio);
+
+void gpio_acknowledge_irq(uint gpio, uint32_t event_mask);
+
+#endif //_HARDWARE_GPIO_H
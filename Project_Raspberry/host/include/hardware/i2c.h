@@ -0,0 +1,68 @@
+#ifndef _HARDWARE_I2C_H
+#define _HARDWARE_I2C_H
+
+/**
+ * @file i2c.h
+ * @brief hardware/i2c.h do build de host: controladores I2C do simulador.
+ * @note As funções bloqueantes e o DMA sobre IC_DATA_CMD (ver hardware/dma.h)
+ * chegam aos dispositivos virtuais do barramento; os registradores simulados são
+ * apenas os que o gerenciador de transações (i2c_bus.c) consulta.
+ */
+
+#include "pico/platform.h"
+
+#define I2C_IC_DATA_CMD_CMD_BITS 0x00000100u
+#define I2C_IC_DATA_CMD_STOP_BITS 0x00000200u
+#define I2C_IC_DATA_CMD_RESTART_BITS 0x00000400u
+#define I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS 0x00000040u
+#define I2C_IC_RAW_INTR_STAT_STOP_DET_BITS 0x00000200u
+#define I2C_IC_INTR_MASK_M_TX_ABRT_BITS 0x00000040u
+#define I2C_IC_INTR_MASK_M_STOP_DET_BITS 0x00000200u
+#define I2C_IC_STATUS_TFE_BITS 0x00000004u
+#define I2C_IC_STATUS_MST_ACTIVITY_BITS 0x00000020u
+#define I2C_IC_ENABLE_ENABLE_BITS 0x00000001u
+#define I2C_IC_ENABLE_ABORT_BITS 0x00000002u
+
+// Registradores do controlador (subconjunto)
+typedef struct {
+    volatile uint32_t con;
+    volatile uint32_t tar;
+    volatile uint32_t data_cmd;
+    volatile uint32_t intr_mask;
+    volatile uint32_t raw_intr_stat;
+    volatile uint32_t clr_tx_abrt;
+    volatile uint32_t clr_stop_det;
+    volatile uint32_t enable;
+    volatile uint32_t status;
+    volatile uint32_t dma_cr;
+} i2c_hw_t;
+
+typedef struct i2c_inst {
+    i2c_hw_t hw;
+    uint index;
+    uint baudrate;
+} i2c_inst_t;
+
+extern i2c_inst_t i2c0_inst;
+extern i2c_inst_t i2c1_inst;
+
+#define i2c0 (&i2c0_inst)
+#define i2c1 (&i2c1_inst)
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate);
+
+static inline uint i2c_get_index(i2c_inst_t *i2c){
+    return i2c->index;
+}
+
+static inline i2c_hw_t *i2c_get_hw(i2c_inst_t *i2c){
+    return &i2c->hw;
+}
+
+uint i2c_get_dreq(i2c_inst_t *i2c, bool is_tx);
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop);
+
+#endif //_HARDWARE_I2C_H
@@ -0,0 +1,28 @@
+#ifndef _HARDWARE_IRQ_H
+#define _HARDWARE_IRQ_H
+
+/**
+ * @file irq.h
+ * @brief hardware/irq.h do build de host: linhas de interrupção despachadas pelo simulador.
+ */
+
+#include "pico/platform.h"
+
+#define DMA_IRQ_0 11
+#define DMA_IRQ_1 12
+#define IO_IRQ_BANK0 13
+#define I2C0_IRQ 23
+#define I2C1_IRQ 24
+#define SIM_IRQ_COUNT 32
+
+#define PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY 0x80
+
+typedef void (*irq_handler_t)(void);
+
+void irq_set_enabled(uint num, bool enabled);
+
+bool irq_is_enabled(uint num);
+
+void irq_add_shared_handler(uint num, irq_handler_t handler, uint8_t order_priority);
+
+#endif //_HARDWARE_IRQ_H
@@ -0,0 +1,38 @@
+#ifndef _HARDWARE_SYNC_H
+#define _HARDWARE_SYNC_H
+
+/**
+ * @file sync.h
+ * @brief hardware/sync.h do build de host.
+ * @note "Desabilitar interrupções" bloqueia o sinal do tick da porta POSIX do
+ * FreeRTOS na thread atual, o que impede a preempção; como a porta executa uma
+ * task por vez, os spinlocks se reduzem a isso.
+ */
+
+#include "pico/platform.h"
+
+typedef volatile uint32_t spin_lock_t;
+
+static inline void __dmb(void){
+    __sync_synchronize();
+}
+
+static inline void __compiler_memory_barrier(void){
+    __asm__ volatile ("" : : : "memory");
+}
+
+uint32_t save_and_disable_interrupts(void);
+
+void restore_interrupts(uint32_t status);
+
+spin_lock_t *spin_lock_instance(uint lock_num);
+
+spin_lock_t *spin_lock_init(uint lock_num);
+
+int spin_lock_claim_unused(bool required);
+
+uint32_t spin_lock_blocking(spin_lock_t *lock);
+
+void spin_unlock(spin_lock_t *lock, uint32_t saved_irq);
+
+#endif //_HARDWARE_SYNC_H
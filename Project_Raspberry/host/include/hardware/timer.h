@@ -0,0 +1,19 @@
+#ifndef _HARDWARE_TIMER_H
+#define _HARDWARE_TIMER_H
+
+/**
+ * @file timer.h
+ * @brief hardware/timer.h do build de host: o timer de 1 MHz é o relógio monotônico do host.
+ */
+
+#include "pico/platform.h"
+
+uint64_t time_us_64(void);
+
+uint32_t time_us_32(void);
+
+void busy_wait_us_32(uint32_t delay_us);
+
+void busy_wait_us(uint64_t delay_us);
+
+#endif //_HARDWARE_TIMER_H
@@ -0,0 +1,33 @@
+#ifndef _PICO_PLATFORM_H
+#define _PICO_PLATFORM_H
+
+/**
+ * @file platform.h
+ * @brief pico/platform.h do build de host: tipos básicos, códigos de erro e o core atual.
+ * @note Reproduz apenas o subconjunto do pico-sdk usado pelo firmware; as funções
+ * são implementadas pelo simulador (host/sim).
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef unsigned int uint;
+
+#define NUM_CORES 2
+
+#define __not_in_flash_func(func_name) func_name
+#define __time_critical_func(func_name) func_name
+
+enum pico_error_codes {
+    PICO_OK = 0,
+    PICO_ERROR_NONE = 0,
+    PICO_ERROR_TIMEOUT = -1,
+    PICO_ERROR_GENERIC = -2
+};
+
+static inline void tight_loop_contents(void){}
+
+uint get_core_num(void);
+
+#endif //_PICO_PLATFORM_H
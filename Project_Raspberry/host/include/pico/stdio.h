@@ -0,0 +1,21 @@
+#ifndef _PICO_STDIO_H
+#define _PICO_STDIO_H
+
+/**
+ * @file stdio.h
+ * @brief pico/stdio.h do build de host: o console USB é a saída padrão do processo.
+ * @note stdio_init_all() também inicia o simulador (modelos e task de interrupções).
+ */
+
+#include "pico/platform.h"
+#include <stdio.h>
+
+bool stdio_init_all(void);
+
+bool stdio_usb_connected(void);
+
+void stdio_put_string(const char *s, int len, bool newline, bool cr_translation);
+
+void stdio_flush(void);
+
+#endif //_PICO_STDIO_H
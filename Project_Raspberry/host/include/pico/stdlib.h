@@ -0,0 +1,14 @@
+#ifndef _PICO_STDLIB_H
+#define _PICO_STDLIB_H
+
+/**
+ * @file stdlib.h
+ * @brief pico/stdlib.h do build de host (ver host/sim).
+ */
+
+#include "pico/platform.h"
+#include "pico/time.h"
+#include "pico/stdio.h"
+#include "hardware/gpio.h"
+
+#endif //_PICO_STDLIB_H
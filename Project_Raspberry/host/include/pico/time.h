@@ -0,0 +1,33 @@
+#ifndef _PICO_TIME_H
+#define _PICO_TIME_H
+
+/**
+ * @file time.h
+ * @brief pico/time.h do build de host: alarmes e espera.
+ * @note Os callbacks dos alarmes rodam na task de interrupções do simulador,
+ * com a mesma semântica de retorno do pico-sdk.
+ */
+
+#include "pico/platform.h"
+#include "hardware/timer.h"
+
+typedef int32_t alarm_id_t;
+
+/**
+ * @brief Callback de alarme.
+ * @return 0 para encerrar; > 0 para reagendar esse tanto de us a partir do retorno;
+ * < 0 para reagendar esse tanto de us a partir do instante agendado anterior.
+ */
+typedef int64_t (*alarm_callback_t)(alarm_id_t id, void *user_data);
+
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback, void *user_data, bool fire_if_past);
+
+alarm_id_t add_alarm_in_ms(uint32_t ms, alarm_callback_t callback, void *user_data, bool fire_if_past);
+
+bool cancel_alarm(alarm_id_t alarm_id);
+
+void sleep_us(uint64_t us);
+
+void sleep_ms(uint32_t ms);
+
+#endif //_PICO_TIME_H
@@ -0,0 +1,457 @@
+/**
+ * @file replay.c
+ * @brief Reprodução (host) de capturas de sensores pela cadeia de processamento do firmware.
+ * @note Quatro modos:
+ * - "filtercore_replay <arquivo>": lê o bloco "CAPTURE BEGIN" ... "CAPTURE END"
+ * de um console (capture_dump) já decodificado por tools/log_decode.c, reproduz a captura com sensor_replay_run() e
+ * imprime a linha do tempo de alertas e a vazão da reprodução.
+ * - "filtercore_replay filters <arquivo>": passa as amostras brutas de pH e TDS
+ * da captura pelo estimador do firmware (sample_estimator) e pelas janelas
+ * ordenadas (sample_filter, mediana e média aparada), com a janela de cada
+ * canal, e compara cada saída a uma referência sem atraso (mediana centrada
+ * da própria captura). Uma linha por canal e filtro:
+ * "FILTER <canal> <filtro> samples <n> rms_error <códigos> max_error <códigos>
+ * roughness <códigos> ns_per_sample <ns>", onde roughness é o RMS da variação
+ * da saída entre amostras (ruído que passa).
+ * - "filtercore_replay evaluate <arquivo>": avalia a amostragem adaptativa
+ * (sampling_policy) numa captura gravada na taxa máxima. A captura inteira no
+ * perfil mais rápido dá os instantes de referência de cada início de alerta;
+ * depois ela é reproduzida com a política adaptativa e com perfis fixos, com as
+ * conversões reduzidas à taxa de cada perfil. Uma linha por política:
+ * "EVALUATE <política> adc_reads_per_s <n> cycles_per_s <n> detected <n>/<n>
+ * latency_mean_ms <ms> latency_max_ms <ms>", onde as leituras do ADC (uma
+ * transação I2C cada) medem o uso do barramento e a latência é a do início de
+ * cada alerta em relação à referência.
+ * - "filtercore_replay record <segundos> [fastest]": roda os produtores e
+ * task_sensors sobre o simulador com a captura ativa, até ela encher ou o tempo
+ * acabar, e imprime a captura (em quadros de texto, como o firmware: passe a
+ * saída pelo log_decode) e os alertas publicados ao vivo no fim (LIVE),
+ * para conferir a reprodução contra o firmware. Com "fastest", a política fica
+ * no perfil mais rápido (a captura para o modo evaluate).
+ * As linhas de alerta são "ALERTS <ms> <temperatura> <pH> <TDS>" (0 ou 1).
+ */
+#include "events.h"
+#include "i2c_configs.h"
+#include "notifications.h"
+#include "task_sensors.h"
+#include "ph4502c.h"
+#include "tds_meter.h"
+#include "sensor_capture.h"
+#include "sensor_replay.h"
+#include "sensor_configs.h"
+#include "sample_estimator.h"
+#include "sample_filter.h"
+#include "sampling_policy.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define REPLAY_STACK_SIZE (configMINIMAL_STACK_SIZE * 4)
+#define REPLAY_LINE_SIZE 256
+#define RECORD_POLL_MS 100
+#define REFERENCE_HALF_WINDOW 15    // reference: median of the 31 samples centred on each one
+
+// Um canal analógico comparado: janela equivalente da configuração do firmware
+typedef struct {
+    const char *name;
+    uint8_t channel;
+    fixed_t measurement_noise;
+    fixed_t gate;
+    uint8_t max_rejects;
+    uint8_t window;         // NUM_SAMPLES of the driver
+    uint8_t trim;           // 20% on each side, as the original pH mean
+} filter_channel_t;
+
+static const filter_channel_t filter_channels[] = {
+    { "pH",  PH_ADC_CHANNEL,  PH_MEASUREMENT_NOISE,  PH_OUTLIER_GATE,  PH_MAX_REJECTS,  10, 2 },
+    { "TDS", TDS_ADC_CHANNEL, TDS_MEASUREMENT_NOISE, TDS_OUTLIER_GATE, TDS_MAX_REJECTS, 30, 6 },
+};
+
+// Um filtro comparado: 'update' recebe uma amostra e devolve a saída atual
+typedef enum {
+    FILTER_ESTIMATOR,
+    FILTER_MEDIAN,
+    FILTER_TRIMMED_MEAN,
+    FILTER_KINDS
+} filter_kind_t;
+
+static const char *const filter_names[FILTER_KINDS] = { "estimator", "median", "trimmed_mean" };
+
+#define EVALUATE_MAX_ONSETS 256
+#define EVALUATE_MATCH_US 5000000   // an onset farther than this from the reference is a miss
+
+// Uma política avaliada: SAMPLING_POLICY_ADAPTIVE ou um nível fixo
+typedef struct {
+    const char *name;
+    fixed_t level;
+} evaluate_policy_t;
+
+static const evaluate_policy_t evaluate_policies[] = {
+    { "adaptive", SAMPLING_POLICY_ADAPTIVE },
+    { "fastest",  0 },
+    { "middle",   FIXED_ONE / 2 },
+    { "slowest",  FIXED_ONE },
+};
+
+// Inícios de alerta (0 -> 1) de cada sensor numa reprodução
+typedef struct {
+    uint32_t timestamp_us[3][EVALUATE_MAX_ONSETS];
+    uint32_t count[3];
+    normalized_sensors_data_t previous;
+} alert_onsets_t;
+
+static alert_onsets_t *collecting_onsets;
+
+// Latest-value mailboxes, defined by main.c in the firmware
+mailbox_t mailbox_sensors_data;
+mailbox_t mailbox_normalized_sensors_data;
+
+static sensors_data_t sensors_data_buffers[2];
+static normalized_sensors_data_t normalized_sensors_data_buffers[2];
+
+static StaticTask_t replay_task_buffer;
+static StackType_t replay_task_stack[REPLAY_STACK_SIZE];
+
+static capture_record_t records[CAPTURE_MAX_RECORDS];
+
+static int16_t channel_codes[CAPTURE_MAX_RECORDS];
+static int16_t reference_codes[CAPTURE_MAX_RECORDS];
+
+static const char *capture_path;
+static bool compare_filters;
+static bool evaluate_policies_mode;
+static uint32_t record_seconds;
+static bool record_fastest;
+
+/**
+ * @brief Lê os registros de um console com um bloco de captura.
+ * @return A quantidade de registros, ou -1 se o bloco está ausente ou incompleto.
+ */
+static int read_capture(const char *path){
+    FILE *file = fopen(path, "r");
+    if(!file){
+        fprintf(stderr, "filtercore_replay: cannot open %s\n", path);
+        return -1;
+    }
+
+    char line[REPLAY_LINE_SIZE];
+    unsigned version = 0, expected = 0;
+    bool inside = false;
+    size_t bytes = 0;
+    uint8_t *out = (uint8_t *)records;
+
+    while(fgets(line, sizeof(line), file)){
+        if(!inside){
+            inside = sscanf(line, "CAPTURE BEGIN %u %u", &version, &expected) == 2;
+            continue;
+        }
+        if(strncmp(line, "CAPTURE END", 11) == 0) break;
+
+        for(char *c = line; c[0] && c[1] && c[0] != '\n'; c += 2){
+            unsigned byte;
+            if(sscanf(c, "%2x", &byte) != 1 || bytes >= sizeof(records)) break;
+            out[bytes++] = (uint8_t)byte;
+        }
+    }
+    fclose(file);
+
+    size_t count = bytes / sizeof(capture_record_t);
+    if(!inside || version != CAPTURE_VERSION || count != expected){
+        fprintf(stderr, "filtercore_replay: %s: capture v%u with %zu of %u records\n", path, version, count, expected);
+        return -1;
+    }
+    return (int)count;
+}
+
+static void print_alerts(uint32_t timestamp_us, normalized_sensors_data_t alerts, const char *prefix){
+    printf("%sALERTS %lu %u %u %u\n", prefix, (unsigned long)(timestamp_us / 1000), alerts.temperature, alerts.ph,
+           alerts.tds);
+}
+
+static void on_alert_change(uint32_t timestamp_us, sensors_data_t data, normalized_sensors_data_t alerts){
+    (void)data;
+    print_alerts(timestamp_us, alerts, "");
+}
+
+/**
+ * @brief Reproduz a captura do arquivo e imprime a linha do tempo e o resultado.
+ */
+static int replay(void){
+    int count = read_capture(capture_path);
+    if(count < 0) return EXIT_FAILURE;
+
+    ph4502c_init();
+    tds_meter_init();
+
+    replay_report_t report;
+    if(!sensor_replay_run(records, (size_t)count, false, on_alert_change, &report)) return EXIT_FAILURE;
+
+    printf("REPLAY records %lu cycles %lu alert_changes %lu elapsed_us %llu records_per_second %lu\n",
+           (unsigned long)report.records, (unsigned long)report.cycles, (unsigned long)report.alert_changes,
+           (unsigned long long)report.elapsed_us, (unsigned long)report.records_per_second);
+    return EXIT_SUCCESS;
+}
+
+static int compare_codes(const void *a, const void *b){
+    return *(const int16_t *)a - *(const int16_t *)b;
+}
+
+/**
+ * @brief Referência sem atraso: mediana da janela centrada em cada amostra (encurtada nas bordas).
+ */
+static void build_reference(size_t count){
+    int16_t window[2 * REFERENCE_HALF_WINDOW + 1];
+
+    for(size_t i = 0; i < count; i++){
+        size_t first = i > REFERENCE_HALF_WINDOW ? i - REFERENCE_HALF_WINDOW : 0;
+        size_t last = i + REFERENCE_HALF_WINDOW < count ? i + REFERENCE_HALF_WINDOW : count - 1;
+        size_t size = last - first + 1;
+
+        memcpy(window, &channel_codes[first], size * sizeof(int16_t));
+        qsort(window, size, sizeof(int16_t), compare_codes);
+        reference_codes[i] = window[size / 2];
+    }
+}
+
+static uint64_t thread_cpu_ns(void){
+    struct timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+/**
+ * @brief Passa as amostras de um canal por um filtro e imprime o erro contra a referência.
+ * @note As primeiras 'window' saídas (janela enchendo) ficam fora das métricas.
+ */
+static void run_filter(const filter_channel_t *channel, filter_kind_t kind, size_t count){
+    static int16_t outputs[CAPTURE_MAX_RECORDS];
+    sample_estimator_t estimator;
+    sample_filter_t filter;
+
+    sample_estimator_init(&estimator, channel->measurement_noise, channel->gate, channel->max_rejects, channel->window);
+    sample_filter_init(&filter, channel->window, channel->trim);
+
+    uint64_t start_ns = thread_cpu_ns();
+    for(size_t i = 0; i < count; i++){
+        if(kind == FILTER_ESTIMATOR){
+            sample_estimator_update(&estimator, channel_codes[i]);
+            outputs[i] = sample_estimator_value(&estimator);
+        } else {
+            sample_filter_push(&filter, channel_codes[i]);
+            outputs[i] = kind == FILTER_MEDIAN ? sample_filter_median(&filter) : sample_filter_trimmed_mean(&filter);
+        }
+    }
+    uint64_t elapsed_ns = thread_cpu_ns() - start_ns;
+
+    double squared_error = 0;
+    double squared_step = 0;
+    int32_t max_error = 0;
+    size_t measured = 0;
+    for(size_t i = channel->window; i < count; i++){
+        int32_t error = outputs[i] - reference_codes[i];
+        int32_t step = outputs[i] - outputs[i - 1];
+        squared_error += (double)error * error;
+        squared_step += (double)step * step;
+        if(abs(error) > max_error) max_error = abs(error);
+        measured++;
+    }
+    if(measured == 0) return;
+
+    printf("FILTER %s %s samples %zu rms_error %.2f max_error %ld roughness %.2f ns_per_sample %.1f\n",
+           channel->name, filter_names[kind], count, sqrt(squared_error / measured), (long)max_error,
+           sqrt(squared_step / measured), (double)elapsed_ns / count);
+}
+
+/**
+ * @brief Compara os filtros nas amostras brutas de pH e TDS da captura do arquivo.
+ */
+static int compare(void){
+    int count = read_capture(capture_path);
+    if(count < 0) return EXIT_FAILURE;
+
+    for(size_t c = 0; c < sizeof(filter_channels) / sizeof(filter_channels[0]); c++){
+        const filter_channel_t *channel = &filter_channels[c];
+
+        size_t codes = 0;
+        for(int i = 0; i < count; i++){
+            if(records[i].source == CAPTURE_SOURCE_ADC && records[i].channel == channel->channel){
+                channel_codes[codes++] = records[i].raw;
+            }
+        }
+        if(codes <= channel->window){
+            fprintf(stderr, "filtercore_replay: %zu %s samples in the capture\n", codes, channel->name);
+            return EXIT_FAILURE;
+        }
+
+        build_reference(codes);
+        for(uint8_t kind = 0; kind < FILTER_KINDS; kind++) run_filter(channel, (filter_kind_t)kind, codes);
+    }
+    return EXIT_SUCCESS;
+}
+
+static void on_alert_onset(uint32_t timestamp_us, sensors_data_t data, normalized_sensors_data_t alerts){
+    (void)data;
+    alert_onsets_t *onsets = collecting_onsets;
+    const bool now[3] = { alerts.temperature, alerts.ph, alerts.tds };
+    const bool before[3] = { onsets->previous.temperature, onsets->previous.ph, onsets->previous.tds };
+
+    for(uint8_t s = 0; s < 3; s++){
+        if(now[s] && !before[s] && onsets->count[s] < EVALUATE_MAX_ONSETS){
+            onsets->timestamp_us[s][onsets->count[s]++] = timestamp_us;
+        }
+    }
+    onsets->previous = alerts;
+}
+
+/**
+ * @brief Reproduz a captura com uma política e coleta os inícios de alerta.
+ */
+static void replay_policy(size_t count, fixed_t level, bool resample, alert_onsets_t *onsets, replay_report_t *report){
+    *onsets = (alert_onsets_t){0};
+    collecting_onsets = onsets;
+
+    sampling_policy_pin(level);
+    ph4502c_init();
+    tds_meter_init();
+    sensor_replay_run(records, count, resample, on_alert_onset, report);
+}
+
+/**
+ * @brief Avalia latência de detecção contra uso do barramento para cada política.
+ */
+static int evaluate(void){
+    int count = read_capture(capture_path);
+    if(count < 0) return EXIT_FAILURE;
+
+    uint32_t duration_us = records[count - 1].timestamp_us - records[0].timestamp_us;
+    if(duration_us == 0) return EXIT_FAILURE;
+
+    // Reference: every recorded conversion, fastest profile
+    static alert_onsets_t reference;
+    replay_report_t report;
+    replay_policy((size_t)count, 0, false, &reference, &report);
+    printf("REFERENCE records %d seconds %.1f onsets %lu %lu %lu\n", count, duration_us / 1e6,
+           (unsigned long)reference.count[0], (unsigned long)reference.count[1], (unsigned long)reference.count[2]);
+
+    for(size_t p = 0; p < sizeof(evaluate_policies) / sizeof(evaluate_policies[0]); p++){
+        static alert_onsets_t onsets;
+        replay_policy((size_t)count, evaluate_policies[p].level, true, &onsets, &report);
+
+        uint32_t expected = 0;
+        uint32_t detected = 0;
+        int64_t latency_sum_us = 0;
+        int64_t latency_max_us = 0;
+        for(uint8_t s = 0; s < 3; s++){
+            for(uint32_t r = 0; r < reference.count[s]; r++){
+                expected++;
+
+                // The policy's onset closest to the reference one
+                int64_t best_us = INT64_MAX;
+                for(uint32_t o = 0; o < onsets.count[s]; o++){
+                    int64_t latency_us = (int64_t)onsets.timestamp_us[s][o] - reference.timestamp_us[s][r];
+                    if(llabs(latency_us) < llabs(best_us)) best_us = latency_us;
+                }
+                if(llabs(best_us) > EVALUATE_MATCH_US) continue;
+
+                detected++;
+                latency_sum_us += best_us;
+                if(best_us > latency_max_us) latency_max_us = best_us;
+            }
+        }
+
+        printf("EVALUATE %s adc_reads_per_s %.1f cycles_per_s %.2f detected %lu/%lu latency_mean_ms %lld "
+               "latency_max_ms %lld\n", evaluate_policies[p].name, report.adc_samples * 1e6 / duration_us,
+               report.cycles * 1e6 / duration_us, (unsigned long)detected, (unsigned long)expected,
+               detected ? (long long)(latency_sum_us / detected / 1000) : 0LL, (long long)(latency_max_us / 1000));
+    }
+
+    sampling_policy_pin(SAMPLING_POLICY_ADAPTIVE);
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Grava uma captura do firmware ao vivo sobre o simulador.
+ */
+static int record(void){
+    i2c0_configs(I2C_BAUDRATE_DEFAULT);
+    if(!notifications_init()) return EXIT_FAILURE;
+
+    if(record_fastest) sampling_policy_pin(0);
+
+    capture_start();
+    uint64_t start_us = time_us_64();
+    create_task_sensors();
+
+    normalized_sensors_data_t alerts = {0};
+    uint32_t publication = 0;
+    uint32_t alerts_us = 0;
+    notification_t notification;
+
+    // The last publication while the capture was still recording
+    while(capture_is_active() && time_us_64() - start_us < record_seconds * 1000000ull){
+        vTaskDelay(pdMS_TO_TICKS(RECORD_POLL_MS));
+        while(receive_notification(&notification));
+
+        if(capture_is_active() && mailbox_read_if_new(&mailbox_normalized_sensors_data, &alerts, &publication)){
+            alerts_us = (uint32_t)(time_us_64() - start_us);
+        }
+    }
+    capture_stop();
+
+    capture_dump();
+    print_alerts(alerts_us, alerts, "LIVE ");
+    return EXIT_SUCCESS;
+}
+
+static void task_replay(void *params){
+    (void)params;
+
+    int result = compare_filters ? compare() : evaluate_policies_mode ? evaluate() : capture_path ? replay() : record();
+    fflush(stdout);
+    exit(result);
+}
+
+int main(int argc, char **argv){
+    if((argc == 3 || argc == 4) && strcmp(argv[1], "record") == 0){
+        record_seconds = (uint32_t)atoi(argv[2]);
+        record_fastest = argc == 4 && strcmp(argv[3], "fastest") == 0;
+    }
+    else if(argc == 3 && strcmp(argv[1], "filters") == 0){
+        compare_filters = true;
+        capture_path = argv[2];
+    }
+    else if(argc == 3 && strcmp(argv[1], "evaluate") == 0){
+        evaluate_policies_mode = true;
+        capture_path = argv[2];
+    }
+    else if(argc == 2) capture_path = argv[1];
+    else {
+        fprintf(stderr, "usage: filtercore_replay <console with a capture>\n"
+                        "       filtercore_replay filters <console with a capture>\n"
+                        "       filtercore_replay evaluate <console with a capture at the fastest profile>\n"
+                        "       filtercore_replay record <seconds> [fastest]\n");
+        return EXIT_FAILURE;
+    }
+
+    stdio_init_all();
+
+    mailbox_init(&mailbox_sensors_data, &sensors_data_buffers[0], &sensors_data_buffers[1], sizeof(sensors_data_t));
+    mailbox_init(&mailbox_normalized_sensors_data, &normalized_sensors_data_buffers[0],
+                 &normalized_sensors_data_buffers[1], sizeof(normalized_sensors_data_t));
+
+    TaskHandle_t handle = xTaskCreateStatic(
+        task_replay,
+        "Task Replay",
+        REPLAY_STACK_SIZE,
+        NULL,
+        tskIDLE_PRIORITY + 2,
+        replay_task_stack,
+        &replay_task_buffer
+    );
+    if(handle == NULL) abort();
+
+    vTaskStartScheduler();
+    abort();
+}
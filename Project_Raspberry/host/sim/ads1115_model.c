@@ -0,0 +1,205 @@
+#include "sim.h"
+#include "hardware/sync.h"
+
+#define ADS1115_MODEL_BASE_ADDRESS 0x48
+#define ADS1115_MODEL_MAX_DEVICES 4
+
+// Campos do registrador de configuração
+#define CONFIG_OS (1u << 15)
+#define CONFIG_MUX_SHIFT 12
+#define CONFIG_PGA_SHIFT 9
+#define CONFIG_MODE_SINGLE (1u << 8)
+#define CONFIG_DR_SHIFT 5
+
+// Sensores ligados às entradas de cada conversor (ADS1115_CHANNEL(n, entrada) no firmware)
+#define INPUT_PH 0
+#define INPUT_TDS 1
+
+#define ADC_NOISE_VOLTS 0.002f
+
+// The firmware converts at PGA 000 (+/-6.144 V) but scales codes by ADS1115_VREF
+// (4.096 V), and ph4502c.c and tds_meter.c were calibrated on those readings: the
+// probe curves below are in that scale, and the pin sees them 6.144/4.096 higher
+#define FIRMWARE_READING_SCALE (6.144f / 4.096f)
+
+enum { REG_CONVERSION, REG_CONFIG, REG_LO_THRESH, REG_HI_THRESH };
+
+static const float full_scale_volts[8] = { 6.144f, 4.096f, 2.048f, 1.024f, 0.512f, 0.256f, 0.256f, 0.256f };
+static const uint16_t data_rates_sps[8] = { 8, 16, 32, 64, 128, 250, 475, 860 };
+
+// Estado de um conversor
+typedef struct {
+    sim_i2c_device_t device;
+    uint8_t pointer;
+    uint16_t registers[4];
+    bool converting;
+    uint64_t next_us;               // end of the conversion in progress
+    uint32_t conversions;
+} ads1115_t;
+
+static ads1115_t converters[ADS1115_MODEL_MAX_DEVICES];
+static uint8_t converter_count;
+
+/**
+ * @brief Tensão de saída da sonda de pH (inverso da reta do ph4502c.c).
+ */
+static float ph_volts(float ph){
+    return (ph - 58.247f) / -20.4082f;
+}
+
+/**
+ * @brief Tensão de saída da sonda de TDS: inverte a curva do tds_meter.c por bisseção
+ * e desfaz a compensação de temperatura (2 % por ºC).
+ */
+static float tds_volts(float ppm, float temperature){
+    float low = 0.0f, high = 4.0f;
+    for(int i = 0; i < 32; i++){
+        float v = (low + high) / 2.0f;
+        float curve = (133.42f * v * v * v - 255.86f * v * v + 857.39f * v) * 0.5f;
+        if(curve < ppm) low = v;
+        else high = v;
+    }
+    return (low + high) / 2.0f * (1.0f + 0.02f * (temperature - 25.0f));
+}
+
+/**
+ * @brief Tensão (sem ruído) no pino de uma entrada single-ended no instante dado.
+ */
+float ads1115_model_input_volts(uint8_t input, uint64_t now_us){
+    switch(input){
+        case INPUT_PH: return ph_volts(world_ph(now_us)) * FIRMWARE_READING_SCALE;
+        case INPUT_TDS: return tds_volts(world_tds(now_us), world_temperature(now_us)) * FIRMWARE_READING_SCALE;
+        default: return 0.0f;
+    }
+}
+
+static uint32_t conversion_us(const ads1115_t *ads){
+    return 1000000u / data_rates_sps[(ads->registers[REG_CONFIG] >> CONFIG_DR_SHIFT) & 0x7];
+}
+
+/**
+ * @brief Conclui uma conversão: atualiza o resultado e pulsa ALERT/RDY.
+ * @note Com Hi_thresh[15] = 1 e Lo_thresh[15] = 0 o pino sinaliza "conversão pronta"
+ * com um pulso baixo (dreno aberto, ligado aos dos outros conversores; o pull-up
+ * é o do firmware).
+ */
+static void complete_conversion(ads1115_t *ads, uint64_t now_us){
+    uint16_t config = ads->registers[REG_CONFIG];
+    uint8_t mux = (config >> CONFIG_MUX_SHIFT) & 0x7;
+    float full_scale = full_scale_volts[(config >> CONFIG_PGA_SHIFT) & 0x7];
+
+    // Single-ended inputs only (MUX 100..111); differential pairs read 0 V
+    float volts = mux >= 4 ? ads1115_model_input_volts(mux - 4, now_us) + sim_noise(ADC_NOISE_VOLTS) : 0.0f;
+    float code = volts / full_scale * 32768.0f;
+    if(code > 32767.0f) code = 32767.0f;
+    if(code < -32768.0f) code = -32768.0f;
+
+    ads->registers[REG_CONVERSION] = (uint16_t)(int16_t)code;
+    ads->conversions++;
+
+    if((ads->registers[REG_HI_THRESH] & 0x8000) && !(ads->registers[REG_LO_THRESH] & 0x8000)){
+        sim_gpio_drive(SIM_ADS1115_ALERT_PIN, false);
+        sim_gpio_release(SIM_ADS1115_ALERT_PIN);
+    }
+}
+
+static void write_config(ads1115_t *ads, uint16_t value){
+    ads->registers[REG_CONFIG] = value & ~CONFIG_OS;
+
+    bool single_shot = value & CONFIG_MODE_SINGLE;
+    if(single_shot && !(value & CONFIG_OS)){
+        ads->converting = false; // power-down
+        return;
+    }
+
+    // Continuous mode restarts on every write; single-shot converts once
+    ads->converting = true;
+    ads->next_us = time_us_64() + conversion_us(ads);
+}
+
+/**
+ * @brief Conclui a conversão de um conversor, se vencida; no modo contínuo, a próxima começa em seguida.
+ */
+static void update_converter(ads1115_t *ads, uint64_t now_us){
+    if(!ads->converting || now_us < ads->next_us) return;
+
+    complete_conversion(ads, now_us);
+
+    if(ads->registers[REG_CONFIG] & CONFIG_MODE_SINGLE) ads->converting = false;
+    else {
+        uint32_t period_us = conversion_us(ads);
+        while(ads->next_us <= now_us) ads->next_us += period_us;
+    }
+}
+
+static void ads1115_write(void *context, const uint8_t *data, size_t len){
+    ads1115_t *ads = context;
+    if(len == 0) return;
+
+    ads->pointer = data[0] & 0x3;
+    if(len < 3) return;
+
+    uint16_t value = (uint16_t)((data[1] << 8) | data[2]);
+    if(ads->pointer == REG_CONFIG) write_config(ads, value);
+    else if(ads->pointer != REG_CONVERSION) ads->registers[ads->pointer] = value;
+}
+
+static void ads1115_read(void *context, uint8_t *data, size_t len){
+    ads1115_t *ads = context;
+
+    // A conversion due before this read is already in the register, even if the
+    // interrupt task has not run since it ended
+    update_converter(ads, time_us_64());
+
+    uint16_t value = ads->registers[ads->pointer];
+    if(ads->pointer == REG_CONFIG && !ads->converting) value |= CONFIG_OS;
+
+    for(size_t i = 0; i < len; i++) data[i] = (i % 2) ? (value & 0xFF) : (value >> 8);
+}
+
+/**
+ * @brief Conecta os conversores (FILTERCORE_SIM_ADS1115, 1 por padrão) a partir de 0x48.
+ * @note Todos leem as mesmas entradas (pH em AIN0, TDS em AIN1).
+ */
+void ads1115_model_init(void){
+    int count = sim_env_int("FILTERCORE_SIM_ADS1115", 1);
+    if(count < 0) count = 0;
+    if(count > ADS1115_MODEL_MAX_DEVICES) count = ADS1115_MODEL_MAX_DEVICES;
+    converter_count = (uint8_t)count;
+
+    for(uint8_t i = 0; i < converter_count; i++){
+        ads1115_t *ads = &converters[i];
+        ads->registers[REG_CONFIG] = 0x8583 & ~CONFIG_OS;
+        ads->registers[REG_LO_THRESH] = 0x8000;
+        ads->registers[REG_HI_THRESH] = 0x7FFF;
+
+        ads->device = (sim_i2c_device_t){
+            .bus = SIM_I2C_SENSORS,
+            .address = ADS1115_MODEL_BASE_ADDRESS + i,
+            .context = ads,
+            .write = ads1115_write,
+            .read = ads1115_read
+        };
+        sim_i2c_attach(&ads->device);
+    }
+}
+
+/**
+ * @brief Conclui as conversões vencidas de todos os conversores.
+ * @note Conversões perdidas enquanto a task de interrupções não rodou são descartadas,
+ * como o conversor faz (só o último resultado fica no registrador).
+ */
+void ads1115_model_update(uint64_t now_us){
+    uint32_t saved_irq = save_and_disable_interrupts();
+    for(uint8_t i = 0; i < converter_count; i++) update_converter(&converters[i], now_us);
+    restore_interrupts(saved_irq);
+}
+
+void ads1115_model_report(void){
+    for(uint8_t i = 0; i < converter_count; i++){
+        const ads1115_t *ads = &converters[i];
+        sim_log("[sim] ADS1115 0x%02X: %lu conversions, %u SPS, AIN%u\n", ads->device.address,
+                (unsigned long)ads->conversions, data_rates_sps[(ads->registers[REG_CONFIG] >> CONFIG_DR_SHIFT) & 0x7],
+                (ads->registers[REG_CONFIG] >> CONFIG_MUX_SHIFT) & 0x3);
+    }
+}
@@ -0,0 +1,417 @@
+#include "sim.h"
+#include "hardware/sync.h"
+#include <string.h>
+
+#define DS18B20_MODEL_MAX_PROBES 4
+#define DS18B20_MODEL_CONVERSION_US 600000  // 12-bit conversion (750 ms max in the datasheet)
+
+// Tempos do escravo (us)
+#define RESET_MIN_LOW_US 400                // master holds 480
+#define WRITE_ZERO_MIN_LOW_US 30            // master holds 60 for a 0, 6 for a 1 and 2 for a read
+#define PRESENCE_START_US 20
+#define PRESENCE_END_US 140
+#define READ_ZERO_HOLD_US 40                // a 0 is held from the master's falling edge
+
+// Janelas que o mestre deve respeitar (datasheet do DS18B20, us)
+#define MASTER_RESET_MIN_LOW_US 480
+#define MASTER_SHORT_LOW_MAX_US 15          // write 1 and read: 1..15
+#define MASTER_ZERO_MIN_LOW_US 60           // write 0: 60..120
+#define MASTER_ZERO_MAX_LOW_US 120
+#define MASTER_SLOT_MIN_US 60               // falling edge to falling edge
+#define MASTER_RECOVERY_MIN_US 1            // line high between slots
+#define MASTER_READ_SAMPLE_MAX_US 15        // read sampled within 15 of the falling edge
+#define MASTER_PRESENCE_SAMPLE_MIN_US 60    // presence guaranteed low 60..120 after the release
+#define MASTER_PRESENCE_SAMPLE_MAX_US 120
+#define MAX_LOGGED_VIOLATIONS 8
+
+// Comandos
+#define CMD_SEARCH_ROM 0xF0
+#define CMD_READ_ROM 0x33
+#define CMD_MATCH_ROM 0x55
+#define CMD_SKIP_ROM 0xCC
+#define CMD_CONVERT_T 0x44
+#define CMD_WRITE_SCRATCHPAD 0x4E
+#define CMD_READ_SCRATCHPAD 0xBE
+
+// Estados de uma sonda entre dois resets
+typedef enum {
+    PROBE_IDLE,                 // waits for a reset (not selected)
+    PROBE_ROM_COMMAND,
+    PROBE_MATCH_ROM,
+    PROBE_SEARCH,
+    PROBE_FUNCTION_COMMAND,
+    PROBE_WRITE_SCRATCHPAD,
+    PROBE_SEND,                 // ROM or scratchpad, then 1s
+    PROBE_CONVERTING            // read slots return 0 until the conversion ends
+} probe_state_t;
+
+// Sonda no barramento
+typedef struct {
+    uint8_t rom[8];
+    uint8_t scratchpad[9];
+    float offset_celsius;
+    probe_state_t state;
+
+    uint8_t rx[8];              // bytes being received (LSB first)
+    uint8_t rx_bits;
+    const uint8_t *tx;
+    uint8_t tx_bits;
+    uint8_t tx_index;
+    uint8_t search_bit;         // 0..63
+    uint8_t search_phase;       // 0: bit, 1: complement, 2: master's direction
+    bool sending_zero;          // holds the line low in the current read slot
+
+    bool converting;
+    uint64_t conversion_end_us;
+    uint32_t conversions;
+    uint32_t reads;
+} probe_t;
+
+static probe_t probes[DS18B20_MODEL_MAX_PROBES];
+static uint8_t probe_count;
+
+static uint64_t fall_us;                // master's last falling edge
+static uint64_t rise_us;                // master's last release
+static uint64_t presence_us;            // release that ended the last reset
+static bool slot_open;                  // the last release ended a slot, not a reset
+static uint32_t resets;
+static sim_onewire_timing_t timing;
+
+/**
+ * @brief CRC-8 Dallas/Maxim (x^8 + x^5 + x^4 + 1), como o das sondas.
+ */
+static uint8_t crc8(const uint8_t *data, size_t len){
+    uint8_t crc = 0;
+    for(size_t i = 0; i < len; i++){
+        uint8_t byte_val = data[i];
+        for(int bit = 0; bit < 8; bit++){
+            uint8_t mix = (crc ^ byte_val) & 0x01;
+            crc >>= 1;
+            if(mix) crc ^= 0x8C;
+            byte_val >>= 1;
+        }
+    }
+    return crc;
+}
+
+/**
+ * @brief Atualiza o scratchpad ao fim de uma conversão (temperatura do instante final).
+ */
+static void finish_conversion(probe_t *probe, uint64_t now_us){
+    if(!probe->converting || now_us < probe->conversion_end_us) return;
+    probe->converting = false;
+    probe->conversions++;
+
+    float celsius = world_temperature(now_us) + probe->offset_celsius + sim_noise(0.05f);
+    int16_t raw = (int16_t)(celsius * 16.0f + (celsius >= 0 ? 0.5f : -0.5f));
+    probe->scratchpad[0] = (uint8_t)(raw & 0xFF);
+    probe->scratchpad[1] = (uint8_t)((uint16_t)raw >> 8);
+    probe->scratchpad[8] = crc8(probe->scratchpad, 8);
+}
+
+static void send(probe_t *probe, const uint8_t *data, uint8_t bytes){
+    probe->tx = data;
+    probe->tx_bits = bytes * 8;
+    probe->tx_index = 0;
+    probe->state = PROBE_SEND;
+}
+
+static void receive(probe_t *probe, probe_state_t state){
+    probe->state = state;
+    probe->rx_bits = 0;
+    memset(probe->rx, 0, sizeof(probe->rx));
+}
+
+/**
+ * @brief Trata um byte (ou a ROM inteira) recebido do mestre.
+ */
+static void received(probe_t *probe, uint64_t now_us){
+    switch(probe->state){
+        case PROBE_ROM_COMMAND:
+            switch(probe->rx[0]){
+                case CMD_SKIP_ROM: receive(probe, PROBE_FUNCTION_COMMAND); break;
+                case CMD_MATCH_ROM: receive(probe, PROBE_MATCH_ROM); break;
+                case CMD_READ_ROM: send(probe, probe->rom, sizeof(probe->rom)); break;
+                case CMD_SEARCH_ROM:
+                    probe->state = PROBE_SEARCH;
+                    probe->search_bit = 0;
+                    probe->search_phase = 0;
+                    break;
+                default: probe->state = PROBE_IDLE; break;
+            }
+            break;
+
+        case PROBE_MATCH_ROM:
+            if(memcmp(probe->rx, probe->rom, sizeof(probe->rom)) == 0) receive(probe, PROBE_FUNCTION_COMMAND);
+            else probe->state = PROBE_IDLE;
+            break;
+
+        case PROBE_FUNCTION_COMMAND:
+            switch(probe->rx[0]){
+                case CMD_CONVERT_T:
+                    probe->converting = true;
+                    probe->conversion_end_us = now_us + DS18B20_MODEL_CONVERSION_US;
+                    probe->state = PROBE_CONVERTING;
+                    break;
+                case CMD_READ_SCRATCHPAD:
+                    finish_conversion(probe, now_us);
+                    probe->reads++;
+                    send(probe, probe->scratchpad, sizeof(probe->scratchpad));
+                    break;
+                case CMD_WRITE_SCRATCHPAD: receive(probe, PROBE_WRITE_SCRATCHPAD); break;
+                default: probe->state = PROBE_IDLE; break;
+            }
+            break;
+
+        case PROBE_WRITE_SCRATCHPAD:
+            memcpy(&probe->scratchpad[2], probe->rx, 3); // TH, TL, configuration
+            probe->scratchpad[8] = crc8(probe->scratchpad, 8);
+            probe->state = PROBE_IDLE;
+            break;
+
+        default:
+            break;
+    }
+}
+
+static uint8_t expected_bits(const probe_t *probe){
+    switch(probe->state){
+        case PROBE_MATCH_ROM: return 64;
+        case PROBE_WRITE_SCRATCHPAD: return 24;
+        default: return 8;
+    }
+}
+
+/**
+ * @brief Bit que a sonda transmite na fenda de leitura atual (true = deixa a linha subir).
+ */
+static bool bit_to_send(probe_t *probe, uint64_t now_us){
+    switch(probe->state){
+        case PROBE_SEND:
+            if(probe->tx_index >= probe->tx_bits) return true;
+            return (probe->tx[probe->tx_index / 8] >> (probe->tx_index % 8)) & 1;
+
+        case PROBE_SEARCH: {
+            bool bit = (probe->rom[probe->search_bit / 8] >> (probe->search_bit % 8)) & 1;
+            if(probe->search_phase == 0) return bit;
+            if(probe->search_phase == 1) return !bit;
+            return true;
+        }
+
+        case PROBE_CONVERTING:
+            finish_conversion(probe, now_us);
+            return !probe->converting;
+
+        default:
+            return true;
+    }
+}
+
+/**
+ * @brief Fim de uma fenda (o mestre liberou a linha) com o bit que ela carregou.
+ */
+static void slot_done(probe_t *probe, bool bit, uint64_t now_us){
+    switch(probe->state){
+        case PROBE_ROM_COMMAND:
+        case PROBE_MATCH_ROM:
+        case PROBE_FUNCTION_COMMAND:
+        case PROBE_WRITE_SCRATCHPAD:
+            if(bit) probe->rx[probe->rx_bits / 8] |= 1 << (probe->rx_bits % 8);
+            if(++probe->rx_bits == expected_bits(probe)) received(probe, now_us);
+            break;
+
+        case PROBE_SEND:
+            if(probe->tx_index < probe->tx_bits) probe->tx_index++;
+            break;
+
+        case PROBE_SEARCH:
+            if(probe->search_phase < 2){
+                probe->search_phase++;
+                break;
+            }
+
+            // Devices whose bit differs from the chosen direction leave the search
+            if(bit != ((probe->rom[probe->search_bit / 8] >> (probe->search_bit % 8)) & 1)){
+                probe->state = PROBE_IDLE;
+                break;
+            }
+            probe->search_phase = 0;
+            if(++probe->search_bit == 64) receive(probe, PROBE_FUNCTION_COMMAND);
+            break;
+
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Registra um tempo do mestre fora da janela do datasheet.
+ * @note Curto demais é erro do firmware; longo demais também pode ser atraso do
+ * host (o simulador roda no relógio real), que só estica os tempos. As primeiras são descritas no log.
+ * * @param too_short true se o tempo ficou abaixo da janela.
+ */
+static void timing_violation(bool too_short, const char *what, uint64_t us){
+    if(too_short) timing.too_short++;
+    else timing.too_long++;
+
+    if(timing.too_short + timing.too_long <= MAX_LOGGED_VIOLATIONS){
+        sim_log("[sim] DS18B20: %s (%llu us)\n", what, (unsigned long long)us);
+    }
+}
+
+/**
+ * @brief Confere os tempos de uma borda do mestre: duração do nível baixo na
+ * subida, recuperação e duração da fenda na descida.
+ */
+static void check_master_timing(bool level, uint64_t now_us){
+    if(!level){
+        if(rise_us && now_us - rise_us < MASTER_RECOVERY_MIN_US) timing_violation(true, "recovery too short", now_us - rise_us);
+        if(slot_open && now_us - fall_us < MASTER_SLOT_MIN_US) timing_violation(true, "slot too short", now_us - fall_us);
+        return;
+    }
+
+    uint64_t low_us = now_us - fall_us;
+    if(low_us >= MASTER_RESET_MIN_LOW_US) return;
+    if(low_us >= RESET_MIN_LOW_US){
+        timing_violation(true, "reset pulse too short", low_us);
+        return;
+    }
+
+    timing.slots++;
+    if(low_us < 1) timing_violation(true, "low pulse too short", low_us);
+    // Between the windows: a stretched 1/read or a short 0, not told apart (counted as long)
+    else if(low_us > MASTER_SHORT_LOW_MAX_US && low_us < MASTER_ZERO_MIN_LOW_US){
+        timing_violation(false, "low pulse between the 1 and 0 windows", low_us);
+        timing.misread++;
+    }
+    else if(low_us > MASTER_ZERO_MAX_LOW_US) timing_violation(false, "0 pulse stretched", low_us);
+}
+
+/**
+ * @brief Leituras do mestre: a presença e os bits devem ser amostrados dentro das janelas.
+ */
+static void onewire_reader(uint pin, bool level, uint64_t now_us){
+    (void)pin;
+    (void)level;
+
+    if(!slot_open){
+        if(!presence_us) return;
+        uint64_t after_us = now_us - presence_us;
+        if(after_us < MASTER_PRESENCE_SAMPLE_MIN_US) timing_violation(true, "presence sampled early", after_us);
+        else if(after_us >= MASTER_PRESENCE_SAMPLE_MAX_US) timing_violation(false, "presence sampled late", after_us);
+        return;
+    }
+
+    uint64_t after_us = now_us - fall_us;
+    if(after_us > MASTER_READ_SAMPLE_MAX_US) timing_violation(false, "read sampled late", after_us);
+    // Past the probe's hold a 0 reads as a 1
+    if(after_us >= READ_ZERO_HOLD_US) timing.misread++;
+}
+
+/**
+ * @brief Bordas impostas pelo mestre: a descida abre uma fenda, a subida a classifica
+ * pela duração (reset, 0 escrito ou 1/leitura).
+ */
+static void onewire_listener(uint pin, bool level, uint64_t now_us){
+    (void)pin;
+    check_master_timing(level, now_us);
+
+    if(!level){
+        fall_us = now_us;
+        for(uint8_t i = 0; i < probe_count; i++){
+            probes[i].sending_zero = !bit_to_send(&probes[i], now_us);
+        }
+        return;
+    }
+
+    rise_us = now_us;
+    uint64_t low_us = now_us - fall_us;
+    slot_open = low_us < RESET_MIN_LOW_US;
+    if(!slot_open){
+        resets++;
+        presence_us = now_us;
+        for(uint8_t i = 0; i < probe_count; i++){
+            probes[i].sending_zero = false;
+            receive(&probes[i], PROBE_ROM_COMMAND);
+        }
+        return;
+    }
+
+    // A probe sending a 0 keeps holding the line after the master releases it (see the sampler)
+    bool bit = low_us < WRITE_ZERO_MIN_LOW_US;
+    for(uint8_t i = 0; i < probe_count; i++){
+        // A 1 written by the master reads back as the probe's own bit (wired-AND)
+        slot_done(&probes[i], bit && !probes[i].sending_zero, now_us);
+    }
+}
+
+/**
+ * @brief Nível da linha liberada pelo mestre: pull-up externo e sondas em dreno aberto.
+ */
+static bool onewire_sampler(uint pin, uint64_t now_us){
+    (void)pin;
+
+    if(probe_count && presence_us && now_us >= presence_us + PRESENCE_START_US && now_us < presence_us + PRESENCE_END_US) return false;
+
+    for(uint8_t i = 0; i < probe_count; i++){
+        if(probes[i].sending_zero && now_us < fall_us + READ_ZERO_HOLD_US) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Conecta as sondas (FILTERCORE_SIM_PROBES, 1 por padrão) ao pino do 1-Wire.
+ */
+void ds18b20_model_init(void){
+    int count = sim_env_int("FILTERCORE_SIM_PROBES", 1);
+    if(count < 0) count = 0;
+    if(count > DS18B20_MODEL_MAX_PROBES) count = DS18B20_MODEL_MAX_PROBES;
+    probe_count = (uint8_t)count;
+
+    for(uint8_t i = 0; i < probe_count; i++){
+        probe_t *probe = &probes[i];
+        const uint8_t rom[7] = { 0x28, 0x5A, 0x10 + i, 0x3C, 0x07, 0x00, 0x00 };
+        memcpy(probe->rom, rom, sizeof(rom));
+        probe->rom[7] = crc8(probe->rom, 7);
+
+        // Power-on scratchpad: +85 ºC, TH/TL from EEPROM, 12-bit resolution
+        const uint8_t scratchpad[8] = { 0x50, 0x05, 0x4B, 0x46, 0x7F, 0xFF, 0x0C, 0x10 };
+        memcpy(probe->scratchpad, scratchpad, sizeof(scratchpad));
+        probe->scratchpad[8] = crc8(probe->scratchpad, 8);
+
+        probe->offset_celsius = 0.25f * i;
+        probe->state = PROBE_IDLE;
+    }
+
+    sim_gpio_listen(SIM_ONEWIRE_PIN, onewire_listener);
+    sim_gpio_sample_with(SIM_ONEWIRE_PIN, onewire_sampler);
+    sim_gpio_observe_reads(SIM_ONEWIRE_PIN, onewire_reader);
+}
+
+/**
+ * @brief Desconecta todas as sondas do barramento (sonda morta ou cabo rompido).
+ */
+void ds18b20_model_unplug(void){
+    uint32_t saved_irq = save_and_disable_interrupts();
+    probe_count = 0;
+    restore_interrupts(saved_irq);
+}
+
+void ds18b20_model_report(void){
+    sim_log("[sim] DS18B20: %u probe(s), %lu resets, %lu slots, %lu too short, %lu too long (%lu misread)\n",
+            probe_count, (unsigned long)resets, (unsigned long)timing.slots, (unsigned long)timing.too_short,
+            (unsigned long)timing.too_long, (unsigned long)timing.misread);
+    for(uint8_t i = 0; i < probe_count; i++){
+        sim_log("[sim]   probe %u: %lu conversions, %lu scratchpad reads\n", i,
+                (unsigned long)probes[i].conversions, (unsigned long)probes[i].reads);
+    }
+}
+
+/**
+ * @brief Fendas do mestre e tempos fora das janelas do datasheet desde o início.
+ */
+void ds18b20_model_timing(sim_onewire_timing_t *copy){
+    uint32_t saved_irq = save_and_disable_interrupts();
+    *copy = timing;
+    restore_interrupts(saved_irq);
+}
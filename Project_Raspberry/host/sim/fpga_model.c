@@ -0,0 +1,85 @@
+#include "sim.h"
+#include "hardware/sync.h"
+
+#define FPGA_MODEL_ACK_US 2000          // REQ edge to ACK edge
+
+// Estado do enlace com o FPGA
+static struct {
+    uint32_t ack_delay_us;
+    uint32_t miss_percent;              // requests left without ACK (exercises the retries)
+    bool ack_pending;
+    bool ack_level;                     // level the pending edge will set
+    uint64_t ack_us;
+    uint8_t last_data;                  // temperature, pH, TDS, button (bits 0..3)
+    uint32_t requests;
+    uint32_t acks;
+    uint32_t missed;
+} fpga;
+
+static bool data_pin(uint pin){
+    return sim_gpio_output_level(pin);
+}
+
+/**
+ * @brief Borda do REQ: na subida o FPGA lê os dados e responde com ACK; na
+ * descida ele baixa o ACK.
+ */
+static void req_listener(uint pin, bool level, uint64_t now_us){
+    (void)pin;
+
+    if(level){
+        fpga.requests++;
+        fpga.last_data = (uint8_t)(data_pin(SIM_DATA_TEMPERATURE_PIN) | (data_pin(SIM_DATA_PH_PIN) << 1) |
+                                   (data_pin(SIM_DATA_TDS_PIN) << 2) | (data_pin(SIM_DATA_BUTTON_PIN) << 3));
+
+        if(sim_random() % 100 < fpga.miss_percent){
+            fpga.missed++;
+            return;
+        }
+    }
+
+    fpga.ack_pending = true;
+    fpga.ack_level = level;
+    fpga.ack_us = now_us + fpga.ack_delay_us;
+}
+
+void fpga_model_init(void){
+    fpga.ack_delay_us = (uint32_t)sim_env_int("FILTERCORE_SIM_ACK_US", FPGA_MODEL_ACK_US);
+    fpga.miss_percent = (uint32_t)sim_env_int("FILTERCORE_SIM_ACK_MISS", 0);
+
+    sim_gpio_drive(SIM_FPGA_ALIVE_PIN, true);
+    sim_gpio_listen(SIM_REQ_PIN, req_listener);
+}
+
+/**
+ * @brief Troca o atraso entre a borda do REQ e a do ACK (FILTERCORE_SIM_ACK_US no início).
+ */
+void fpga_model_set_ack_delay(uint32_t delay_us){
+    uint32_t saved_irq = save_and_disable_interrupts();
+    fpga.ack_delay_us = delay_us;
+    restore_interrupts(saved_irq);
+}
+
+/**
+ * @brief Aplica a borda de ACK vencida (o ACK baixa pelo pull-down do firmware).
+ */
+void fpga_model_update(uint64_t now_us){
+    uint32_t saved_irq = save_and_disable_interrupts();
+
+    if(fpga.ack_pending && now_us >= fpga.ack_us){
+        fpga.ack_pending = false;
+        if(fpga.ack_level){
+            fpga.acks++;
+            sim_gpio_drive(SIM_ACK_PIN, true);
+        }
+        else sim_gpio_release(SIM_ACK_PIN);
+    }
+
+    restore_interrupts(saved_irq);
+}
+
+void fpga_model_report(void){
+    sim_log("[sim] FPGA: %lu requests, %lu ACKs, %lu missed, last data T=%u pH=%u TDS=%u button=%u\n",
+            (unsigned long)fpga.requests, (unsigned long)fpga.acks, (unsigned long)fpga.missed,
+            fpga.last_data & 1, (fpga.last_data >> 1) & 1, (fpga.last_data >> 2) & 1, (fpga.last_data >> 3) & 1);
+}
@@ -0,0 +1,137 @@
+#ifndef SIM_H
+#define SIM_H
+
+/**
+ * @file sim.h
+ * @brief Interface interna do simulador do build de host.
+ * @note O simulador implementa a HAL do pico-sdk (host/include) sobre o relógio
+ * do host e liga os pinos e barramentos a modelos dos dispositivos da placa:
+ * ADS1115, DS18B20, SSD1306 e o enlace com o FPGA. As interrupções (alarmes,
+ * bordas de GPIO, fim de DMA) são entregues por uma task de prioridade máxima,
+ * que faz o papel do NVIC.
+ */
+
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+
+// Ligações da placa (iguais às do firmware)
+#define SIM_I2C_SENSORS 0               // ADS1115
+#define SIM_I2C_DISPLAY 1               // SSD1306
+#define SIM_ONEWIRE_PIN 2               // DS18B20
+#define SIM_DATA_BUTTON_PIN 4
+#define SIM_BUTTON_A_PIN 5
+#define SIM_BUTTON_B_PIN 6
+#define SIM_ACK_PIN 8
+#define SIM_REQ_PIN 9
+#define SIM_FPGA_RESET_PIN 16
+#define SIM_FPGA_ALIVE_PIN 17
+#define SIM_DATA_TEMPERATURE_PIN 18
+#define SIM_DATA_PH_PIN 19
+#define SIM_DATA_TDS_PIN 20
+#define SIM_BUTTON_SW_PIN 22
+#define SIM_ADS1115_ALERT_PIN 28
+
+#define SIM_SPIN_US 200                 // events due this soon are waited for by spinning, not by the next tick
+
+// --- Núcleo (sim_core.c) ---
+
+void sim_init(void);
+
+void sim_irq_raise(uint num);
+
+void sim_wake(void);
+
+int sim_env_int(const char *name, int fallback);
+
+float sim_noise(float amplitude);
+
+uint32_t sim_random(void);
+
+void sim_log(const char *format, ...) __attribute__((format(printf, 1, 2)));
+
+// --- GPIO (sim_gpio.c) ---
+
+/**
+ * @brief Observador de um pino: recebe o nível que o firmware impõe à linha
+ * (saída: o valor escrito; entrada: true, linha liberada).
+ */
+typedef void (*sim_pin_listener_t)(uint pin, bool level, uint64_t now_us);
+
+/**
+ * @brief Amostrador de um pino: nível que os dispositivos impõem à linha quando
+ * o firmware não a aciona (linhas com pull-up externo, como o 1-Wire).
+ */
+typedef bool (*sim_pin_sampler_t)(uint pin, uint64_t now_us);
+
+/**
+ * @brief Observador das leituras de um pino de entrada: recebe o nível lido e o
+ * instante da amostra (para conferir janelas de amostragem, como a do 1-Wire).
+ */
+typedef void (*sim_pin_reader_t)(uint pin, bool level, uint64_t now_us);
+
+void sim_gpio_listen(uint pin, sim_pin_listener_t listener);
+
+void sim_gpio_sample_with(uint pin, sim_pin_sampler_t sampler);
+
+void sim_gpio_observe_reads(uint pin, sim_pin_reader_t reader);
+
+void sim_gpio_drive(uint pin, bool level);
+
+void sim_gpio_release(uint pin);
+
+bool sim_gpio_output_level(uint pin);
+
+void sim_gpio_irq_dispatch(void);
+
+// --- I2C e DMA (sim_i2c.c) ---
+
+// Dispositivo virtual de um barramento I2C
+typedef struct {
+    uint8_t bus;
+    uint8_t address;
+    void *context;                      // state of the model instance, passed to the callbacks
+    void (*write)(void *context, const uint8_t *data, size_t len);
+    void (*read)(void *context, uint8_t *data, size_t len);
+} sim_i2c_device_t;
+
+void sim_i2c_attach(const sim_i2c_device_t *device);
+
+void sim_i2c_report(void);
+
+// --- Mundo e modelos ---
+
+void world_init(void);
+void world_update(uint64_t now_us);
+void world_script_buttons(bool enabled);
+float world_temperature(uint64_t now_us);
+float world_ph(uint64_t now_us);
+float world_tds(uint64_t now_us);
+
+void ads1115_model_init(void);
+void ads1115_model_update(uint64_t now_us);
+void ads1115_model_report(void);
+float ads1115_model_input_volts(uint8_t input, uint64_t now_us);
+
+void ds18b20_model_init(void);
+void ds18b20_model_report(void);
+void ds18b20_model_unplug(void);
+
+// Tempos do mestre 1-Wire conferidos pelo modelo do DS18B20
+typedef struct {
+    uint32_t slots;                     // write and read slots (resets not counted)
+    uint32_t too_short;                 // below a datasheet window: a firmware error
+    uint32_t too_long;                  // above one: the firmware or a host delay
+    uint32_t misread;                   // of those, slots long enough to change the bit
+} sim_onewire_timing_t;
+
+void ds18b20_model_timing(sim_onewire_timing_t *timing);
+
+void ssd1306_model_init(void);
+void ssd1306_model_report(void);
+
+void fpga_model_init(void);
+void fpga_model_update(uint64_t now_us);
+void fpga_model_set_ack_delay(uint32_t delay_us);
+void fpga_model_report(void);
+
+#endif //SIM_H
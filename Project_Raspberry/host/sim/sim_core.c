@@ -0,0 +1,511 @@
+#include "sim.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include <pthread.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SIM_MAX_ALARMS 32
+#define SIM_MAX_SHARED_HANDLERS 4
+#define SIM_SPIN_LOCKS 32
+#define SIM_TASK_STACK_SIZE (configMINIMAL_STACK_SIZE * 2)
+
+// Alarme pendente (id 0 = posição livre)
+typedef struct {
+    alarm_id_t id;
+    uint64_t at_us;
+    alarm_callback_t callback;
+    void *user_data;
+} sim_alarm_t;
+
+// Linha de interrupção
+typedef struct {
+    bool enabled;
+    volatile bool pending;
+    uint8_t handler_count;
+    irq_handler_t handlers[SIM_MAX_SHARED_HANDLERS];
+} sim_irq_t;
+
+static sim_alarm_t alarms[SIM_MAX_ALARMS];
+static alarm_id_t next_alarm_id = 1;
+
+static sim_irq_t irqs[SIM_IRQ_COUNT];
+
+static spin_lock_t spin_locks[SIM_SPIN_LOCKS];
+static uint32_t claimed_spin_locks;
+
+static uint64_t start_ns;
+static uint64_t end_us;
+static uint32_t random_state;
+
+static TaskHandle_t sim_task_handle = NULL;
+static StaticTask_t sim_task_buffer;
+static StackType_t sim_task_stack[SIM_TASK_STACK_SIZE];
+
+// --- Tempo ---
+
+static uint64_t monotonic_ns(void){
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+/**
+ * @brief Tempo desde o início do processo, em microssegundos (o timer do RP2040 conta desde o boot).
+ */
+uint64_t time_us_64(void){
+    return (monotonic_ns() - start_ns) / 1000u;
+}
+
+uint32_t time_us_32(void){
+    return (uint32_t)time_us_64();
+}
+
+void busy_wait_us(uint64_t delay_us){
+    uint64_t deadline = time_us_64() + delay_us;
+    while(time_us_64() < deadline) tight_loop_contents();
+}
+
+void busy_wait_us_32(uint32_t delay_us){
+    busy_wait_us(delay_us);
+}
+
+static bool scheduler_running(void){
+    return xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED;
+}
+
+/**
+ * @brief Dorme (cede a CPU às outras tasks) quando o escalonador já iniciou, como
+ * a interoperabilidade de tempo do FreeRTOS faz no RP2040.
+ */
+void sleep_us(uint64_t us){
+    if(!scheduler_running()){
+        struct timespec delay = { .tv_sec = us / 1000000u, .tv_nsec = (us % 1000000u) * 1000u };
+        nanosleep(&delay, NULL);
+        return;
+    }
+
+    TickType_t ticks = (TickType_t)((us + portTICK_PERIOD_MS * 1000u - 1) / (portTICK_PERIOD_MS * 1000u));
+    vTaskDelay(ticks ? ticks : 1);
+}
+
+void sleep_ms(uint32_t ms){
+    sleep_us((uint64_t)ms * 1000u);
+}
+
+uint get_core_num(void){
+    return 0; // the POSIX port runs every task on a single simulated core
+}
+
+// --- Interrupções e spinlocks ---
+
+/**
+ * @brief Bloqueia o sinal do tick da porta POSIX na thread atual.
+ * @return 1 se já estava bloqueado (interrupções já desabilitadas), 0 caso contrário.
+ */
+uint32_t save_and_disable_interrupts(void){
+    sigset_t tick, previous;
+    sigemptyset(&tick);
+    sigaddset(&tick, SIGALRM);
+    pthread_sigmask(SIG_BLOCK, &tick, &previous);
+    return sigismember(&previous, SIGALRM) ? 1u : 0u;
+}
+
+void restore_interrupts(uint32_t status){
+    if(status) return;
+
+    sigset_t tick;
+    sigemptyset(&tick);
+    sigaddset(&tick, SIGALRM);
+    pthread_sigmask(SIG_UNBLOCK, &tick, NULL);
+}
+
+spin_lock_t *spin_lock_instance(uint lock_num){
+    return &spin_locks[lock_num % SIM_SPIN_LOCKS];
+}
+
+spin_lock_t *spin_lock_init(uint lock_num){
+    spin_lock_t *lock = spin_lock_instance(lock_num);
+    *lock = 0;
+    return lock;
+}
+
+int spin_lock_claim_unused(bool required){
+    uint32_t saved_irq = save_and_disable_interrupts();
+    int lock_num = PICO_ERROR_GENERIC;
+    for(uint i = 0; i < SIM_SPIN_LOCKS; i++){
+        if(claimed_spin_locks & (1u << i)) continue;
+        claimed_spin_locks |= 1u << i;
+        lock_num = (int)i;
+        break;
+    }
+    restore_interrupts(saved_irq);
+
+    if(lock_num < 0 && required) abort();
+    return lock_num;
+}
+
+/**
+ * @brief Com uma task por vez na porta POSIX, basta impedir a preempção.
+ */
+uint32_t spin_lock_blocking(spin_lock_t *lock){
+    uint32_t saved_irq = save_and_disable_interrupts();
+    *lock = 1;
+    return saved_irq;
+}
+
+void spin_unlock(spin_lock_t *lock, uint32_t saved_irq){
+    *lock = 0;
+    restore_interrupts(saved_irq);
+}
+
+void irq_set_enabled(uint num, bool enabled){
+    if(num >= SIM_IRQ_COUNT) return;
+    irqs[num].enabled = enabled;
+    if(enabled && irqs[num].pending) sim_wake();
+}
+
+bool irq_is_enabled(uint num){
+    return num < SIM_IRQ_COUNT && irqs[num].enabled;
+}
+
+void irq_add_shared_handler(uint num, irq_handler_t handler, uint8_t order_priority){
+    (void)order_priority;
+    if(num >= SIM_IRQ_COUNT || irqs[num].handler_count >= SIM_MAX_SHARED_HANDLERS) abort();
+    irqs[num].handlers[irqs[num].handler_count++] = handler;
+}
+
+/**
+ * @brief Marca uma linha de interrupção como pendente; a task de interrupções a despacha.
+ */
+void sim_irq_raise(uint num){
+    if(num >= SIM_IRQ_COUNT) return;
+    irqs[num].pending = true;
+    sim_wake();
+}
+
+/**
+ * @brief Executa os tratadores das linhas pendentes e habilitadas.
+ * @note Uma borda que chega durante o tratamento fica pendente para a próxima passada.
+ */
+static void dispatch_irqs(void){
+    for(uint num = 0; num < SIM_IRQ_COUNT; num++){
+        sim_irq_t *irq = &irqs[num];
+        if(!irq->pending || !irq->enabled) continue;
+        irq->pending = false;
+
+        if(num == IO_IRQ_BANK0) sim_gpio_irq_dispatch();
+        for(uint8_t i = 0; i < irq->handler_count; i++) irq->handlers[i]();
+    }
+}
+
+// --- Alarmes ---
+
+static alarm_id_t schedule(alarm_id_t id, uint64_t at_us, alarm_callback_t callback, void *user_data){
+    uint32_t saved_irq = save_and_disable_interrupts();
+
+    sim_alarm_t *slot = NULL;
+    for(uint i = 0; i < SIM_MAX_ALARMS && !slot; i++){
+        if(alarms[i].id == 0) slot = &alarms[i];
+    }
+
+    if(slot){
+        if(id == 0){
+            id = next_alarm_id++;
+            if(next_alarm_id <= 0) next_alarm_id = 1;
+        }
+        *slot = (sim_alarm_t){ id, at_us, callback, user_data };
+    }
+    else id = PICO_ERROR_GENERIC;
+
+    restore_interrupts(saved_irq);
+
+    if(id > 0) sim_wake();
+    return id;
+}
+
+/**
+ * @brief Agenda um alarme com a semântica do pico-sdk para instantes já vencidos.
+ * @note Um alarme para agora (us = 0) já passou: sem fire_if_past retorna 0 e não
+ * é agendado; com fire_if_past o callback roda na hora, no contexto de quem
+ * chamou, e só é agendado se pedir repetição.
+ * @return O id do alarme, 0 se ele não ficou agendado ou PICO_ERROR_GENERIC sem posição livre.
+ */
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback, void *user_data, bool fire_if_past){
+    uint64_t at_us = time_us_64() + us;
+    if(us > 0) return schedule(0, at_us, callback, user_data);
+    if(!fire_if_past) return 0;
+
+    int64_t delay_us = callback(0, user_data);
+    if(delay_us == 0) return 0;
+    return schedule(0, delay_us > 0 ? time_us_64() + (uint64_t)delay_us : at_us + (uint64_t)(-delay_us), callback, user_data);
+}
+
+alarm_id_t add_alarm_in_ms(uint32_t ms, alarm_callback_t callback, void *user_data, bool fire_if_past){
+    return add_alarm_in_us((uint64_t)ms * 1000u, callback, user_data, fire_if_past);
+}
+
+bool cancel_alarm(alarm_id_t alarm_id){
+    bool cancelled = false;
+
+    uint32_t saved_irq = save_and_disable_interrupts();
+    for(uint i = 0; i < SIM_MAX_ALARMS; i++){
+        if(alarm_id > 0 && alarms[i].id == alarm_id){
+            alarms[i].id = 0;
+            cancelled = true;
+        }
+    }
+    restore_interrupts(saved_irq);
+
+    return cancelled;
+}
+
+/**
+ * @brief Retira da tabela o alarme vencido mais antigo, se houver.
+ * * @param now_us Instante atual.
+ * @param alarm Recebe o alarme retirado.
+ */
+static bool take_due_alarm(uint64_t now_us, sim_alarm_t *alarm){
+    sim_alarm_t *due = NULL;
+
+    uint32_t saved_irq = save_and_disable_interrupts();
+    for(uint i = 0; i < SIM_MAX_ALARMS; i++){
+        if(alarms[i].id == 0 || alarms[i].at_us > now_us) continue;
+        if(!due || alarms[i].at_us < due->at_us) due = &alarms[i];
+    }
+    if(due){
+        *alarm = *due;
+        due->id = 0;
+    }
+    restore_interrupts(saved_irq);
+
+    return due != NULL;
+}
+
+static uint64_t next_alarm_us(void){
+    uint64_t next = UINT64_MAX;
+
+    uint32_t saved_irq = save_and_disable_interrupts();
+    for(uint i = 0; i < SIM_MAX_ALARMS; i++){
+        if(alarms[i].id && alarms[i].at_us < next) next = alarms[i].at_us;
+    }
+    restore_interrupts(saved_irq);
+
+    return next;
+}
+
+/**
+ * @brief Executa os alarmes vencidos e reagenda os que pedem repetição (semântica do pico-sdk).
+ */
+static void run_due_alarms(void){
+    sim_alarm_t alarm;
+
+    while(take_due_alarm(time_us_64(), &alarm)){
+        int64_t delay_us = alarm.callback(alarm.id, alarm.user_data);
+        if(delay_us == 0) continue;
+
+        uint64_t at_us = delay_us > 0 ? time_us_64() + (uint64_t)delay_us : alarm.at_us + (uint64_t)(-delay_us);
+        schedule(alarm.id, at_us, alarm.callback, alarm.user_data);
+    }
+}
+
+// --- Task de interrupções ---
+
+/**
+ * @brief Acorda a task de interrupções (um alarme ou uma interrupção chegou).
+ * @note Sem efeito antes do escalonador e na própria task; em seção crítica, o
+ * despacho fica para o próximo tick.
+ */
+void sim_wake(void){
+    if(!sim_task_handle || !scheduler_running()) return;
+    if(xTaskGetCurrentTaskHandle() == sim_task_handle) return;
+
+    uint32_t saved_irq = save_and_disable_interrupts();
+    restore_interrupts(saved_irq);
+    if(saved_irq) return;
+
+    xTaskNotifyGive(sim_task_handle);
+}
+
+/**
+ * @brief Relatório dos modelos ao fim de uma execução com duração definida.
+ */
+static void finish(void){
+    sim_log("[sim] %.1f s simulated\n", time_us_64() / 1e6);
+    sim_i2c_report();
+    ads1115_model_report();
+    ds18b20_model_report();
+    ssd1306_model_report();
+    fpga_model_report();
+
+    fflush(stdout);
+    fflush(stderr);
+    _exit(0);
+}
+
+/**
+ * @brief Atualiza os modelos e entrega interrupções e alarmes vencidos.
+ * @note Eventos que vencem dentro de SIM_SPIN_US são aguardados em espera ativa
+ * (fendas do 1-Wire); os demais esperam o próximo tick ou uma notificação.
+ */
+static void service(void){
+    while(true){
+        uint64_t now_us = time_us_64();
+        world_update(now_us);
+        ads1115_model_update(now_us);
+        fpga_model_update(now_us);
+
+        run_due_alarms();
+        dispatch_irqs();
+
+        uint64_t next_us = next_alarm_us();
+        if(next_us == UINT64_MAX || next_us > time_us_64() + SIM_SPIN_US) return;
+        while(time_us_64() < next_us) tight_loop_contents();
+    }
+}
+
+/**
+ * @brief Função da task de interrupções do simulador.
+ * @note Tem a maior prioridade do sistema, sozinha, para que os "tratadores"
+ * nunca sejam interrompidos pelas tasks, como no hardware.
+ */
+static void task_sim_irq(void *params){
+    while(true){
+        ulTaskNotifyTake(pdTRUE, 1);
+        service();
+
+        if(end_us && time_us_64() >= end_us) finish();
+    }
+}
+
+/**
+ * @brief Inicia o simulador: relógio, modelos e a task de interrupções.
+ * @note Chamada por stdio_init_all(), a primeira chamada do main().
+ */
+void sim_init(void){
+    static bool initialized = false;
+    if(initialized) return;
+    initialized = true;
+
+    start_ns = monotonic_ns();
+    random_state = (uint32_t)sim_env_int("FILTERCORE_SIM_SEED", 1) | 1u;
+
+    int seconds = sim_env_int("FILTERCORE_SIM_SECONDS", 0);
+    end_us = seconds > 0 ? (uint64_t)seconds * 1000000u : 0;
+
+    world_init();
+    ads1115_model_init();
+    ds18b20_model_init();
+    ssd1306_model_init();
+    fpga_model_init();
+
+    sim_task_handle = xTaskCreateStatic(
+        task_sim_irq,
+        "Task Sim IRQ",
+        SIM_TASK_STACK_SIZE,
+        NULL,
+        configMAX_PRIORITIES - 1,
+        sim_task_stack,
+        &sim_task_buffer
+    );
+    if(sim_task_handle == NULL) abort();
+}
+
+// --- Utilidades ---
+
+int sim_env_int(const char *name, int fallback){
+    const char *value = getenv(name);
+    if(!value || !*value) return fallback;
+    return (int)strtol(value, NULL, 0);
+}
+
+uint32_t sim_random(void){
+    // xorshift32: reproducible for a given FILTERCORE_SIM_SEED
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return random_state;
+}
+
+/**
+ * @brief Ruído triangular em [-amplitude, amplitude].
+ */
+float sim_noise(float amplitude){
+    float a = (float)(sim_random() & 0xFFFF) / 65535.0f;
+    float b = (float)(sim_random() & 0xFFFF) / 65535.0f;
+    return (a + b - 1.0f) * amplitude;
+}
+
+void sim_log(const char *format, ...){
+    va_list args;
+    va_start(args, format);
+    uint32_t saved_irq = save_and_disable_interrupts();
+    vfprintf(stderr, format, args);
+    restore_interrupts(saved_irq);
+    va_end(args);
+}
+
+// --- stdio ---
+
+bool stdio_init_all(void){
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    sim_init();
+    return true;
+}
+
+bool stdio_usb_connected(void){
+    return true;
+}
+
+void stdio_put_string(const char *s, int len, bool newline, bool cr_translation){
+    (void)cr_translation;
+
+    uint32_t saved_irq = save_and_disable_interrupts();
+    fwrite(s, 1, (size_t)len, stdout);
+    if(newline) fputc('\n', stdout);
+    fflush(stdout);
+    restore_interrupts(saved_irq);
+}
+
+void stdio_flush(void){
+    uint32_t saved_irq = save_and_disable_interrupts();
+    fflush(stdout);
+    restore_interrupts(saved_irq);
+}
+
+/*
+ * printf, puts e putchar do firmware passam por aqui (-Wl,--wrap, como o pico_stdio
+ * faz no RP2040): uma task preemptada com o lock do stdout preso travaria a que
+ * escreve em seguida, já que a porta POSIX só acorda a thread escolhida pelo kernel.
+ */
+int __real_puts(const char *s);
+int __real_putchar(int c);
+
+int __wrap_printf(const char *format, ...){
+    va_list args;
+    va_start(args, format);
+    uint32_t saved_irq = save_and_disable_interrupts();
+    int written = vprintf(format, args);
+    restore_interrupts(saved_irq);
+    va_end(args);
+    return written;
+}
+
+int __wrap_puts(const char *s){
+    uint32_t saved_irq = save_and_disable_interrupts();
+    int result = __real_puts(s);
+    restore_interrupts(saved_irq);
+    return result;
+}
+
+int __wrap_putchar(int c){
+    uint32_t saved_irq = save_and_disable_interrupts();
+    int result = __real_putchar(c);
+    restore_interrupts(saved_irq);
+    return result;
+}
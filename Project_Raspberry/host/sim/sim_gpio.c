@@ -0,0 +1,252 @@
+#include "sim.h"
+#include "hardware/gpio.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+
+#define GPIO_EDGES (GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE)
+
+// Estado de um pino
+typedef struct {
+    bool output;                    // direction set by the firmware
+    bool out_level;                 // output latch
+    bool pull_up;
+    bool pull_down;
+    bool driven;                    // a device drives the line (push-pull)
+    bool driven_level;
+    bool line_level;                // last level seen for edge detection
+    uint32_t irq_enabled;           // enabled edges
+    volatile uint32_t events;       // latched edges
+    irq_handler_t handler;
+    sim_pin_listener_t listener;
+    sim_pin_sampler_t sampler;
+    sim_pin_reader_t reader;
+    bool listened_level;            // last level reported to the listener
+} sim_pin_t;
+
+static sim_pin_t pins[NUM_BANK0_GPIOS];
+
+/**
+ * @brief Nível da linha: o firmware (saída), um dispositivo ou os pull-ups.
+ * @note Sem pull nem dispositivo a linha flutua; lê-se 0.
+ */
+static bool line_level(const sim_pin_t *pin, uint gpio){
+    if(pin->output) return pin->out_level;
+    if(pin->sampler) return pin->sampler(gpio, time_us_64());
+    if(pin->driven) return pin->driven_level;
+    return pin->pull_up;
+}
+
+/**
+ * @brief Registra as bordas da linha e sinaliza IO_IRQ_BANK0 se alguma está habilitada.
+ */
+static void update_line(uint gpio){
+    sim_pin_t *pin = &pins[gpio];
+    bool level = line_level(pin, gpio);
+    if(level == pin->line_level) return;
+
+    uint32_t edge = level ? GPIO_IRQ_EDGE_RISE : GPIO_IRQ_EDGE_FALL;
+    pin->line_level = level;
+    pin->events |= edge;
+    if(pin->irq_enabled & edge) sim_irq_raise(IO_IRQ_BANK0);
+}
+
+/**
+ * @brief Avisa o observador do pino quando o nível imposto pelo firmware muda.
+ */
+static void notify_listener(uint gpio){
+    sim_pin_t *pin = &pins[gpio];
+    bool level = pin->output ? pin->out_level : true;
+    if(!pin->listener || level == pin->listened_level) return;
+
+    pin->listened_level = level;
+    pin->listener(gpio, level, time_us_64());
+}
+
+static void firmware_changed(uint gpio){
+    notify_listener(gpio);
+    update_line(gpio);
+}
+
+void gpio_init(uint gpio){
+    if(gpio >= NUM_BANK0_GPIOS) return;
+
+    uint32_t saved_irq = save_and_disable_interrupts();
+    pins[gpio].output = false;
+    pins[gpio].out_level = false;
+    firmware_changed(gpio);
+    restore_interrupts(saved_irq);
+}
+
+void gpio_init_mask(uint32_t gpio_mask){
+    for(uint gpio = 0; gpio < NUM_BANK0_GPIOS; gpio++){
+        if(gpio_mask & (1u << gpio)) gpio_init(gpio);
+    }
+}
+
+void gpio_set_function(uint gpio, gpio_function_t fn){
+    (void)gpio;
+    (void)fn; // I2C pins are not simulated at the wire level
+}
+
+void gpio_set_dir(uint gpio, bool out){
+    if(gpio >= NUM_BANK0_GPIOS) return;
+
+    uint32_t saved_irq = save_and_disable_interrupts();
+    pins[gpio].output = out;
+    firmware_changed(gpio);
+    restore_interrupts(saved_irq);
+}
+
+void gpio_set_dir_out_masked(uint32_t mask){
+    for(uint gpio = 0; gpio < NUM_BANK0_GPIOS; gpio++){
+        if(mask & (1u << gpio)) gpio_set_dir(gpio, GPIO_OUT);
+    }
+}
+
+void gpio_put(uint gpio, bool value){
+    if(gpio >= NUM_BANK0_GPIOS) return;
+
+    uint32_t saved_irq = save_and_disable_interrupts();
+    pins[gpio].out_level = value;
+    firmware_changed(gpio);
+    restore_interrupts(saved_irq);
+}
+
+void gpio_put_masked(uint32_t mask, uint32_t value){
+    for(uint gpio = 0; gpio < NUM_BANK0_GPIOS; gpio++){
+        if(mask & (1u << gpio)) gpio_put(gpio, (value >> gpio) & 1u);
+    }
+}
+
+bool gpio_get(uint gpio){
+    if(gpio >= NUM_BANK0_GPIOS) return false;
+
+    sim_pin_t *pin = &pins[gpio];
+    bool level = line_level(pin, gpio);
+    if(pin->reader && !pin->output) pin->reader(gpio, level, time_us_64());
+    return level;
+}
+
+void gpio_pull_up(uint gpio){
+    if(gpio >= NUM_BANK0_GPIOS) return;
+
+    uint32_t saved_irq = save_and_disable_interrupts();
+    pins[gpio].pull_up = true;
+    pins[gpio].pull_down = false;
+    update_line(gpio);
+    restore_interrupts(saved_irq);
+}
+
+void gpio_pull_down(uint gpio){
+    if(gpio >= NUM_BANK0_GPIOS) return;
+
+    uint32_t saved_irq = save_and_disable_interrupts();
+    pins[gpio].pull_up = false;
+    pins[gpio].pull_down = true;
+    update_line(gpio);
+    restore_interrupts(saved_irq);
+}
+
+void gpio_disable_pulls(uint gpio){
+    if(gpio >= NUM_BANK0_GPIOS) return;
+
+    uint32_t saved_irq = save_and_disable_interrupts();
+    pins[gpio].pull_up = false;
+    pins[gpio].pull_down = false;
+    update_line(gpio);
+    restore_interrupts(saved_irq);
+}
+
+void gpio_set_irq_enabled(uint gpio, uint32_t event_mask, bool enabled){
+    if(gpio >= NUM_BANK0_GPIOS) return;
+
+    uint32_t saved_irq = save_and_disable_interrupts();
+    // Stale edges are cleared when enabling, as the SDK does
+    pins[gpio].events &= ~(event_mask & GPIO_EDGES);
+    if(enabled) pins[gpio].irq_enabled |= event_mask & GPIO_EDGES;
+    else pins[gpio].irq_enabled &= ~event_mask;
+    restore_interrupts(saved_irq);
+}
+
+void gpio_add_raw_irq_handler(uint gpio, irq_handler_t handler){
+    if(gpio >= NUM_BANK0_GPIOS) return;
+    pins[gpio].handler = handler;
+}
+
+uint32_t gpio_get_irq_event_mask(uint gpio){
+    if(gpio >= NUM_BANK0_GPIOS) return 0;
+    return pins[gpio].events & pins[gpio].irq_enabled;
+}
+
+void gpio_acknowledge_irq(uint gpio, uint32_t event_mask){
+    if(gpio >= NUM_BANK0_GPIOS) return;
+    pins[gpio].events &= ~(event_mask & GPIO_EDGES);
+}
+
+/**
+ * @brief Tratador do banco de GPIO: chama o tratador de cada pino com bordas habilitadas.
+ */
+void sim_gpio_irq_dispatch(void){
+    for(uint gpio = 0; gpio < NUM_BANK0_GPIOS; gpio++){
+        sim_pin_t *pin = &pins[gpio];
+        if((pin->events & pin->irq_enabled) && pin->handler) pin->handler();
+    }
+}
+
+/**
+ * @brief Registra o observador das mudanças impostas pelo firmware a um pino.
+ */
+void sim_gpio_listen(uint gpio, sim_pin_listener_t listener){
+    if(gpio >= NUM_BANK0_GPIOS) return;
+    pins[gpio].listener = listener;
+    pins[gpio].listened_level = true;
+}
+
+/**
+ * @brief Registra o amostrador do nível de uma linha compartilhada (dreno aberto).
+ */
+void sim_gpio_sample_with(uint gpio, sim_pin_sampler_t sampler){
+    if(gpio >= NUM_BANK0_GPIOS) return;
+    pins[gpio].sampler = sampler;
+}
+
+/**
+ * @brief Registra o observador das leituras do firmware num pino de entrada.
+ */
+void sim_gpio_observe_reads(uint gpio, sim_pin_reader_t reader){
+    if(gpio >= NUM_BANK0_GPIOS) return;
+    pins[gpio].reader = reader;
+}
+
+/**
+ * @brief Um dispositivo passa a acionar a linha com o nível dado.
+ */
+void sim_gpio_drive(uint gpio, bool level){
+    if(gpio >= NUM_BANK0_GPIOS) return;
+
+    uint32_t saved_irq = save_and_disable_interrupts();
+    pins[gpio].driven = true;
+    pins[gpio].driven_level = level;
+    update_line(gpio);
+    restore_interrupts(saved_irq);
+}
+
+/**
+ * @brief O dispositivo deixa de acionar a linha (fica com os pulls do pino).
+ */
+void sim_gpio_release(uint gpio){
+    if(gpio >= NUM_BANK0_GPIOS) return;
+
+    uint32_t saved_irq = save_and_disable_interrupts();
+    pins[gpio].driven = false;
+    update_line(gpio);
+    restore_interrupts(saved_irq);
+}
+
+/**
+ * @brief Nível que o firmware escreve no pino (latch de saída).
+ */
+bool sim_gpio_output_level(uint gpio){
+    if(gpio >= NUM_BANK0_GPIOS) return false;
+    return pins[gpio].out_level;
+}
@@ -0,0 +1,356 @@
+#include "sim.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define SIM_MAX_I2C_DEVICES 8
+#define SIM_I2C_SEGMENT_SIZE 2048       // bytes between two (RE)STARTs
+#define SIM_I2C_DREQ_BASE 32            // DREQ_I2C0_TX on the RP2040
+#define SIM_I2C_FIFO_DEPTH 16           // words still in the TX FIFO when the DMA finishes
+
+// Canal de DMA
+typedef struct {
+    bool claimed;
+    bool busy;
+    bool irq1_enabled;
+    bool irq1_status;
+    dma_channel_config config;
+    volatile void *write_addr;
+    const volatile void *read_addr;
+    uint transfer_count;
+
+    // Transfer into an I2C controller: the DMA ends when the last word enters the
+    // FIFO, the controller when the final STOP leaves the wire
+    i2c_inst_t *i2c;
+    int rx_channel;
+    bool nack;
+    alarm_id_t completion;
+    alarm_id_t stop;
+} sim_dma_channel_t;
+
+// Contadores de um barramento
+typedef struct {
+    uint32_t transactions;
+    uint32_t nacks;
+    uint32_t bytes;
+    uint64_t wire_us;
+} sim_i2c_stats_t;
+
+i2c_inst_t i2c0_inst = { .index = 0 };
+i2c_inst_t i2c1_inst = { .index = 1 };
+
+static const sim_i2c_device_t *devices[SIM_MAX_I2C_DEVICES];
+static uint8_t device_count;
+
+static sim_i2c_stats_t stats[2];
+
+static sim_dma_channel_t channels[NUM_DMA_CHANNELS];
+
+/**
+ * @brief Conecta um dispositivo virtual a um barramento.
+ * @note Os callbacks rodam com as interrupções desabilitadas.
+ */
+void sim_i2c_attach(const sim_i2c_device_t *device){
+    if(device_count < SIM_MAX_I2C_DEVICES) devices[device_count++] = device;
+}
+
+static const sim_i2c_device_t *find_device(uint bus, uint8_t address){
+    for(uint8_t i = 0; i < device_count; i++){
+        if(devices[i]->bus == bus && devices[i]->address == address) return devices[i];
+    }
+    return NULL;
+}
+
+/**
+ * @brief Tempo de fio de um segmento: endereço e dados, 9 bits cada, mais START e STOP.
+ */
+static uint64_t wire_time_us(const i2c_inst_t *i2c, size_t bytes){
+    uint baudrate = i2c->baudrate ? i2c->baudrate : 100000;
+    return ((uint64_t)(bytes + 1) * 9 + 2) * 1000000u / baudrate;
+}
+
+/**
+ * @brief Entrega um segmento (do START ao RESTART/STOP) ao dispositivo endereçado.
+ * @return false se ninguém reconheceu o endereço (NACK).
+ */
+static bool transfer_segment(i2c_inst_t *i2c, uint8_t address, bool read, uint8_t *data, size_t len){
+    const sim_i2c_device_t *device = find_device(i2c->index, address);
+
+    uint32_t saved_irq = save_and_disable_interrupts();
+    if(device){
+        if(read && device->read) device->read(device->context, data, len);
+        else if(read) memset(data, 0xFF, len);
+        else if(device->write) device->write(device->context, data, len);
+        stats[i2c->index].bytes += len;
+    }
+    else stats[i2c->index].nacks++;
+    stats[i2c->index].wire_us += wire_time_us(i2c, device ? len : 0);
+    restore_interrupts(saved_irq);
+
+    return device != NULL;
+}
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate){
+    i2c->baudrate = baudrate;
+    i2c->hw.enable = I2C_IC_ENABLE_ENABLE_BITS;
+    i2c->hw.status = I2C_IC_STATUS_TFE_BITS;
+    return baudrate;
+}
+
+uint i2c_get_dreq(i2c_inst_t *i2c, bool is_tx){
+    return SIM_I2C_DREQ_BASE + 2 * i2c->index + (is_tx ? 0 : 1);
+}
+
+/**
+ * @brief Escrita bloqueante: o chamador espera (ocupado) o tempo de fio, como no RP2040.
+ */
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop){
+    uint8_t segment[SIM_I2C_SEGMENT_SIZE];
+    if(len > sizeof(segment)) return PICO_ERROR_GENERIC;
+    memcpy(segment, src, len);
+
+    bool acknowledged = transfer_segment(i2c, addr, false, segment, len);
+    if(!nostop) stats[i2c->index].transactions++;
+    busy_wait_us(wire_time_us(i2c, acknowledged ? len : 0));
+
+    return acknowledged ? (int)len : PICO_ERROR_GENERIC;
+}
+
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop){
+    bool acknowledged = transfer_segment(i2c, addr, true, dst, len);
+    if(!nostop) stats[i2c->index].transactions++;
+    busy_wait_us(wire_time_us(i2c, acknowledged ? len : 0));
+
+    return acknowledged ? (int)len : PICO_ERROR_GENERIC;
+}
+
+// --- DMA ---
+
+int dma_claim_unused_channel(bool required){
+    for(uint channel = 0; channel < NUM_DMA_CHANNELS; channel++){
+        if(channels[channel].claimed) continue;
+        channels[channel].claimed = true;
+        return (int)channel;
+    }
+
+    if(required) abort();
+    return -1;
+}
+
+void dma_channel_unclaim(uint channel){
+    if(channel < NUM_DMA_CHANNELS) channels[channel].claimed = false;
+}
+
+dma_channel_config dma_channel_get_default_config(uint channel){
+    (void)channel;
+    return (dma_channel_config){ .size = DMA_SIZE_32, .read_increment = true, .write_increment = false, .dreq = 0x3f };
+}
+
+void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size){
+    c->size = size;
+}
+
+void channel_config_set_read_increment(dma_channel_config *c, bool incr){
+    c->read_increment = incr;
+}
+
+void channel_config_set_write_increment(dma_channel_config *c, bool incr){
+    c->write_increment = incr;
+}
+
+void channel_config_set_dreq(dma_channel_config *c, uint dreq){
+    c->dreq = dreq;
+}
+
+static i2c_inst_t *i2c_of_data_cmd(const volatile void *address){
+    if(address == &i2c0_inst.hw.data_cmd) return &i2c0_inst;
+    if(address == &i2c1_inst.hw.data_cmd) return &i2c1_inst;
+    return NULL;
+}
+
+/**
+ * @brief Fim do DMA de transmissão: a última palavra entrou no FIFO; sinaliza a IRQ1 do canal.
+ */
+static int64_t dma_complete(alarm_id_t id, void *user_data){
+    (void)id;
+    sim_dma_channel_t *tx = (sim_dma_channel_t *)user_data;
+
+    tx->completion = 0;
+    tx->busy = false;
+
+    if(tx->irq1_enabled){
+        tx->irq1_status = true;
+        sim_irq_raise(DMA_IRQ_1);
+    }
+    return 0;
+}
+
+/**
+ * @brief Fim da transação: o FIFO esvaziou e o STOP saiu (ou o NACK a abortou).
+ * @note Sinaliza STOP_DET (e TX_ABRT) e, se desmascarada, a interrupção do controlador.
+ */
+static int64_t i2c_stop(alarm_id_t id, void *user_data){
+    (void)id;
+    sim_dma_channel_t *tx = (sim_dma_channel_t *)user_data;
+    i2c_hw_t *hw = &tx->i2c->hw;
+
+    tx->stop = 0;
+    if(tx->rx_channel >= 0) channels[tx->rx_channel].busy = false;
+
+    hw->status = I2C_IC_STATUS_TFE_BITS;
+    hw->raw_intr_stat |= I2C_IC_RAW_INTR_STAT_STOP_DET_BITS;
+    if(tx->nack) hw->raw_intr_stat |= I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS;
+
+    if(hw->raw_intr_stat & hw->intr_mask) sim_irq_raise(tx->i2c->index ? I2C1_IRQ : I2C0_IRQ);
+    return 0;
+}
+
+// Transação em execução por DMA
+typedef struct {
+    i2c_inst_t *i2c;
+    uint8_t segment[SIM_I2C_SEGMENT_SIZE];
+    size_t length;
+    bool reading;
+    uint8_t *rx;
+    size_t rx_left;
+    uint64_t wire_us;
+} dma_transfer_t;
+
+/**
+ * @brief Entrega o segmento acumulado; os bytes lidos seguem para o buffer do canal de recepção.
+ * @return false em NACK.
+ */
+static bool flush_segment(dma_transfer_t *transfer){
+    if(!transfer->length) return true;
+
+    size_t length = transfer->length;
+    transfer->length = 0;
+    transfer->wire_us += wire_time_us(transfer->i2c, length);
+    if(!transfer_segment(transfer->i2c, (uint8_t)transfer->i2c->hw.tar, transfer->reading, transfer->segment, length)) return false;
+
+    if(transfer->reading && transfer->rx){
+        size_t copied = length < transfer->rx_left ? length : transfer->rx_left;
+        memcpy(transfer->rx, transfer->segment, copied);
+        transfer->rx += copied;
+        transfer->rx_left -= copied;
+    }
+    return true;
+}
+
+/**
+ * @brief Executa as palavras de IC_DATA_CMD que um canal de DMA alimenta.
+ * @note Os segmentos são separados por RESTART, troca de direção e STOP. Os bytes
+ * lidos vão para o canal de recepção (o que lê IC_DATA_CMD); no primeiro NACK o
+ * restante da transação é descartado, como após TX_ABRT. O DMA termina quando
+ * as últimas palavras (até SIM_I2C_FIFO_DEPTH) ainda estão no FIFO; o STOP sai
+ * depois do tempo de fio da transação inteira.
+ */
+static void start_i2c_transfer(sim_dma_channel_t *tx, i2c_inst_t *i2c){
+    dma_transfer_t transfer;
+    i2c_hw_t *hw = &i2c->hw;
+
+    tx->i2c = i2c;
+    tx->nack = false;
+    tx->rx_channel = -1;
+    for(uint channel = 0; channel < NUM_DMA_CHANNELS; channel++){
+        if(channels[channel].busy && channels[channel].read_addr == &hw->data_cmd) tx->rx_channel = (int)channel;
+    }
+
+    hw->raw_intr_stat = 0;
+    hw->status = I2C_IC_STATUS_MST_ACTIVITY_BITS;
+
+    transfer = (dma_transfer_t){ .i2c = i2c };
+    if(tx->rx_channel >= 0){
+        transfer.rx = (uint8_t *)channels[tx->rx_channel].write_addr;
+        transfer.rx_left = channels[tx->rx_channel].transfer_count;
+    }
+
+    for(uint i = 0; i < tx->transfer_count && !tx->nack; i++){
+        uint index = tx->config.read_increment ? i : 0;
+        uint32_t word;
+        if(tx->config.size == DMA_SIZE_8) word = ((const volatile uint8_t *)tx->read_addr)[index];
+        else if(tx->config.size == DMA_SIZE_16) word = ((const volatile uint16_t *)tx->read_addr)[index];
+        else word = ((const volatile uint32_t *)tx->read_addr)[index];
+
+        bool read = word & I2C_IC_DATA_CMD_CMD_BITS;
+        if((word & I2C_IC_DATA_CMD_RESTART_BITS) || read != transfer.reading){
+            tx->nack = !flush_segment(&transfer);
+            if(tx->nack) break;
+        }
+
+        transfer.reading = read;
+        if(transfer.length < sizeof(transfer.segment)) transfer.segment[transfer.length++] = (uint8_t)word;
+
+        if(word & I2C_IC_DATA_CMD_STOP_BITS){
+            tx->nack = !flush_segment(&transfer);
+            stats[i2c->index].transactions++;
+        }
+    }
+
+    uint words = tx->transfer_count < SIM_I2C_FIFO_DEPTH ? tx->transfer_count : SIM_I2C_FIFO_DEPTH;
+    uint64_t fifo_us = wire_time_us(i2c, words) - wire_time_us(i2c, 0);
+    uint64_t dma_us = transfer.wire_us > fifo_us ? transfer.wire_us - fifo_us : 1;
+
+    tx->completion = add_alarm_in_us(dma_us, dma_complete, tx, true);
+    tx->stop = add_alarm_in_us(transfer.wire_us, i2c_stop, tx, true);
+}
+
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint transfer_count, bool trigger){
+    if(channel >= NUM_DMA_CHANNELS) return;
+    sim_dma_channel_t *dma = &channels[channel];
+
+    dma->config = *config;
+    dma->write_addr = write_addr;
+    dma->read_addr = read_addr;
+    dma->transfer_count = transfer_count;
+    if(!trigger) return;
+
+    dma->busy = true;
+    i2c_inst_t *i2c = i2c_of_data_cmd(write_addr);
+    if(i2c) start_i2c_transfer(dma, i2c);
+}
+
+void dma_channel_abort(uint channel){
+    if(channel >= NUM_DMA_CHANNELS) return;
+    sim_dma_channel_t *dma = &channels[channel];
+
+    if(dma->completion > 0) cancel_alarm(dma->completion);
+    if(dma->stop > 0) cancel_alarm(dma->stop);
+    dma->completion = 0;
+    dma->stop = 0;
+    dma->busy = false;
+    if(dma->i2c) dma->i2c->hw.status = I2C_IC_STATUS_TFE_BITS;
+}
+
+bool dma_channel_is_busy(uint channel){
+    return channel < NUM_DMA_CHANNELS && channels[channel].busy;
+}
+
+void dma_channel_set_irq1_enabled(uint channel, bool enabled){
+    if(channel < NUM_DMA_CHANNELS) channels[channel].irq1_enabled = enabled;
+}
+
+bool dma_channel_get_irq1_status(uint channel){
+    return channel < NUM_DMA_CHANNELS && channels[channel].irq1_status;
+}
+
+void dma_channel_acknowledge_irq1(uint channel){
+    if(channel < NUM_DMA_CHANNELS) channels[channel].irq1_status = false;
+}
+
+/**
+ * @brief Resumo dos barramentos: transações, NACKs, bytes e ocupação do fio.
+ */
+void sim_i2c_report(void){
+    uint64_t elapsed_us = time_us_64();
+
+    for(uint bus = 0; bus < 2; bus++){
+        sim_log("[sim] i2c%u: %lu transactions, %lu NACK, %lu bytes, wire busy %.1f%%\n", bus,
+                (unsigned long)stats[bus].transactions, (unsigned long)stats[bus].nacks,
+                (unsigned long)stats[bus].bytes,
+                elapsed_us ? 100.0 * (double)stats[bus].wire_us / (double)elapsed_us : 0.0);
+    }
+}
@@ -0,0 +1,170 @@
+#include "sim.h"
+#include <string.h>
+
+#define SSD1306_MODEL_ADDRESS 0x3C
+#define SSD1306_COLUMNS 128
+#define SSD1306_PAGES 8
+
+// Byte de controle: Co (só um byte a seguir) e D/C# (dados)
+#define CONTROL_CONTINUATION 0x80
+#define CONTROL_DATA 0x40
+
+// Estado do controlador
+static struct {
+    uint8_t gddram[SSD1306_PAGES][SSD1306_COLUMNS];
+    uint8_t command;                // command waiting for arguments
+    uint8_t arguments[2];
+    uint8_t argument_count;
+    uint8_t arguments_left;
+    uint8_t addressing_mode;        // 0 horizontal, 1 vertical, 2 page
+    uint8_t column_start, column_end, column;
+    uint8_t page_start, page_end, page;
+    bool display_on;
+    uint8_t contrast;
+    uint32_t commands;
+    uint32_t frames;                // data writes (each render sends one)
+    uint32_t data_bytes;
+} oled;
+
+/**
+ * @brief Quantidade de argumentos dos comandos de múltiplos bytes.
+ */
+static uint8_t argument_count(uint8_t command){
+    switch(command){
+        case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+        case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+            return 1;
+        case 0x21: case 0x22:
+            return 2;
+        default:
+            return 0;
+    }
+}
+
+static void execute(uint8_t command, const uint8_t *arguments){
+    oled.commands++;
+
+    switch(command){
+        case 0x20: oled.addressing_mode = arguments[0] & 0x3; break;
+        case 0x21:
+            oled.column_start = oled.column = arguments[0] & 0x7F;
+            oled.column_end = arguments[1] & 0x7F;
+            break;
+        case 0x22:
+            oled.page_start = oled.page = arguments[0] & 0x7;
+            oled.page_end = arguments[1] & 0x7;
+            break;
+        case 0x81: oled.contrast = arguments[0]; break;
+        case 0xAE: oled.display_on = false; break;
+        case 0xAF: oled.display_on = true; break;
+        default:
+            if(command >= 0xB0 && command <= 0xB7) oled.page = command & 0x7; // page mode start page
+            break;
+    }
+}
+
+static void command_byte(uint8_t value){
+    if(oled.arguments_left){
+        oled.arguments[oled.argument_count++] = value;
+        if(--oled.arguments_left == 0) execute(oled.command, oled.arguments);
+        return;
+    }
+
+    oled.command = value;
+    oled.argument_count = 0;
+    oled.arguments_left = argument_count(value);
+    if(!oled.arguments_left) execute(value, NULL);
+}
+
+/**
+ * @brief Escreve um byte na GDDRAM e avança o cursor conforme o modo de endereçamento.
+ */
+static void data_byte(uint8_t value){
+    oled.gddram[oled.page][oled.column] = value;
+    oled.data_bytes++;
+
+    if(oled.addressing_mode == 2){
+        if(oled.column < SSD1306_COLUMNS - 1) oled.column++;
+        return;
+    }
+
+    if(oled.column < oled.column_end){
+        oled.column++;
+        return;
+    }
+    oled.column = oled.column_start;
+    oled.page = oled.page < oled.page_end ? oled.page + 1 : oled.page_start;
+}
+
+/**
+ * @brief Uma escrita I2C: sequência de [controle, byte(s)].
+ * @note Com Co = 1 segue um único byte e outro controle; com Co = 0 o resto da
+ * transação é do tipo indicado por D/C#.
+ */
+static void ssd1306_write(void *context, const uint8_t *data, size_t len){
+    (void)context;
+
+    bool frame = false;
+    size_t i = 0;
+
+    while(i < len){
+        uint8_t control = data[i++];
+        bool is_data = control & CONTROL_DATA;
+        size_t end = (control & CONTROL_CONTINUATION) ? (i < len ? i + 1 : i) : len;
+
+        for(; i < end; i++){
+            if(is_data){
+                data_byte(data[i]);
+                frame = true;
+            }
+            else command_byte(data[i]);
+        }
+    }
+
+    if(frame) oled.frames++;
+}
+
+static const sim_i2c_device_t ssd1306_device = {
+    .bus = SIM_I2C_DISPLAY,
+    .address = SSD1306_MODEL_ADDRESS,
+    .write = ssd1306_write,
+    .read = NULL
+};
+
+void ssd1306_model_init(void){
+    oled.column_end = SSD1306_COLUMNS - 1;
+    oled.page_end = SSD1306_PAGES - 1;
+    oled.addressing_mode = 2;
+    sim_i2c_attach(&ssd1306_device);
+}
+
+/**
+ * @brief Desenha a GDDRAM no stderr com meios-blocos (duas linhas de pixels por linha).
+ * @note A orientação é a da memória; o remapeamento de segmentos/COM do firmware
+ * (0xA1, 0xC8) só gira a imagem no vidro.
+ */
+static void dump(void){
+    for(uint8_t row = 0; row < SSD1306_PAGES * 8; row += 2){
+        char line[SSD1306_COLUMNS * 3 + 2];
+        size_t length = 0;
+
+        for(uint8_t column = 0; column < SSD1306_COLUMNS; column++){
+            bool top = (oled.gddram[row / 8][column] >> (row % 8)) & 1;
+            bool bottom = (oled.gddram[(row + 1) / 8][column] >> ((row + 1) % 8)) & 1;
+            const char *glyph = top ? (bottom ? "█" : "▀") : (bottom ? "▄" : " ");
+            size_t glyph_length = strlen(glyph);
+            memcpy(&line[length], glyph, glyph_length);
+            length += glyph_length;
+        }
+        line[length] = '\0';
+        sim_log("|%s|\n", line);
+    }
+}
+
+void ssd1306_model_report(void){
+    sim_log("[sim] SSD1306 0x%02X: display %s, %lu commands, %lu frames, %lu data bytes\n", SSD1306_MODEL_ADDRESS,
+            oled.display_on ? "on" : "off", (unsigned long)oled.commands, (unsigned long)oled.frames,
+            (unsigned long)oled.data_bytes);
+
+    if(sim_env_int("FILTERCORE_SIM_OLED", 0)) dump();
+}
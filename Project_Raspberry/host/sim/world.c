@@ -0,0 +1,97 @@
+#include "sim.h"
+#include <math.h>
+
+#define WORLD_PI 3.14159265f
+#define WORLD_BOUNCE_MS 3               // contact bounce after each press and release
+
+// Pressionamentos periódicos de um botão
+typedef struct {
+    uint pin;
+    uint32_t first_ms;
+    uint32_t period_ms;
+    uint32_t hold_ms;
+} button_script_t;
+
+/**
+ * @brief Roteiro dos botões: B pagina o display, A pede o início manual.
+ */
+static const button_script_t scripts[] = {
+    { SIM_BUTTON_B_PIN, 3000, 7000, 120 },
+    { SIM_BUTTON_A_PIN, 20000, 45000, 3000 },
+};
+
+/**
+ * @brief Indica se o roteiro aciona os botões; um teste pode desligá-lo e acionar os pinos.
+ */
+static bool buttons_scripted = true;
+
+/**
+ * @brief Onda senoidal em torno de 'center', com período em segundos.
+ */
+static float wave(uint64_t now_us, float center, float amplitude, float period_s, float phase){
+    float t = (float)now_us / 1e6f;
+    return center + amplitude * sinf(2.0f * WORLD_PI * t / period_s + phase);
+}
+
+/**
+ * @brief Temperatura da água (ºC): cruza os limites de 24 e 30 ºC.
+ */
+float world_temperature(uint64_t now_us){
+    return wave(now_us, 27.0f, 3.5f, 90.0f, 0.0f);
+}
+
+/**
+ * @brief pH da água: cruza os limites de 6 e 8.
+ */
+float world_ph(uint64_t now_us){
+    return wave(now_us, 7.0f, 1.3f, 70.0f, 1.0f);
+}
+
+/**
+ * @brief TDS da água (ppm): atravessa o máximo que o analisador deriva da temperatura e do pH.
+ */
+float world_tds(uint64_t now_us){
+    return wave(now_us, 450.0f, 300.0f, 110.0f, 2.0f);
+}
+
+/**
+ * @brief Estado de um botão (ativo em nível baixo), com repique nas transições.
+ */
+static bool button_level(const button_script_t *script, uint32_t now_ms){
+    if(now_ms < script->first_ms) return true;
+
+    uint32_t phase = (now_ms - script->first_ms) % script->period_ms;
+    if(phase < WORLD_BOUNCE_MS) return phase % 2;
+    if(phase < script->hold_ms) return false;
+    if(phase < script->hold_ms + WORLD_BOUNCE_MS) return (phase - script->hold_ms) % 2 == 0;
+    return true;
+}
+
+void world_init(void){
+    for(size_t i = 0; i < sizeof(scripts) / sizeof(scripts[0]); i++) sim_gpio_drive(scripts[i].pin, true);
+    sim_gpio_drive(SIM_BUTTON_SW_PIN, true);
+}
+
+/**
+ * @brief Liga ou desliga o roteiro dos botões; desligado, os botões ficam soltos
+ * até que o chamador acione os pinos (sim_gpio_drive).
+ */
+void world_script_buttons(bool enabled){
+    buttons_scripted = enabled;
+    if(enabled) return;
+
+    for(size_t i = 0; i < sizeof(scripts) / sizeof(scripts[0]); i++) sim_gpio_drive(scripts[i].pin, true);
+}
+
+/**
+ * @brief Aciona os botões conforme o roteiro (resolução de um tick).
+ */
+void world_update(uint64_t now_us){
+    if(!buttons_scripted) return;
+
+    uint32_t now_ms = (uint32_t)(now_us / 1000u);
+
+    for(size_t i = 0; i < sizeof(scripts) / sizeof(scripts[0]); i++){
+        sim_gpio_drive(scripts[i].pin, button_level(&scripts[i], now_ms));
+    }
+}
@@ -0,0 +1,90 @@
+#include "host_test.h"
+#include "sim.h"
+#include "events.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define HOST_TEST_STACK_SIZE (configMINIMAL_STACK_SIZE * 4)
+
+// Latest-value mailboxes, defined by main.c in the firmware
+mailbox_t mailbox_sensors_data;
+mailbox_t mailbox_normalized_sensors_data;
+
+static sensors_data_t sensors_data_buffers[2];
+static normalized_sensors_data_t normalized_sensors_data_buffers[2];
+
+static StaticTask_t test_task_buffer;
+static StackType_t test_task_stack[HOST_TEST_STACK_SIZE];
+
+static const char *test_name;
+static void (*test_scenario)(void);
+static uint32_t checks = 0;
+static uint32_t failures = 0;
+
+void host_test_check(bool condition, const char *file, int line, const char *format, ...){
+    checks++;
+    if(condition) return;
+    failures++;
+
+    va_list args;
+    va_start(args, format);
+    char message[256];
+    vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+
+    sim_log("[%s] FAIL %s:%d: %s\n", test_name, file, line, message);
+}
+
+void host_test_log(const char *format, ...){
+    va_list args;
+    va_start(args, format);
+    char message[256];
+    vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+
+    sim_log("[%s] %s", test_name, message);
+}
+
+/**
+ * @brief Task do cenário: executa-o e encerra o processo com o resultado.
+ */
+static void task_test(void *params){
+    (void)params;
+
+    test_scenario();
+
+    sim_log("[%s] %lu checks, %lu failed\n", test_name, (unsigned long)checks, (unsigned long)failures);
+    fflush(stdout);
+    exit(failures ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+
+/**
+ * @brief Prepara o simulador e as mailboxes do firmware e roda o cenário.
+ * * @param name Nome do teste (prefixo das mensagens).
+ * @param scenario Função do cenário, executada numa task de HOST_TEST_PRIORITY.
+ */
+void host_test_main(const char *name, void (*scenario)(void)){
+    test_name = name;
+    test_scenario = scenario;
+
+    stdio_init_all();
+
+    mailbox_init(&mailbox_sensors_data, &sensors_data_buffers[0], &sensors_data_buffers[1], sizeof(sensors_data_t));
+    mailbox_init(&mailbox_normalized_sensors_data, &normalized_sensors_data_buffers[0],
+                 &normalized_sensors_data_buffers[1], sizeof(normalized_sensors_data_t));
+
+    TaskHandle_t handle = xTaskCreateStatic(
+        task_test,
+        "Task Test",
+        HOST_TEST_STACK_SIZE,
+        NULL,
+        HOST_TEST_PRIORITY,
+        test_task_stack,
+        &test_task_buffer
+    );
+    if(handle == NULL) abort();
+
+    vTaskStartScheduler();
+    abort();
+}
@@ -0,0 +1,33 @@
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+/**
+ * @file host_test.h
+ * @brief Apoio aos testes do build de host.
+ * @note Cada teste é um executável com o firmware (filtercore_firmware) e o
+ * simulador: o cenário roda numa task do FreeRTOS, como o código que ele testa,
+ * e o processo termina com o resultado das verificações (código 0 se todas
+ * passaram). As mensagens vão para o stderr; o stdout fica com o console do
+ * firmware.
+ */
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define HOST_TEST_PRIORITY (tskIDLE_PRIORITY + 2)
+
+/**
+ * @brief Verifica uma condição; em caso de falha, registra a mensagem e segue o cenário.
+ */
+#define TEST_CHECK(condition, ...) host_test_check((condition), __FILE__, __LINE__, __VA_ARGS__)
+
+void host_test_check(bool condition, const char *file, int line, const char *format, ...)
+    __attribute__((format(printf, 4, 5)));
+
+void host_test_log(const char *format, ...) __attribute__((format(printf, 1, 2)));
+
+void host_test_main(const char *name, void (*scenario)(void)) __attribute__((noreturn));
+
+#endif //HOST_TEST_H
@@ -0,0 +1,106 @@
+# Capture and replay (cmake -P): records the live pipeline on the simulator, replays
+# the capture through the same processing chain and compares the final alerts.
+if(NOT SECONDS)
+    set(SECONDS 10)
+endif()
+file(MAKE_DIRECTORY ${WORK_DIR})
+set(console ${WORK_DIR}/console.bin)
+set(capture ${WORK_DIR}/capture.txt)
+
+execute_process(COMMAND ${REPLAY} record ${SECONDS}
+    OUTPUT_FILE ${console}
+    ERROR_QUIET
+    RESULT_VARIABLE result
+    TIMEOUT 30
+)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "filtercore_replay record exited with '${result}'")
+endif()
+
+# The capture leaves in text frames, as on the device
+execute_process(COMMAND ${LOG_DECODE}
+    INPUT_FILE ${console}
+    OUTPUT_FILE ${capture}
+    RESULT_VARIABLE result
+)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "log_decode exited with '${result}'")
+endif()
+
+file(READ ${capture} recorded)
+if(NOT recorded MATCHES "CAPTURE BEGIN 1 ([1-9][0-9]*)")
+    message(FATAL_ERROR "no capture recorded")
+endif()
+set(records ${CMAKE_MATCH_1})
+if(NOT recorded MATCHES "LIVE ALERTS [0-9]+ ([01] [01] [01])")
+    message(FATAL_ERROR "no live alerts recorded")
+endif()
+set(live ${CMAKE_MATCH_1})
+
+execute_process(COMMAND ${REPLAY} ${capture}
+    OUTPUT_VARIABLE replayed
+    ERROR_QUIET
+    RESULT_VARIABLE result
+    TIMEOUT 30
+)
+message("${replayed}")
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "filtercore_replay exited with '${result}'")
+endif()
+
+# Every record went through, in cycles of the sampling profile's period
+if(NOT replayed MATCHES "REPLAY records ${records} cycles [1-9][0-9]* ")
+    message(FATAL_ERROR "the replay did not process the ${records} records")
+endif()
+
+# The alerts at the end of the capture are the ones the firmware published
+set(final "0 0 0")
+string(REGEX MATCHALL "(^|\n)ALERTS [0-9]+ [01] [01] [01]" changes "${replayed}")
+if(changes)
+    list(GET changes -1 last)
+    string(REGEX REPLACE ".*ALERTS [0-9]+ " "" final "${last}")
+endif()
+if(NOT final STREQUAL live)
+    message(FATAL_ERROR "replay ends with alerts '${final}', the firmware published '${live}'")
+endif()
+
+# The filter comparison on the same capture: each filter on the pH and TDS samples
+execute_process(COMMAND ${REPLAY} filters ${capture}
+    OUTPUT_VARIABLE compared
+    ERROR_QUIET
+    RESULT_VARIABLE result
+    TIMEOUT 30
+)
+message("${compared}")
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "filtercore_replay filters exited with '${result}'")
+endif()
+foreach(channel pH TDS)
+    foreach(filter estimator median trimmed_mean)
+        if(NOT compared MATCHES "FILTER ${channel} ${filter} samples [1-9][0-9]* rms_error ")
+            message(FATAL_ERROR "no ${filter} comparison on the ${channel} samples")
+        endif()
+    endforeach()
+endforeach()
+
+# The sampling evaluation runs on the same capture; the fastest profile, with every
+# recorded conversion, detects each reference onset at once
+execute_process(COMMAND ${REPLAY} evaluate ${capture}
+    OUTPUT_VARIABLE evaluated
+    ERROR_QUIET
+    RESULT_VARIABLE result
+    TIMEOUT 30
+)
+message("${evaluated}")
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "filtercore_replay evaluate exited with '${result}'")
+endif()
+foreach(policy adaptive fastest middle slowest)
+    if(NOT evaluated MATCHES "EVALUATE ${policy} adc_reads_per_s [0-9.]+ cycles_per_s [0-9.]+ detected [0-9]+/[0-9]+ ")
+        message(FATAL_ERROR "no evaluation of the ${policy} policy")
+    endif()
+endforeach()
+if(NOT evaluated MATCHES "EVALUATE fastest [^\n]* detected ([0-9]+)/([0-9]+) latency_mean_ms 0 "
+   OR NOT CMAKE_MATCH_1 EQUAL CMAKE_MATCH_2)
+    message(FATAL_ERROR "the fastest profile misses reference onsets")
+endif()
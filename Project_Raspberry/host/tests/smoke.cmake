@@ -0,0 +1,77 @@
+# Smoke run of filtercore_host (cmake -P): runs the firmware for a few simulated
+# seconds and checks the device models' report and the decoded console.
+# With ACK_MISS, the FPGA model drops that share of requests and the handshake
+# must recover them with retries.
+if(NOT SECONDS)
+    set(SECONDS 5)
+endif()
+set(ENV{FILTERCORE_SIM_SECONDS} ${SECONDS})
+if(ACK_MISS)
+    set(ENV{FILTERCORE_SIM_ACK_MISS} ${ACK_MISS})
+endif()
+file(MAKE_DIRECTORY ${WORK_DIR})
+set(console ${WORK_DIR}/console.bin)
+
+execute_process(COMMAND ${HOST}
+    OUTPUT_FILE ${console}
+    ERROR_VARIABLE report
+    RESULT_VARIABLE result
+    TIMEOUT 30
+)
+message("${report}")
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "filtercore_host exited with '${result}'")
+endif()
+
+# Every device was exercised
+foreach(expected
+        "i2c0: [1-9][0-9]* transactions"
+        "i2c1: [1-9][0-9]* transactions"
+        "ADS1115 0x48: [1-9][0-9]* conversions"
+        "probe 0: [1-9][0-9]* conversions"
+        "SSD1306 0x3C: display on, [0-9]+ commands, [1-9][0-9]* frames"
+        "FPGA: [1-9][0-9]* requests, [1-9][0-9]* ACKs")
+    if(NOT report MATCHES "${expected}")
+        message(FATAL_ERROR "device report lacks '${expected}'")
+    endif()
+endforeach()
+
+# The deferred log decodes: boot record and every task started, nothing failed
+execute_process(COMMAND ${LOG_DECODE}
+    INPUT_FILE ${console}
+    OUTPUT_VARIABLE log
+    RESULT_VARIABLE result
+)
+foreach(expected "\\[Log\\] boot" "Display Printing" "Sensors Reading" "Handshake" "Diagnostics")
+    if(NOT log MATCHES "${expected}")
+        message(FATAL_ERROR "decoded log lacks '${expected}'")
+    endif()
+endforeach()
+if(log MATCHES "Failed to create|Error|unknown log id|rebuild log_decode")
+    message(FATAL_ERROR "decoded log reports a failure:\n${log}")
+endif()
+
+# The telemetry stream decodes without CRC or framing errors
+execute_process(COMMAND ${TELEMETRY_DECODE}
+    INPUT_FILE ${console}
+    OUTPUT_VARIABLE records
+    ERROR_VARIABLE summary
+    RESULT_VARIABLE result
+)
+message("${summary}")
+if(NOT records MATCHES "\n[0-9]")
+    message(FATAL_ERROR "no telemetry records decoded")
+endif()
+if(NOT summary MATCHES "\\[total\\][^\n]*crc errors 0 ")
+    message(FATAL_ERROR "telemetry stream has CRC errors")
+endif()
+
+# Link records: type 4, ..., success, attempts
+if(ACK_MISS)
+    if(NOT report MATCHES "ACKs, [1-9][0-9]* missed")
+        message(FATAL_ERROR "the FPGA model dropped no request")
+    endif()
+    if(NOT records MATCHES "\n4,[^\n]*,link,,,,,,,,,1,[2-9]")
+        message(FATAL_ERROR "no handshake succeeded on a retry")
+    endif()
+endif()
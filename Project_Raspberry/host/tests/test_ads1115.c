@@ -0,0 +1,153 @@
+/**
+ * @file test_ads1115.c
+ * @brief Teste (host) do motor de aquisição contínua sobre o modelo de registradores do ADS1115.
+ * @note Com uma só entrada ativa, o conversor 0x48 não reinicia a conversão e
+ * cada pulso ALERT/RDY é lido: a taxa efetiva fica perto da taxa de dados.
+ * Em seguida, duas entradas são varridas em round-robin. A cada taxa
+ * de dados, a taxa efetiva não pode passar da do conversor (cada troca de
+ * entrada reinicia a conversão) e deve ficar perto dela; as entradas se
+ * alternam e cada canal carrega a tensão da sua própria entrada.
+ * Roda com três conversores (FILTERCORE_SIM_ADS1115=3): com todos varrendo, a
+ * taxa total cresce, pois cada um converte enquanto os outros usam o barramento.
+ */
+#include "host_test.h"
+#include "sim.h"
+#include "ads1115.h"
+#include "i2c_configs.h"
+
+#define WARM_UP_MS 200
+#define WINDOW_MS 2000
+#define MIN_SINGLE_INPUT_RATIO 0.85f // conversions lost to host stalls
+#define PGA_FULL_SCALE_VOLTS 6.144f   // PGA 000, as the firmware configures the converter
+#define MAX_ERROR_VOLTS 0.02f   // model noise (2 mV) and the signal's drift since the sample
+
+#define CONVERTERS 3
+
+static const uint8_t inputs[] = { 0, 1 };
+
+/**
+ * @brief Amostras/s somadas das entradas varridas dos primeiros 'converters' conversores.
+ */
+static uint32_t measure_rate(uint8_t converters){
+    uint32_t start = 0;
+    for(uint8_t d = 0; d < converters; d++){
+        for(uint8_t i = 0; i < 2; i++) start += ads1115_scan_get_sample_count(ADS1115_CHANNEL(d, inputs[i]));
+    }
+    vTaskDelay(pdMS_TO_TICKS(WINDOW_MS));
+
+    uint32_t total = 0;
+    for(uint8_t d = 0; d < converters; d++){
+        for(uint8_t i = 0; i < 2; i++) total += ads1115_scan_get_sample_count(ADS1115_CHANNEL(d, inputs[i]));
+    }
+    return (total - start) * 1000u / WINDOW_MS;
+}
+
+/**
+ * @brief Com uma só entrada, cada conversão é lida no seu pulso, sem esperar o tempo máximo.
+ */
+static void check_single_input(uint16_t sps){
+    TEST_CHECK(ads1115_scan_set_data_rate(sps), "%u SPS rejected", sps);
+    vTaskDelay(pdMS_TO_TICKS(WARM_UP_MS));
+
+    uint32_t start = ads1115_scan_get_sample_count(ADS1115_CHANNEL(0, inputs[0]));
+    vTaskDelay(pdMS_TO_TICKS(WINDOW_MS));
+    uint32_t count = ads1115_scan_get_sample_count(ADS1115_CHANNEL(0, inputs[0])) - start;
+
+    uint32_t rate_sps = count * 1000u / WINDOW_MS;
+    host_test_log("%u SPS, AIN%u only: %lu samples in %u ms (%lu samples/s)\n", sps, inputs[0], (unsigned long)count,
+                  WINDOW_MS, (unsigned long)rate_sps);
+
+    TEST_CHECK(rate_sps <= sps, "%lu samples/s from a %u SPS converter", (unsigned long)rate_sps, sps);
+    TEST_CHECK(rate_sps >= sps * MIN_SINGLE_INPUT_RATIO, "%lu samples/s at %u SPS", (unsigned long)rate_sps, sps);
+}
+
+/**
+ * @brief Mede a taxa de cada canal numa taxa de dados e confere a varredura.
+ */
+static void check_data_rate(uint16_t sps){
+    TEST_CHECK(ads1115_scan_set_data_rate(sps), "%u SPS rejected", sps);
+    vTaskDelay(pdMS_TO_TICKS(WARM_UP_MS));
+
+    uint32_t start[2];
+    for(uint8_t i = 0; i < 2; i++) start[i] = ads1115_scan_get_sample_count(ADS1115_CHANNEL(0, inputs[i]));
+    vTaskDelay(pdMS_TO_TICKS(WINDOW_MS));
+
+    uint32_t counts[2];
+    for(uint8_t i = 0; i < 2; i++) counts[i] = ads1115_scan_get_sample_count(ADS1115_CHANNEL(0, inputs[i])) - start[i];
+
+    uint32_t total_sps = (counts[0] + counts[1]) * 1000u / WINDOW_MS;
+    host_test_log("%u SPS: %lu + %lu samples in %u ms (%lu samples/s)\n", sps, (unsigned long)counts[0],
+                  (unsigned long)counts[1], WINDOW_MS, (unsigned long)total_sps);
+
+    TEST_CHECK(total_sps <= sps, "%lu samples/s from a %u SPS converter", (unsigned long)total_sps, sps);
+    TEST_CHECK(total_sps >= sps / 2, "%lu samples/s at %u SPS", (unsigned long)total_sps, sps);
+
+    uint32_t difference = counts[0] > counts[1] ? counts[0] - counts[1] : counts[1] - counts[0];
+    TEST_CHECK(difference <= 2, "round robin unbalanced: %lu vs %lu", (unsigned long)counts[0], (unsigned long)counts[1]);
+}
+
+/**
+ * @brief A última amostra de cada canal é a tensão da sua entrada, não a da outra.
+ * @note Confere o código contra a tensão no pino na escala do PGA configurado;
+ * a escala de ADS1115_VREF é a das calibrações de pH e TDS.
+ */
+static void check_channels(void){
+    for(uint8_t i = 0; i < 2; i++){
+        int16_t sample;
+        TEST_CHECK(ads1115_scan_get_samples(ADS1115_CHANNEL(0, inputs[i]), &sample, 1) == 1, "no sample on AIN%u", inputs[i]);
+
+        float volts = sample * PGA_FULL_SCALE_VOLTS / 32768.0f;
+        float expected = ads1115_model_input_volts(inputs[i], time_us_64());
+        host_test_log("AIN%u: %.4f V (input %.4f V)\n", inputs[i], volts, expected);
+        TEST_CHECK(volts > expected - MAX_ERROR_VOLTS && volts < expected + MAX_ERROR_VOLTS, "AIN%u reads %.4f V, input %.4f V",
+                   inputs[i], volts, expected);
+    }
+}
+
+/**
+ * @brief Taxa total com um e com todos os conversores varrendo as mesmas entradas.
+ */
+static void check_converters(void){
+    TEST_CHECK(ads1115_scan_set_data_rate(860), "860 SPS rejected");
+    vTaskDelay(pdMS_TO_TICKS(WARM_UP_MS));
+    uint32_t single_sps = measure_rate(1);
+
+    for(uint8_t d = 1; d < CONVERTERS; d++){
+        for(uint8_t i = 0; i < 2; i++){
+            TEST_CHECK(ads1115_scan_enable_channel(ADS1115_CHANNEL(d, inputs[i])), "converter %u AIN%u", d, inputs[i]);
+        }
+    }
+    vTaskDelay(pdMS_TO_TICKS(WARM_UP_MS));
+    uint32_t all_sps = measure_rate(CONVERTERS);
+
+    host_test_log("860 SPS: 1 converter %lu samples/s, %u converters %lu samples/s\n", (unsigned long)single_sps,
+                  CONVERTERS, (unsigned long)all_sps);
+    TEST_CHECK(all_sps >= single_sps * 2, "%u converters: %lu samples/s, one: %lu", CONVERTERS, (unsigned long)all_sps,
+               (unsigned long)single_sps);
+}
+
+static void scenario(void){
+    i2c0_configs(I2C_BAUDRATE_DEFAULT);
+
+    TEST_CHECK(ads1115_scan_init(), "ads1115_scan_init");
+    TEST_CHECK(ads1115_get_device_count() == CONVERTERS, "%u converters", ads1115_get_device_count());
+
+    // Converter 0x4B is absent, and its channels are refused
+    TEST_CHECK(!ads1115_scan_enable_channel(ADS1115_CHANNEL(CONVERTERS, 0)), "channel of an absent converter");
+    TEST_CHECK(!ads1115_scan_enable_channel(ADS1115_NUM_CHANNELS), "channel %u", ADS1115_NUM_CHANNELS);
+
+    TEST_CHECK(ads1115_scan_enable_channel(ADS1115_CHANNEL(0, inputs[0])), "AIN%u", inputs[0]);
+    check_single_input(860);
+    check_single_input(128);
+
+    TEST_CHECK(ads1115_scan_enable_channel(ADS1115_CHANNEL(0, inputs[1])), "AIN%u", inputs[1]);
+    check_data_rate(860);
+    check_channels();
+    check_data_rate(128);
+    check_channels();
+    check_converters();
+}
+
+int main(void){
+    host_test_main("test_ads1115", scenario);
+}
@@ -0,0 +1,84 @@
+/**
+ * @file test_buttons.c
+ * @brief Teste (host) do debounce por interrupção e alarme dos botões.
+ * @note O roteiro do mundo é desligado e o teste aciona o pino do botão A com
+ * padrões de repique: cada pressionamento e cada soltura devem chegar ao
+ * listener como um único evento, e um pulso mais curto que o debounce não
+ * deve chegar.
+ */
+#include "host_test.h"
+#include "sim.h"
+#include "buttons.h"
+
+#define DEBOUNCE_MS 10          // DEBOUNCE_DELAY of buttons.c
+#define SETTLE_MS (DEBOUNCE_MS * 3)
+#define BOUNCES 6
+
+/**
+ * @brief Leva o pino ao nível dado com repique: alterna a cada 'gap_us' antes de firmar.
+ */
+static void bounce_to(bool level, uint32_t gap_us){
+    for(uint8_t i = 0; i < BOUNCES; i++){
+        sim_gpio_drive(SIM_BUTTON_A_PIN, (i % 2) ? !level : level);
+        busy_wait_us(gap_us);
+    }
+    sim_gpio_drive(SIM_BUTTON_A_PIN, level);
+}
+
+/**
+ * @brief Eventos entregues ao listener até o fim do debounce.
+ */
+static uint32_t events_after_settle(void){
+    vTaskDelay(pdMS_TO_TICKS(SETTLE_MS));
+
+    uint32_t events = 0;
+    xTaskNotifyWait(0, UINT32_MAX, &events, 0);
+    return events;
+}
+
+/**
+ * @brief Pressiona e solta com repique; cada transição é um único evento.
+ */
+static void check_press(const char *pattern, uint32_t gap_us){
+    bounce_to(false, gap_us);
+    uint32_t events = events_after_settle();
+    host_test_log("%s press: events 0x%lx\n", pattern, (unsigned long)events);
+    TEST_CHECK(events == BUTTON_EVENT_PRESSED, "%s press: events 0x%lx", pattern, (unsigned long)events);
+    TEST_CHECK(button_is_pressed(BUTTON_A), "%s press: not pressed", pattern);
+
+    bounce_to(true, gap_us);
+    events = events_after_settle();
+    host_test_log("%s release: events 0x%lx\n", pattern, (unsigned long)events);
+    TEST_CHECK(events == BUTTON_EVENT_RELEASED, "%s release: events 0x%lx", pattern, (unsigned long)events);
+    TEST_CHECK(!button_is_pressed(BUTTON_A), "%s release: still pressed", pattern);
+}
+
+/**
+ * @brief Um pulso (com repique) mais curto que o debounce não é um pressionamento.
+ */
+static void check_glitch(void){
+    bounce_to(false, 200);
+    busy_wait_us(DEBOUNCE_MS * 1000 / 4);
+    sim_gpio_drive(SIM_BUTTON_A_PIN, true);
+
+    uint32_t events = events_after_settle();
+    TEST_CHECK(events == 0, "glitch: events 0x%lx", (unsigned long)events);
+    TEST_CHECK(!button_is_pressed(BUTTON_A), "glitch: pressed");
+}
+
+static void scenario(void){
+    world_script_buttons(false);
+
+    init_button_a();
+    TEST_CHECK(button_enable_events(BUTTON_A, xTaskGetCurrentTaskHandle()), "button_enable_events");
+    TEST_CHECK(!button_is_pressed(BUTTON_A), "released button reads pressed");
+
+    check_press("fast bounce", 200);
+    // Each bounce comes halfway through the debounce and postpones it
+    check_press("slow bounce", DEBOUNCE_MS * 1000 / 2);
+    check_glitch();
+}
+
+int main(void){
+    host_test_main("test_buttons", scenario);
+}
@@ -0,0 +1,123 @@
+/**
+ * @file test_diagnostics.c
+ * @brief Teste (host) da contabilidade de CPU, trocas de contexto e heap das amostras de diagnóstico.
+ * @note Uma task ocupa metade da CPU (espera ativa de 5 ms a cada 10 ms): a
+ * amostra deve atribuir a ela ~50% e uma carga do core pelo menos igual, com as
+ * tasks em ordem de uso. O heap livre mínimo não pode subir quando um bloco é
+ * liberado.
+ */
+#include "host_test.h"
+#include "diagnostics.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define WINDOW_MS 1000
+#define BUSY_MS 5
+#define BUSY_PERIOD_MS 10
+#define BUSY_PERMILLE (BUSY_MS * 1000 / BUSY_PERIOD_MS)
+#define TOLERANCE_PERMILLE 150      // host stalls are charged to whichever task is running
+#define HEAP_BLOCK_SIZE (64 * 1024) // below the mmap threshold: taken from the arena
+
+#define BUSY_STACK_SIZE configMINIMAL_STACK_SIZE
+
+static StaticTask_t busy_task_buffer;
+static StackType_t busy_task_stack[BUSY_STACK_SIZE];
+
+static void task_busy(void *params){
+    while(true){
+        busy_wait_us(BUSY_MS * 1000);
+        vTaskDelay(pdMS_TO_TICKS(BUSY_PERIOD_MS - BUSY_MS));
+    }
+}
+
+static const diagnostics_task_t *find_task(const diagnostics_t *diagnostics, const char *name){
+    for(uint8_t i = 0; i < diagnostics->task_count; i++){
+        if(strcmp(diagnostics->tasks[i].name, name) == 0) return &diagnostics->tasks[i];
+    }
+    return NULL;
+}
+
+/**
+ * @brief Uma janela com a task ocupada: fração da CPU, carga do core e ordenação.
+ */
+static void check_cpu(void){
+    static diagnostics_t diagnostics;
+
+    xTaskCreateStatic(task_busy, "Task Busy", BUSY_STACK_SIZE, NULL, HOST_TEST_PRIORITY + 1, busy_task_stack,
+                      &busy_task_buffer);
+
+    TEST_CHECK(!diagnostics_sample(), "the first sample only sets the base");
+    vTaskDelay(pdMS_TO_TICKS(WINDOW_MS));
+    TEST_CHECK(diagnostics_sample(), "no sample published");
+    TEST_CHECK(diagnostics_read(&diagnostics), "no sample to read");
+
+    uint32_t window_ms = diagnostics.window_us / 1000;
+    TEST_CHECK(window_ms >= WINDOW_MS * 9 / 10 && window_ms < WINDOW_MS * 5 / 4, "window %lu ms",
+               (unsigned long)window_ms);
+    TEST_CHECK(diagnostics.context_switches[0] >= WINDOW_MS / BUSY_PERIOD_MS, "%lu context switches",
+               (unsigned long)diagnostics.context_switches[0]);
+
+    const diagnostics_task_t *busy = find_task(&diagnostics, "Busy");
+    TEST_CHECK(busy != NULL, "no Busy task in %u tasks", diagnostics.task_count);
+    if(!busy) return;
+
+    host_test_log("window %lu ms: Busy %u permille, core load %u permille, %lu switches\n", (unsigned long)window_ms,
+                  busy->cpu_permille, diagnostics.core_load_permille[0], (unsigned long)diagnostics.context_switches[0]);
+
+    TEST_CHECK(busy->cpu_permille > BUSY_PERMILLE - TOLERANCE_PERMILLE &&
+               busy->cpu_permille < BUSY_PERMILLE + TOLERANCE_PERMILLE, "Busy uses %u permille", busy->cpu_permille);
+    TEST_CHECK(busy->priority == HOST_TEST_PRIORITY + 1, "Busy priority %u", busy->priority);
+    TEST_CHECK(busy->stack_free_words > 0, "Busy stack exhausted");
+    TEST_CHECK(diagnostics.core_load_permille[0] >= busy->cpu_permille, "core load %u permille below Busy's %u",
+               diagnostics.core_load_permille[0], busy->cpu_permille);
+
+    // The idle task is the only one outside the core load
+    const diagnostics_task_t *idle = find_task(&diagnostics, "IDLE");
+    if(idle){
+        uint32_t total = diagnostics.core_load_permille[0] + idle->cpu_permille;
+        TEST_CHECK(total > 1000 - TOLERANCE_PERMILLE / 3 && total < 1000 + TOLERANCE_PERMILLE / 3,
+                   "core load %u + idle %u permille", diagnostics.core_load_permille[0], idle->cpu_permille);
+    }
+
+    for(uint8_t i = 1; i < diagnostics.task_count; i++){
+        TEST_CHECK(diagnostics.tasks[i - 1].cpu_permille >= diagnostics.tasks[i].cpu_permille,
+                   "%s (%u) before %s (%u)", diagnostics.tasks[i - 1].name, diagnostics.tasks[i - 1].cpu_permille,
+                   diagnostics.tasks[i].name, diagnostics.tasks[i].cpu_permille);
+    }
+}
+
+/**
+ * @brief O mínimo do heap livre acompanha uma alocação e não volta quando ela é liberada.
+ */
+static void check_heap(void){
+    static diagnostics_t diagnostics;
+
+    uint8_t *block = malloc(HEAP_BLOCK_SIZE);
+    TEST_CHECK(block != NULL, "malloc");
+    if(!block) return;
+    memset(block, 0xA5, HEAP_BLOCK_SIZE);
+
+    diagnostics_sample();
+    diagnostics_read(&diagnostics);
+    uint32_t allocated_min = diagnostics.heap_min_free;
+
+    free(block);
+    diagnostics_sample();
+    diagnostics_read(&diagnostics);
+
+    host_test_log("heap min free %lu B with the block, %lu B after freeing it\n", (unsigned long)allocated_min,
+                  (unsigned long)diagnostics.heap_min_free);
+    TEST_CHECK(diagnostics.heap_min_free <= allocated_min, "heap min free rose from %lu to %lu B",
+               (unsigned long)allocated_min, (unsigned long)diagnostics.heap_min_free);
+}
+
+static void scenario(void){
+    diagnostics_init();
+
+    check_cpu();
+    check_heap();
+}
+
+int main(void){
+    host_test_main("test_diagnostics", scenario);
+}
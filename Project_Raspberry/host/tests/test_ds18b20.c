@@ -0,0 +1,76 @@
+/**
+ * @file test_ds18b20.c
+ * @brief Teste (host) da busca de ROM com várias sondas no mesmo barramento.
+ * @note Roda com três sondas simuladas (FILTERCORE_SIM_PROBES=3), que diferem
+ * em dois bits da ROM: a busca precisa resolver as discrepâncias e encontrar
+ * todas. Cada sonda é então lida por Match ROM; o modelo soma 0,25 ºC por
+ * sonda à temperatura do mundo, então as leituras devem ser distintas.
+ */
+#include "host_test.h"
+#include "ds18b20.h"
+#include "units.h"
+
+#define PROBES 3
+#define MAX_CYCLES 8    // a Convert T or a scratchpad can be lost to a host stall; another conversion follows
+#define MAX_SCANS 3     // a bit read late by a host stall reads 1 and hides a discrepancy
+
+/**
+ * @brief Converte e coleta um ciclo completo.
+ * @return true se todas as sondas foram lidas com CRC válido.
+ */
+static bool conversion_cycle(celsius_t *average){
+    if(!ds18b20_start_conversion()) return false;
+
+    uint32_t waited_ms = 0;
+    while(!ds18b20_is_conversion_ready() && waited_ms < DS18B20_CONVERSION_TIME_MS){
+        vTaskDelay(pdMS_TO_TICKS(50));
+        waited_ms += 50;
+    }
+
+    if(!ds18b20_collect_temperature(average)) return false;
+
+    celsius_t temperature;
+    for(uint8_t i = 0; i < ds18b20_get_device_count(); i++){
+        if(!ds18b20_get_probe_temperature(i, &temperature)) return false;
+    }
+    return true;
+}
+
+static void scenario(void){
+    TEST_CHECK(ds18b20_init(), "ds18b20_init");
+
+    // The firmware retries steps that fail (lost bit, ROM CRC), but a hidden
+    // discrepancy ends the search early on a valid ROM: only a new scan finds it
+    uint8_t found = 0;
+    for(uint8_t scan = 0; scan < MAX_SCANS && found < PROBES; scan++) found = ds18b20_scan();
+    TEST_CHECK(found == PROBES, "%u probes found, %u on the bus", found, PROBES);
+    TEST_CHECK(ds18b20_get_device_count() == found, "device count %u", ds18b20_get_device_count());
+
+    celsius_t average = 0;
+    bool complete = false;
+    for(uint8_t cycle = 0; cycle < MAX_CYCLES && !complete; cycle++) complete = conversion_cycle(&average);
+    TEST_CHECK(complete, "no cycle read every probe in %u conversions", MAX_CYCLES);
+    if(!complete) return;
+
+    // Match ROM reached each probe: one reading per offset (0, 0.25 and 0.5 ºC)
+    celsius_t temperatures[PROBES];
+    celsius_t lowest = 0;
+    celsius_t highest = 0;
+    fixed_t sum = 0;
+    for(uint8_t i = 0; i < found; i++){
+        ds18b20_get_probe_temperature(i, &temperatures[i]);
+        if(i == 0 || temperatures[i] < lowest) lowest = temperatures[i];
+        if(i == 0 || temperatures[i] > highest) highest = temperatures[i];
+        sum += temperatures[i];
+        host_test_log("probe %u: %.4f C\n", i, fixed_to_float(temperatures[i]));
+    }
+
+    fixed_t spread = highest - lowest;
+    TEST_CHECK(spread >= FIXED_ONE / 4 && spread <= FIXED_ONE * 3 / 4, "spread between probes %.4f C",
+               fixed_to_float(spread));
+    TEST_CHECK(average == sum / found, "average %.4f C", fixed_to_float(average));
+}
+
+int main(void){
+    host_test_main("test_ds18b20", scenario);
+}
@@ -0,0 +1,197 @@
+/**
+ * @file test_i2c_bus.c
+ * @brief Teste (host) do gerenciador de transações I2C (fila, DMA e conclusão por notificação).
+ * @note Ordem: lotes de escritas e leituras de um registrador do ADS1115 são
+ * submetidos sem esperar; cada leitura devolve o valor da escrita anterior, os
+ * callbacks chegam na ordem de submissão e uma transação para um endereço
+ * ausente falha sem afetar as seguintes.
+ * Aqui uma transação curta termina dentro da própria submissão (o simulador
+ * aguarda ativamente eventos a menos de SIM_SPIN_US), então a profundidade da
+ * fila é conferida só com quadros.
+ * Vazão: quadros inteiros do SSD1306 mantidos na fila devem ocupar o fio quase
+ * todo o tempo, enquanto cada submissão retorna bem antes do quadro terminar.
+ */
+#include "host_test.h"
+#include "i2c_bus.h"
+
+#define ADS1115_ADDRESS 0x48
+#define ABSENT_ADDRESS 0x4B
+#define REG_LO_THRESH 0x02
+#define ROUNDS 20
+#define PAIRS ((I2C_BUS_QUEUE_LENGTH - 1) / 2)  // a write and a read each, plus the absent device
+
+#define OLED_ADDRESS 0x3C
+#define FRAME_SIZE 1024
+#define FRAMES_IN_FLIGHT 4
+#define WINDOW_MS 2000
+#define MIN_WIRE_PERCENT 70             // host stalls leave the wire idle between frames
+#define MAX_FAILED_PERCENT 5            // a host stall longer than the drain timeout aborts a frame
+
+typedef struct {
+    i2c_transaction_t transaction;
+    uint8_t tx[3];
+    uint8_t rx[2];
+    uint8_t index;
+} ordered_t;
+
+static uint8_t completion_order[I2C_BUS_QUEUE_LENGTH];
+static uint8_t completions;
+
+static void record_completion(i2c_transaction_t *transaction, bool success){
+    (void)success;
+    const ordered_t *ordered = transaction->context;
+    if(completions < I2C_BUS_QUEUE_LENGTH) completion_order[completions] = ordered->index;
+    completions++;
+}
+
+static void prepare(ordered_t *ordered, uint8_t index, i2c_transaction_kind_t kind, uint8_t address){
+    ordered->transaction = (i2c_transaction_t){
+        .kind = kind,
+        .address = address,
+        .tx = ordered->tx,
+        .tx_len = kind == I2C_BUS_WRITE ? 3 : 1,
+        .rx = kind == I2C_BUS_WRITE_READ ? ordered->rx : NULL,
+        .rx_len = kind == I2C_BUS_WRITE_READ ? 2 : 0,
+        .callback = record_completion,
+        .context = ordered
+    };
+    ordered->index = index;
+}
+
+/**
+ * @brief Um lote submetido de uma vez: escrita e leitura de Lo_thresh em pares,
+ * com uma transação para um endereço ausente no meio.
+ * @return Pares cuja leitura devolveu o valor escrito.
+ */
+static uint8_t run_round(uint8_t round){
+    static ordered_t batch[PAIRS * 2 + 1];
+    uint8_t count = 0;
+    completions = 0;
+
+    for(uint8_t pair = 0; pair < PAIRS; pair++){
+        uint16_t value = (uint16_t)(round * 256 + pair * 17 + 1);
+
+        if(pair == PAIRS / 2){
+            ordered_t *absent = &batch[count];
+            prepare(absent, count++, I2C_BUS_WRITE, ABSENT_ADDRESS);
+            absent->tx[0] = REG_LO_THRESH;
+        }
+
+        ordered_t *write = &batch[count];
+        prepare(write, count++, I2C_BUS_WRITE, ADS1115_ADDRESS);
+        write->tx[0] = REG_LO_THRESH;
+        write->tx[1] = (uint8_t)(value >> 8);
+        write->tx[2] = (uint8_t)value;
+
+        ordered_t *read = &batch[count];
+        prepare(read, count++, I2C_BUS_WRITE_READ, ADS1115_ADDRESS);
+        read->tx[0] = REG_LO_THRESH;
+    }
+
+    for(uint8_t i = 0; i < count; i++){
+        TEST_CHECK(i2c_bus_submit(I2C0_PORT, &batch[i].transaction), "round %u: transaction %u rejected", round, i);
+    }
+
+    uint8_t matches = 0;
+    for(uint8_t i = 0; i < count; i++){
+        bool success = i2c_bus_wait(&batch[i].transaction, pdMS_TO_TICKS(I2C_BUS_TIMEOUT_MS));
+        bool absent = batch[i].transaction.address == ABSENT_ADDRESS;
+        TEST_CHECK(success != absent, "round %u: transaction %u (0x%02X) %s", round, i, batch[i].transaction.address,
+                   success ? "acknowledged" : "failed");
+
+        if(batch[i].transaction.kind == I2C_BUS_WRITE_READ){
+            const uint8_t *written = batch[i - 1].tx;
+            if(batch[i].rx[0] == written[1] && batch[i].rx[1] == written[2]) matches++;
+        }
+    }
+
+    TEST_CHECK(completions == count, "round %u: %u of %u callbacks", round, completions, count);
+    for(uint8_t i = 0; i < count && i < completions; i++){
+        TEST_CHECK(completion_order[i] == i, "round %u: completion %u was transaction %u", round, i, completion_order[i]);
+    }
+    return matches;
+}
+
+static void check_ordering(void){
+    uint32_t matches = 0;
+    for(uint8_t round = 0; round < ROUNDS; round++) matches += run_round(round);
+
+    i2c_bus_stats_t stats;
+    TEST_CHECK(i2c_bus_get_stats(I2C0_PORT, &stats), "no i2c0 stats");
+    host_test_log("ordering: %lu/%u reads matched the preceding write; %lu completed, %lu failed\n",
+                  (unsigned long)matches, ROUNDS * PAIRS, (unsigned long)stats.completed, (unsigned long)stats.failed);
+
+    TEST_CHECK(matches == ROUNDS * PAIRS, "%lu of %u reads matched", (unsigned long)matches, ROUNDS * PAIRS);
+    TEST_CHECK(stats.failed == ROUNDS, "%lu failed transactions, %u to the absent device", (unsigned long)stats.failed,
+               ROUNDS);
+}
+
+/**
+ * @brief Quadros inteiros, sempre FRAMES_IN_FLIGHT na fila, durante WINDOW_MS.
+ */
+static void check_throughput(void){
+    static uint8_t frames[FRAMES_IN_FLIGHT][1 + FRAME_SIZE];
+    static i2c_transaction_t transactions[FRAMES_IN_FLIGHT];
+
+    for(uint8_t i = 0; i < FRAMES_IN_FLIGHT; i++){
+        frames[i][0] = 0x40; // data stream
+        for(uint16_t b = 0; b < FRAME_SIZE; b++) frames[i][1 + b] = (uint8_t)(b + i);
+        transactions[i] = (i2c_transaction_t){
+            .kind = I2C_BUS_WRITE, .address = OLED_ADDRESS, .tx = frames[i], .tx_len = sizeof(frames[i])
+        };
+    }
+
+    i2c_bus_reset_stats(I2C1_PORT);
+
+    uint32_t frames_sent = 0;
+    uint32_t failures = 0;
+    uint32_t slowest_submit_us = 0;
+    uint64_t start_us = time_us_64();
+    while(time_us_64() - start_us < WINDOW_MS * 1000ull){
+        i2c_transaction_t *transaction = &transactions[frames_sent % FRAMES_IN_FLIGHT];
+        if(frames_sent >= FRAMES_IN_FLIGHT && !i2c_bus_wait(transaction, portMAX_DELAY)) failures++;
+
+        uint64_t submit_us = time_us_64();
+        TEST_CHECK(i2c_bus_submit(I2C1_PORT, transaction), "frame %lu rejected", (unsigned long)frames_sent);
+        uint32_t elapsed_us = (uint32_t)(time_us_64() - submit_us);
+        if(elapsed_us > slowest_submit_us) slowest_submit_us = elapsed_us;
+        frames_sent++;
+    }
+    for(uint8_t i = 0; i < FRAMES_IN_FLIGHT; i++){
+        if(!i2c_bus_wait(&transactions[i], portMAX_DELAY)) failures++;
+    }
+
+    i2c_bus_stats_t stats;
+    TEST_CHECK(i2c_bus_get_stats(I2C1_PORT, &stats), "no i2c1 stats");
+
+    // Address and data bytes, 9 clocks each, plus START and STOP
+    uint32_t frame_wire_us = (uint32_t)(((1 + sizeof(frames[0])) * 9 + 2) * 1000000ull / I2C_BAUDRATE_DEFAULT);
+    uint32_t wire_percent = (uint32_t)((uint64_t)frames_sent * frame_wire_us * 100 / stats.elapsed_us);
+    host_test_log("throughput: %lu frames in %lu ms (%lu us each on the wire), %lu%% wire, %u%% busy, "
+                  "slowest submit %lu us, max depth %u\n", (unsigned long)frames_sent,
+                  (unsigned long)(stats.elapsed_us / 1000), (unsigned long)frame_wire_us, (unsigned long)wire_percent,
+                  stats.utilization_percent, (unsigned long)slowest_submit_us, stats.max_queue_depth);
+
+    TEST_CHECK(failures * 100 <= frames_sent * MAX_FAILED_PERCENT, "%lu of %lu frames failed", (unsigned long)failures,
+               (unsigned long)frames_sent);
+    TEST_CHECK(stats.completed + stats.failed == frames_sent, "%lu + %lu of %lu frames finished",
+               (unsigned long)stats.completed, (unsigned long)stats.failed, (unsigned long)frames_sent);
+    TEST_CHECK(wire_percent >= MIN_WIRE_PERCENT, "the wire carried frames %lu%% of the time", (unsigned long)wire_percent);
+    TEST_CHECK(stats.utilization_percent >= MIN_WIRE_PERCENT, "utilization %u%%", stats.utilization_percent);
+    TEST_CHECK(stats.max_queue_depth >= 2, "max queue depth %u: frames were not queued behind each other",
+               stats.max_queue_depth);
+    TEST_CHECK(slowest_submit_us < frame_wire_us / 4, "a submit took %lu us, a frame %lu us",
+               (unsigned long)slowest_submit_us, (unsigned long)frame_wire_us);
+}
+
+static void scenario(void){
+    i2c0_configs(I2C_BAUDRATE_DEFAULT);
+    i2c1_configs(I2C_BAUDRATE_DEFAULT);
+
+    check_ordering();
+    check_throughput();
+}
+
+int main(void){
+    host_test_main("test_i2c_bus", scenario);
+}
@@ -0,0 +1,173 @@
+/**
+ * @file test_latency.c
+ * @brief Teste (host) do rastreio de latência da amostra até o ACK do FPGA.
+ * @note task_sensors e task_handshake rodam sobre o enlace simulado. O atraso
+ * do ACK do FPGA é trocado entre duas janelas: só as etapas a partir do REQ
+ * acompanham o atraso, e cada etapa cabe dentro da de ponta a ponta. A
+ * publicação acorda o handshake (notify_handshake), então a amostra é pega logo.
+ * Numa terceira janela o ACK demora mais que o intervalo de amostragem: o laço
+ * dos sensores publica mais rápido que o handshake consome, e há amostras
+ * substituídas no mailbox.
+ * Antes das tasks, ciclos de sensor_pipeline com snapshots montados conferem o
+ * início do rastro: a amostra que cruzou o limite, não a mais recente.
+ */
+#include "host_test.h"
+#include "sim.h"
+#include "events.h"
+#include "i2c_configs.h"
+#include "notifications.h"
+#include "task_sensors.h"
+#include "task_handshake.h"
+#include "latency.h"
+#include "sensor_pipeline.h"
+#include "sampling_policy.h"
+
+#define WARM_UP_MS 1500
+#define WINDOW_MS 4000
+#define SHORT_ACK_US 2000
+#define LONG_ACK_US 40000
+#define BACKLOG_ACK_US 300000       // above SAMPLING_MIN_INTERVAL_MS, below HANDSHAKE_TIMEOUT_MS
+#define ACK_POLL_US 10000           // handshake_acknowledge polls the ACK every 10 ms
+#define SLACK_US 20000              // host stalls
+
+#define STAGE_REQUEST_ACK (LATENCY_ACKNOWLEDGED - 1)
+#define STAGE_PUBLISH_PICK (LATENCY_PICKED - 1)
+
+/**
+ * @brief Descarta as notificações (o display não roda no teste).
+ */
+static void drain_notifications(void){
+    notification_t notification;
+    while(receive_notification(&notification));
+}
+
+/**
+ * @brief Um ciclo do pipeline; devolve o instante em que o rastro começaria.
+ */
+static uint64_t trigger_of(sensor_pipeline_t *pipeline, const sensor_snapshot_t *snapshot, uint64_t now_us){
+    sensors_data_t data;
+    normalized_sensors_data_t normalized_data;
+    sensor_pipeline_process(pipeline, snapshot, now_us, &data, &normalized_data);
+    return pipeline->trigger_us;
+}
+
+/**
+ * @brief O rastro começa na amostra que mudou um alerta; sem mudança, na mais recente.
+ */
+static void check_trigger(void){
+    static sensor_pipeline_t pipeline;
+    sensor_pipeline_init(&pipeline);
+
+    sensor_snapshot_t snapshot = {
+        .temperature = FIXED_FROM_FLOAT(26.0f), .ph = FIXED_FROM_FLOAT(7.0f), .tds = FIXED_FROM_FLOAT(300.0f),
+        .temperature_us = 1000, .ph_us = 2000, .tds_us = 3000
+    };
+    uint64_t trigger_us = trigger_of(&pipeline, &snapshot, 3500);
+    TEST_CHECK(trigger_us == 3000, "calm cycle stamped at %llu us", (unsigned long long)trigger_us);
+
+    // pH crosses its limit, and a newer TDS value arrives in the same cycle
+    snapshot.ph = FIXED_FROM_FLOAT(9.0f);
+    snapshot.ph_us = 3200;
+    snapshot.tds_us = 3400;
+    trigger_us = trigger_of(&pipeline, &snapshot, 3600);
+    TEST_CHECK(trigger_us == 3200, "pH alert stamped at %llu us, crossed at 3200 us", (unsigned long long)trigger_us);
+
+    snapshot.tds_us = 3800;
+    trigger_us = trigger_of(&pipeline, &snapshot, 3900);
+    TEST_CHECK(trigger_us == 3800, "held alert stamped at %llu us", (unsigned long long)trigger_us);
+
+    // No temperature for seconds: the alert comes from the cycle, not from a sample
+    uint64_t now_us = 10000000;
+    snapshot.ph_us = now_us - 1000;
+    snapshot.tds_us = now_us - 500;
+    trigger_us = trigger_of(&pipeline, &snapshot, now_us);
+    TEST_CHECK(pipeline.new_stale == SENSOR_STALE_TEMPERATURE, "stale mask 0x%x", pipeline.new_stale);
+    TEST_CHECK(trigger_us == now_us, "stale alert stamped at %llu us", (unsigned long long)trigger_us);
+
+    drain_notifications();
+}
+
+/**
+ * @brief Uma janela com o atraso de ACK dado; copia as estatísticas de cada etapa.
+ */
+static void run_window(uint32_t ack_us, latency_stats_t stats[LATENCY_STAGES]){
+    fpga_model_set_ack_delay(ack_us);
+    vTaskDelay(pdMS_TO_TICKS(SAMPLING_MAX_INTERVAL_MS + ack_us / 1000));
+    latency_reset_stats();
+
+    for(uint32_t waited_ms = 0; waited_ms < WINDOW_MS; waited_ms += 100){
+        vTaskDelay(pdMS_TO_TICKS(100));
+        drain_notifications();
+    }
+
+    host_test_log("ACK after %lu us: %lu superseded\n", (unsigned long)ack_us, (unsigned long)latency_superseded());
+    for(uint8_t i = 0; i < LATENCY_STAGES; i++){
+        latency_get_stats(i, &stats[i]);
+        host_test_log("  %-15s n %lu | p50 %lu us, max %lu us\n", stats[i].name, (unsigned long)stats[i].count,
+                      (unsigned long)stats[i].p50_us, (unsigned long)stats[i].max_us);
+    }
+}
+
+/**
+ * @brief Cada etapa foi medida em todas as amostras concluídas e cabe na de ponta a ponta.
+ */
+static void check_stages(const latency_stats_t stats[LATENCY_STAGES], uint32_t ack_us){
+    const latency_stats_t *total = &stats[LATENCY_END_TO_END];
+    TEST_CHECK(total->count >= WINDOW_MS / SAMPLING_MAX_INTERVAL_MS, "%lu samples acknowledged",
+               (unsigned long)total->count);
+
+    for(uint8_t i = 0; i < LATENCY_END_TO_END; i++){
+        TEST_CHECK(stats[i].count == total->count, "%s: %lu of %lu samples", stats[i].name,
+                   (unsigned long)stats[i].count, (unsigned long)total->count);
+        TEST_CHECK(stats[i].max_us <= total->max_us, "%s: max %lu us above the total %lu us", stats[i].name,
+                   (unsigned long)stats[i].max_us, (unsigned long)total->max_us);
+    }
+
+    // The FPGA answers after ack_us; the handshake sees it at its next poll
+    const latency_stats_t *ack = &stats[STAGE_REQUEST_ACK];
+    TEST_CHECK(ack->min_us >= ack_us, "request>ack min %lu us, ACK after %lu us", (unsigned long)ack->min_us,
+               (unsigned long)ack_us);
+    TEST_CHECK(ack->p50_us <= ack_us + ACK_POLL_US + SLACK_US, "request>ack p50 %lu us, ACK after %lu us",
+               (unsigned long)ack->p50_us, (unsigned long)ack_us);
+
+    // The publication wakes the handshake, idle between samples
+    const latency_stats_t *pick = &stats[STAGE_PUBLISH_PICK];
+    TEST_CHECK(pick->p50_us <= SLACK_US, "publish>pick p50 %lu us", (unsigned long)pick->p50_us);
+}
+
+static void scenario(void){
+    i2c0_configs(I2C_BAUDRATE_DEFAULT);
+    TEST_CHECK(notifications_init(), "notifications ring");
+    check_trigger();
+
+    create_task_sensors();
+    create_task_handshake();
+    vTaskDelay(pdMS_TO_TICKS(WARM_UP_MS));
+
+    static latency_stats_t fast[LATENCY_STAGES];
+    static latency_stats_t slow[LATENCY_STAGES];
+    run_window(SHORT_ACK_US, fast);
+    check_stages(fast, SHORT_ACK_US);
+    run_window(LONG_ACK_US, slow);
+    check_stages(slow, LONG_ACK_US);
+
+    // Only the stages after the REQ follow the FPGA's delay
+    uint32_t delay_us = LONG_ACK_US - SHORT_ACK_US;
+    TEST_CHECK(slow[STAGE_REQUEST_ACK].p50_us >= fast[STAGE_REQUEST_ACK].p50_us + delay_us - ACK_POLL_US,
+               "request>ack p50 %lu -> %lu us", (unsigned long)fast[STAGE_REQUEST_ACK].p50_us,
+               (unsigned long)slow[STAGE_REQUEST_ACK].p50_us);
+    TEST_CHECK(slow[LATENCY_END_TO_END].p50_us > fast[LATENCY_END_TO_END].p50_us, "sample>ack p50 %lu -> %lu us",
+               (unsigned long)fast[LATENCY_END_TO_END].p50_us, (unsigned long)slow[LATENCY_END_TO_END].p50_us);
+
+    // Handshakes longer than the sampling interval: the newest publication replaces the waiting one
+    static latency_stats_t backlog[LATENCY_STAGES];
+    run_window(BACKLOG_ACK_US, backlog);
+    TEST_CHECK(latency_superseded() > 0, "no sample superseded in the mailbox");
+    TEST_CHECK(backlog[STAGE_PUBLISH_PICK].max_us <= BACKLOG_ACK_US + 2 * ACK_POLL_US + SLACK_US,
+               "publish>pick max %lu us, ACK after %lu us", (unsigned long)backlog[STAGE_PUBLISH_PICK].max_us,
+               (unsigned long)BACKLOG_ACK_US);
+}
+
+int main(void){
+    host_test_main("test_latency", scenario);
+}
@@ -0,0 +1,105 @@
+/**
+ * @file test_notifications.c
+ * @brief Teste (host) do agrupamento e do descarte por severidade do anel de notificações.
+ * @note Uma notificação idêntica a uma pendente é agrupada, mesmo com o anel
+ * cheio. Com o anel cheio, sai a pendente mais antiga da menor severidade abaixo
+ * da nova; sem nenhuma, a nova é descartada. Os contadores são conferidos
+ * exatamente a cada passo.
+ */
+#include "host_test.h"
+#include "notifications.h"
+#include <string.h>
+
+/**
+ * @brief Confere os contadores do anel.
+ */
+static void check_stats(const char *step, uint32_t sent, uint32_t coalesced, uint32_t dropped, uint8_t pending){
+    notifications_stats_t stats;
+    notifications_get_stats(&stats);
+
+    TEST_CHECK(stats.sent == sent && stats.coalesced == coalesced && stats.dropped == dropped && stats.pending == pending,
+               "%s: sent %lu, coalesced %lu, dropped %lu, pending %u (expected %lu, %lu, %lu, %u)", step,
+               (unsigned long)stats.sent, (unsigned long)stats.coalesced, (unsigned long)stats.dropped, stats.pending,
+               (unsigned long)sent, (unsigned long)coalesced, (unsigned long)dropped, pending);
+}
+
+/**
+ * @brief Retira a próxima notificação e confere tipo, mensagem e repetições.
+ */
+static void check_next(notification_type_t type, const char *message, uint16_t count){
+    notification_t notification;
+    if(!receive_notification(&notification)){
+        TEST_CHECK(false, "no notification, expected \"%s\"", message);
+        return;
+    }
+
+    TEST_CHECK(notification.type == type && strcmp(notification.message, message) == 0 && notification.count == count,
+               "received \"%s\" (type %u, x%u), expected \"%s\" (type %u, x%u)", notification.message,
+               notification.type, notification.count, message, type, count);
+}
+
+/**
+ * @brief Duas notificações idênticas seguidas viram uma, com duas repetições.
+ */
+static void check_coalesce(void){
+    send_notification(INFO, "Coalesced");
+    send_notification(INFO, "Coalesced");
+    check_stats("coalesce", 2, 1, 0, 1);
+
+    check_next(INFO, "Coalesced", 2);
+    check_stats("coalesce drained", 2, 1, 0, 0);
+}
+
+/**
+ * @brief Com o anel cheio: descarte da menor severidade, da nova e agrupamento.
+ */
+static void check_full_ring(void){
+    static char *errors[] = { "Error 1", "Error 2", "Error 3", "Error 4", "Error 5" };
+
+    // Eight pending notifications fill the ring
+    send_notification(INFO, "Info 1");
+    send_notification(ALERT, "Alert 1");
+    send_notification(INFO, "Info 2");
+    for(uint8_t i = 0; i < 5; i++) send_notification(ERROR, errors[i]);
+    check_stats("full", 10, 1, 0, NOTIFICATIONS_RING_SIZE);
+
+    // The lowest severity goes first, the oldest among equals: Info 1, then Info 2 before Alert 1
+    send_notification(ERROR, "Error 6");
+    check_stats("evict Info 1", 11, 1, 1, NOTIFICATIONS_RING_SIZE);
+    send_notification(ERROR, "Error 7");
+    check_stats("evict Info 2", 12, 1, 2, NOTIFICATIONS_RING_SIZE);
+
+    // Nothing below ALERT is pending: the new one is dropped
+    send_notification(ALERT, "Alert 2");
+    check_stats("drop Alert 2", 13, 1, 3, NOTIFICATIONS_RING_SIZE);
+
+    send_notification(ERROR, "Error 8");
+    check_stats("evict Alert 1", 14, 1, 4, NOTIFICATIONS_RING_SIZE);
+    send_notification(ERROR, "Error 9");
+    check_stats("drop Error 9", 15, 1, 5, NOTIFICATIONS_RING_SIZE);
+
+    // A repeat still coalesces with the ring full
+    send_notification(ERROR, "Error 1");
+    check_stats("coalesce when full", 16, 2, 5, NOTIFICATIONS_RING_SIZE);
+
+    check_next(ERROR, "Error 1", 2);
+    for(uint8_t i = 1; i < 5; i++) check_next(ERROR, errors[i], 1);
+    check_next(ERROR, "Error 6", 1);
+    check_next(ERROR, "Error 7", 1);
+    check_next(ERROR, "Error 8", 1);
+
+    notification_t notification;
+    TEST_CHECK(!receive_notification(&notification), "extra notification \"%s\"", notification.message);
+    check_stats("drained", 16, 2, 5, 0);
+}
+
+static void scenario(void){
+    TEST_CHECK(notifications_init(), "notifications ring");
+
+    check_coalesce();
+    check_full_ring();
+}
+
+int main(void){
+    host_test_main("test_notifications", scenario);
+}
@@ -0,0 +1,100 @@
+/**
+ * @file test_onewire.c
+ * @brief Teste (host) da temporização das fendas 1-Wire dirigidas por alarmes.
+ * @note O modelo do DS18B20 confere cada borda do mestre contra as janelas do
+ * datasheet (reset, escrita de 0 e de 1, leitura, recuperação e amostragem).
+ * O simulador roda no relógio real: um atraso do host entre a borda e o seu
+ * registro desloca os tempos medidos (quase sempre para mais) e corrompe algumas
+ * transferências. Um erro de temporização do firmware aparece em todas as
+ * fendas do seu tipo, então as violações são toleradas só em poucas fendas.
+ */
+#include "host_test.h"
+#include "sim.h"
+#include "onewire.h"
+
+#define ATTEMPTS 20
+#define CMD_READ_ROM 0x33
+#define CMD_WRITE_SCRATCHPAD 0x4E
+#define CMD_READ_SCRATCHPAD 0xBE
+
+// Read ROM (1 + 8 bytes), Write Scratchpad (5) and Read Scratchpad (2 + 9) per attempt
+#define SLOTS (ATTEMPTS * 8 * ((1 + 8) + 5 + (2 + 9)))
+
+static onewire_t bus;
+
+static int64_t count_call(alarm_id_t id, void *user_data){
+    (void)id;
+    (*(uint32_t *)user_data)++;
+    return 0;
+}
+
+/**
+ * @brief Alarmes para um instante já vencido, com a semântica do pico-sdk.
+ */
+static void check_past_alarms(void){
+    uint32_t calls = 0;
+
+    alarm_id_t id = add_alarm_in_us(0, count_call, &calls, false);
+    TEST_CHECK(id == 0 && calls == 0, "past alarm without fire_if_past: id %d, %lu calls", (int)id, (unsigned long)calls);
+
+    id = add_alarm_in_us(0, count_call, &calls, true);
+    TEST_CHECK(id == 0 && calls == 1, "past alarm with fire_if_past: id %d, %lu calls", (int)id, (unsigned long)calls);
+}
+
+/**
+ * @brief Lê a ROM da sonda única (Read ROM).
+ */
+static bool read_rom(void){
+    const uint8_t command = CMD_READ_ROM;
+    uint8_t rom[ONEWIRE_ROM_SIZE];
+
+    if(!onewire_transfer(&bus, true, &command, 1, rom, sizeof(rom))) return false;
+    return onewire_crc8(rom, sizeof(rom)) == 0 && rom[0] == 0x28;
+}
+
+/**
+ * @brief Escreve TH no scratchpad e o lê de volta (escritas de 0 e de 1 e leituras).
+ */
+static bool scratchpad_round_trip(uint8_t th){
+    const uint8_t write[] = { ONEWIRE_CMD_SKIP_ROM, CMD_WRITE_SCRATCHPAD, th, 0x46, 0x7F };
+    if(!onewire_transfer(&bus, true, write, sizeof(write), NULL, 0)) return false;
+
+    const uint8_t read[] = { ONEWIRE_CMD_SKIP_ROM, CMD_READ_SCRATCHPAD };
+    uint8_t scratchpad[9];
+    if(!onewire_transfer(&bus, true, read, sizeof(read), scratchpad, sizeof(scratchpad))) return false;
+
+    return onewire_crc8(scratchpad, sizeof(scratchpad)) == 0 && scratchpad[2] == th;
+}
+
+static void scenario(void){
+    check_past_alarms();
+
+    TEST_CHECK(onewire_init(&bus, SIM_ONEWIRE_PIN), "onewire_init");
+
+    uint32_t roms = 0;
+    uint32_t round_trips = 0;
+    for(uint8_t i = 0; i < ATTEMPTS; i++){
+        if(read_rom()) roms++;
+        if(scratchpad_round_trip(0x10 + i)) round_trips++;
+    }
+
+    sim_onewire_timing_t timing;
+    ds18b20_model_timing(&timing);
+    host_test_log("%lu/%u ROM reads, %lu/%u scratchpad round trips; %lu slots, %lu too short, %lu too long\n",
+                  (unsigned long)roms, ATTEMPTS, (unsigned long)round_trips, ATTEMPTS, (unsigned long)timing.slots,
+                  (unsigned long)timing.too_short, (unsigned long)timing.too_long);
+
+    // A host stall can stretch a slot into a reset
+    TEST_CHECK(timing.slots >= SLOTS * 19 / 20, "%lu slots, %u expected", (unsigned long)timing.slots, SLOTS);
+    TEST_CHECK(timing.too_short * 100 <= timing.slots, "%lu of %lu master times below the datasheet windows",
+               (unsigned long)timing.too_short, (unsigned long)timing.slots);
+    TEST_CHECK(timing.too_long * 20 <= timing.slots, "%lu of %lu slots stretched", (unsigned long)timing.too_long,
+               (unsigned long)timing.slots);
+
+    TEST_CHECK(roms >= ATTEMPTS / 2, "%lu ROM reads", (unsigned long)roms);
+    TEST_CHECK(round_trips >= ATTEMPTS / 2, "%lu scratchpad round trips", (unsigned long)round_trips);
+}
+
+int main(void){
+    host_test_main("test_onewire", scenario);
+}
@@ -0,0 +1,238 @@
+/**
+ * @file test_sensor_history.c
+ * @brief Teste (host) da codificação, descarte e decodificação do histórico de sensores.
+ * @note As amostras entram com instantes dados (sensor_history_record_at), e um
+ * modelo de referência guarda os pontos esperados de cada camada sem codificar
+ * (médias, mínimos e máximos já quantizados, com os períodos repetidos nas
+ * lacunas curtas). A primeira fase tem saltos de pH maiores que um delta de 8
+ * bits e lacunas curta e longa; a segunda cobre 10 dias, o bastante para os
+ * anéis das três camadas darem a volta. Em cada verificação, os pontos lidos
+ * de volta devem ser a cauda exata do modelo.
+ */
+#include "host_test.h"
+#include "sensor_history.h"
+#include <math.h>
+#include <string.h>
+
+#define SENSORS 3
+#define MODEL_POINTS 2048               // above the largest ring (46 x 32 minute points)
+
+#define BURST_SECONDS 2000              // phase 1: a sample per second
+#define PH_JUMP_EVERY_S 100             // 1 pH (256 quanta) steps, beyond a delta
+#define SHORT_GAP_AT_S 500              // 2 missing seconds: held
+#define LONG_GAP_AT_S 1000              // 10 missing seconds: a new block
+#define LONG_GAP_S 10
+
+#define DAYS 10                         // phase 2: every ring rolls over (7 x 32 h of hours)
+#define SLOW_STEP_S 2                   // every other second held
+#define CHECK_EVERY_S (24 * 3600)
+
+static const uint32_t tier_period_s[HISTORY_TIERS] = { 1, 60, 3600 };
+static const uint8_t tier_blocks[HISTORY_TIERS] = {
+    HISTORY_SECONDS_BLOCKS, HISTORY_MINUTES_BLOCKS, HISTORY_HOURS_BLOCKS
+};
+static const char *const tier_names[HISTORY_TIERS] = { "seconds", "minutes", "hours" };
+static const uint8_t sensor_shift[SENSORS] = {
+    HISTORY_TEMPERATURE_SHIFT, HISTORY_PH_SHIFT, HISTORY_TDS_SHIFT
+};
+
+// Pontos esperados de uma camada: anel com os mais recentes e o período aberto
+typedef struct {
+    history_point_t points[MODEL_POINTS];
+    size_t total;
+    uint32_t period;
+    uint32_t count;
+    int64_t sum[SENSORS];
+    fixed_t min[SENSORS];
+    fixed_t max[SENSORS];
+} model_tier_t;
+
+static model_tier_t model[HISTORY_TIERS];
+static history_point_t read_back[HISTORY_MINUTES_BLOCKS * HISTORY_BLOCK_POINTS];
+
+static fixed_t round_to_quantum(fixed_t value, uint8_t shift){
+    return ((value + (1 << (shift - 1))) >> shift) * (1 << shift);
+}
+
+static const history_point_t *model_point(const model_tier_t *tier, size_t index){
+    return &tier->points[index % MODEL_POINTS];
+}
+
+static void model_push(model_tier_t *tier, const history_point_t *point){
+    tier->points[tier->total % MODEL_POINTS] = *point;
+    tier->total++;
+}
+
+/**
+ * @brief Fecha o período aberto: repete o último ponto numa lacuna curta e grava o novo.
+ */
+static void model_commit(model_tier_t *tier, uint32_t period_s){
+    history_point_t point;
+    history_value_t *values[SENSORS] = { &point.temperature, &point.ph, &point.tds };
+
+    point.time_s = tier->period * period_s;
+    for(uint8_t s = 0; s < SENSORS; s++){
+        fixed_t mean = round_to_quantum((fixed_t)(tier->sum[s] / (int64_t)tier->count), sensor_shift[s]);
+        values[s]->mean = mean;
+        values[s]->min = period_s == 1 ? mean : round_to_quantum(tier->min[s], sensor_shift[s]);
+        values[s]->max = period_s == 1 ? mean : round_to_quantum(tier->max[s], sensor_shift[s]);
+    }
+
+    if(tier->total){
+        history_point_t held = *model_point(tier, tier->total - 1);
+        uint32_t gap = (point.time_s - held.time_s) / period_s;
+        for(uint32_t i = 1; i < gap && gap <= HISTORY_MAX_HOLD_PERIODS + 1; i++){
+            held.time_s += period_s;
+            model_push(tier, &held);
+        }
+    }
+    model_push(tier, &point);
+}
+
+static void model_record(const sensors_data_t *data, uint32_t now_s){
+    const fixed_t sample[SENSORS] = { data->temperature, data->ph, data->tds };
+
+    for(uint8_t t = 0; t < HISTORY_TIERS; t++){
+        model_tier_t *tier = &model[t];
+        uint32_t period = now_s / tier_period_s[t];
+
+        if(tier->count && period != tier->period){
+            model_commit(tier, tier_period_s[t]);
+            tier->count = 0;
+        }
+        if(tier->count == 0){
+            tier->period = period;
+            for(uint8_t s = 0; s < SENSORS; s++){
+                tier->sum[s] = 0;
+                tier->min[s] = sample[s];
+                tier->max[s] = sample[s];
+            }
+        }
+        for(uint8_t s = 0; s < SENSORS; s++){
+            tier->sum[s] += sample[s];
+            if(sample[s] < tier->min[s]) tier->min[s] = sample[s];
+            if(sample[s] > tier->max[s]) tier->max[s] = sample[s];
+        }
+        tier->count++;
+    }
+}
+
+/**
+ * @brief Ondas lentas (períodos de horas) e, na primeira fase, degraus de pH.
+ */
+static void record(uint32_t now_s, bool ph_steps){
+    const float two_pi = 6.2831853f;
+    float ph = 7.0f + 0.5f * sinf(two_pi * now_s / (24 * 3600.0f));
+    if(ph_steps && (now_s / PH_JUMP_EVERY_S) % 2) ph += 1.0f;
+
+    sensors_data_t data = {
+        .temperature = (fixed_t)lrintf((25.0f + 2.0f * sinf(two_pi * now_s / (6 * 3600.0f))) * FIXED_ONE),
+        .ph = (fixed_t)lrintf(ph * FIXED_ONE),
+        .tds = (fixed_t)lrintf((300.0f + 50.0f * sinf(two_pi * now_s / (12 * 3600.0f))) * FIXED_ONE),
+        .button_state = false
+    };
+
+    sensor_history_record_at(&data, now_s);
+    model_record(&data, now_s);
+}
+
+static bool same_point(const history_point_t *a, const history_point_t *b){
+    return a->time_s == b->time_s &&
+           memcmp(&a->temperature, &b->temperature, sizeof(a->temperature)) == 0 &&
+           memcmp(&a->ph, &b->ph, sizeof(a->ph)) == 0 &&
+           memcmp(&a->tds, &b->tds, sizeof(a->tds)) == 0;
+}
+
+/**
+ * @brief Os pontos lidos de cada camada são a cauda do modelo, inteira e só os últimos.
+ */
+static void check_tiers(const char *stage){
+    for(uint8_t t = 0; t < HISTORY_TIERS; t++){
+        const model_tier_t *tier = &model[t];
+        size_t capacity = (size_t)tier_blocks[t] * HISTORY_BLOCK_POINTS;
+        size_t count = sensor_history_count((history_tier_t)t);
+
+        TEST_CHECK(count <= capacity && count <= tier->total, "%s %s: %zu points, %zu recorded, capacity %zu", stage,
+                   tier_names[t], count, tier->total, capacity);
+        if(count > capacity || count > tier->total) continue;
+
+        // Until a ring is full nothing is dropped
+        if(tier->total <= (size_t)(tier_blocks[t] - 1) * HISTORY_BLOCK_POINTS){
+            TEST_CHECK(count == tier->total, "%s %s: %zu of %zu points kept", stage, tier_names[t], count, tier->total);
+        }
+
+        size_t read = sensor_history_latest((history_tier_t)t, read_back, count);
+        TEST_CHECK(read == count, "%s %s: %zu of %zu points read", stage, tier_names[t], read, count);
+
+        size_t mismatches = 0;
+        for(size_t i = 0; i < read; i++){
+            const history_point_t *expected = model_point(tier, tier->total - read + i);
+            if(!same_point(&read_back[i], expected)){
+                if(mismatches++ == 0){
+                    TEST_CHECK(false, "%s %s: point %zu at %lu s, expected %lu s (pH %.4f/%.4f/%.4f, expected %.4f)",
+                               stage, tier_names[t], i, (unsigned long)read_back[i].time_s,
+                               (unsigned long)expected->time_s, fixed_to_float(read_back[i].ph.min),
+                               fixed_to_float(read_back[i].ph.mean), fixed_to_float(read_back[i].ph.max),
+                               fixed_to_float(expected->ph.mean));
+                }
+            }
+        }
+
+        // A short read decodes from the middle of a block
+        if(read > HISTORY_BLOCK_POINTS / 2){
+            size_t few = HISTORY_BLOCK_POINTS / 2 + 1;
+            TEST_CHECK(sensor_history_latest((history_tier_t)t, read_back, few) == few, "%s %s: short read", stage,
+                       tier_names[t]);
+            for(size_t i = 0; i < few; i++){
+                if(!same_point(&read_back[i], model_point(tier, tier->total - few + i))) mismatches++;
+            }
+        }
+
+        host_test_log("%s %s: %zu points (%zu recorded), %zu mismatches\n", stage, tier_names[t], count, tier->total,
+                      mismatches);
+        TEST_CHECK(mismatches == 0, "%s %s: %zu mismatched points", stage, tier_names[t], mismatches);
+    }
+}
+
+/**
+ * @brief Com o anel cheio e sem saltos, só o bloco mais antigo pode estar incompleto.
+ */
+static void check_full_rings(void){
+    for(uint8_t t = HISTORY_TIER_MINUTES; t < HISTORY_TIERS; t++){
+        size_t count = sensor_history_count((history_tier_t)t);
+        size_t full = (size_t)(tier_blocks[t] - 1) * HISTORY_BLOCK_POINTS;
+
+        TEST_CHECK(model[t].total > (size_t)tier_blocks[t] * HISTORY_BLOCK_POINTS, "%s ring never rolled over",
+                   tier_names[t]);
+        TEST_CHECK(count > full, "%s: %zu points in %u blocks", tier_names[t], count, tier_blocks[t]);
+    }
+}
+
+static void scenario(void){
+    TEST_CHECK(sensor_history_init(), "sensor_history_init");
+    TEST_CHECK(sensor_history_latest(HISTORY_TIER_SECONDS, read_back, 1) == 0, "points before any sample");
+
+    uint32_t now_s = 0;
+    for(; now_s < BURST_SECONDS; now_s++){
+        if(now_s == SHORT_GAP_AT_S) now_s += HISTORY_MAX_HOLD_PERIODS;
+        if(now_s == LONG_GAP_AT_S) now_s += LONG_GAP_S;
+        record(now_s, true);
+    }
+    check_tiers("burst");
+
+    uint32_t end_s = now_s + DAYS * 24 * 3600;
+    uint32_t next_check_s = now_s + CHECK_EVERY_S;
+    for(; now_s < end_s; now_s += SLOW_STEP_S){
+        record(now_s, false);
+        if(now_s >= next_check_s){
+            check_tiers("rollover");
+            next_check_s += CHECK_EVERY_S;
+        }
+    }
+    check_tiers("end");
+    check_full_rings();
+}
+
+int main(void){
+    host_test_main("test_sensor_history", scenario);
+}
@@ -0,0 +1,183 @@
+/**
+ * @file test_sensor_loop.c
+ * @brief Teste (host) do período do laço de sensores com a conversão do DS18B20 em segundo plano.
+ * @note O pipeline completo (produtores e task_sensors) roda sobre o barramento
+ * 1-Wire e o ADS1115 simulados. O laço deve publicar no período do perfil de
+ * amostragem, bem abaixo dos 750 ms de uma conversão, enquanto a temperatura
+ * continua sendo atualizada a cada conversão concluída.
+ * Um toque curto no botão A, solto antes do ciclo seguinte, ainda chega como
+ * pressionamento. Com as sondas desconectadas, a temperatura fica velha: o
+ * canal vai a alerta e uma notificação de erro é enviada.
+ */
+#include "host_test.h"
+#include "sim.h"
+#include "events.h"
+#include "i2c_configs.h"
+#include "notifications.h"
+#include "task_sensors.h"
+#include "periodic_job.h"
+#include "sampling_policy.h"
+#include "sensor_snapshot.h"
+#include "ds18b20.h"
+#include <string.h>
+
+#define WARM_UP_MS 1500             // first conversion and the first complete snapshot
+#define WARM_UP_MAX_MS (WARM_UP_MS + DS18B20_CONVERSION_TIME_MS * 2)   // a scratchpad or two lost to host stalls
+#define WINDOW_MS 5000
+#define POLL_MS 5
+#define TAP_MS 30                   // debounced, and released well before the next cycle
+#define STALE_WAIT_MS (DS18B20_CONVERSION_TIME_MS * 4 + SAMPLING_MAX_INTERVAL_MS * 2)
+
+/**
+ * @brief Estatísticas de um job periódico pelo nome.
+ */
+static bool job_stats(const char *name, periodic_job_stats_t *stats){
+    for(uint8_t i = 0; periodic_job_get_stats(i, stats); i++){
+        if(strcmp(stats->name, name) == 0) return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Procura uma notificação pendente pela mensagem (as outras são descartadas).
+ */
+static bool find_notification(const char *message){
+    notification_t notification;
+    while(receive_notification(&notification)){
+        if(strcmp(notification.message, message) == 0) return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Um toque no botão A entre dois ciclos é publicado como pressionamento.
+ */
+static void check_button_tap(void){
+    sensors_data_t data;
+    uint32_t publication = 0;
+    mailbox_read(&mailbox_sensors_data, &data, &publication);
+
+    sim_gpio_drive(SIM_BUTTON_A_PIN, false);
+    vTaskDelay(pdMS_TO_TICKS(TAP_MS));
+    sim_gpio_drive(SIM_BUTTON_A_PIN, true);
+
+    bool pressed = false;
+    uint64_t start_us = time_us_64();
+    while(!pressed && time_us_64() - start_us < SAMPLING_MAX_INTERVAL_MS * 2000ull){
+        vTaskDelay(pdMS_TO_TICKS(POLL_MS));
+        if(mailbox_read_if_new(&mailbox_sensors_data, &data, &publication)) pressed = data.button_state;
+    }
+    TEST_CHECK(pressed, "a %u ms tap was not published", TAP_MS);
+    TEST_CHECK(find_notification("Manual Start"), "no Manual Start notification");
+}
+
+/**
+ * @brief Sem sondas, a temperatura fica velha e vai a alerta.
+ */
+static void check_stale_temperature(void){
+    ds18b20_model_unplug();
+    vTaskDelay(pdMS_TO_TICKS(STALE_WAIT_MS));
+
+    sensor_snapshot_t snapshot;
+    sensor_snapshot_read(&snapshot);
+    uint32_t age_ms = sensor_snapshot_age_ms(snapshot.temperature_us, time_us_64());
+
+    normalized_sensors_data_t normalized;
+    uint32_t publication = 0;
+    TEST_CHECK(mailbox_read(&mailbox_normalized_sensors_data, &normalized, &publication), "no normalized data");
+    host_test_log("temperature unplugged: %lu ms old, alert %u\n", (unsigned long)age_ms, normalized.temperature);
+
+    TEST_CHECK(age_ms >= STALE_WAIT_MS - DS18B20_CONVERSION_TIME_MS, "temperature published %lu ms ago",
+               (unsigned long)age_ms);
+    TEST_CHECK(normalized.temperature, "stale temperature not flagged");
+    TEST_CHECK(find_notification("Temp Stale!"), "no Temp Stale notification");
+}
+
+static void scenario(void){
+    world_script_buttons(false);
+    i2c0_configs(I2C_BAUDRATE_DEFAULT);
+    TEST_CHECK(notifications_init(), "notifications ring");
+    create_task_sensors();
+
+    vTaskDelay(pdMS_TO_TICKS(WARM_UP_MS));
+
+    // The window starts at a publication: a host stall can corrupt the first
+    // scratchpad, and the snapshot is only complete after the next conversion
+    sensors_data_t data;
+    uint32_t publication = 0;
+    bool published = mailbox_read(&mailbox_sensors_data, &data, &publication);
+    uint64_t warm_up_us = time_us_64();
+    while(!published && time_us_64() - warm_up_us < (WARM_UP_MAX_MS - WARM_UP_MS) * 1000ull){
+        vTaskDelay(pdMS_TO_TICKS(POLL_MS));
+        published = mailbox_read(&mailbox_sensors_data, &data, &publication);
+    }
+    TEST_CHECK(published, "no sensor data after %u ms", WARM_UP_MAX_MS);
+    if(!published) return;
+
+    uint32_t publications = 0;
+    uint32_t temperature_updates = 0;
+    sensor_snapshot_t snapshot;
+    sensor_snapshot_read(&snapshot);
+    uint64_t last_temperature_us = snapshot.temperature_us;
+    sim_onewire_timing_t timing_start;
+    ds18b20_model_timing(&timing_start);
+
+    uint64_t start_us = time_us_64();
+    while(time_us_64() - start_us < WINDOW_MS * 1000ull){
+        vTaskDelay(pdMS_TO_TICKS(POLL_MS));
+
+        if(mailbox_read_if_new(&mailbox_sensors_data, &data, &publication)) publications++;
+
+        sensor_snapshot_read(&snapshot);
+        if(snapshot.temperature_us != last_temperature_us){
+            temperature_updates++;
+            last_temperature_us = snapshot.temperature_us;
+        }
+    }
+
+    sim_onewire_timing_t timing;
+    ds18b20_model_timing(&timing);
+    uint32_t misread = timing.misread - timing_start.misread;
+
+    uint32_t loop_period_ms = publications ? WINDOW_MS / publications : WINDOW_MS;
+    host_test_log("%lu publications (%lu ms period), %lu temperature updates in %u ms, %lu misread 1-Wire slots\n",
+                  (unsigned long)publications, (unsigned long)loop_period_ms,
+                  (unsigned long)temperature_updates, WINDOW_MS, (unsigned long)misread);
+
+    // The loop runs at the sampling profile's period, not at the conversion time
+    TEST_CHECK(loop_period_ms <= SAMPLING_MAX_INTERVAL_MS, "loop period %lu ms", (unsigned long)loop_period_ms);
+    TEST_CHECK(loop_period_ms < DS18B20_CONVERSION_TIME_MS, "loop period %lu ms is bound by the DS18B20",
+               (unsigned long)loop_period_ms);
+
+    periodic_job_stats_t sensors;
+    TEST_CHECK(job_stats("Sensors", &sensors), "no Sensors job");
+    TEST_CHECK(loop_period_ms <= sensors.period_ms * 5 / 4, "loop period %lu ms, profile %lu ms",
+               (unsigned long)loop_period_ms, (unsigned long)sensors.period_ms);
+    TEST_CHECK(sensors.response_p99_us < SAMPLING_MIN_INTERVAL_MS * 1000u, "Sensors p99 response %lu us",
+               (unsigned long)sensors.response_p99_us);
+
+    // The temperature producer polls the conversion and never waits for it. The
+    // simulator spins through the 1-Wire slots, so a Match ROM read costs ~11 ms
+    // of CPU here (not on the RP2040, where each slot is a short alarm interrupt)
+    periodic_job_stats_t temperature;
+    TEST_CHECK(job_stats("Temperature", &temperature), "no Temperature job");
+    host_test_log("Temperature: response p50 %lu us, max %lu us\n", (unsigned long)temperature.response_p50_us,
+                  (unsigned long)temperature.response_max_us);
+    TEST_CHECK(temperature.response_max_us < DS18B20_CONVERSION_TIME_MS * 1000u / 4, "Temperature max response %lu us",
+               (unsigned long)temperature.response_max_us);
+
+    // ...and still publishes every completed conversion (a scratchpad lost to a CRC
+    // error is read again after the next conversion). Each slot a host stall
+    // stretched past its bit can cost one conversion, but not all of them
+    uint32_t conversions = WINDOW_MS / (DS18B20_CONVERSION_TIME_MS + 500);
+    uint32_t lost = misread < conversions ? misread : conversions - 1;
+    TEST_CHECK(temperature_updates >= conversions - lost, "%lu temperature updates, %lu misread slots",
+               (unsigned long)temperature_updates, (unsigned long)misread);
+
+    check_button_tap();
+    check_stale_temperature();
+}
+
+int main(void){
+    host_test_main("test_sensor_loop", scenario);
+}
@@ -87,15 +87,18 @@
 // todo need this for lwip FreeRTOS sys_arch to compile
 #define configENABLE_BACKWARD_COMPATIBILITY     1
 #define configNUM_THREAD_LOCAL_STORAGE_POINTERS 5
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES   2 // index 1: I2C transaction completion
 
 /* System */
 #define configSTACK_DEPTH_TYPE                  uint32_t
 #define configMESSAGE_BUFFER_LENGTH_TYPE        size_t
 
 /* Memory allocation related definitions. */
-#define configSUPPORT_STATIC_ALLOCATION         0
-#define configSUPPORT_DYNAMIC_ALLOCATION        1
-#define configTOTAL_HEAP_SIZE                   (128*1024)
+// Every task, queue and semaphore is a statically sized object (xTaskCreateStatic, ...);
+// without dynamic allocation there is no FreeRTOS heap (heap_4 is not linked).
+// Idle and timer task memory comes from src/miscellaneous/rtos_memory.c.
+#define configSUPPORT_STATIC_ALLOCATION         1
+#define configSUPPORT_DYNAMIC_ALLOCATION        0
 #define configAPPLICATION_ALLOCATED_HEAP        0
 
 /* Hook function related definitions. */
@@ -106,7 +109,11 @@
 
 
 /* Run time and task stats gathering related definitions. */
-#define configGENERATE_RUN_TIME_STATS           0
+// Run time counted by the RP2040 64-bit microsecond timer; sampled by diagnostics.c
+#define configGENERATE_RUN_TIME_STATS           1
+#define configRUN_TIME_COUNTER_TYPE             uint64_t
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE()        time_us_64()
 #define configUSE_TRACE_FACILITY                1
 #define configUSE_STATS_FORMATTING_FUNCTIONS    0
 
@@ -165,5 +172,12 @@ to exclude the API function. */
 #define INCLUDE_xQueueGetMutexHolder            1
 
 /* A header file that defines trace macro can be included here. */
+#ifndef __ASSEMBLER__
+#include "hardware/timer.h"
+void diagnostics_task_switched_in(void);
+#endif
+
+// Per-core busy time and context switches (diagnostics.c)
+#define traceTASK_SWITCHED_IN()                 diagnostics_task_switched_in()
 
 #endif /* FREERTOS_CONFIG_H */
\ No newline at end of file
@@ -1,8 +1,29 @@
 #ifndef DS18B20_H
 #define DS18B20_H
 
+#include <stdbool.h>
+#include <stdint.h>
 #include "units.h"
 
+#define DS18B20_CONVERSION_TIME_MS 750 // max conversion time for 12-bit resolution
+#define DS18B20_MAX_DEVICES 4          // max probes on the same 1-Wire bus
+#define DS18B20_FAMILY_CODE 0x28
+#define DS18B20_SCAN_ATTEMPTS 3        // attempts of each search step after a bus error
+
+bool ds18b20_init(void);
+
+uint8_t ds18b20_scan(void);
+
+uint8_t ds18b20_get_device_count(void);
+
+bool ds18b20_start_conversion(void);
+
+bool ds18b20_is_conversion_ready(void);
+
+bool ds18b20_collect_temperature(celsius_t *temperature);
+
+bool ds18b20_get_probe_temperature(uint8_t index, celsius_t *temperature);
+
 celsius_t ds18b20_read_temperature(void);
 
-#endif // Temperature sensor DS18B20
\ No newline at end of file
+#endif // Temperature sensor DS18B20
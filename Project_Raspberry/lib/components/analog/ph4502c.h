@@ -3,6 +3,10 @@
 
 #include "units.h"
 
+void ph4502c_init(void);
+
+void ph4502c_set_window(uint8_t window);
+
 ph_t ph4502c_read_ph(void);
 
 #endif // pH sensor PH4502C
\ No newline at end of file
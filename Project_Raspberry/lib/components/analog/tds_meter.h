@@ -3,6 +3,14 @@
 
 #include "units.h"
 
+void tds_meter_init(void);
+
+void tds_meter_set_window(uint8_t window);
+
 ppm_t tds_meter_read_ppm(celsius_t current_temperature);
 
+float tds_polynomial(float compensated_voltage);
+
+ppm_t tds_curve_lookup(fixed_t voltage);
+
 #endif // TDS Meter
\ No newline at end of file
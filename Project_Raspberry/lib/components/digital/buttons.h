@@ -2,6 +2,12 @@
 #define BUTTONS_H
 
 #include "pico/stdlib.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+// Button events (direct-to-task notification bits of the listener)
+#define BUTTON_EVENT_PRESSED  (1u << 0)
+#define BUTTON_EVENT_RELEASED (1u << 1)
 
 //Tipagem para definir o botão
 typedef enum{
@@ -19,8 +25,8 @@ typedef struct{
 void init_button_a();
 void init_button_b();
 void init_button_sw();
-bool get_button_a();
-bool get_button_b();
-bool get_button_sw();
+
+bool button_enable_events(button_id_t button, TaskHandle_t listener);
+bool button_is_pressed(button_id_t button);
 
 #endif //BUTTONS_H
\ No newline at end of file
@@ -2,11 +2,44 @@
 #define ADS1115_H
 
 #include "i2c_configs.h"
+#include "fixed_point.h"
 
 #define ADS1115_VREF 4.096f
 #define ADS1115_MAX_ADC_VALUE 32767.0f
+#define ADS1115_MAX_ADC_CODE 32767
+
+// --- Conversores no barramento I2C0 (pino ADDR em GND, VDD, SDA e SCL) ---
+#define ADS1115_BASE_ADDR 0x48
+#define ADS1115_MAX_DEVICES 4
+#define ADS1115_INPUTS_PER_DEVICE 4
+#define ADS1115_NUM_CHANNELS (ADS1115_MAX_DEVICES * ADS1115_INPUTS_PER_DEVICE)
+
+// Logical channel of an analog input: device index (0 = 0x48 ... 3 = 0x4B) and input AIN0-AIN3
+#define ADS1115_CHANNEL(device, input) ((device) * ADS1115_INPUTS_PER_DEVICE + (input))
+
+// --- Motor de aquisição contínua ---
+#define ADS1115_ALERT_PIN 28        // ALERT/RDY pins of every converter, wired together (active low)
+#define ADS1115_DATA_RATE_SPS 860   // initial data rate of each converter, shared by its scanned inputs
+#define ADS1115_RING_SIZE 32        // samples kept per channel
 
 int16_t ads1115_read_adc(uint8_t channel);
 
+fixed_t ads1115_raw_to_voltage(int16_t raw);
+
+bool ads1115_scan_init(void);
+
+bool ads1115_scan_enable_channel(uint8_t channel);
+
+bool ads1115_scan_set_data_rate(uint16_t sps);
+
+size_t ads1115_scan_get_samples(uint8_t channel, int16_t *samples, size_t count);
+
+size_t ads1115_scan_get_new_samples(uint8_t channel, uint32_t *cursor, int16_t *samples, size_t count);
+
+uint32_t ads1115_scan_get_sample_count(uint8_t channel);
+
+void ads1115_scan_inject_sample(uint8_t channel, int16_t value);
+
+uint8_t ads1115_get_device_count(void);
 
 #endif //ADS1115_H
\ No newline at end of file
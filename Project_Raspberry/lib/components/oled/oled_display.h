@@ -1,7 +1,7 @@
 #ifndef OLED_DISPLAY_H
 #define OLED_DISPLAY_H
 
-#include "i2c_configs.h"
+#include "i2c_bus.h"
 #include "ssd1306_text.h"
 #include <stdint.h>
 #include <stddef.h>
@@ -21,9 +21,14 @@ typedef struct {
     uint8_t pages;
     uint8_t address;
     i2c_inst_t* i2c_port;
+    uint8_t *frame;                     // address window followed by ram_buffer, sent as one transaction
     uint8_t *ram_buffer;
+    uint8_t *shown_buffer;              // last frame the display acknowledged
+    bool shown_valid;
     size_t buffer_size;
-    uint8_t port_buffer[2];
+    uint32_t frames_rendered;
+    uint32_t frames_skipped;            // identical to the frame already shown
+    i2c_transaction_t render_frame;     // address window and ram_buffer contents
 } ssd1306_t;
 
 bool oled_init(ssd1306_t* oled);
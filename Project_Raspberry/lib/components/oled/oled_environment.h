@@ -10,6 +10,8 @@ extern ssd1306_t oled;
 
 extern SemaphoreHandle_t oled_mutex;
 
-extern volatile oled_screen_t current_screen;
+oled_screen_t current_screen_get(void);
+
+void current_screen_set(oled_screen_t screen);
 
 #endif // OLED_ENVIRONMENT_H
\ No newline at end of file
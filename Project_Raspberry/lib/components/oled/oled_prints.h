@@ -10,6 +10,8 @@
 #define SSD1306_CHAR_LARGE_PAGES 3
 #define DEFAULT_MARGIN 8
 
+void print_large_symbol(ssd1306_t* oled, const uint8_t* bitmap, uint8_t x, uint8_t start_y);
+
 void print_text_center(ssd1306_t* oled, const char* text, uint8_t line);
 
 void print_text_left(ssd1306_t* oled, const char* text, uint8_t line);
@@ -10,6 +10,7 @@ typedef enum {
     TDS_SCREEN,
     TEMPERATURE_SCREEN,
     NOTIFICATIONS_SCREEN,
+    DIAGNOSTICS_SCREEN,
     TOTAL_SCREENS
 } oled_screen_t;
 
@@ -7,9 +7,16 @@
 #include "task.h"
 #include "queue.h"
 #include "units.h"
+#include "mailbox.h"
+#include "latency.h"
 
 #define MAX_NOTIFICATIONS 5
-#define MAX_SENSORS_DATA 5
+
+// Display wake-up events (direct-to-task notification bits of handle_display)
+#define DISPLAY_EVENT_SENSORS      (1u << 0)
+#define DISPLAY_EVENT_PAGE         (1u << 1)
+#define DISPLAY_EVENT_NOTIFICATION (1u << 2)
+#define DISPLAY_EVENT_DIAGNOSTICS  (1u << 3)
 
 typedef enum {
     INFO,
@@ -29,17 +36,37 @@ typedef struct{
     bool ph;
     bool tds;
     bool button_state;
+    latency_trace_t trace;  // sample to FPGA ACK timestamps, not sent to the FPGA
 } normalized_sensors_data_t;
 
 typedef struct{
     notification_type_t type;
     char *message;
+    uint16_t count; // repetitions coalesced into this notification
 } notification_t;
 
 extern TaskHandle_t handle_display;
-extern QueueHandle_t queue_sensors_data;
-extern QueueHandle_t queue_normalized_sensors_data;
-extern QueueHandle_t queue_notifications;
+extern TaskHandle_t handle_handshake;
+extern mailbox_t mailbox_sensors_data;
+extern mailbox_t mailbox_normalized_sensors_data;
+
+/**
+ * @brief Acorda a task do display, sinalizando o que mudou (DISPLAY_EVENT_...).
+ * @note Os bits se acumulam até a task consumi-los; chamada apenas por tasks.
+ * * @param events Máscara de eventos.
+ */
+static inline void notify_display(uint32_t events){
+    if(handle_display) xTaskNotify(handle_display, events, eSetBits);
+}
+
+/**
+ * @brief Acorda a task de handshake: há uma publicação nova em 'mailbox_normalized_sensors_data'.
+ * @note Publicações feitas durante um handshake em curso se acumulam numa única
+ * notificação; a task então lê só a mais recente.
+ */
+static inline void notify_handshake(void){
+    if(handle_handshake) xTaskNotifyGive(handle_handshake);
+}
 
 
 #endif // EVENTS_H
\ No newline at end of file
@@ -0,0 +1,64 @@
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+#include <stdint.h>
+
+// Q16.16: 16 integer bits (with sign) and 16 fractional bits
+typedef int32_t fixed_t;
+
+#define FIXED_FRACTION_BITS 16
+#define FIXED_ONE ((fixed_t)1 << FIXED_FRACTION_BITS)
+#define FIXED_MAX INT32_MAX
+#define FIXED_MIN INT32_MIN
+
+// Conversions of constants, folded by the compiler (no float at run time)
+#define FIXED_FROM_INT(x) ((fixed_t)(x) * FIXED_ONE)
+#define FIXED_FROM_FLOAT(x) ((fixed_t)((x) * 65536.0f + ((x) >= 0 ? 0.5f : -0.5f)))
+
+/**
+ * @brief Limita um resultado intermediário de 64 bits à faixa do Q16.16.
+ */
+static inline fixed_t fixed_saturate(int64_t value){
+    if(value > FIXED_MAX) return FIXED_MAX;
+    if(value < FIXED_MIN) return FIXED_MIN;
+    return (fixed_t)value;
+}
+
+/**
+ * @brief Soma com saturação.
+ */
+static inline fixed_t fixed_add(fixed_t a, fixed_t b){
+    return fixed_saturate((int64_t)a + b);
+}
+
+/**
+ * @brief Subtração com saturação.
+ */
+static inline fixed_t fixed_sub(fixed_t a, fixed_t b){
+    return fixed_saturate((int64_t)a - b);
+}
+
+/**
+ * @brief Multiplicação com saturação (produto de 64 bits, arredondado).
+ */
+static inline fixed_t fixed_mul(fixed_t a, fixed_t b){
+    int64_t product = (int64_t)a * b;
+    return fixed_saturate((product + (FIXED_ONE / 2)) >> FIXED_FRACTION_BITS);
+}
+
+/**
+ * @brief Divisão com saturação; divisão por zero satura no sinal do dividendo.
+ */
+static inline fixed_t fixed_div(fixed_t a, fixed_t b){
+    if(b == 0) return a >= 0 ? FIXED_MAX : FIXED_MIN;
+    return fixed_saturate(((int64_t)a * FIXED_ONE) / b);
+}
+
+/**
+ * @brief Converte para float, apenas para exibição e depuração (fora do caminho crítico).
+ */
+static inline float fixed_to_float(fixed_t value){
+    return (float)value / FIXED_ONE;
+}
+
+#endif // FIXED_POINT_H
\ No newline at end of file
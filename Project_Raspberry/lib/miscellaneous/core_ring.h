@@ -0,0 +1,40 @@
+#ifndef CORE_RING_H
+#define CORE_RING_H
+
+#include "pico/platform.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Anel de um core: produtores do próprio core, um único consumidor
+typedef struct {
+    volatile uint32_t head;     // written by the core's producers (interrupts disabled)
+    volatile uint32_t tail;     // written by the consumer
+    volatile uint32_t dropped;
+} core_ring_lane_t;
+
+// Anéis por core de registros de tamanho fixo (log diferido, telemetria)
+typedef struct {
+    uint8_t *records;           // NUM_CORES x capacity records of record_size bytes
+    size_t record_size;
+    uint32_t capacity;          // records per core, power of two
+    core_ring_lane_t lanes[NUM_CORES];
+    uint8_t next_core;          // next lane the consumer reads
+} core_ring_t;
+
+// Inicializador estático a partir de um armazenamento 'tipo storage[NUM_CORES][capacidade]'
+#define CORE_RING_INIT(storage) { \
+    .records = (uint8_t *)(storage), \
+    .record_size = sizeof((storage)[0][0]), \
+    .capacity = sizeof((storage)[0]) / sizeof((storage)[0][0]) \
+}
+
+void *core_ring_claim(core_ring_t *ring, uint8_t core);
+
+void core_ring_publish(core_ring_t *ring, uint8_t core);
+
+bool core_ring_take(core_ring_t *ring, void *record);
+
+uint32_t core_ring_dropped(const core_ring_t *ring, uint8_t core);
+
+#endif //CORE_RING_H
@@ -0,0 +1,43 @@
+#ifndef DIAGNOSTICS_H
+#define DIAGNOSTICS_H
+
+#include "events.h"
+#include "notifications.h"
+#include "pico/platform.h"
+
+#define DIAGNOSTICS_MAX_TASKS 20
+#define DIAGNOSTICS_NAME_LEN 12         // name without the "Task " prefix
+#define DIAGNOSTICS_CORES NUM_CORES        // the page always shows both cores (the host build runs one)
+#define DIAGNOSTICS_ANY_CORE 0xFF
+
+// Uma task na última janela de amostragem
+typedef struct {
+    char name[DIAGNOSTICS_NAME_LEN];
+    uint8_t core;                   // pinned core, or DIAGNOSTICS_ANY_CORE
+    uint8_t priority;
+    uint16_t cpu_permille;          // share of one core
+    uint16_t stack_free_words;      // high-water mark (minimum ever free)
+} diagnostics_task_t;
+
+// Amostra compacta do estado do sistema
+typedef struct {
+    uint32_t window_us;
+    uint16_t core_load_permille[DIAGNOSTICS_CORES];
+    uint32_t context_switches[DIAGNOSTICS_CORES];   // during the window
+    uint32_t heap_min_free;         // C library heap, lowest since boot; the kernel has none
+    notifications_stats_t notifications; // since boot
+    uint8_t task_count;
+    diagnostics_task_t tasks[DIAGNOSTICS_MAX_TASKS]; // busiest first
+} diagnostics_t;
+
+void diagnostics_init(void);
+
+void diagnostics_task_switched_in(void);
+
+bool diagnostics_sample(void);
+
+bool diagnostics_read(diagnostics_t *diagnostics);
+
+void diagnostics_print(const diagnostics_t *diagnostics);
+
+#endif // DIAGNOSTICS_H
\ No newline at end of file
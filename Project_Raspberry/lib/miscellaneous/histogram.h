@@ -0,0 +1,66 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <stdint.h>
+
+/*
+ * Histograma logarítmico de tempos em microssegundos, compartilhado pelos jobs
+ * periódicos e pelo rastreio de latência: abaixo de 4 us cada valor tem o seu
+ * índice; acima, cada oitava é dividida em 4 faixas (erro relativo de no máximo 25%).
+ */
+
+/**
+ * @brief Índice do histograma de um tempo.
+ * * @param value_us O tempo em microssegundos.
+ * @param buckets Quantidade de índices; tempos maiores caem no último.
+ */
+static inline uint8_t histogram_bucket(uint32_t value_us, uint8_t buckets){
+    if(value_us < 4) return (uint8_t)value_us;
+
+    uint32_t octave = 31 - __builtin_clz(value_us);
+    uint32_t bucket = (octave - 1) * 4 + ((value_us >> (octave - 2)) & 3);
+
+    return bucket < buckets ? (uint8_t)bucket : (uint8_t)(buckets - 1);
+}
+
+/**
+ * @brief Maior tempo (us) que cai em um índice do histograma.
+ * * @param bucket O índice do histograma.
+ */
+static inline uint32_t histogram_upper_bound(uint8_t bucket){
+    if(bucket < 4) return bucket;
+
+    uint32_t octave = bucket / 4 + 1;
+    uint32_t sub = bucket % 4;
+
+    return ((5 + sub) << (octave - 2)) - 1;
+}
+
+/**
+ * @brief Calcula um percentil a partir do histograma.
+ * @note O resultado é o limite superior da faixa, limitado ao máximo observado.
+ * * @param histogram As contagens.
+ * @param buckets Quantidade de índices.
+ * @param count Total de contagens.
+ * @param max_us O maior tempo observado.
+ * @param percent O percentil desejado (1 a 100).
+ */
+static inline uint32_t histogram_percentile(const uint32_t *histogram, uint8_t buckets,
+                                            uint32_t count, uint32_t max_us, uint32_t percent){
+    if(count == 0) return 0;
+
+    uint32_t target = (uint32_t)(((uint64_t)count * percent + 99) / 100);
+    uint32_t accumulated = 0;
+
+    for(uint8_t i = 0; i < buckets; i++){
+        accumulated += histogram[i];
+        if(accumulated >= target){
+            uint32_t bound = histogram_upper_bound(i);
+            return bound < max_us ? bound : max_us;
+        }
+    }
+
+    return max_us;
+}
+
+#endif // HISTOGRAM_H
\ No newline at end of file
@@ -0,0 +1,58 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define LATENCY_HISTOGRAM_BUCKETS 88    // 4 buckets per octave, up to ~8 s
+
+// Pontos de rastreio, na ordem do caminho de uma amostra até o FPGA
+typedef enum {
+    LATENCY_SAMPLED,        // sample that decided the alerts (producers, see sensor_pipeline)
+    LATENCY_ANALYZED,       // analyzer_process_data done (task_sensors)
+    LATENCY_PUBLISHED,      // handed to mailbox_normalized_sensors_data (task_sensors)
+    LATENCY_PICKED,         // read from the mailbox (task_handshake)
+    LATENCY_REQUESTED,      // REQ raised, first attempt
+    LATENCY_ACKNOWLEDGED,   // ACK seen
+    LATENCY_POINTS
+} latency_point_t;
+
+// Etapas medidas: entre pontos consecutivos e, por último, de ponta a ponta
+#define LATENCY_STAGES LATENCY_POINTS
+#define LATENCY_END_TO_END (LATENCY_STAGES - 1)
+
+// Rastro de uma amostra, levado junto com os dados normalizados
+typedef struct {
+    uint32_t id;                        // 0 = not traced
+    uint32_t at_us[LATENCY_POINTS];     // time_us_32
+    uint8_t reached;                    // bit per latency_point_t
+} latency_trace_t;
+
+// Estatísticas de uma etapa, copiadas de forma consistente
+typedef struct {
+    const char *name;
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint32_t p50_us;
+    uint32_t p90_us;
+    uint32_t p99_us;
+} latency_stats_t;
+
+void latency_begin(latency_trace_t *trace, uint32_t sampled_us);
+
+void latency_mark(latency_trace_t *trace, latency_point_t point);
+
+void latency_mark_at(latency_trace_t *trace, latency_point_t point, uint32_t at_us);
+
+void latency_complete(const latency_trace_t *trace);
+
+bool latency_get_stats(uint8_t stage, latency_stats_t *stats);
+
+uint32_t latency_superseded(void);
+
+void latency_reset_stats(void);
+
+void latency_print_stats(void);
+
+#endif // LATENCY_H
\ No newline at end of file
@@ -0,0 +1,68 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define LOG_MAX_ARGS 3
+#define LOG_RING_SIZE 64            // records per core, power of two
+
+#define LOG_FRAME_SYNC_0 0xA5
+#define LOG_FRAME_SYNC_1 0x5A
+#define LOG_TEXT_SYNC_1 0x5B        // second sync byte of a text frame
+
+// Quadro de texto: sincronismo, tamanho, até LOG_TEXT_MAX bytes e soma do tamanho e do texto
+#define LOG_TEXT_MAX 160
+#define LOG_TEXT_FRAME_SIZE(length) (3 + (length) + 1)
+
+// Identificadores das mensagens (log_messages.def)
+typedef enum {
+#define LOG_MESSAGE(id, format) id,
+#include "log_messages.def"
+#undef LOG_MESSAGE
+    LOG_MESSAGES_COUNT
+} log_id_t;
+
+// Registro binário: identificador, instante e argumentos crus (sem formatação)
+typedef struct __attribute__((packed)) {
+    uint16_t id;
+    uint8_t argc;
+    uint8_t core;
+    uint32_t timestamp_us;
+    uint32_t args[LOG_MAX_ARGS];
+} log_record_t;
+
+// Quadro enviado ao console: sincronismo, registro e soma dos bytes do registro
+typedef struct __attribute__((packed)) {
+    uint8_t sync[2];
+    log_record_t record;
+    uint8_t checksum;
+} log_frame_t;
+
+void log_event(log_id_t id, uint8_t argc, uint32_t arg0, uint32_t arg1, uint32_t arg2);
+
+bool log_take(log_record_t *record);
+
+uint32_t log_dropped(uint8_t core);
+
+void log_frame(const log_record_t *record, log_frame_t *frame);
+
+void log_text(const char *format, ...) __attribute__((format(printf, 1, 2)));
+
+/**
+ * @brief Converte um float em argumento do log (bits crus, decodificados no host).
+ * * @param value O valor.
+ */
+static inline uint32_t log_float(float value){
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+#define LOG(id)                 log_event((id), 0, 0, 0, 0)
+#define LOG1(id, a)             log_event((id), 1, (uint32_t)(a), 0, 0)
+#define LOG2(id, a, b)          log_event((id), 2, (uint32_t)(a), (uint32_t)(b), 0)
+#define LOG3(id, a, b, c)       log_event((id), 3, (uint32_t)(a), (uint32_t)(b), (uint32_t)(c))
+
+#endif // LOG_H
\ No newline at end of file
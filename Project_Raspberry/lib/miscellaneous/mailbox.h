@@ -0,0 +1,23 @@
+#ifndef MAILBOX_H
+#define MAILBOX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Caixa de último valor: um escritor, vários leitores, sem bloqueio (seqlock + buffer duplo)
+typedef struct {
+    volatile uint32_t sequence;  // odd while a publication is being written; publications = sequence / 2
+    void *buffers[2];
+    size_t size;
+} mailbox_t;
+
+void mailbox_init(mailbox_t *mailbox, void *buffer_a, void *buffer_b, size_t size);
+
+void mailbox_publish(mailbox_t *mailbox, const void *value);
+
+bool mailbox_read(const mailbox_t *mailbox, void *value, uint32_t *publication);
+
+bool mailbox_read_if_new(const mailbox_t *mailbox, void *value, uint32_t *last_publication);
+
+#endif //MAILBOX_H
\ No newline at end of file
@@ -3,6 +3,22 @@
 
 #include "events.h"
 
+#define NOTIFICATIONS_RING_SIZE 8 // pending notifications not yet shown
+
+// Contadores do anel de notificações
+typedef struct {
+    uint32_t sent;
+    uint32_t coalesced;     // merged into a pending identical notification
+    uint32_t dropped;       // discarded (new or evicted) because the ring was full
+    uint8_t pending;
+} notifications_stats_t;
+
+bool notifications_init(void);
+
 void send_notification(notification_type_t type, char *message);
 
+bool receive_notification(notification_t *notification);
+
+void notifications_get_stats(notifications_stats_t *stats);
+
 #endif // NOTIFICATION_H
\ No newline at end of file
@@ -0,0 +1,59 @@
+#ifndef PERIODIC_JOB_H
+#define PERIODIC_JOB_H
+
+#include "events.h"
+
+#define PERIODIC_JOB_MAX_JOBS 8
+#define PERIODIC_JOB_HISTOGRAM_BUCKETS 92 // 4 buckets per octave, up to ~8 s
+
+// Job periódico liberado em instantes absolutos (vTaskDelayUntil)
+typedef struct {
+    const char *name;
+    TickType_t last_wake;
+    uint32_t period_ms;
+    uint32_t deadline_us;   // relative to the expected release
+    uint64_t release_us;    // expected release of the current cycle
+    bool started;
+
+    uint32_t cycles;
+    uint32_t deadline_misses;
+    uint32_t jitter_min_us;
+    uint32_t jitter_max_us;
+    uint32_t response_min_us;
+    uint32_t response_max_us;
+    uint32_t histogram[PERIODIC_JOB_HISTOGRAM_BUCKETS]; // response times
+} periodic_job_t;
+
+// Estatísticas de um job, copiadas de forma consistente
+typedef struct {
+    const char *name;
+    uint32_t period_ms;
+    uint32_t deadline_us;
+    uint32_t cycles;
+    uint32_t deadline_misses;
+    uint32_t jitter_min_us;
+    uint32_t jitter_max_us;
+    uint32_t response_min_us;
+    uint32_t response_max_us;
+    uint32_t response_p50_us;
+    uint32_t response_p90_us;
+    uint32_t response_p99_us;
+} periodic_job_stats_t;
+
+bool periodic_job_init(periodic_job_t *job, const char *name, uint32_t period_ms, uint32_t deadline_ms);
+
+void periodic_job_set_period(periodic_job_t *job, uint32_t period_ms);
+
+void periodic_job_release(periodic_job_t *job);
+
+void periodic_job_wait(periodic_job_t *job);
+
+void periodic_job_reset_stats(periodic_job_t *job);
+
+uint8_t periodic_job_count(void);
+
+bool periodic_job_get_stats(uint8_t index, periodic_job_stats_t *stats);
+
+void periodic_job_print_stats(void);
+
+#endif //PERIODIC_JOB_H
\ No newline at end of file
@@ -0,0 +1,9 @@
+#ifndef RTOS_MEMORY_H
+#define RTOS_MEMORY_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+bool rtos_memory_is_idle_task(TaskHandle_t task);
+
+#endif // RTOS_MEMORY_H
\ No newline at end of file
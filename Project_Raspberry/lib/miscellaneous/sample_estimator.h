@@ -0,0 +1,33 @@
+#ifndef SAMPLE_ESTIMATOR_H
+#define SAMPLE_ESTIMATOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "fixed_point.h"
+
+// Filtro de Kalman escalar (passeio aleatório) sobre as amostras brutas de um canal
+typedef struct {
+    fixed_t estimate;           // estimated ADC code (Q16.16)
+    fixed_t variance;           // estimate variance, in ADC codes² (Q16.16)
+    fixed_t process_noise;      // variance added per sample, in ADC codes² (Q16.16)
+    fixed_t measurement_noise;  // variance of a single conversion, in ADC codes² (Q16.16)
+    fixed_t gate;               // outlier gate, in standard deviations of the innovation (Q16.16)
+    uint8_t max_rejects;        // consecutive outliers accepted as a real step change
+    uint8_t rejects;
+    bool ready;
+} sample_estimator_t;
+
+void sample_estimator_init(sample_estimator_t *estimator, fixed_t measurement_noise, fixed_t gate,
+                           uint8_t max_rejects, uint8_t window);
+
+void sample_estimator_set_window(sample_estimator_t *estimator, uint8_t window);
+
+bool sample_estimator_update(sample_estimator_t *estimator, int16_t sample);
+
+bool sample_estimator_is_ready(const sample_estimator_t *estimator);
+
+int16_t sample_estimator_value(const sample_estimator_t *estimator);
+
+fixed_t sample_estimator_variance(const sample_estimator_t *estimator);
+
+#endif //SAMPLE_ESTIMATOR_H
\ No newline at end of file
@@ -0,0 +1,32 @@
+#ifndef SAMPLE_FILTER_H
+#define SAMPLE_FILTER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SAMPLE_FILTER_MAX_WINDOW 32
+
+// Janela deslizante de amostras brutas, mantida também ordenada
+typedef struct {
+    int16_t ring[SAMPLE_FILTER_MAX_WINDOW];   // samples in arrival order
+    int16_t sorted[SAMPLE_FILTER_MAX_WINDOW]; // same samples, ascending
+    uint8_t window;
+    uint8_t trim;       // samples discarded on each side when the window is full
+    uint8_t size;
+    uint8_t head;
+    int32_t sum;        // sum of every sample in the window
+    int32_t low_sum;    // sum of the 'trim' lowest samples
+    int32_t high_sum;   // sum of the 'trim' highest samples
+} sample_filter_t;
+
+bool sample_filter_init(sample_filter_t *filter, uint8_t window, uint8_t trim);
+
+void sample_filter_push(sample_filter_t *filter, int16_t sample);
+
+uint8_t sample_filter_count(const sample_filter_t *filter);
+
+int16_t sample_filter_median(const sample_filter_t *filter);
+
+int16_t sample_filter_trimmed_mean(const sample_filter_t *filter);
+
+#endif //SAMPLE_FILTER_H
\ No newline at end of file
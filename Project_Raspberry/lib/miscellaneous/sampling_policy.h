@@ -0,0 +1,45 @@
+#ifndef SAMPLING_POLICY_H
+#define SAMPLING_POLICY_H
+
+#include "events.h"
+
+// Sensor loop period: fastest near the limits, slowest well inside the safe band
+#define SAMPLING_MIN_INTERVAL_MS 125
+#define SAMPLING_MAX_INTERVAL_MS 1000
+
+// Equivalent estimator windows (raw samples): shortest near the limits
+#define SAMPLING_PH_MIN_WINDOW 5
+#define SAMPLING_PH_MAX_WINDOW 10
+#define SAMPLING_TDS_MIN_WINDOW 9
+#define SAMPLING_TDS_MAX_WINDOW 30
+
+// ADS1115 data rate while calm and while approaching a limit
+#define SAMPLING_CALM_ADC_RATE_SPS 16
+#define SAMPLING_ACTIVE_ADC_RATE_SPS 128
+
+// Safety margin (fraction of the half band, 1 = center): ramp from fastest to slowest
+#define SAMPLING_ALERT_MARGIN FIXED_FROM_FLOAT(0.15f)
+#define SAMPLING_CALM_MARGIN FIXED_FROM_FLOAT(0.60f)
+
+// Largest step toward the calm profile per cycle; speeding up is immediate
+#define SAMPLING_RELAX_STEP (FIXED_ONE / 8)
+
+// sampling_policy_pin(): back to the margin-driven profile
+#define SAMPLING_POLICY_ADAPTIVE (-FIXED_ONE)
+
+// Parâmetros de amostragem escolhidos para o próximo ciclo
+typedef struct {
+    fixed_t margin;
+    uint32_t interval_ms;
+    uint8_t ph_window;
+    uint8_t tds_window;
+    uint16_t adc_rate_sps;
+} sampling_profile_t;
+
+fixed_t sampling_policy_margin(sensors_data_t data);
+
+sampling_profile_t sampling_policy_update(sensors_data_t data);
+
+void sampling_policy_pin(fixed_t level);
+
+#endif //SAMPLING_POLICY_H
\ No newline at end of file
@@ -11,6 +11,8 @@ bool analyzer_is_temperature_alert(celsius_t temperature);
 
 bool analyzer_is_ph_alert(ph_t ph);
 
+ppm_t analyzer_get_max_tds(sensors_data_t data);
+
 bool analyzer_is_tds_alert(sensors_data_t data);
 
 #endif //SENSOR_ANALYZER_H
\ No newline at end of file
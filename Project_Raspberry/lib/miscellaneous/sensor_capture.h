@@ -0,0 +1,42 @@
+#ifndef SENSOR_CAPTURE_H
+#define SENSOR_CAPTURE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef CAPTURE_MAX_RECORDS
+#define CAPTURE_MAX_RECORDS 2048    // 16 KB of RAM
+#endif
+#define CAPTURE_VERSION 1
+#define CAPTURE_DUMP_RECORDS_PER_LINE 8
+
+// Origem de um registro
+typedef enum {
+    CAPTURE_SOURCE_ADC = 0,         // raw ADS1115 code, channel = logical channel
+    CAPTURE_SOURCE_TEMPERATURE = 1  // raw DS18B20 reading (1/16 ºC), channel = probe index
+} capture_source_t;
+
+// Registro de 8 bytes (little-endian, sem preenchimento)
+typedef struct __attribute__((packed)) {
+    uint32_t timestamp_us;  // since capture_start()
+    uint8_t source;
+    uint8_t channel;
+    int16_t raw;
+} capture_record_t;
+
+void capture_start(void);
+
+void capture_stop(void);
+
+bool capture_is_active(void);
+
+bool capture_is_full(void);
+
+void capture_record(capture_source_t source, uint8_t channel, int16_t raw);
+
+size_t capture_get_records(const capture_record_t **records);
+
+void capture_dump(void);
+
+#endif //SENSOR_CAPTURE_H
\ No newline at end of file
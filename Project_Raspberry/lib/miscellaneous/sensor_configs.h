@@ -1,17 +1,35 @@
 #ifndef SENSOR_CONFIGS_H
 #define SENSOR_CONFIGS_H
 
+#include "fixed_point.h"
+#include "ads1115.h"
+
+// Analog inputs (logical channel: ADS1115_CHANNEL(device, input))
+#define PH_ADC_CHANNEL ADS1115_CHANNEL(0, 0)
+#define TDS_ADC_CHANNEL ADS1115_CHANNEL(0, 1)
+
+// Estimators (noise of one conversion in ADC codes², outlier gate in standard deviations)
+#define PH_MEASUREMENT_NOISE FIXED_FROM_INT(16)
+#define PH_OUTLIER_GATE FIXED_FROM_INT(4)
+#define PH_MAX_REJECTS 3
+#define TDS_MEASUREMENT_NOISE FIXED_FROM_INT(64)
+#define TDS_OUTLIER_GATE FIXED_FROM_INT(3)
+#define TDS_MAX_REJECTS 3
+
+// Raw sample capture (1 = on): records from boot until the buffer is full, then dumps it to the console
+#define SENSOR_CAPTURE_ENABLED 0
+
 // Temperature thresholds
-#define MIN_TEMPERATURE_CELSIUS 24.0f
-#define MAX_TEMPERATURE_CELSIUS 30.0f
+#define MIN_TEMPERATURE_CELSIUS FIXED_FROM_FLOAT(24.0f)
+#define MAX_TEMPERATURE_CELSIUS FIXED_FROM_FLOAT(30.0f)
 
 // PH thresholds
-#define MIN_PH 6.0f
-#define MAX_PH 8.0f
-#define PH_FACTOR 0.5f
+#define MIN_PH FIXED_FROM_FLOAT(6.0f)
+#define MAX_PH FIXED_FROM_FLOAT(8.0f)
+#define PH_FACTOR FIXED_FROM_FLOAT(0.5f)
 
 // TDS thresholds
-#define MAX_DEFAULT_TDS 750.0f
+#define MAX_DEFAULT_TDS FIXED_FROM_FLOAT(750.0f)
 
 
 #endif //SENSOR_CONFIGS_H
\ No newline at end of file
@@ -0,0 +1,57 @@
+#ifndef SENSOR_HISTORY_H
+#define SENSOR_HISTORY_H
+
+#include "events.h"
+
+// Each tier is a ring of blocks: one absolute point (keyframe) followed by 8-bit deltas
+#define HISTORY_BLOCK_POINTS 32
+
+// Blocks per tier; nominal span with full blocks: (blocks - 1) x 32 points
+#define HISTORY_SECONDS_BLOCKS 20   // > 10 min of 1 s points
+#define HISTORY_MINUTES_BLOCKS 46   // > 24 h of 1 min aggregates
+#define HISTORY_HOURS_BLOCKS 7      // > 8 days of 1 h aggregates
+
+// Periods without samples repeated from the previous point; longer gaps start a new block
+#define HISTORY_MAX_HOLD_PERIODS 2
+
+// Resolução de cada sensor no histórico (quantum = 2^-shift da unidade)
+#define HISTORY_TEMPERATURE_SHIFT 12    // 1/16 ºC, the DS18B20 resolution
+#define HISTORY_PH_SHIFT 8              // 1/256 pH, about one ADS1115 code
+#define HISTORY_TDS_SHIFT 16            // 1 ppm
+
+// Camadas do histórico
+typedef enum {
+    HISTORY_TIER_SECONDS,           // mean of each second
+    HISTORY_TIER_MINUTES,           // min/mean/max of each minute
+    HISTORY_TIER_HOURS,             // min/mean/max of each hour
+    HISTORY_TIERS
+} history_tier_t;
+
+// Mínimo, média e máximo de um sensor no período (iguais na camada de segundos)
+typedef struct {
+    fixed_t min;
+    fixed_t mean;
+    fixed_t max;
+} history_value_t;
+
+// Um ponto de uma camada
+typedef struct {
+    uint32_t time_s;                // start of the period, seconds since boot
+    history_value_t temperature;
+    history_value_t ph;
+    history_value_t tds;
+} history_point_t;
+
+bool sensor_history_init(void);
+
+void sensor_history_record(const sensors_data_t *data);
+
+void sensor_history_record_at(const sensors_data_t *data, uint32_t now_s);
+
+size_t sensor_history_count(history_tier_t tier);
+
+size_t sensor_history_latest(history_tier_t tier, history_point_t *points, size_t max_points);
+
+void sensor_history_print_stats(void);
+
+#endif //SENSOR_HISTORY_H
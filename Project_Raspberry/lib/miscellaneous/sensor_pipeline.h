@@ -0,0 +1,31 @@
+#ifndef SENSOR_PIPELINE_H
+#define SENSOR_PIPELINE_H
+
+#include "events.h"
+#include "sensor_snapshot.h"
+#include "sampling_policy.h"
+
+// Canais sem publicação recente (máscaras de sensor_pipeline_t)
+#define SENSOR_STALE_TEMPERATURE (1u << 0)
+#define SENSOR_STALE_PH          (1u << 1)
+#define SENSOR_STALE_TDS         (1u << 2)
+
+// Alertas de um ciclo: os bits dos canais acima e o do botão
+#define SENSOR_ALERT_BUTTON      (1u << 3)
+
+// Estado do processamento entre ciclos (task_sensors e sensor_replay)
+typedef struct {
+    uint32_t handled_presses;
+    uint8_t stale;          // SENSOR_STALE_... of the last cycle
+    uint8_t new_stale;      // channels that went stale in the last cycle
+    uint8_t alerts;         // alert bits of the last cycle's normalized data
+    uint64_t trigger_us;    // sample that decided the last cycle's alerts (latency trace)
+} sensor_pipeline_t;
+
+void sensor_pipeline_init(sensor_pipeline_t *pipeline);
+
+sampling_profile_t sensor_pipeline_process(sensor_pipeline_t *pipeline, const sensor_snapshot_t *snapshot,
+                                           uint64_t now_us, sensors_data_t *data,
+                                           normalized_sensors_data_t *normalized_data);
+
+#endif //SENSOR_PIPELINE_H
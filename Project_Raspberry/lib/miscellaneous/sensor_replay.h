@@ -0,0 +1,23 @@
+#ifndef SENSOR_REPLAY_H
+#define SENSOR_REPLAY_H
+
+#include "events.h"
+#include "sensor_capture.h"
+
+// Resultado de uma reprodução
+typedef struct {
+    uint32_t records;
+    uint32_t cycles;
+    uint32_t adc_samples;       // conversions fed to the drivers (one I2C read each)
+    uint32_t alert_changes;
+    uint64_t elapsed_us;
+    uint32_t records_per_second;
+} replay_report_t;
+
+// Chamado a cada mudança de qualquer alerta (linha do tempo de alertas)
+typedef void (*replay_alert_callback_t)(uint32_t timestamp_us, sensors_data_t data, normalized_sensors_data_t alerts);
+
+bool sensor_replay_run(const capture_record_t *records, size_t count, bool resample,
+                       replay_alert_callback_t on_alert_change, replay_report_t *report);
+
+#endif //SENSOR_REPLAY_H
\ No newline at end of file
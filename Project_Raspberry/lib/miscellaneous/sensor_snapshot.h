@@ -0,0 +1,33 @@
+#ifndef SENSOR_SNAPSHOT_H
+#define SENSOR_SNAPSHOT_H
+
+#include "events.h"
+
+// Últimos valores publicados por cada produtor, com o instante da publicação
+typedef struct {
+    celsius_t temperature;
+    ph_t ph;
+    ppm_t tds;
+    bool button_state;
+    uint32_t button_presses;    // confirmed presses since boot: a press between two reads is not lost
+    uint64_t temperature_us;    // 0 = never published
+    uint64_t ph_us;
+    uint64_t tds_us;
+    uint64_t button_us;
+} sensor_snapshot_t;
+
+void sensor_snapshot_publish_temperature(celsius_t temperature);
+
+void sensor_snapshot_publish_ph(ph_t ph);
+
+void sensor_snapshot_publish_tds(ppm_t tds);
+
+void sensor_snapshot_publish_button(bool button_state, bool pressed);
+
+void sensor_snapshot_read(sensor_snapshot_t *snapshot);
+
+bool sensor_snapshot_is_complete(const sensor_snapshot_t *snapshot);
+
+uint32_t sensor_snapshot_age_ms(uint64_t published_us, uint64_t now_us);
+
+#endif //SENSOR_SNAPSHOT_H
\ No newline at end of file
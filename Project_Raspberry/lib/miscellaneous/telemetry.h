@@ -0,0 +1,24 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include "events.h"
+#include "telemetry_format.h"
+
+#define TELEMETRY_ENABLED 1
+#define TELEMETRY_RING_SIZE 32      // records per core, power of two
+
+void telemetry_sensors(const sensors_data_t *data);
+
+void telemetry_normalized(const normalized_sensors_data_t *data);
+
+void telemetry_alert(telemetry_sensor_t sensor, bool active, fixed_t value);
+
+void telemetry_link(bool success, uint8_t attempts);
+
+bool telemetry_take(telemetry_record_t *record);
+
+uint32_t telemetry_dropped(uint8_t core);
+
+size_t telemetry_encode(const telemetry_record_t *record, uint8_t *frame);
+
+#endif // TELEMETRY_H
\ No newline at end of file
@@ -0,0 +1,116 @@
+#ifndef TELEMETRY_FORMAT_H
+#define TELEMETRY_FORMAT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * Formato da telemetria binária (compartilhado com tools/telemetry_decode.cpp).
+ * Quadro no console: 0x00 | COBS(registro + CRC-16) | 0x00
+ * - registro: telemetry_record_t, little-endian, apenas os bytes do tipo;
+ * - CRC-16/CCITT-FALSE (0x1021, início 0xFFFF) sobre o registro, little-endian;
+ * - os dois delimitadores isolam o quadro de qualquer outro byte do console.
+ * Valores de sensores em Q16.16 (fixed_t), como no firmware.
+ */
+
+#define TELEMETRY_VERSION 1
+
+// Tipos de registro
+typedef enum {
+    TELEMETRY_SENSORS = 1,
+    TELEMETRY_NORMALIZED,
+    TELEMETRY_ALERT,
+    TELEMETRY_LINK
+} telemetry_type_t;
+
+// Sensor de um evento de alerta
+typedef enum {
+    TELEMETRY_SENSOR_TEMPERATURE,
+    TELEMETRY_SENSOR_PH,
+    TELEMETRY_SENSOR_TDS
+} telemetry_sensor_t;
+
+// Bits de telemetry_normalized_t.flags
+#define TELEMETRY_FLAG_TEMPERATURE (1u << 0)
+#define TELEMETRY_FLAG_PH          (1u << 1)
+#define TELEMETRY_FLAG_TDS         (1u << 2)
+#define TELEMETRY_FLAG_BUTTON      (1u << 3)
+
+typedef struct __attribute__((packed)) {
+    int32_t temperature;    // Q16.16 Celsius
+    int32_t ph;             // Q16.16
+    int32_t tds;            // Q16.16 ppm
+    uint8_t button_state;
+} telemetry_sensors_t;
+
+typedef struct __attribute__((packed)) {
+    uint8_t flags;          // TELEMETRY_FLAG_...
+} telemetry_normalized_t;
+
+typedef struct __attribute__((packed)) {
+    uint8_t sensor;         // telemetry_sensor_t
+    uint8_t active;         // 1 raised, 0 cleared
+    int32_t value;          // Q16.16 reading that changed the state
+} telemetry_alert_t;
+
+typedef struct __attribute__((packed)) {
+    uint8_t success;
+    uint8_t attempts;
+} telemetry_link_t;
+
+// Cabeçalho comum; a sequência é contada por core, na ordem de registro
+typedef struct __attribute__((packed)) {
+    uint8_t type;           // telemetry_type_t
+    uint8_t core;
+    uint16_t sequence;
+    uint32_t timestamp_us;
+} telemetry_header_t;
+
+typedef struct __attribute__((packed)) {
+    telemetry_header_t header;
+    union __attribute__((packed)) {
+        telemetry_sensors_t sensors;
+        telemetry_normalized_t normalized;
+        telemetry_alert_t alert;
+        telemetry_link_t link;
+    } body;
+} telemetry_record_t;
+
+#define TELEMETRY_CRC_SIZE 2
+#define TELEMETRY_MAX_PAYLOAD (sizeof(telemetry_record_t) + TELEMETRY_CRC_SIZE)
+#define TELEMETRY_MAX_FRAME (TELEMETRY_MAX_PAYLOAD + TELEMETRY_MAX_PAYLOAD / 254 + 1 + 2) // COBS + delimiters
+
+/**
+ * @brief Tamanho em bytes de um registro do tipo indicado (cabeçalho + corpo).
+ * * @param type O tipo do registro.
+ * @return O tamanho, ou 0 para um tipo desconhecido.
+ */
+static inline size_t telemetry_record_size(uint8_t type){
+    switch(type){
+        case TELEMETRY_SENSORS: return sizeof(telemetry_header_t) + sizeof(telemetry_sensors_t);
+        case TELEMETRY_NORMALIZED: return sizeof(telemetry_header_t) + sizeof(telemetry_normalized_t);
+        case TELEMETRY_ALERT: return sizeof(telemetry_header_t) + sizeof(telemetry_alert_t);
+        case TELEMETRY_LINK: return sizeof(telemetry_header_t) + sizeof(telemetry_link_t);
+        default: return 0;
+    }
+}
+
+/**
+ * @brief CRC-16/CCITT-FALSE.
+ * * @param data Os bytes.
+ * @param length A quantidade de bytes.
+ */
+static inline uint16_t telemetry_crc16(const uint8_t *data, size_t length){
+    uint16_t crc = 0xFFFF;
+
+    for(size_t i = 0; i < length; i++){
+        crc ^= (uint16_t)data[i] << 8;
+        for(uint8_t bit = 0; bit < 8; bit++){
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+#endif // TELEMETRY_FORMAT_H
\ No newline at end of file
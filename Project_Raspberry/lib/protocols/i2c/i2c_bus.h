@@ -0,0 +1,77 @@
+#ifndef I2C_BUS_H
+#define I2C_BUS_H
+
+#include "i2c_configs.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define I2C_BUS_COUNT 2
+#define I2C_BUS_QUEUE_LENGTH 8
+#define I2C_BUS_MAX_WORDS 1040      // DMA command words per transaction (fits a full OLED frame)
+#define I2C_BUS_TIMEOUT_MS 100
+#define I2C_BUS_NOTIFY_INDEX 1      // task notification slot used to wake the submitters
+
+// Tipos de transação
+typedef enum {
+    I2C_BUS_WRITE,          // tx bytes, then STOP
+    I2C_BUS_WRITE_READ,     // tx bytes, repeated START, rx bytes, then STOP
+    I2C_BUS_COMMAND_LIST    // one [control, tx[i]] write per byte of tx, each with its own STOP
+} i2c_transaction_kind_t;
+
+typedef enum {
+    I2C_BUS_IDLE,
+    I2C_BUS_PENDING,
+    I2C_BUS_DONE,
+    I2C_BUS_FAILED
+} i2c_transaction_status_t;
+
+typedef struct i2c_transaction i2c_transaction_t;
+
+typedef void (*i2c_transaction_callback_t)(i2c_transaction_t *transaction, bool success);
+
+// Transação; a memória (e os buffers) pertencem ao chamador até a conclusão
+struct i2c_transaction {
+    i2c_transaction_kind_t kind;
+    uint8_t address;
+    uint8_t control;                        // control byte of I2C_BUS_COMMAND_LIST
+    const uint8_t *tx;
+    size_t tx_len;
+    uint8_t *rx;
+    size_t rx_len;
+    i2c_transaction_callback_t callback;    // runs in the bus task, before the status changes (optional)
+    void *context;
+    TaskHandle_t waiter;                    // set by i2c_bus_submit()
+    volatile i2c_transaction_status_t status;
+};
+
+// Contadores de um barramento
+typedef struct {
+    uint32_t submitted;
+    uint32_t completed;
+    uint32_t failed;
+    uint32_t rejected;      // queue full or transaction still pending
+    uint32_t bytes;
+    uint8_t queue_depth;
+    uint8_t max_queue_depth;
+    uint64_t busy_us;
+    uint64_t elapsed_us;
+    uint8_t utilization_percent;
+} i2c_bus_stats_t;
+
+bool i2c_bus_init(i2c_inst_t *port);
+
+bool i2c_bus_submit(i2c_inst_t *port, i2c_transaction_t *transaction);
+
+bool i2c_bus_submit_wait(i2c_inst_t *port, i2c_transaction_t *transaction, TickType_t timeout);
+
+bool i2c_bus_wait(i2c_transaction_t *transaction, TickType_t timeout);
+
+bool i2c_bus_transfer(i2c_inst_t *port, i2c_transaction_t *transaction);
+
+bool i2c_bus_is_busy(const i2c_transaction_t *transaction);
+
+bool i2c_bus_get_stats(i2c_inst_t *port, i2c_bus_stats_t *stats);
+
+void i2c_bus_reset_stats(i2c_inst_t *port);
+
+#endif //I2C_BUS_H
\ No newline at end of file
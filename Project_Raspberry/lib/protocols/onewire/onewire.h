@@ -0,0 +1,75 @@
+#ifndef ONEWIRE_H
+#define ONEWIRE_H
+
+#include "pico/stdlib.h"
+#include "pico/time.h"
+#include "FreeRTOS.h"
+#include "semphr.h"
+
+// --- Temporização dos slots (modo standard, em microssegundos) ---
+#define ONEWIRE_RESET_LOW_US 480
+#define ONEWIRE_PRESENCE_SAMPLE_US 70
+#define ONEWIRE_RESET_RECOVERY_US 410
+#define ONEWIRE_WRITE_ONE_LOW_US 6
+#define ONEWIRE_WRITE_ZERO_LOW_US 60
+#define ONEWIRE_READ_LOW_US 2
+#define ONEWIRE_READ_SAMPLE_US 8
+#define ONEWIRE_SLOT_US 65
+#define ONEWIRE_RECOVERY_US 5
+
+#define ONEWIRE_START_DELAY_US 10
+#define ONEWIRE_TIMEOUT_MS 50
+
+// --- Comandos de ROM ---
+#define ONEWIRE_CMD_SEARCH_ROM 0xF0
+#define ONEWIRE_CMD_MATCH_ROM 0x55
+#define ONEWIRE_CMD_SKIP_ROM 0xCC
+#define ONEWIRE_ROM_SIZE 8
+
+// Estados da máquina de slots
+typedef enum {
+    ONEWIRE_STATE_IDLE,
+    ONEWIRE_STATE_RESET,
+    ONEWIRE_STATE_RESET_RELEASE,
+    ONEWIRE_STATE_RESET_PRESENCE,
+    ONEWIRE_STATE_SLOT,
+    ONEWIRE_STATE_WRITE_ZERO_RELEASE
+} onewire_state_t;
+
+// Estrutura do barramento 1-Wire
+typedef struct {
+    uint pin;
+    volatile onewire_state_t state;
+    volatile bool presence;
+    const uint8_t *tx_buffer;
+    uint8_t *rx_buffer;
+    size_t tx_bits;
+    size_t rx_bits;
+    volatile size_t bit_index;
+    alarm_id_t alarm;
+    SemaphoreHandle_t done;
+    StaticSemaphore_t done_buffer;
+} onewire_t;
+
+// Estado do algoritmo de busca de ROM (Search ROM)
+typedef struct {
+    uint8_t rom[ONEWIRE_ROM_SIZE];
+    uint8_t last_discrepancy;
+    bool last_device;
+} onewire_search_t;
+
+bool onewire_init(onewire_t *bus, uint pin);
+
+uint32_t onewire_step(onewire_t *bus);
+
+bool onewire_transfer_bits(onewire_t *bus, bool reset, const uint8_t *tx, size_t tx_bits, uint8_t *rx, size_t rx_bits);
+
+bool onewire_transfer(onewire_t *bus, bool reset, const uint8_t *tx, size_t tx_len, uint8_t *rx, size_t rx_len);
+
+uint8_t onewire_crc8(const uint8_t *data, size_t len);
+
+void onewire_search_reset(onewire_search_t *search);
+
+bool onewire_search_next(onewire_t *bus, onewire_search_t *search, uint8_t *rom);
+
+#endif //ONEWIRE_H
@@ -0,0 +1,8 @@
+#ifndef DIAGNOSTICS_SCREEN_H
+#define DIAGNOSTICS_SCREEN_H
+
+#include "diagnostics.h"
+
+void show_diagnostics_screen(const diagnostics_t *diagnostics);
+
+#endif //DIAGNOSTICS_SCREEN_H
\ No newline at end of file
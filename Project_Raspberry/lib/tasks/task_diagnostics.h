@@ -0,0 +1,6 @@
+#ifndef TASK_DIAGNOSTICS_H
+#define TASK_DIAGNOSTICS_H
+
+void create_task_diagnostics(void);
+
+#endif //TASK_DIAGNOSTICS_H
\ No newline at end of file
@@ -0,0 +1,6 @@
+#ifndef TASK_LOG_H
+#define TASK_LOG_H
+
+void create_task_log(void);
+
+#endif //TASK_LOG_H
\ No newline at end of file
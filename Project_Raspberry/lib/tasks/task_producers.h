@@ -0,0 +1,10 @@
+#ifndef TASK_PRODUCERS_H
+#define TASK_PRODUCERS_H
+
+#include "sampling_policy.h"
+
+void create_task_producers(void);
+
+void producers_apply_profile(sampling_profile_t profile);
+
+#endif // TASK_PRODUCERS_H
\ No newline at end of file
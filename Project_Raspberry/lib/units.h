@@ -2,9 +2,10 @@
 #define UNITS_H
 
 #include <stdint.h>
+#include "fixed_point.h"
 
-typedef float celsius_t;   // Temperature in Celsius
-typedef float ph_t;        // pH value
-typedef float ppm_t;      // Parts per million
+typedef fixed_t celsius_t;   // Temperature in Celsius (Q16.16)
+typedef fixed_t ph_t;        // pH value (Q16.16)
+typedef fixed_t ppm_t;       // Parts per million (Q16.16)
 
 #endif // UNITS_H
\ No newline at end of file
@@ -0,0 +1,73 @@
+# Static RAM report per subsystem, run after each link:
+#   cmake -DNM=<nm> -DELF=<firmware.elf> -DSOURCE_DIR=<project dir> -P memory_report.cmake
+#
+# Every RAM symbol (.data/.bss) is attributed to a subsystem by its source file
+# (debug info, nm -l): src/components/<x>, src/protocols/<x>, src/tasks, ...
+# Symbols without a source in this project go to "freertos" or "sdk/libc".
+
+if(NOT NM OR NOT ELF OR NOT SOURCE_DIR)
+    message(FATAL_ERROR "memory_report.cmake: NM, ELF and SOURCE_DIR are required")
+endif()
+
+execute_process(
+    COMMAND ${NM} --print-size --line-numbers --size-sort ${ELF}
+    OUTPUT_VARIABLE nm_output
+    RESULT_VARIABLE nm_result
+)
+if(NOT nm_result EQUAL 0)
+    message(WARNING "memory_report.cmake: ${NM} failed, no report")
+    return()
+endif()
+
+get_filename_component(SOURCE_DIR "${SOURCE_DIR}" ABSOLUTE)
+string(REPLACE "\n" ";" nm_lines "${nm_output}")
+
+set(subsystems "")
+set(total 0)
+
+foreach(line IN LISTS nm_lines)
+    # <address> <size> <type> <name>[\t<file>:<line>]
+    if(NOT line MATCHES "^[0-9a-fA-F]+ ([0-9a-fA-F]+) ([bBdD]) ([^\t ]+)[\t ]*(.*)$")
+        continue()
+    endif()
+
+    math(EXPR size "0x${CMAKE_MATCH_1}")
+    set(location "${CMAKE_MATCH_4}")
+
+    if(location MATCHES "${SOURCE_DIR}/src/(components|protocols)/([^/]+)/")
+        set(subsystem "${CMAKE_MATCH_1}/${CMAKE_MATCH_2}")
+    elseif(location MATCHES "${SOURCE_DIR}/src/([^/]+)/")
+        set(subsystem "${CMAKE_MATCH_1}")
+    elseif(location MATCHES "${SOURCE_DIR}/src/main\\.c")
+        set(subsystem "main")
+    elseif(location MATCHES "FreeRTOS-Kernel")
+        set(subsystem "freertos")
+    else()
+        set(subsystem "sdk/libc")
+    endif()
+
+    string(MAKE_C_IDENTIFIER "${subsystem}" key)
+    if(NOT DEFINED ram_${key})
+        set(ram_${key} 0)
+        list(APPEND subsystems "${subsystem}")
+    endif()
+    math(EXPR ram_${key} "${ram_${key}} + ${size}")
+    math(EXPR total "${total} + ${size}")
+endforeach()
+
+list(SORT subsystems)
+set(column "                        ")
+
+message("Static RAM per subsystem (.data + .bss):")
+foreach(subsystem IN LISTS subsystems)
+    string(MAKE_C_IDENTIFIER "${subsystem}" key)
+    set(bytes "${ram_${key}}")
+    string(LENGTH "${subsystem}" name_length)
+    math(EXPR padding "24 - ${name_length}")
+    if(padding LESS 1)
+        set(padding 1)
+    endif()
+    string(SUBSTRING "${column}" 0 ${padding} spaces)
+    message("  ${subsystem}${spaces}${bytes} B")
+endforeach()
+message("  total                   ${total} B")
\ No newline at end of file
@@ -1,113 +1,242 @@
 #include "ds18b20.h"
+#include "onewire.h"
+#include "sensor_capture.h"
 #include "pico/stdlib.h"
-#include "hardware/gpio.h"
 #include "pico/time.h"
 #include "FreeRTOS.h"
 #include "task.h"
+#include <string.h>
 
 #define DS18B20_PIN 2 // gpio pin where the DS18B20 is connected
+#define DS18B20_CMD_CONVERT_T 0x44
+#define DS18B20_CMD_READ_SCRATCHPAD 0xBE
+#define DS18B20_SCRATCHPAD_SIZE 9
+#define DS18B20_POWER_ON_RAW 0x0550 // +85 ºC: the register's power-on value, before any conversion
+
+// Probe found on the bus
+typedef struct {
+    uint8_t rom[ONEWIRE_ROM_SIZE];
+    celsius_t temperature;
+    bool valid;
+} ds18b20_probe_t;
 
 /**
- * @brief Executa o procedimento de inicialização (reset e detecção de presença)
- * do barramento 1-Wire para o sensor DS18B20.
+ * @brief Barramento 1-Wire onde o DS18B20 está conectado.
  */
-static void init_procedure(){
-    gpio_set_dir(DS18B20_PIN, GPIO_OUT);
-    gpio_put(DS18B20_PIN, 0);
-    busy_wait_us(490);
+static onewire_t ds18b20_bus;
 
-    gpio_put(DS18B20_PIN, 1);
-    gpio_set_dir(DS18B20_PIN, GPIO_IN);
-    busy_wait_us(60);
+/**
+ * @brief Tabela de sondas encontradas pela busca de ROM.
+ */
+static ds18b20_probe_t probes[DS18B20_MAX_DEVICES];
+
+/**
+ * @brief Quantidade de sondas válidas em 'probes'.
+ */
+static uint8_t probe_count = 0;
+
+/**
+ * @brief Indica se existe uma conversão iniciada e ainda não coletada.
+ */
+static bool conversion_pending = false;
+
+/**
+ * @brief Instante (em microssegundos desde o boot) em que a última conversão foi iniciada.
+ */
+static uint64_t conversion_start_us = 0;
 
-    busy_wait_us(430);
+/**
+ * @brief Inicializa o barramento 1-Wire do sensor DS18B20.
+ * * @return true se o barramento foi inicializado, false caso contrário.
+ */
+bool ds18b20_init(void){
+    conversion_pending = false;
+    probe_count = 0;
+    return onewire_init(&ds18b20_bus, DS18B20_PIN);
 }
 
 /**
- * @brief Lê um único bit do barramento 1-Wire.
- * * @return O valor booleano do bit lido (true para 1, false para 0).
+ * @brief Procura as sondas DS18B20 do barramento (Search ROM) e preenche a tabela de sondas.
+ * @note Deve ser chamada com o escalonador em execução, pois as transferências
+ * 1-Wire aguardam em semáforo. Dispositivos de outras famílias são ignorados.
+ * Um passo da busca interrompido por erro no barramento (bit perdido, CRC da
+ * ROM) é refeito a partir do estado anterior a ele, até DS18B20_SCAN_ATTEMPTS
+ * vezes, sem perder as sondas já encontradas.
+ * * @return A quantidade de sondas encontradas (até DS18B20_MAX_DEVICES).
  */
-static bool read_bit(){
-    bool bit_val = false;
+uint8_t ds18b20_scan(void){
+    onewire_search_t search;
+    uint8_t rom[ONEWIRE_ROM_SIZE];
+
+    probe_count = 0;
+    onewire_search_reset(&search);
+
+    while(probe_count < DS18B20_MAX_DEVICES && !search.last_device){
+        // A failed step corrupts the search state: each attempt starts from a copy
+        const onewire_search_t previous = search;
+        bool found = false;
 
-    gpio_set_dir(DS18B20_PIN, GPIO_OUT);
-    gpio_put(DS18B20_PIN, 0);
-    busy_wait_us(2);
+        for(uint8_t attempt = 0; attempt < DS18B20_SCAN_ATTEMPTS && !found; attempt++){
+            search = previous;
+            found = onewire_search_next(&ds18b20_bus, &search, rom);
+        }
+        if(!found) break;
+
+        if(rom[0] != DS18B20_FAMILY_CODE) continue;
+
+        memcpy(probes[probe_count].rom, rom, ONEWIRE_ROM_SIZE);
+        probes[probe_count].valid = false;
+        probe_count++;
+    }
 
-    gpio_set_dir(DS18B20_PIN, GPIO_IN);
-    busy_wait_us(2);
-    bit_val = gpio_get(DS18B20_PIN);
-    busy_wait_us(80);
+    return probe_count;
+}
 
-    return bit_val;
+/**
+ * @brief Retorna a quantidade de sondas encontradas na última busca.
+ */
+uint8_t ds18b20_get_device_count(void){
+    return probe_count;
 }
 
 /**
- * @brief Envia um único bit (0 ou 1) para o barramento 1-Wire.
- * * @param bit_state O valor booleano do bit a ser enviado (true para 1, false para 0).
+ * @brief Lê e valida (CRC8) o "Scratchpad" de uma sonda.
+ * * @param rom ROM da sonda a ser endereçada (Match ROM), ou NULL para usar Skip ROM
+ * (apenas quando há um único dispositivo no barramento).
+ * @param temperature Ponteiro onde a temperatura em graus Celsius será escrita.
+ * @return true se a leitura foi bem-sucedida e o CRC confere, false caso contrário
+ * (inclusive quando a sonda ainda guarda o valor de power-on, sem conversão).
  */
-static void send_bit(bool bit_state){
-    gpio_set_dir(DS18B20_PIN, GPIO_OUT);
-    gpio_put(DS18B20_PIN, 0);
-
-    if(bit_state){
-        busy_wait_us(5);
-        gpio_put(DS18B20_PIN, 1);
-        busy_wait_us(45);
+static bool read_scratchpad(const uint8_t *rom, celsius_t *temperature){
+    uint8_t commands[ONEWIRE_ROM_SIZE + 2];
+    size_t length = 0;
+
+    if(rom){
+        commands[length++] = ONEWIRE_CMD_MATCH_ROM;
+        memcpy(&commands[length], rom, ONEWIRE_ROM_SIZE);
+        length += ONEWIRE_ROM_SIZE;
     } else {
-        busy_wait_us(90);
-        gpio_put(DS18B20_PIN, 1);
-        busy_wait_us(10);
+        commands[length++] = ONEWIRE_CMD_SKIP_ROM;
     }
+    commands[length++] = DS18B20_CMD_READ_SCRATCHPAD;
+
+    uint8_t scratchpad[DS18B20_SCRATCHPAD_SIZE];
+    if(!onewire_transfer(&ds18b20_bus, true, commands, length, scratchpad, sizeof(scratchpad))) return false;
+
+    // The 9th byte is the CRC of the first 8; an open bus would read all 0xFF
+    if(onewire_crc8(scratchpad, sizeof(scratchpad)) != 0 || scratchpad[4] == 0xFF) return false;
+
+    // Combine the two bytes into a single 16-bit value
+    int16_t raw_temp = (scratchpad[1] << 8) | scratchpad[0];
+
+    // A Convert T lost on the bus (or a probe reset by a power glitch) leaves +85 ºC
+    if(raw_temp == DS18B20_POWER_ON_RAW) return false;
+
+    *temperature = (celsius_t)raw_temp * (FIXED_ONE / 16); // Convert to Celsius (each bit represents 0.0625 degrees)
+
+    return true;
+}
+
+/**
+ * @brief Inicia uma conversão de temperatura sem aguardar o seu término.
+ * @note O comando é enviado em broadcast (Skip ROM), então todas as sondas do
+ * barramento convertem em paralelo na mesma janela de 750ms.
+ * O sensor converte em segundo plano (até 750ms para 12 bits), permitindo
+ * que outras leituras sejam feitas enquanto isso. Use ds18b20_is_conversion_ready()
+ * para verificar o término e ds18b20_collect_temperature() para obter o resultado.
+ * @note Mesmo sem resposta do sensor a conversão é marcada como pendente, de forma
+ * que o ciclo seguinte (após o tempo máximo de conversão) tente novamente.
+ * * @return true se o sensor respondeu ao reset e a conversão foi iniciada, false caso contrário.
+ */
+bool ds18b20_start_conversion(void){
+    conversion_start_us = time_us_64();
+    conversion_pending = true;
+
+    // Reset, “Skip ROM” and start conversion on every probe
+    const uint8_t commands[] = {ONEWIRE_CMD_SKIP_ROM, DS18B20_CMD_CONVERT_T};
+    return onewire_transfer(&ds18b20_bus, true, commands, sizeof(commands), NULL, 0);
 }
 
 /**
- * @brief Lê um byte (8 bits) do barramento 1-Wire, bit a bit (LSB first).
- * * @return O byte (uint8_t) lido do barramento.
+ * @brief Verifica, sem bloquear, se a conversão em andamento já terminou.
+ * @note Durante a conversão o DS18B20 responde 0 aos slots de leitura e passa
+ * a responder 1 ao terminar; com várias sondas, a linha só sobe quando todas terminam. O tempo máximo de conversão é usado como garantia
+ * caso o sensor não responda.
+ * * @return true se existe uma conversão concluída aguardando coleta, false caso contrário.
  */
-static uint8_t read_byte(){
-    uint8_t byte_val = 0x00;
+bool ds18b20_is_conversion_ready(void){
+    if(!conversion_pending) return false;
 
-    for(int i=0; i<8; i++) byte_val |= (read_bit() << i);
-    
-    return byte_val;
+    uint8_t bit_val = 0;
+    if(onewire_transfer_bits(&ds18b20_bus, false, NULL, 0, &bit_val, 1) && bit_val) return true;
+
+    return (time_us_64() - conversion_start_us) >= (DS18B20_CONVERSION_TIME_MS * 1000ULL);
 }
 
 /**
- * @brief Envia um byte (8 bits) para o barramento 1-Wire, bit a bit (LSB first).
- * * @param cmd O byte (comando) a ser enviado.
+ * @brief Lê o "Scratchpad" de todas as sondas e obtém a temperatura da última conversão.
+ * @note Deve ser chamada após ds18b20_is_conversion_ready() retornar true. Cada sonda
+ * é endereçada por Match ROM e só é considerada se o CRC8 conferir. Sem sondas
+ * na tabela (busca não executada ou sem resultado), usa Skip ROM como sonda única.
+ * * @param temperature Ponteiro onde a média das temperaturas válidas (°C) será escrita.
+ * @return true se havia uma conversão pendente e ao menos uma sonda foi lida,
+ * false caso contrário (nesse caso 'temperature' não é alterada).
  */
-static void send_byte(uint8_t cmd){
-    for(int i=0; i<8; i++){
-        send_bit((cmd >> i) & 1);
+bool ds18b20_collect_temperature(celsius_t *temperature){
+    if(!conversion_pending) return false;
+    conversion_pending = false;
+
+    if(probe_count == 0){
+        if(!read_scratchpad(NULL, temperature)) return false;
+        capture_record(CAPTURE_SOURCE_TEMPERATURE, 0, (int16_t)(*temperature / (FIXED_ONE / 16)));
+        return true;
+    }
+
+    celsius_t sum = 0;
+    uint8_t valid_count = 0;
+
+    for(uint8_t i = 0; i < probe_count; i++){
+        probes[i].valid = read_scratchpad(probes[i].rom, &probes[i].temperature);
+        if(probes[i].valid){
+            capture_record(CAPTURE_SOURCE_TEMPERATURE, i, (int16_t)(probes[i].temperature / (FIXED_ONE / 16)));
+            sum += probes[i].temperature;
+            valid_count++;
+        }
     }
-    busy_wait_us(5);
+
+    if(valid_count == 0) return false;
+
+    *temperature = sum / valid_count;
+    return true;
+}
+
+/**
+ * @brief Obtém a última temperatura válida de uma sonda específica.
+ * * @param index Índice da sonda na tabela (0 a ds18b20_get_device_count() - 1).
+ * @param temperature Ponteiro onde a temperatura em graus Celsius será escrita.
+ * @return true se a sonda existe e a sua última leitura foi válida, false caso contrário.
+ */
+bool ds18b20_get_probe_temperature(uint8_t index, celsius_t *temperature){
+    if(index >= probe_count || !probes[index].valid) return false;
+
+    *temperature = probes[index].temperature;
+    return true;
 }
 
 /**
- * @brief Realiza a leitura completa da temperatura do sensor DS18B20.
+ * @brief Realiza a leitura completa (bloqueante) da temperatura do sensor DS18B20.
  * * Inicia a conversão, aguarda o tempo necessário (750ms), e
  * lê os bytes do "Scratchpad" para calcular a temperatura.
+ * @note Prefira a sequência ds18b20_start_conversion() / ds18b20_is_conversion_ready() /
+ * ds18b20_collect_temperature() em laços periódicos, para não bloquear durante a conversão.
  * * @return A temperatura medida em graus Celsius (tipo celsius_t).
  */
 celsius_t ds18b20_read_temperature(void){
-    gpio_init(DS18B20_PIN);
-
-    init_procedure();   // Initializes the sensor
-    send_byte(0xCC);    // Send the command “Skip ROM”
-    send_byte(0x44);    // Send the command to start the conversion
-    vTaskDelay(pdMS_TO_TICKS(750)); // wait for conversion (max 750ms for 12-bit resolution)
+    celsius_t temperature = 0;
 
-    init_procedure();   // Reset to prepare for reading
-    send_byte(0xCC);    // Send the “Skip ROM” command again
-    send_byte(0xBE);    // Send the command to read the “Scratchpad”
-
-    // Reads the 2 bytes of temperature
-    uint8_t temp_LSB = read_byte();
-    uint8_t temp_MSB = read_byte();
-
-    // Combine the two bytes into a single 16-bit value
-    int16_t raw_temp = (temp_MSB << 8) | temp_LSB;
+    ds18b20_start_conversion();
+    vTaskDelay(pdMS_TO_TICKS(DS18B20_CONVERSION_TIME_MS)); // wait for conversion (max 750ms for 12-bit resolution)
+    ds18b20_collect_temperature(&temperature);
 
-    return (float)raw_temp * 0.0625f; // Convert to Celsius (each bit represents 0.0625 degrees)
+    return temperature;
 }
\ No newline at end of file
@@ -1,62 +1,70 @@
 #include "ph4502c.h"
 #include "ads1115.h"
-#include "FreeRTOS.h"
-#include "task.h"
-#include <stdio.h>
+#include "sensor_configs.h"
+#include "sample_estimator.h"
+#include "log.h"
 
 
-#define PH_ADC_CHANNEL 0
-#define NUM_SAMPLES 10
-#define CALIBRATION_OFFSET 58.2470f
-#define VOLTS_TO_PH_SLOPE -20.4082f
+#define NUM_SAMPLES 10 // largest equivalent window
+#define READ_CHUNK 8 // samples copied from the acquisition engine at a time
+#define CALIBRATION_OFFSET FIXED_FROM_FLOAT(58.2470f)
+#define VOLTS_TO_PH_SLOPE FIXED_FROM_FLOAT(-20.4082f)
 
 /**
- * @brief Ordena um array de amostras (int16_t) usando bubble sort.
- * @note Esta função modifica o array de entrada.
- * * @param samples Ponteiro para o array de amostras a ser ordenado.
+ * @brief Estimador recursivo do código do ADC do canal de pH.
  */
-static void sort_samples(int16_t* samples) {
-    // Simple bubble sort
-    for (int i = 0; i < NUM_SAMPLES - 1; i++) {
-        for (int j = 0; j < NUM_SAMPLES - i - 1; j++) {
-            if (samples[j] > samples[j + 1]) {
-                int16_t temp = samples[j];
-                samples[j] = samples[j + 1];
-                samples[j + 1] = temp;
-            }
+static sample_estimator_t ph_estimator;
+
+/**
+ * @brief Posição deste driver no fluxo de amostras do canal de pH.
+ */
+static uint32_t ph_cursor = 0;
+
+/**
+ * @brief Obtém a estimativa atual do código do ADC do canal de pH.
+ * @note Alimenta o estimador com as amostras que chegaram do motor de aquisição do
+ * ADS1115 desde a última chamada, sem aguardar novas conversões. O estado é
+ * mantido entre leituras, então uma ou duas conversões novas bastam para
+ * atualizar a estimativa; outliers são descartados pelo próprio estimador.
+ * * @param avg_sample Ponteiro onde a estimativa (valor bruto do ADC) será escrita.
+ * @return true se já houve amostras, false caso contrário.
+ */
+static bool read_average_adc(int16_t *avg_sample) {
+    int16_t samples[READ_CHUNK];
+    size_t count;
+
+    do {
+        count = ads1115_scan_get_new_samples(PH_ADC_CHANNEL, &ph_cursor, samples, READ_CHUNK);
+        for (size_t i = 0; i < count; i++) {
+            sample_estimator_update(&ph_estimator, samples[i]);
         }
-    }
+    } while (count == READ_CHUNK);
+
+    if (!sample_estimator_is_ready(&ph_estimator)) return false;
+
+    *avg_sample = sample_estimator_value(&ph_estimator);
+    return true;
 }
 
 /**
  * @brief Lê a tensão do sensor de pH a partir do ADC.
- * * Coleta 10 amostras, ordena, descarta as 2 menores e 2 maiores,
- * e calcula a média das 6 amostras restantes antes de converter para tensão.
+ * * Usa a estimativa recursiva do canal antes de converter para tensão.
  * * @return O valor da tensão média medida em Volts.
  */
 static float ph4502c_read_voltage(void) {
-    int16_t samples[NUM_SAMPLES];
-    int32_t total_raw_adc = 0;
-    for (int i = 0; i < NUM_SAMPLES; i++) {
-        samples[i] = ads1115_read_adc(PH_ADC_CHANNEL);
-        vTaskDelay(pdMS_TO_TICKS(10));
-    }
-    sort_samples(samples);
-    for (int i = 2; i < NUM_SAMPLES - 2; i++) {
-        total_raw_adc += samples[i];
-    }
-    int16_t avg_sample = total_raw_adc / (NUM_SAMPLES - 4);
-    float voltage = (float)avg_sample * (ADS1115_VREF / ADS1115_MAX_ADC_VALUE);
-
-    // Imprima a tensão para você ver no console
-    printf("Tensão do ADC: %.4f V\n", voltage);
+    int16_t avg_sample = 0;
+    read_average_adc(&avg_sample);
+    float voltage = fixed_to_float(ads1115_raw_to_voltage(avg_sample));
+
+    // Deferred log: formatted on the host, never on this core
+    LOG1(LOG_PH_VOLTAGE, log_float(voltage));
 
     return voltage;
 }
 
 /**
  * @brief Função auxiliar para testes de calibração.
- * @note Esta função lê a tensão e imprime no console valores de
+ * @note Esta função lê a tensão e registra no log valores de
  * calibração (slope/offset) baseados em valores fixos (hardcoded).
  * Não é usada na leitura normal de pH.
  */
@@ -72,42 +80,49 @@ static void ph4502c_calibrate(void) {
     float slope = (base_ph - acid_ph) / (voltage_at_base_ph - voltage_at_acid_ph);
     float offset = acid_ph - (slope * voltage_at_acid_ph);
 
-    printf("Slope: %.4f\n", slope);
-    printf("Offset: %.4f\n", offset);
+    LOG2(LOG_PH_CALIBRATION, log_float(slope), log_float(offset));
+}
+
+/**
+ * @brief Prepara o estimador do sensor de pH e inclui o seu canal na varredura do
+ * motor de aquisição do ADS1115.
+ */
+void ph4502c_init(void) {
+    sample_estimator_init(&ph_estimator, PH_MEASUREMENT_NOISE, PH_OUTLIER_GATE, PH_MAX_REJECTS, NUM_SAMPLES);
+    if(!ads1115_scan_enable_channel(PH_ADC_CHANNEL)) LOG1(LOG_ERROR_ADS1115_CHANNEL, PH_ADC_CHANNEL);
+}
+
+/**
+ * @brief Altera a janela equivalente do estimador do pH.
+ * @note Janelas menores respondem mais rápido a mudanças, com mais ruído.
+ * * @param window Janela equivalente em amostras (2 a NUM_SAMPLES).
+ */
+void ph4502c_set_window(uint8_t window) {
+    if (window < 2 || window > NUM_SAMPLES) return;
+    sample_estimator_set_window(&ph_estimator, window);
 }
 
 /**
  * @brief Realiza a leitura completa do valor de pH.
- * * Coleta 10 amostras do ADC, descarta 40% (outliers), calcula a tensão média,
- * e aplica a fórmula de calibração linear (slope e offset) para
- * converter a tensão em valor de pH.
+ * * Atualiza a estimativa recursiva com as amostras novas do motor de aquisição
+ * (outliers descartados), converte para tensão e aplica a fórmula de calibração linear (slope e offset)
+ * para converter a tensão em valor de pH. Não aguarda novas conversões.
+ * Todo o cálculo é feito em ponto fixo (Q16.16).
  * * @return O valor de pH medido (tipo ph_t).
  */
 ph_t ph4502c_read_ph(void) {
-    int16_t samples[NUM_SAMPLES];
-    int32_t total_raw_adc = 0;
-    
-    // Collects multiple samples from the ADC to reduce noise
-    for (int i = 0; i < NUM_SAMPLES; i++) {
-        samples[i] = ads1115_read_adc(PH_ADC_CHANNEL);
-        vTaskDelay(pdMS_TO_TICKS(10));
-    }
-
-    // Sort the samples so we can discard the highest and lowest ones.
-    sort_samples(samples);
-    
-    // Calculate the average, discarding the lowest 20% and highest 20%.
-    for (int i = 2; i < NUM_SAMPLES - 2; i++) {
-        total_raw_adc += samples[i];
-    }
-
-    int16_t avg_sample = total_raw_adc / (NUM_SAMPLES - 4);
+    static ph_t last_ph_value = 0;
+    int16_t avg_sample = 0;
+
+    // Keeps the previous value while the acquisition engine has no samples yet
+    if (!read_average_adc(&avg_sample)) return last_ph_value;
 
     // Convert the average ADC value to voltage.
-    float voltage = (float)avg_sample * (ADS1115_VREF / ADS1115_MAX_ADC_VALUE);
+    fixed_t voltage = ads1115_raw_to_voltage(avg_sample);
 
     // Convert the voltage to the pH value using the linear formula
-    ph_t ph_value = (VOLTS_TO_PH_SLOPE * voltage) + CALIBRATION_OFFSET;
+    ph_t ph_value = fixed_add(fixed_mul(VOLTS_TO_PH_SLOPE, voltage), CALIBRATION_OFFSET);
+    last_ph_value = ph_value;
 
     return ph_value;
 }
\ No newline at end of file
@@ -1,66 +1,131 @@
 #include "tds_meter.h"
 #include "ads1115.h"
-#include "FreeRTOS.h"
-#include "task.h"
+#include "sensor_configs.h"
+#include "sample_estimator.h"
+#include "log.h"
 
-#define TDS_ADC_CHANNEL 1
-#define NUM_SAMPLES 30
+#define NUM_SAMPLES 30 // largest equivalent window
+#define READ_CHUNK 8 // samples copied from the acquisition engine at a time
+
+// Voltage -> ppm curve: linear interpolation over 1/16 V segments from 0 to 8 V
+#define TDS_CURVE_STEP_BITS 12 // segment width in Q16.16 (2^12 / 2^16 = 1/16 V)
+#define TDS_CURVE_MAX_VOLTS 8 // full scale compensated down to 0 ºC
+#define TDS_CURVE_POINTS ((TDS_CURVE_MAX_VOLTS << (FIXED_FRACTION_BITS - TDS_CURVE_STEP_BITS)) + 1)
 
 /**
- * @brief Calcula o valor mediano de um array de amostras.
- * @note Esta função modifica o array de entrada (ordena-o).
- * * @param samples Ponteiro para o array de amostras (será ordenado).
- * @return O valor mediano do array.
+ * @brief Estimador recursivo do código do ADC do canal de TDS.
  */
-static int16_t get_median_value(int16_t *samples){
-    // Simple bubble sort
-    for (int i = 0; i < NUM_SAMPLES - 1; i++) {
-        for (int j = 0; j < NUM_SAMPLES - i - 1; j++) {
-            if (samples[j] > samples[j + 1]) {
-                int16_t temp = samples[j];
-                samples[j] = samples[j + 1];
-                samples[j + 1] = temp;
-            }
-        }
+static sample_estimator_t tds_estimator;
+
+/**
+ * @brief Posição deste driver no fluxo de amostras do canal de TDS.
+ */
+static uint32_t tds_cursor = 0;
+
+/**
+ * @brief Tabela pré-calculada da curva tensão -> PPM (Q16.16), um ponto a cada 1/16 V.
+ */
+static ppm_t tds_curve[TDS_CURVE_POINTS];
+
+/**
+ * @brief Curva de calibração do sensor de TDS (tensão compensada -> PPM).
+ * @note Avaliada em float apenas na montagem da tabela, em tds_meter_init().
+ * * @param compensated_voltage A tensão já compensada pela temperatura, em Volts.
+ * @return O valor de TDS em PPM.
+ */
+float tds_polynomial(float compensated_voltage) {
+    // The formula below is based on typical TDS meter calibration
+    return (133.42f * compensated_voltage * compensated_voltage * compensated_voltage
+          - 255.86f * compensated_voltage * compensated_voltage
+          + 857.39f * compensated_voltage) * 0.5f;
+}
+
+/**
+ * @brief Converte a tensão compensada em PPM por interpolação linear na tabela.
+ * @note Acima de TDS_CURVE_MAX_VOLTS o último segmento é extrapolado. Com
+ * segmentos de 1/16 V o erro em relação ao polinômio fica abaixo de 1,5 ppm
+ * até 3 V e de 0,2% no fundo de escala.
+ * * @param voltage A tensão compensada em Volts (Q16.16).
+ * @return O valor de TDS em PPM (Q16.16).
+ */
+ppm_t tds_curve_lookup(fixed_t voltage) {
+    if (voltage <= 0) return 0;
+
+    uint32_t index = (uint32_t)voltage >> TDS_CURVE_STEP_BITS;
+    if (index > TDS_CURVE_POINTS - 2) index = TDS_CURVE_POINTS - 2;
+
+    int64_t fraction = voltage - (fixed_t)(index << TDS_CURVE_STEP_BITS);
+    int64_t delta = (int64_t)(tds_curve[index + 1] - tds_curve[index]) * fraction;
+
+    return fixed_saturate(tds_curve[index] + (delta >> TDS_CURVE_STEP_BITS));
+}
+
+/**
+ * @brief Monta a tabela da curva de TDS, prepara o estimador do sensor e inclui o
+ * seu canal na varredura do motor de aquisição do ADS1115.
+ */
+void tds_meter_init(void) {
+    for (uint32_t i = 0; i < TDS_CURVE_POINTS; i++) {
+        float voltage = (float)(i << TDS_CURVE_STEP_BITS) / FIXED_ONE;
+        tds_curve[i] = (ppm_t)(tds_polynomial(voltage) * FIXED_ONE + 0.5f);
     }
 
-    return samples[(NUM_SAMPLES - 1) / 2];
+    sample_estimator_init(&tds_estimator, TDS_MEASUREMENT_NOISE, TDS_OUTLIER_GATE, TDS_MAX_REJECTS, NUM_SAMPLES);
+    if(!ads1115_scan_enable_channel(TDS_ADC_CHANNEL)) LOG1(LOG_ERROR_ADS1115_CHANNEL, TDS_ADC_CHANNEL);
+}
+
+/**
+ * @brief Altera a janela equivalente do estimador do TDS.
+ * @note Janelas menores respondem mais rápido a mudanças, com mais ruído.
+ * * @param window Janela equivalente em amostras (2 a NUM_SAMPLES).
+ */
+void tds_meter_set_window(uint8_t window) {
+    if (window < 2 || window > NUM_SAMPLES) return;
+    sample_estimator_set_window(&tds_estimator, window);
 }
 
 /**
  * @brief Lê o valor de TDS (Total de Sólidos Dissolvidos) em PPM.
- * * Esta função coleta 30 amostras do ADC, encontra a mediana,
- * converte para tensão, aplica compensação de temperatura e,
- * finalmente, converte a tensão compensada para PPM.
+ * * Esta função atualiza a estimativa recursiva do canal com o que o motor
+ * de aquisição do ADS1115 produziu (sem aguardar novas conversões, outliers
+ * descartados), converte para tensão, aplica compensação de temperatura e,
+ * finalmente, converte a tensão compensada para PPM pela tabela da curva.
+ * Todo o cálculo é feito em ponto fixo (Q16.16).
  * * @param current_temperature A temperatura atual em Celsius (tipo celsius_t)
  * para aplicar a compensação.
  * @return O valor de TDS calculado em PPM (tipo ppm_t).
  */
 ppm_t tds_meter_read_ppm(celsius_t current_temperature) {
-    int16_t samples[NUM_SAMPLES];
+    static ppm_t last_tds_value = 0;
+    int16_t samples[READ_CHUNK];
+    size_t count;
 
-    // Collect multiple samples from the ADC to reduce noise
-    for (int i = 0; i < NUM_SAMPLES; i++) {
-        samples[i] = ads1115_read_adc(TDS_ADC_CHANNEL);
-        vTaskDelay(pdMS_TO_TICKS(10));
-    }
+    // Feeds the estimator with the samples acquired since the last reading
+    do {
+        count = ads1115_scan_get_new_samples(TDS_ADC_CHANNEL, &tds_cursor, samples, READ_CHUNK);
+        for (size_t i = 0; i < count; i++) {
+            sample_estimator_update(&tds_estimator, samples[i]);
+        }
+    } while (count == READ_CHUNK);
+
+    // Keeps the previous value while the acquisition engine has no samples yet
+    if (!sample_estimator_is_ready(&tds_estimator)) return last_tds_value;
 
-    // Get the median ADC value to minimize the effect of outliers
-    int16_t median_adc_value = get_median_value(samples);
+    // Estimated ADC value, with outliers already rejected
+    int16_t adc_value = sample_estimator_value(&tds_estimator);
 
     // Convert ADC value to voltage
-    float voltage = (float)median_adc_value * (ADS1115_VREF / ADS1115_MAX_ADC_VALUE);
+    fixed_t voltage = ads1115_raw_to_voltage(adc_value);
 
     // Apply temperature compensation
     // Typical compensation coefficient for TDS meters is around 2% per degree Celsius
-    float compensation_coefficient = 1.0f + 0.02f * (current_temperature - 25.0f);
-    float compensated_voltage = voltage / compensation_coefficient;
+    fixed_t compensation_coefficient = fixed_add(FIXED_ONE,
+        fixed_mul(FIXED_FROM_FLOAT(0.02f), fixed_sub(current_temperature, FIXED_FROM_FLOAT(25.0f))));
+    fixed_t compensated_voltage = fixed_div(voltage, compensation_coefficient);
 
-    // Convert voltage to TDS in ppm
-    // The formula below is based on typical TDS meter calibration
-    float tds_value = (133.42f * compensated_voltage * compensated_voltage * compensated_voltage
-                 - 255.86f * compensated_voltage * compensated_voltage
-                 + 857.39f * compensated_voltage) * 0.5f; 
+    // Convert voltage to TDS in ppm through the precomputed calibration curve
+    ppm_t tds_value = tds_curve_lookup(compensated_voltage);
+    last_tds_value = tds_value;
 
     return tds_value;
 }
\ No newline at end of file
@@ -1,11 +1,29 @@
 #include "buttons.h"
-#include "FreeRTOS.h"
-#include "task.h"
+#include "hardware/gpio.h"
+#include "hardware/irq.h"
 
 #define PIN_BUTTON_A 5
 #define PIN_BUTTON_B 6
 #define PIN_BUTTON_SW 22
 #define DEBOUNCE_DELAY 10
+#define DEBOUNCE_US (DEBOUNCE_DELAY * 1000)
+
+#define BUTTON_EDGES (GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE)
+
+// Estado de um botão tratado por interrupção
+typedef struct {
+    uint8_t pin;
+    TaskHandle_t listener;          // notified on each confirmed press/release
+    volatile bool pressed;          // debounced state
+    volatile bool settling;         // debounce alarm pending
+    volatile uint64_t last_edge_us;
+} button_state_t;
+
+static button_state_t buttons[] = {
+    [BUTTON_A] = { .pin = PIN_BUTTON_A },
+    [BUTTON_B] = { .pin = PIN_BUTTON_B },
+    [BUTTON_SW] = { .pin = PIN_BUTTON_SW }
+};
 
 /**
  * @brief Configura um pino GPIO especificado como uma entrada com um resistor de pull-up.
@@ -15,17 +33,6 @@ static void init_button(uint8_t button){
     gpio_init(button); gpio_set_dir(button, GPIO_IN); gpio_pull_up(button);
 }
 
-/**
- * @brief Lê o estado de um botão, implementando um simples debounce de software ao esperar que o botão seja liberado.
- * @param button O número do pino GPIO do botão a ser lido.
- * @return Retorna true no momento em que o botão é pressionado.
- */
-static bool get_button(uint8_t button){
-    bool state = !gpio_get(button);
-    while(!gpio_get(button)) vTaskDelay(pdMS_TO_TICKS(DEBOUNCE_DELAY));
-    return state;
-}
-
 /**
  * @brief Função de inicialização do botão A, utilizando função init_button.
  */
@@ -48,22 +55,104 @@ void init_button_sw(){
 }
 
 /**
- * Função leitura do botão A.
+ * @brief Callback do alarme de hardware que confirma o estado de um botão.
+ * @note Executa em contexto de interrupção. O estado só é aceito após DEBOUNCE_US
+ * sem bordas; enquanto houver repique, o alarme é reagendado. Um nível igual ao
+ * estado confirmado (pulso mais curto que o repique) é descartado.
+ * @note A interrupção do GPIO e a do alarme rodam no Core 0 com a mesma
+ * prioridade, portanto não se interrompem mutuamente.
+ * * @param id Identificador do alarme (não utilizado).
+ * @param user_data Ponteiro para o button_state_t do botão.
+ * @return 0 para encerrar o alarme, ou o atraso (negativo, em us) até a nova verificação.
  */
-bool get_button_a(){
-    return get_button(PIN_BUTTON_A);
+static int64_t button_debounce_callback(alarm_id_t id, void *user_data){
+    button_state_t *state = (button_state_t *)user_data;
+
+    uint64_t quiet_us = time_us_64() - state->last_edge_us;
+    if(quiet_us < DEBOUNCE_US) return -(int64_t)(DEBOUNCE_US - quiet_us); // still bouncing
+
+    state->settling = false;
+
+    bool pressed = !gpio_get(state->pin);
+    if(pressed == state->pressed) return 0;
+    state->pressed = pressed;
+
+    BaseType_t higher_priority_task_woken = pdFALSE;
+    if(state->listener){
+        xTaskNotifyFromISR(state->listener, pressed ? BUTTON_EVENT_PRESSED : BUTTON_EVENT_RELEASED,
+                           eSetBits, &higher_priority_task_woken);
+    }
+    portYIELD_FROM_ISR(higher_priority_task_woken);
+
+    return 0;
 }
 
 /**
- * Função leitura do botão B.
+ * @brief Trata as bordas de um botão: registra o instante e agenda a confirmação.
+ * @note Apenas o primeiro repique agenda o alarme; os seguintes só adiam a confirmação.
+ * * @param state Ponteiro para o button_state_t do botão.
  */
-bool get_button_b(){
-    return get_button(PIN_BUTTON_B);
+static void button_edge(button_state_t *state){
+    uint32_t events = gpio_get_irq_event_mask(state->pin) & BUTTON_EDGES;
+    if(!events) return;
+    gpio_acknowledge_irq(state->pin, events);
+
+    state->last_edge_us = time_us_64();
+    if(state->settling) return;
+
+    state->settling = true;
+    if(add_alarm_in_us(DEBOUNCE_US, button_debounce_callback, state, true) < 0) state->settling = false;
+}
+
+static void button_a_irq_handler(void){
+    button_edge(&buttons[BUTTON_A]);
+}
+
+static void button_b_irq_handler(void){
+    button_edge(&buttons[BUTTON_B]);
+}
+
+static void button_sw_irq_handler(void){
+    button_edge(&buttons[BUTTON_SW]);
 }
 
 /**
- * Função leitura do botão SW.
+ * @brief Passa a tratar um botão por interrupção de borda, com debounce por alarme de hardware.
+ * @note O botão deve ter sido inicializado (init_button_...). Cada pressionamento ou
+ * soltura confirmado é entregue ao 'listener' como notificação direta
+ * (BUTTON_EVENT_PRESSED / BUTTON_EVENT_RELEASED, acumulados com eSetBits).
+ * Deve ser chamada no Core 0, antes de iniciar o escalonador.
+ * * @param button O botão (BUTTON_A, BUTTON_B, BUTTON_SW).
+ * @param listener Handle da task a ser notificada.
+ * @return true se a interrupção foi habilitada, false caso contrário.
  */
-bool get_button_sw(){
-    return get_button(PIN_BUTTON_SW);
+bool button_enable_events(button_id_t button, TaskHandle_t listener){
+    irq_handler_t handlers[] = {
+        [BUTTON_A] = button_a_irq_handler,
+        [BUTTON_B] = button_b_irq_handler,
+        [BUTTON_SW] = button_sw_irq_handler
+    };
+
+    if(button > BUTTON_SW || listener == NULL) return false;
+
+    button_state_t *state = &buttons[button];
+    state->listener = listener;
+    state->pressed = !gpio_get(state->pin);
+    state->settling = false;
+
+    gpio_add_raw_irq_handler(state->pin, handlers[button]);
+    gpio_set_irq_enabled(state->pin, BUTTON_EDGES, true);
+    irq_set_enabled(IO_IRQ_BANK0, true);
+
+    return true;
 }
+
+/**
+ * @brief Lê o estado confirmado (após o debounce) de um botão tratado por interrupção.
+ * * @param button O botão (BUTTON_A, BUTTON_B, BUTTON_SW).
+ * @return true se o botão está pressionado.
+ */
+bool button_is_pressed(button_id_t button){
+    if(button > BUTTON_SW) return false;
+    return buttons[button].pressed;
+}
\ No newline at end of file
@@ -1,38 +1,573 @@
 #include "ads1115.h"
+#include "i2c_bus.h"
+#include "sensor_capture.h"
+#include "hardware/gpio.h"
+#include "hardware/irq.h"
 #include "FreeRTOS.h"
 #include "task.h"
+#include <stdio.h>
 
-#define ADS1115_ADDR 0x48
+// --- Registradores ---
+#define ADS1115_REG_CONVERSION 0x00
+#define ADS1115_REG_CONFIG 0x01
+#define ADS1115_REG_LO_THRESH 0x02
+#define ADS1115_REG_HI_THRESH 0x03
+
+#define ADS1115_MODE_SINGLE_SHOT 0x01 // MODE bit of the config MSB
+
+#define ADS1115_SCAN_STACK_SIZE (configMINIMAL_STACK_SIZE * 2)
+
+
+// Amostras de um canal em buffer circular
+typedef struct {
+    int16_t samples[ADS1115_RING_SIZE];
+    uint8_t head;
+    uint8_t count;
+    uint32_t total;
+} ads1115_ring_t;
+
+// Conversor do barramento e estado da sua varredura
+typedef struct {
+    uint8_t address;
+    bool present;
+    volatile uint8_t inputs;  // inputs enabled for scanning (bit N = AINN)
+    uint8_t input;            // input being converted
+    bool converting;
+    uint64_t start_us;        // earliest start of the current conversion (nominal, in continuous mode)
+    uint64_t ready_us;        // instant when the current result is guaranteed to be ready (or a restart is due)
+} ads1115_device_t;
+
+/**
+ * @brief Buffers circulares de amostras, um por canal lógico.
+ */
+static ads1115_ring_t rings[ADS1115_NUM_CHANNELS];
+
+/**
+ * @brief Tabela dos conversores, indexada pelo endereço (0x48 + índice).
+ */
+static ads1115_device_t devices[ADS1115_MAX_DEVICES];
+
+/**
+ * @brief Taxa de dados atual dos conversores (amostras/s), ajustável em execução.
+ */
+static volatile uint16_t data_rate_sps = ADS1115_DATA_RATE_SPS;
+
+/**
+ * @brief Handle da task de aquisição, acordada pela interrupção do pino ALERT/RDY.
+ */
+static TaskHandle_t scan_task_handle = NULL;
+static StaticTask_t scan_task_buffer;
+static StackType_t scan_task_stack[ADS1115_SCAN_STACK_SIZE];
+
+/**
+ * @brief Monta o byte mais significativo do registrador de configuração para uma entrada.
+ * * @param input A entrada analógica do conversor (0 a 3).
+ * @param single_shot true para conversão única, false para modo contínuo.
+ * @param config_msb Ponteiro onde o byte será escrito.
+ * @return true se a entrada é válida, false caso contrário.
+ */
+static bool build_config_msb(uint8_t input, bool single_shot, uint8_t *config_msb){
+    // OS | MUX[2:0] | PGA[2:0] = 000 (+/-6.144 V) | MODE. The pH and TDS calibrations
+    // were fitted to these codes scaled by ADS1115_VREF
+    switch (input) {
+        case 0: *config_msb = 0b11000001; break; // AIN0 vs GND
+        case 1: *config_msb = 0b11010001; break; // AIN1 vs GND
+        case 2: *config_msb = 0b11100001; break; // AIN2 vs GND
+        case 3: *config_msb = 0b11110001; break; // AIN3 vs GND
+        default: return false;
+    }
+
+    if(!single_shot) *config_msb &= ~ADS1115_MODE_SINGLE_SHOT;
+    return true;
+}
+
+/**
+ * @brief Converte uma taxa de dados nos bits DR (7:5) do registrador de configuração.
+ * * @param sps A taxa de dados em amostras/s (8, 16, 32, 64, 128, 250, 475 ou 860).
+ * @param bits Ponteiro onde os bits, já deslocados para a posição, serão escritos.
+ * @return true se a taxa é suportada, false caso contrário.
+ */
+static bool data_rate_bits(uint16_t sps, uint8_t *bits){
+    switch (sps) {
+        case 8:   *bits = 0b000 << 5; break;
+        case 16:  *bits = 0b001 << 5; break;
+        case 32:  *bits = 0b010 << 5; break;
+        case 64:  *bits = 0b011 << 5; break;
+        case 128: *bits = 0b100 << 5; break;
+        case 250: *bits = 0b101 << 5; break;
+        case 475: *bits = 0b110 << 5; break;
+        case 860: *bits = 0b111 << 5; break;
+        default:  return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Período nominal de uma conversão (1/taxa de dados).
+ * * @param sps A taxa de dados em amostras/s.
+ * @return O tempo em microssegundos.
+ */
+static uint32_t conversion_period_us(uint16_t sps){
+    return 1000000 / sps;
+}
 
 /**
- * @brief Configura o ADS1115 para uma conversão em um canal específico, aguarda a conversão e lê o 
+ * @brief Tempo máximo de uma conversão: período nominal mais 10% de tolerância do oscilador.
+ * * @param sps A taxa de dados em amostras/s.
+ * @return O tempo em microssegundos.
+ */
+static uint32_t conversion_time_us(uint16_t sps){
+    return conversion_period_us(sps) * 11 / 10;
+}
+
+/**
+ * @brief Escreve um registrador de 16 bits de um ADS1115.
+ * * @param address Endereço I2C do conversor.
+ * @param reg Endereço do registrador.
+ * @param value Valor a ser escrito.
+ * @return true se o dispositivo reconheceu a escrita, false caso contrário.
+ */
+static bool write_register(uint8_t address, uint8_t reg, uint16_t value){
+    uint8_t write_buf[3] = {reg, value >> 8, value & 0xFF};
+
+    i2c_transaction_t transaction = {
+        .kind = I2C_BUS_WRITE,
+        .address = address,
+        .tx = write_buf,
+        .tx_len = sizeof(write_buf)
+    };
+    return i2c_bus_transfer(I2C0_PORT, &transaction);
+}
+
+/**
+ * @brief Lê o registrador de conversão de um ADS1115.
+ * * @param address Endereço I2C do conversor.
+ * @param value Ponteiro onde o resultado bruto será escrito.
+ * @return true se a leitura foi bem-sucedida, false caso contrário.
+ */
+static bool read_conversion(uint8_t address, int16_t *value){
+    uint8_t pointer_reg = ADS1115_REG_CONVERSION;
+    uint8_t read_buf[2];
+
+    // Pointer write and read in one transaction (repeated START)
+    i2c_transaction_t transaction = {
+        .kind = I2C_BUS_WRITE_READ,
+        .address = address,
+        .tx = &pointer_reg,
+        .tx_len = 1,
+        .rx = read_buf,
+        .rx_len = sizeof(read_buf)
+    };
+    if(!i2c_bus_transfer(I2C0_PORT, &transaction)) return false;
+
+    *value = (int16_t)((read_buf[0] << 8) | read_buf[1]);
+    return true;
+}
+
+/**
+ * @brief Configura o ADS1115 para uma conversão em um canal específico, aguarda a conversão e lê o
  * resultado bruto do ADC.
- * @param channel O canal de entrada analógica a ser lido (0 a 3).
+ * @note Não deve ser usada com o motor de aquisição em execução, pois a conversão
+ * única interrompe o modo contínuo. Nesse caso, use ads1115_scan_get_samples().
+ * @param channel O canal lógico a ser lido (ADS1115_CHANNEL(conversor, entrada)).
  * @return O resultado da conversão ADC como um inteiro sinalizado de 16 bits.
  */
 int16_t ads1115_read_adc(uint8_t channel) {
+    if(channel >= ADS1115_NUM_CHANNELS) return 0;
+
+    uint8_t address = ADS1115_BASE_ADDR + channel / ADS1115_INPUTS_PER_DEVICE;
     uint8_t config_msb = 0;
-    switch (channel) {
-        case 0: config_msb = 0b11000001; break; // AIN0 vs GND
-        case 1: config_msb = 0b11010001; break; // AIN1 vs GND
-        case 2: config_msb = 0b11100001; break; // AIN2 vs GND
-        case 3: config_msb = 0b11110001; break; // AIN3 vs GND
-        default: return 0;
-    }
+    if(!build_config_msb(channel % ADS1115_INPUTS_PER_DEVICE, true, &config_msb)) return 0;
+
     // Config: Iniciar uma conversão, canal X, ganho +/-4.096V, modo single-shot, 860 amostras/s
     uint8_t config_lsb = 0b10000011;
 
-    uint8_t write_buf[3] = {0x01, config_msb, config_lsb}; // Aponta para o reg de config e escreve
-    i2c_write_blocking(I2C0_PORT, ADS1115_ADDR, write_buf, 3, false);
+    write_register(address, ADS1115_REG_CONFIG, (config_msb << 8) | config_lsb); // Aponta para o reg de config e escreve
 
     vTaskDelay(pdMS_TO_TICKS(2));
 
-    // Aponta para o registrador de conversão (0x00) para ler
-    uint8_t pointer_reg = 0x00;
-    i2c_write_blocking(I2C0_PORT, ADS1115_ADDR, &pointer_reg, 1, false);
+    int16_t value = 0;
+    read_conversion(address, &value);
+    capture_record(CAPTURE_SOURCE_ADC, channel, value);
 
-    uint8_t read_buf[2];
-    i2c_read_blocking(I2C0_PORT, ADS1115_ADDR, read_buf, 2, false);
+    return value;
+}
+
+/**
+ * @brief Converte um resultado bruto do ADC em tensão, em ponto fixo.
+ * @note Usa um produto de 64 bits, mantendo a resolução do Q16.16 (~15 uV)
+ * sem passar por float.
+ * * @param raw O resultado bruto da conversão.
+ * @return A tensão correspondente em Volts (Q16.16).
+ */
+fixed_t ads1115_raw_to_voltage(int16_t raw){
+    return (fixed_t)(((int64_t)raw * FIXED_FROM_FLOAT(ADS1115_VREF)) / ADS1115_MAX_ADC_CODE);
+}
+
+/**
+ * @brief Coloca um conversor em modo contínuo na entrada indicada.
+ * @note A escrita da configuração reinicia a conversão: o resultado é lido no
+ * pulso ALERT/RDY que chega após o período nominal ou, se o pulso se perder, após
+ * o tempo máximo de conversão. O comparador fica configurado para
+ * sinalizar o fim de cada conversão (COMP_QUE = 00).
+ * * @param device Ponteiro para o conversor.
+ * @param input A entrada analógica (0 a 3).
+ * @return true se a configuração foi escrita, false caso contrário.
+ */
+static bool start_continuous(ads1115_device_t *device, uint8_t input){
+    uint8_t config_msb = 0;
+    if(!build_config_msb(input, false, &config_msb)) return false;
+
+    // Comparator: traditional, active low, non-latching, assert after one conversion
+    uint16_t sps = data_rate_sps;
+    uint8_t config_lsb = 0;
+    if(!data_rate_bits(sps, &config_lsb)) return false;
+
+    // The conversion starts at the end of the write, which may wait for the bus: the
+    // pulse is expected a period after the write was issued, the fallback counts from its end
+    device->input = input;
+    device->start_us = time_us_64();
+    device->converting = write_register(device->address, ADS1115_REG_CONFIG, (config_msb << 8) | config_lsb);
+    device->ready_us = time_us_64() + conversion_time_us(sps);
+
+    return device->converting;
+}
+
+/**
+ * @brief Escolhe a próxima entrada ativa de um conversor depois de 'input' (round-robin).
+ * * @param device Ponteiro para o conversor.
+ * @param input A entrada atual.
+ * @return A próxima entrada ativa, ou a própria 'input' se for a única.
+ */
+static uint8_t next_input(const ads1115_device_t *device, uint8_t input){
+    uint8_t mask = device->inputs;
+
+    for(uint8_t i = 1; i <= ADS1115_INPUTS_PER_DEVICE; i++){
+        uint8_t candidate = (input + i) % ADS1115_INPUTS_PER_DEVICE;
+        if(mask & (1 << candidate)) return candidate;
+    }
+
+    return input;
+}
+
+/**
+ * @brief Armazena uma amostra no buffer circular do canal.
+ * * @param channel O canal lógico da amostra.
+ * @param value O resultado bruto da conversão.
+ */
+static void store_sample(uint8_t channel, int16_t value){
+    ads1115_ring_t *ring = &rings[channel];
+
+    taskENTER_CRITICAL();
+    ring->samples[ring->head] = value;
+    ring->head = (ring->head + 1) % ADS1115_RING_SIZE;
+    if(ring->count < ADS1115_RING_SIZE) ring->count++;
+    ring->total++;
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief Armazena uma amostra convertida e a registra na captura (sensor_capture).
+ * * @param channel O canal lógico da amostra.
+ * @param value O resultado bruto da conversão.
+ */
+static void push_sample(uint8_t channel, int16_t value){
+    store_sample(channel, value);
+    capture_record(CAPTURE_SOURCE_ADC, channel, value);
+}
+
+/**
+ * @brief Atende um conversor: lê o resultado pronto e avança a sua varredura.
+ * @note Como os pinos ALERT/RDY são ligados em conjunto, um pulso só é atribuído
+ * a um conversor que já converte há pelo menos o período nominal; sem pulso, o
+ * resultado é lido no tempo máximo de conversão (ready_us).
+ * * @param index Índice do conversor na tabela.
+ * @param now_us Instante atual (em us desde o boot).
+ * @param rdy true se a task foi acordada por um pulso ALERT/RDY.
+ */
+static void service_device(uint8_t index, uint64_t now_us, bool rdy){
+    ads1115_device_t *device = &devices[index];
+
+    if(!device->present || !device->inputs) return;
+
+    uint32_t period_us = conversion_period_us(data_rate_sps);
+    bool converted = rdy && device->converting && now_us >= device->start_us + period_us;
+    if(!converted && now_us < device->ready_us) return;
+
+    if(!device->converting){
+        start_continuous(device, next_input(device, ADS1115_INPUTS_PER_DEVICE - 1));
+        return;
+    }
+
+    int16_t value;
+    if(!read_conversion(device->address, &value)){
+        device->converting = false;
+        return;
+    }
+    push_sample(ADS1115_CHANNEL(index, device->input), value);
+
+    uint8_t next = next_input(device, device->input);
+    if(next != device->input){
+        start_continuous(device, next);
+        return;
+    }
+
+    // Continuous mode: the conversion in progress started when the one just read ended.
+    // A late wake moves the start forward only past conversions surely missed, as the
+    // start may trail the converter by the write's wait for the bus
+    device->start_us += period_us;
+    while(now_us >= device->start_us + 2 * period_us) device->start_us += period_us;
+    device->ready_us = now_us + conversion_time_us(data_rate_sps);
+}
+
+/**
+ * @brief Tratador da interrupção do pino ALERT/RDY (fim de conversão).
+ * @note Apenas acorda a task de aquisição; a leitura I2C é feita fora da interrupção.
+ */
+static void ads1115_alert_irq_handler(void){
+    if(!(gpio_get_irq_event_mask(ADS1115_ALERT_PIN) & GPIO_IRQ_EDGE_FALL)) return;
+    gpio_acknowledge_irq(ADS1115_ALERT_PIN, GPIO_IRQ_EDGE_FALL);
+
+    BaseType_t higher_priority_task_woken = pdFALSE;
+    if(scan_task_handle) vTaskNotifyGiveFromISR(scan_task_handle, &higher_priority_task_woken);
+    portYIELD_FROM_ISR(higher_priority_task_woken);
+}
+
+/**
+ * @brief Calcula quanto a task de aquisição pode dormir até o próximo resultado garantido.
+ * @note Limita a espera pelo pulso ALERT/RDY: como os pinos são ligados em
+ * conjunto, o pulso não diz qual conversor terminou, e um pulso perdido não
+ * pode parar a varredura. Um conversor parado (troca de taxa, falha de I2C)
+ * também é reiniciado no seu ready_us.
+ * * @param now_us Instante atual (em us desde o boot).
+ * @return Os ticks a esperar (arredondados para cima), 0 se um conversor já deve
+ * ser atendido, ou portMAX_DELAY se nenhum canal está em varredura.
+ */
+static TickType_t ticks_until_ready(uint64_t now_us){
+    uint64_t earliest_us = UINT64_MAX;
+
+    for(uint8_t i = 0; i < ADS1115_MAX_DEVICES; i++){
+        const ads1115_device_t *device = &devices[i];
+        if(!device->present || !device->inputs) continue;
+
+        if(device->ready_us <= now_us) return 0;
+        if(device->ready_us < earliest_us) earliest_us = device->ready_us;
+    }
+
+    if(earliest_us == UINT64_MAX) return portMAX_DELAY;
+
+    const uint64_t tick_us = 1000000u / configTICK_RATE_HZ;
+    return (TickType_t)((earliest_us - now_us + tick_us - 1) / tick_us);
+}
+
+/**
+ * @brief Função da task do motor de aquisição dos ADS1115.
+ * @note Esta task é responsável por:
+ * 1. Dormir até um pulso de conversão pronta (ALERT/RDY, ligados em conjunto),
+ * até o tempo máximo da conversão em andamento ou até um canal ser incluído.
+ * 2. Percorrer os conversores, lendo os que já convertem há um período nominal
+ * (no pulso) ou há o tempo máximo de conversão, e armazenar o resultado no buffer
+ * circular do canal.
+ * 3. Alternar cada conversor para a sua próxima entrada ativa (round-robin).
+ * Como cada conversor converte de forma independente, o tráfego I2C de um
+ * ocorre enquanto os outros convertem, e a taxa total cresce com a quantidade
+ * de conversores.
+ * * @param params Parâmetros de inicialização da task (não utilizados).
+ */
+static void task_ads1115_scan(void *params){
+    while(true){
+        bool rdy = ulTaskNotifyTake(pdTRUE, ticks_until_ready(time_us_64())) > 0;
+
+        for(uint8_t i = 0; i < ADS1115_MAX_DEVICES; i++){
+            service_device(i, time_us_64(), rdy);
+        }
+    }
+}
+
+/**
+ * @brief Inicializa o motor de aquisição contínua dos ADS1115.
+ * @note Procura os conversores nos endereços 0x48 a 0x4B, configurando os
+ * limiares do comparador de cada um para que o pino ALERT/RDY sinalize o fim
+ * de cada conversão. Em seguida registra a interrupção de borda de descida e
+ * cria a task de aquisição com prioridade (IDLE + 5) e afinidade com o Core 0.
+ * Os canais só são amostrados após ads1115_scan_enable_channel().
+ * * @return true se ao menos um conversor respondeu e a task foi criada, false caso contrário.
+ */
+bool ads1115_scan_init(void){
+    uint8_t device_count = 0;
+
+    for(uint8_t i = 0; i < ADS1115_MAX_DEVICES; i++){
+        devices[i].address = ADS1115_BASE_ADDR + i;
+        devices[i].converting = false;
+        devices[i].ready_us = 0;
+
+        // Hi_thresh MSB = 1 and Lo_thresh MSB = 0 turn ALERT/RDY into a conversion-ready pin
+        devices[i].present = write_register(devices[i].address, ADS1115_REG_LO_THRESH, 0x0000) &&
+                             write_register(devices[i].address, ADS1115_REG_HI_THRESH, 0x8000);
+        if(devices[i].present) device_count++;
+    }
+
+    if(device_count == 0) return false;
+
+    gpio_init(ADS1115_ALERT_PIN);
+    gpio_set_dir(ADS1115_ALERT_PIN, GPIO_IN);
+    gpio_pull_up(ADS1115_ALERT_PIN); // ALERT/RDY is open drain
+
+    scan_task_handle = xTaskCreateStatic(
+        task_ads1115_scan,
+        "Task ADS1115",
+        ADS1115_SCAN_STACK_SIZE,
+        NULL,
+        tskIDLE_PRIORITY + 5,
+        scan_task_stack,
+        &scan_task_buffer
+    );
+
+    if(scan_task_handle == NULL) return false;
+    vTaskCoreAffinitySet(scan_task_handle, (1 << 0)); // Set task to run on core 0
+
+    gpio_add_raw_irq_handler(ADS1115_ALERT_PIN, ads1115_alert_irq_handler);
+    gpio_set_irq_enabled(ADS1115_ALERT_PIN, GPIO_IRQ_EDGE_FALL, true);
+    irq_set_enabled(IO_IRQ_BANK0, true);
+
+    return true;
+}
+
+/**
+ * @brief Inclui um canal na varredura round-robin do motor de aquisição.
+ * @note A taxa por canal é a taxa de dados do conversor dividida pela quantidade de
+ * entradas ativas do mesmo conversor. Deve ser chamada após ads1115_scan_init().
+ * * @param channel O canal lógico (ADS1115_CHANNEL(conversor, entrada)).
+ * @return true se o canal é válido e o seu conversor respondeu, false caso contrário.
+ */
+bool ads1115_scan_enable_channel(uint8_t channel){
+    if(channel >= ADS1115_NUM_CHANNELS) return false;
+
+    ads1115_device_t *device = &devices[channel / ADS1115_INPUTS_PER_DEVICE];
+    if(!device->present) return false;
+
+    taskENTER_CRITICAL();
+    device->inputs |= (1 << (channel % ADS1115_INPUTS_PER_DEVICE));
+    taskEXIT_CRITICAL();
+
+    // The task may be waiting with no channel to scan
+    if(scan_task_handle) xTaskNotifyGive(scan_task_handle);
+    return true;
+}
+
+/**
+ * @brief Altera a taxa de dados de todos os conversores em execução.
+ * @note Reduzir a taxa libera o barramento I2C e a CPU quando não é preciso
+ * amostrar rápido. A nova taxa é aplicada na próxima escrita de configuração,
+ * forçada aqui para todos os conversores.
+ * * @param sps A nova taxa em amostras/s (8, 16, 32, 64, 128, 250, 475 ou 860).
+ * @return true se a taxa é suportada, false caso contrário.
+ */
+bool ads1115_scan_set_data_rate(uint16_t sps){
+    uint8_t bits;
+    if(!data_rate_bits(sps, &bits)) return false;
+    if(sps == data_rate_sps) return true;
+
+    taskENTER_CRITICAL();
+    data_rate_sps = sps;
+    for(uint8_t i = 0; i < ADS1115_MAX_DEVICES; i++){
+        devices[i].converting = false;
+        devices[i].ready_us = 0;
+    }
+    taskEXIT_CRITICAL();
+
+    if(scan_task_handle) xTaskNotifyGive(scan_task_handle);
+    return true;
+}
+
+/**
+ * @brief Copia, sem bloquear, as amostras mais recentes de um canal.
+ * * @param channel O canal lógico (ADS1115_CHANNEL(conversor, entrada)).
+ * @param samples Buffer de destino, em ordem cronológica (a mais recente por último).
+ * @param count Quantidade máxima de amostras desejadas.
+ * @return A quantidade de amostras copiadas (menor que 'count' se o buffer ainda não encheu).
+ */
+size_t ads1115_scan_get_samples(uint8_t channel, int16_t *samples, size_t count){
+    if(channel >= ADS1115_NUM_CHANNELS || !samples) return 0;
+
+    ads1115_ring_t *ring = &rings[channel];
+
+    taskENTER_CRITICAL();
+    if(count > ring->count) count = ring->count;
+
+    size_t start = (ring->head + ADS1115_RING_SIZE - count) % ADS1115_RING_SIZE;
+    for(size_t i = 0; i < count; i++){
+        samples[i] = ring->samples[(start + i) % ADS1115_RING_SIZE];
+    }
+    taskEXIT_CRITICAL();
+
+    return count;
+}
+
+/**
+ * @brief Copia, sem bloquear, apenas as amostras de um canal ainda não lidas pelo consumidor.
+ * @note Permite alimentar filtros incrementais amostra a amostra. Se mais de 'count'
+ * amostras chegaram desde a última leitura (ou se o buffer circular já as
+ * sobrescreveu), apenas as mais recentes são copiadas.
+ * * @param channel O canal lógico (ADS1115_CHANNEL(conversor, entrada)).
+ * @param cursor Posição do consumidor no fluxo (iniciada em 0); é atualizada pela função.
+ * @param samples Buffer de destino, em ordem cronológica (a mais recente por último).
+ * @param count Quantidade máxima de amostras desejadas.
+ * @return A quantidade de amostras novas copiadas.
+ */
+size_t ads1115_scan_get_new_samples(uint8_t channel, uint32_t *cursor, int16_t *samples, size_t count){
+    if(channel >= ADS1115_NUM_CHANNELS || !cursor || !samples) return 0;
+
+    ads1115_ring_t *ring = &rings[channel];
+
+    taskENTER_CRITICAL();
+    uint32_t pending = ring->total - *cursor;
+    if(pending < count) count = pending;
+    if(count > ring->count) count = ring->count;
+
+    size_t start = (ring->head + ADS1115_RING_SIZE - count) % ADS1115_RING_SIZE;
+    for(size_t i = 0; i < count; i++){
+        samples[i] = ring->samples[(start + i) % ADS1115_RING_SIZE];
+    }
+    *cursor = ring->total;
+    taskEXIT_CRITICAL();
+
+    return count;
+}
+
+/**
+ * @brief Retorna o total de amostras já adquiridas em um canal.
+ * @note Útil para medir a taxa efetiva por canal e detectar dados repetidos.
+ * * @param channel O canal lógico (ADS1115_CHANNEL(conversor, entrada)).
+ * @return O contador de amostras do canal (0 para canal inválido).
+ */
+uint32_t ads1115_scan_get_sample_count(uint8_t channel){
+    if(channel >= ADS1115_NUM_CHANNELS) return 0;
+    return rings[channel].total;
+}
+
+/**
+ * @brief Insere uma amostra no fluxo de um canal como se tivesse sido convertida.
+ * @note Usada pela reprodução de capturas (sensor_replay) para alimentar os
+ * drivers de pH e TDS com dados gravados, sem conversores no barramento. A
+ * amostra não é registrada de novo na captura.
+ * * @param channel O canal lógico (ADS1115_CHANNEL(conversor, entrada)).
+ * @param value O resultado bruto a ser inserido.
+ */
+void ads1115_scan_inject_sample(uint8_t channel, int16_t value){
+    if(channel >= ADS1115_NUM_CHANNELS) return;
+    store_sample(channel, value);
+}
+
+/**
+ * @brief Retorna a quantidade de conversores que responderam em ads1115_scan_init().
+ */
+uint8_t ads1115_get_device_count(void){
+    uint8_t device_count = 0;
+
+    for(uint8_t i = 0; i < ADS1115_MAX_DEVICES; i++){
+        if(devices[i].present) device_count++;
+    }
 
-    return (int16_t)((read_buf[0] << 8) | read_buf[1]);
-}
\ No newline at end of file
+    return device_count;
+}
@@ -1,39 +1,95 @@
 #include "oled_display.h"
 #include <string.h>
-#include <stdlib.h>
 #include <stdio.h>
 #include "hardware/gpio.h"
 
+#define OLED_BUFFER_SIZE (OLED_WIDTH * OLED_PAGES)
+#define OLED_WINDOW_SIZE 12 // column and page address commands, each byte behind a Co = 1 control byte
+
 /**
- * @brief Envia um único byte de comando para o display OLED via I2C.
- * * @param oled Ponteiro para a estrutura ssd1306_t.
- * @param command O byte de comando a ser enviado.
+ * @brief Transação de um quadro: janela de endereços seguida do quadro em desenho (ram_buffer).
  */
-static void ssd1306_send_command(ssd1306_t* oled, uint8_t command) {
-    oled->port_buffer[0] = 0x80; // Control byte for command
-    oled->port_buffer[1] = command;
-    i2c_write_blocking(oled->i2c_port, oled->address, oled->port_buffer, 2, false);
-}
+static uint8_t oled_frame[OLED_WINDOW_SIZE + OLED_BUFFER_SIZE];
+
+/**
+ * @brief Cópia do último quadro enviado ao display.
+ */
+static uint8_t oled_shown_buffer[OLED_BUFFER_SIZE];
 
 /**
  * @brief Envia uma lista de bytes de comando para o display OLED.
+ * @note A lista inteira é uma única transação do barramento (um par controle +
+ * comando por escrita), sem intercalar tráfego de outras tasks.
  * * @param oled Ponteiro para a estrutura ssd1306_t.
  * @param commands Ponteiro para o array de comandos.
  * @param len O número de comandos no array.
+ * @return true se o display reconheceu todos os comandos, false caso contrário.
+ */
+static bool ssd1306_send_command_list(ssd1306_t* oled, const uint8_t* commands, size_t len) {
+    i2c_transaction_t transaction = {
+        .kind = I2C_BUS_COMMAND_LIST,
+        .address = oled->address,
+        .control = 0x80, // Control byte for command
+        .tx = commands,
+        .tx_len = len
+    };
+    return i2c_bus_transfer(oled->i2c_port, &transaction);
+}
+
+/**
+ * @brief Aguarda o envio do quadro anterior antes de o ram_buffer ser alterado.
+ * * @param oled Ponteiro para a estrutura ssd1306_t.
+ */
+static void ssd1306_wait_render(ssd1306_t* oled) {
+    if (i2c_bus_is_busy(&oled->render_frame)) i2c_bus_wait(&oled->render_frame, portMAX_DELAY);
+}
+
+/**
+ * @brief Conclusão do envio de um quadro (callback da transação, na task do I2C1).
+ * @note Só um quadro reconhecido pelo display passa a ser o quadro exibido; após
+ * uma falha o conteúdo do display é incerto e o próximo quadro é sempre enviado.
+ * O ram_buffer não muda durante o envio (oled_clear() aguarda a conclusão).
+ * * @param transaction A transação do quadro.
+ * @param success Resultado da transação.
  */
-static void ssd1306_send_command_list(ssd1306_t* oled, const uint8_t* commands, size_t len) {
-    for (size_t i = 0; i < len; i++) {
-        ssd1306_send_command(oled, commands[i]);
+static void ssd1306_render_done(i2c_transaction_t* transaction, bool success) {
+    ssd1306_t* oled = (ssd1306_t*)transaction->context;
+
+    if (!success) {
+        oled->shown_valid = false;
+        return;
+    }
+
+    memcpy(oled->shown_buffer, oled->ram_buffer, oled->buffer_size);
+    oled->shown_valid = true;
+    oled->frames_rendered++;
+}
+
+/**
+ * @brief Monta a janela de endereços (todas as colunas e páginas) à frente do quadro.
+ * @note Cada comando vai atrás de um byte de controle com Co = 1; o byte de
+ * controle de dados (0x40, Co = 0) no início do ram_buffer faz do restante da
+ * escrita a GDDRAM. Janela e quadro saem numa única transação do barramento.
+ * * @param oled Ponteiro para a estrutura ssd1306_t.
+ */
+static void ssd1306_build_window(ssd1306_t* oled) {
+    const uint8_t commands[OLED_WINDOW_SIZE / 2] = {
+        0x21, 0, oled->width - 1, // Set column address: start, end
+        0x22, 0, oled->pages - 1  // Set page address: start, end
+    };
+
+    for (size_t i = 0; i < sizeof(commands); i++) {
+        oled->frame[2 * i] = 0x80; // Control byte for a single command
+        oled->frame[2 * i + 1] = commands[i];
     }
 }
 
 /**
  * @brief Inicializa a estrutura ssd1306_t e o hardware do display OLED.
- * @note Aloca memória para o ram_buffer, configura o I2C e envia a sequência 
- * de inicialização de comandos para o SSD1306.
+ * @note Associa os buffers estáticos do quadro (ram_buffer, precedido da janela de endereços, e a cópia do último quadro enviado),
+ * configura o I2C e envia a sequência de inicialização de comandos para o SSD1306.
  * * @param oled Ponteiro para a estrutura ssd1306_t a ser inicializada.
- * @return true se a inicialização for bem-sucedida (especialmente a alocação de memória), 
- * false caso contrário.
+ * @return true se o display reconheceu a sequência de inicialização, false caso contrário.
  */
 bool oled_init(ssd1306_t* oled) {
     if(!oled) return false;
@@ -43,12 +99,18 @@ bool oled_init(ssd1306_t* oled) {
     oled->pages = OLED_PAGES;
     oled->address = OLED_I2C_ADDRESS;
     oled->i2c_port = I2C1_PORT;
-    oled->buffer_size = oled->width * oled->pages;
-    oled->ram_buffer = calloc(oled->buffer_size, sizeof(uint8_t));
+    oled->buffer_size = OLED_BUFFER_SIZE;
+    oled->frame = oled_frame;
+    oled->ram_buffer = oled_frame + OLED_WINDOW_SIZE;
+    oled->shown_buffer = oled_shown_buffer;
+    oled->shown_valid = false;
+    oled->frames_rendered = 0;
+    oled->frames_skipped = 0;
 
-    if(!oled->ram_buffer) return false;
+    memset(oled->ram_buffer, 0x00, oled->buffer_size);
 
     oled->ram_buffer[0] = 0x40; // Control byte for data
+    ssd1306_build_window(oled);
 
     // Pins setup
     i2c1_configs(OLED_I2C_FREQ);
@@ -69,38 +131,55 @@ bool oled_init(ssd1306_t* oled) {
         0xAF // Display ON
     };
 
-    ssd1306_send_command_list(oled, init_commands, sizeof(init_commands));
-
-    return true;
+    return ssd1306_send_command_list(oled, init_commands, sizeof(init_commands));
 }
 
 /**
  * @brief Limpa o buffer da RAM do OLED (preenche com 0x00).
  * @note Isto limpa apenas o buffer local. Chame oled_render() para 
- * enviar o buffer limpo para o display.
+ * enviar o buffer limpo para o display. Se o quadro anterior ainda está sendo
+ * enviado, aguarda a conclusão antes de alterar o buffer.
  * @note O byte de controle (índice 0) não é zerado.
  * * @param oled Ponteiro para a estrutura ssd1306_t.
  */
 void oled_clear(ssd1306_t* oled) {
     if(!oled || !oled->ram_buffer) return;
+    ssd1306_wait_render(oled);
     memset(&oled->ram_buffer[1], 0x00, oled->buffer_size - 1);
 }
 
 /**
  * @brief Envia o conteúdo do ram_buffer local para a RAM do display OLED.
  * @note Esta função atualiza o display físico com o que foi desenhado no buffer.
+ * O envio é assíncrono: a janela de endereços e o quadro formam uma única
+ * transação, enfileirada no gerenciador do I2C1 e transferida por DMA enquanto a
+ * task segue. Com a fila cheia, aguarda espaço por até I2C_BUS_TIMEOUT_MS por
+ * transação à frente; se ainda assim não couber, o quadro é descartado. O próximo
+ * oled_clear() aguarda o fim do envio; o buffer não deve ser alterado antes disso.
+ * @note Um quadro idêntico ao último que o display reconheceu não é transferido
+ * (frames_skipped): o conteúdo visível não mudaria e o barramento fica livre.
+ * frames_rendered conta apenas os quadros reconhecidos.
  * * @param oled Ponteiro para a estrutura ssd1306_t.
  */
 void oled_render(ssd1306_t* oled) {
     if(!oled || !oled->ram_buffer) return;
 
-    ssd1306_send_command(oled, 0x21); // Set column address
-    ssd1306_send_command(oled, 0);    // Column start address
-    ssd1306_send_command(oled, oled->width - 1); // Column end address
+    ssd1306_wait_render(oled);
 
-    ssd1306_send_command(oled, 0x22); // Set page address
-    ssd1306_send_command(oled, 0);    // Page start address
-    ssd1306_send_command(oled, oled->pages - 1); // Page end address
+    if(oled->shown_valid && memcmp(oled->shown_buffer, oled->ram_buffer, oled->buffer_size) == 0){
+        oled->frames_skipped++;
+        return;
+    }
+
+    oled->render_frame = (i2c_transaction_t){
+        .kind = I2C_BUS_WRITE,
+        .address = oled->address,
+        .tx = oled->frame,
+        .tx_len = OLED_WINDOW_SIZE + oled->buffer_size,
+        .callback = ssd1306_render_done,
+        .context = oled
+    };
 
-    i2c_write_blocking(oled->i2c_port, oled->address, oled->ram_buffer, oled->buffer_size, false);
+    // Every queued transaction ends within I2C_BUS_TIMEOUT_MS
+    i2c_bus_submit_wait(oled->i2c_port, &oled->render_frame, pdMS_TO_TICKS(I2C_BUS_TIMEOUT_MS * I2C_BUS_QUEUE_LENGTH));
 }
@@ -1,4 +1,5 @@
 #include "oled_environment.h"
+#include "hardware/sync.h"
 
 /**
  * @brief Instância global da estrutura do display OLED.
@@ -14,7 +15,33 @@ ssd1306_t oled;
 SemaphoreHandle_t oled_mutex = NULL;
 
 /**
- * @brief Variável volátil que controla qual tela está sendo exibida.
- * Usada para gerenciar a máquina de estados da interface do usuário.
+ * @brief Tela exibida, publicada pela task de paginação (Core 0) e lida pelo display (Core 1).
+ * @note Palavra de 32 bits alinhada: leitura e escrita são atômicas no Cortex-M0+.
+ * Acessada apenas por current_screen_get() / current_screen_set().
  */
-volatile oled_screen_t current_screen = DEFAULT_SCREEN;
\ No newline at end of file
+static volatile uint32_t current_screen = DEFAULT_SCREEN;
+
+/**
+ * @brief Lê a tela publicada.
+ * @note A barreira garante que o que foi escrito antes da publicação já é visível.
+ * * @return A tela atual (oled_screen_t).
+ */
+oled_screen_t current_screen_get(void){
+    oled_screen_t screen = (oled_screen_t)current_screen;
+    __dmb();
+    return screen;
+}
+
+/**
+ * @brief Publica a tela a ser exibida.
+ * @note Deve ter um único escritor (task_pagination); a barreira ordena a
+ * publicação antes da notificação do display que a segue.
+ * * @param screen A nova tela (menor que TOTAL_SCREENS).
+ */
+void current_screen_set(oled_screen_t screen){
+    if(screen >= TOTAL_SCREENS) return;
+
+    __dmb();
+    current_screen = screen;
+    __dmb();
+}
\ No newline at end of file
@@ -8,7 +8,7 @@
  * @param x Posição X inicial (canto esquerdo) onde o bitmap será desenhado.
  * @param start_y Página (linha de 8 pixels) Y inicial onde o bitmap será desenhado.
  */
-static void print_large_symbol(ssd1306_t* oled, const uint8_t* bitmap, uint8_t x, uint8_t start_y) {
+void print_large_symbol(ssd1306_t* oled, const uint8_t* bitmap, uint8_t x, uint8_t start_y) {
     for(uint8_t col = 0; col < SSD1306_CHAR_LARGE_WIDTH; col++) {
         for(uint8_t page = 0; page < SSD1306_CHAR_LARGE_PAGES; page++) {
             int index = col * SSD1306_BITMAP_LARGE_HEIGHT + (page + 5);
@@ -5,12 +5,19 @@
 #include "task_display.h"
 #include "task_pagination.h"
 #include "task_handshake.h"
+#include "task_diagnostics.h"
+#include "task_log.h"
+#include "notifications.h"
+#include "log.h"
 
 
 
-QueueHandle_t queue_sensors_data = NULL;
-QueueHandle_t queue_normalized_sensors_data = NULL;
-QueueHandle_t queue_notifications = NULL;
+mailbox_t mailbox_sensors_data;
+mailbox_t mailbox_normalized_sensors_data;
+
+// Buffers of the latest-value mailboxes (written by task_sensors, read from core 1)
+static sensors_data_t sensors_data_buffers[2];
+static normalized_sensors_data_t normalized_sensors_data_buffers[2];
 
 int main(){
     stdio_init_all();
@@ -22,35 +29,26 @@ int main(){
 
     // Initializes the OLED display
     if(!oled_init(&oled)){
-        printf("Error starting OLED display!\n");
+        log_text("Error starting OLED display!\n");
         while(true);
     }
 
     // Creates mutex for shared use of OLED
-    oled_mutex = xSemaphoreCreateMutex();
+    static StaticSemaphore_t oled_mutex_buffer;
+    oled_mutex = xSemaphoreCreateMutexStatic(&oled_mutex_buffer);
     if(oled_mutex == NULL){
-        printf("Error creating OLED display mutex!\n");
-        while(true);
-    }
-
-    // Creates queue for sensors data
-    queue_sensors_data = xQueueCreate(MAX_SENSORS_DATA, sizeof(sensors_data_t));
-    if(queue_sensors_data == NULL){
-        printf("Error creating sensor data queue!\n");
+        log_text("Error creating OLED display mutex!\n");
         while(true);
     }
 
-    // Creates queue for normalized sensors data
-    queue_normalized_sensors_data = xQueueCreate(MAX_SENSORS_DATA, sizeof(normalized_sensors_data_t));
-    if(queue_normalized_sensors_data == NULL){
-        printf("Error creating sensor data queue!\n");
-        while(true);
-    }
+    // Latest sensor values for the display and the handshake
+    mailbox_init(&mailbox_sensors_data, &sensors_data_buffers[0], &sensors_data_buffers[1], sizeof(sensors_data_t));
+    mailbox_init(&mailbox_normalized_sensors_data, &normalized_sensors_data_buffers[0],
+                 &normalized_sensors_data_buffers[1], sizeof(normalized_sensors_data_t));
 
-    // Creates queue for notifications
-    queue_notifications = xQueueCreate(MAX_NOTIFICATIONS, sizeof(notification_t));
-    if(queue_notifications == NULL){
-        printf("Error creating notifications queue!\n");
+    // Initializes the notifications ring (must precede any sender task)
+    if(!notifications_init()){
+        log_text("Error starting notifications ring!\n");
         while(true);
     }
 
@@ -66,6 +64,12 @@ int main(){
     // Task Handshake
     create_task_handshake();
 
+    // Task Diagnostics
+    create_task_diagnostics();
+
+    // Task Log (drains the deferred log to USB stdio)
+    create_task_log();
+
     // FreeRTOS scheduler
     vTaskStartScheduler();
 
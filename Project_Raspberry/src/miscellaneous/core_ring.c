@@ -0,0 +1,75 @@
+#include "core_ring.h"
+#include "hardware/sync.h"
+#include <string.h>
+
+/**
+ * @brief Reserva o próximo registro livre do anel de um core.
+ * @note Deve ser chamada no próprio core, com as interrupções desabilitadas até
+ * core_ring_publish(): cada core escreve apenas no seu anel, então não há trava
+ * entre os cores. Com o anel cheio, o registro é descartado e contado.
+ * * @param ring Ponteiro para os anéis.
+ * @param core O core atual.
+ * @return O registro a ser preenchido, ou NULL se o anel está cheio.
+ */
+void *core_ring_claim(core_ring_t *ring, uint8_t core){
+    core_ring_lane_t *lane = &ring->lanes[core];
+
+    uint32_t head = lane->head;
+    if(head - lane->tail >= ring->capacity){
+        lane->dropped++;
+        return NULL;
+    }
+
+    uint32_t index = core * ring->capacity + (head & (ring->capacity - 1));
+    return &ring->records[index * ring->record_size];
+}
+
+/**
+ * @brief Entrega ao consumidor o registro reservado por core_ring_claim().
+ * * @param ring Ponteiro para os anéis.
+ * @param core O core atual.
+ */
+void core_ring_publish(core_ring_t *ring, uint8_t core){
+    core_ring_lane_t *lane = &ring->lanes[core];
+
+    __dmb(); // record visible before the new head
+    lane->head = lane->head + 1;
+}
+
+/**
+ * @brief Retira o registro mais antigo de um dos anéis.
+ * @note Deve haver um único consumidor. Os anéis são lidos de forma alternada,
+ * para não privilegiar um core; a ordem global é reconstruída pelos instantes.
+ * * @param ring Ponteiro para os anéis.
+ * @param record Ponteiro onde o registro (record_size bytes) será copiado.
+ * @return true se havia um registro, false se os anéis estão vazios.
+ */
+bool core_ring_take(core_ring_t *ring, void *record){
+    for(uint8_t i = 0; i < NUM_CORES; i++){
+        uint8_t core = ring->next_core;
+        ring->next_core = (core + 1) % NUM_CORES;
+
+        core_ring_lane_t *lane = &ring->lanes[core];
+        uint32_t tail = lane->tail;
+        if(tail == lane->head) continue;
+
+        __dmb(); // head read before the record
+        uint32_t index = core * ring->capacity + (tail & (ring->capacity - 1));
+        memcpy(record, &ring->records[index * ring->record_size], ring->record_size);
+        __dmb(); // record copied before the slot is released
+        lane->tail = tail + 1;
+
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Quantidade de registros descartados por anel cheio em um core.
+ * * @param ring Ponteiro para os anéis.
+ * @param core O core.
+ */
+uint32_t core_ring_dropped(const core_ring_t *ring, uint8_t core){
+    return core < NUM_CORES ? ring->lanes[core].dropped : 0;
+}
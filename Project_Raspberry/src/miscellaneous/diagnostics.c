@@ -0,0 +1,268 @@
+#include "diagnostics.h"
+#include "rtos_memory.h"
+#include "mailbox.h"
+#include "log.h"
+#include "pico/platform.h"
+#include <inttypes.h>
+#include <malloc.h>
+#include <string.h>
+
+// Contabilidade de um core, escrita apenas pelo próprio core na troca de contexto
+typedef struct {
+    volatile uint32_t switches;
+    volatile uint32_t busy_us;      // wraps; only differences are used
+    volatile uint32_t since_us;     // switch-in of the running task
+    volatile bool running_idle;
+} core_accounting_t;
+
+// Tempo de execução de uma task na amostra anterior
+typedef struct {
+    TaskHandle_t handle;
+    uint64_t run_time_us;
+} task_history_t;
+
+static core_accounting_t cores[DIAGNOSTICS_CORES];
+
+/**
+ * @brief Estado da amostra anterior, base das diferenças da janela seguinte.
+ */
+static task_history_t previous_tasks[DIAGNOSTICS_MAX_TASKS];
+static uint8_t previous_task_count = 0;
+static uint32_t previous_switches[DIAGNOSTICS_CORES];
+static uint32_t previous_busy_us[DIAGNOSTICS_CORES];
+static uint64_t previous_us = 0;
+static bool has_previous = false;
+
+/**
+ * @brief Menor memória livre do heap já vista nas amostras.
+ */
+static uint32_t heap_min_free = UINT32_MAX;
+
+static TaskStatus_t task_status[DIAGNOSTICS_MAX_TASKS];
+
+/**
+ * @brief Última amostra publicada, lida pelo display e pelo console.
+ */
+static diagnostics_t diagnostics_buffers[2];
+static mailbox_t mailbox_diagnostics;
+
+#if !FILTERCORE_HOST
+// Limits of the C library heap (linker script)
+extern char __end__;
+extern char __HeapLimit;
+#endif
+
+/**
+ * @brief Memória livre do heap da biblioteca C.
+ * @note No RP2040, o espaço entre a arena do malloc e o limite reservado pelo
+ * linker script. No build de host o heap é o do sistema e não tem limite fixo:
+ * conta o livre dentro da arena, com mallinfo2 (os campos int de mallinfo
+ * transbordam acima de 2 GiB e a função está obsoleta na glibc).
+ */
+static uint32_t heap_free_bytes(void){
+#if FILTERCORE_HOST
+    struct mallinfo2 heap = mallinfo2();
+    return heap.fordblks > UINT32_MAX ? UINT32_MAX : (uint32_t)heap.fordblks;
+#else
+    struct mallinfo heap = mallinfo();
+    uint32_t heap_size = (uint32_t)(&__HeapLimit - &__end__);
+    return heap_size > (uint32_t)heap.arena ? heap_size - (uint32_t)heap.arena : 0;
+#endif
+}
+
+/**
+ * @brief Fração em milésimos, saturada em 1000.
+ * * @param part A parte.
+ * @param whole O todo (0 resulta em 0).
+ */
+static uint16_t permille(uint64_t part, uint64_t whole){
+    if(whole == 0) return 0;
+
+    uint64_t value = (part * 1000 + whole / 2) / whole;
+    return value > 1000 ? 1000 : (uint16_t)value;
+}
+
+/**
+ * @brief Tempo ocupado acumulado de um core até agora, incluindo a task em execução.
+ * * @param core O core.
+ * @param now_us O instante atual (time_us_32).
+ */
+static uint32_t core_busy_us(uint8_t core, uint32_t now_us){
+    core_accounting_t *accounting = &cores[core];
+
+    uint32_t busy_us = accounting->busy_us;
+    if(!accounting->running_idle) busy_us += now_us - accounting->since_us;
+
+    return busy_us;
+}
+
+/**
+ * @brief Procura o tempo de execução de uma task na amostra anterior.
+ * * @param handle O handle da task.
+ * @return O tempo acumulado, ou 0 para uma task criada durante a janela.
+ */
+static uint64_t previous_run_time(TaskHandle_t handle){
+    for(uint8_t i = 0; i < previous_task_count; i++){
+        if(previous_tasks[i].handle == handle) return previous_tasks[i].run_time_us;
+    }
+    return 0;
+}
+
+/**
+ * @brief Converte o estado de uma task do kernel para a forma compacta.
+ * * @param status O estado retornado por uxTaskGetSystemState.
+ * @param window_us A duração da janela de amostragem.
+ */
+static diagnostics_task_t compact_task(const TaskStatus_t *status, uint32_t window_us){
+    diagnostics_task_t task = {
+        .priority = (uint8_t)status->uxCurrentPriority,
+        .cpu_permille = permille(status->ulRunTimeCounter - previous_run_time(status->xHandle), window_us),
+        .stack_free_words = status->usStackHighWaterMark > UINT16_MAX ? UINT16_MAX : (uint16_t)status->usStackHighWaterMark
+    };
+
+    const char *name = status->pcTaskName;
+    if(strncmp(name, "Task ", 5) == 0) name += 5;
+    strncpy(task.name, name, DIAGNOSTICS_NAME_LEN - 1);
+
+#if (configUSE_CORE_AFFINITY == 1) && (configNUMBER_OF_CORES > 1)
+    switch(status->uxCoreAffinityMask){
+        case (1 << 0): task.core = 0; break;
+        case (1 << 1): task.core = 1; break;
+        default: task.core = DIAGNOSTICS_ANY_CORE; break;
+    }
+#else
+    task.core = DIAGNOSTICS_ANY_CORE;
+#endif
+
+    return task;
+}
+
+/**
+ * @brief Inicializa a caixa de último valor das amostras.
+ * @note Deve ser chamada antes de iniciar o escalonador.
+ */
+void diagnostics_init(void){
+    mailbox_init(&mailbox_diagnostics, &diagnostics_buffers[0], &diagnostics_buffers[1], sizeof(diagnostics_t));
+}
+
+/**
+ * @brief Contabiliza uma troca de contexto no core atual.
+ * @note Chamada pelo kernel (traceTASK_SWITCHED_IN, ver FreeRTOSConfig.h) com as
+ * interrupções desabilitadas. O tempo até aqui é somado como ocupado se a task
+ * que sai não era a idle.
+ */
+void diagnostics_task_switched_in(void){
+    core_accounting_t *accounting = &cores[get_core_num()];
+    uint32_t now_us = time_us_32();
+
+    if(!accounting->running_idle) accounting->busy_us += now_us - accounting->since_us;
+
+    accounting->since_us = now_us;
+    accounting->running_idle = rtos_memory_is_idle_task(xTaskGetCurrentTaskHandle());
+    accounting->switches++;
+}
+
+/**
+ * @brief Amostra o estado do sistema desde a amostra anterior e o publica.
+ * @note Por task: fração da CPU (do tempo de execução contado pelo kernel com o
+ * timer de 64 bits), core fixado, prioridade e marca d'água da pilha. Por core:
+ * carga (tempo fora da task idle) e trocas de contexto. O heap livre entra no
+ * mínimo desde o boot, visto apenas nos instantes das amostras, e os contadores
+ * de notificações são os totais desde o boot. A primeira chamada apenas define a
+ * base das diferenças.
+ * * @return true se uma amostra foi publicada, false caso contrário.
+ */
+bool diagnostics_sample(void){
+    uint64_t total_run_time = 0;
+    UBaseType_t count = uxTaskGetSystemState(task_status, DIAGNOSTICS_MAX_TASKS, &total_run_time);
+    if(count == 0) return false; // more tasks than DIAGNOSTICS_MAX_TASKS
+
+    uint32_t heap_free = heap_free_bytes();
+    if(heap_free < heap_min_free) heap_min_free = heap_free;
+
+    uint64_t now_us = time_us_64();
+    uint32_t switches[DIAGNOSTICS_CORES];
+    uint32_t busy_us[DIAGNOSTICS_CORES];
+    for(uint8_t core = 0; core < DIAGNOSTICS_CORES; core++){
+        switches[core] = cores[core].switches;
+        busy_us[core] = core_busy_us(core, (uint32_t)now_us);
+    }
+
+    bool publish = has_previous;
+    if(publish){
+        static diagnostics_t sample;
+        memset(&sample, 0, sizeof(sample));
+        sample.window_us = (uint32_t)(now_us - previous_us);
+
+        for(uint8_t core = 0; core < DIAGNOSTICS_CORES; core++){
+            sample.core_load_permille[core] = permille(busy_us[core] - previous_busy_us[core], sample.window_us);
+            sample.context_switches[core] = switches[core] - previous_switches[core];
+        }
+
+        // Insertion by CPU share, busiest first
+        for(UBaseType_t i = 0; i < count; i++){
+            diagnostics_task_t task = compact_task(&task_status[i], sample.window_us);
+
+            uint8_t position = sample.task_count++;
+            while(position > 0 && sample.tasks[position - 1].cpu_permille < task.cpu_permille){
+                sample.tasks[position] = sample.tasks[position - 1];
+                position--;
+            }
+            sample.tasks[position] = task;
+        }
+
+        sample.heap_min_free = heap_min_free;
+        notifications_get_stats(&sample.notifications);
+
+        mailbox_publish(&mailbox_diagnostics, &sample);
+    }
+
+    for(UBaseType_t i = 0; i < count; i++){
+        previous_tasks[i] = (task_history_t){ task_status[i].xHandle, task_status[i].ulRunTimeCounter };
+    }
+    previous_task_count = (uint8_t)count;
+    memcpy(previous_switches, switches, sizeof(switches));
+    memcpy(previous_busy_us, busy_us, sizeof(busy_us));
+    previous_us = now_us;
+    has_previous = true;
+
+    return publish;
+}
+
+/**
+ * @brief Copia a última amostra publicada, sem bloquear.
+ * * @param diagnostics Ponteiro onde a amostra será escrita.
+ * @return true se já existe uma amostra, false caso contrário.
+ */
+bool diagnostics_read(diagnostics_t *diagnostics){
+    return mailbox_read(&mailbox_diagnostics, diagnostics, NULL);
+}
+
+/**
+ * @brief Imprime uma amostra no console (USB stdio).
+ * * @param diagnostics A amostra.
+ */
+void diagnostics_print(const diagnostics_t *diagnostics){
+    uint32_t window_ms = diagnostics->window_us / 1000;
+    if(window_ms == 0) return;
+
+    log_text("[Diagnostics] window %" PRIu32 " ms | heap min free %" PRIu32 " B\n",
+             window_ms, diagnostics->heap_min_free);
+
+    for(uint8_t core = 0; core < DIAGNOSTICS_CORES; core++){
+        log_text("  core %u: load %u.%u%% | switches %" PRIu32 "/s\n", core,
+                 diagnostics->core_load_permille[core] / 10, diagnostics->core_load_permille[core] % 10,
+                 diagnostics->context_switches[core] * 1000 / window_ms);
+    }
+
+    const notifications_stats_t *notifications = &diagnostics->notifications;
+    log_text("  notifications: sent %" PRIu32 " | coalesced %" PRIu32 " | dropped %" PRIu32 " | pending %u\n",
+             notifications->sent, notifications->coalesced, notifications->dropped, notifications->pending);
+
+    for(uint8_t i = 0; i < diagnostics->task_count; i++){
+        const diagnostics_task_t *task = &diagnostics->tasks[i];
+        log_text("  %-11s core %c | prio %2u | cpu %3u.%u%% | stack free %u words\n",
+                 task->name, task->core == DIAGNOSTICS_ANY_CORE ? '*' : (char)('0' + task->core),
+                 task->priority, task->cpu_permille / 10, task->cpu_permille % 10, task->stack_free_words);
+    }
+}
\ No newline at end of file
@@ -79,11 +79,14 @@ void handshake_request(normalized_sensors_data_t data){
 /**
  * @brief Aguarda pelo reconhecimento (ACK) do FPGA após uma requisição.
  * @note Monitora o pino ACK. Espera que o FPGA eleve o pino ACK para
- * sinalizar que recebeu os dados.
+ * sinalizar que recebeu os dados. Cada chamada tem o seu próprio timeout.
+ * Em caso de timeout, baixa o REQ: o FPGA só lê os dados na borda de subida,
+ * então a próxima tentativa (handshake_request) precisa de uma nova borda.
  * * @return true se o ACK foi recebido dentro do timeout (HANDSHAKE_TIMEOUT_MS),
  * false se ocorreu timeout.
  */
 bool handshake_acknowledge(void){
+    timeout_ms = 0;
     while(!gpio_get(ACK_PIN) && timeout_ms < HANDSHAKE_TIMEOUT_MS){
         vTaskDelay(pdMS_TO_TICKS(10));
         timeout_ms += 10;
@@ -91,7 +94,7 @@ bool handshake_acknowledge(void){
 
     if(timeout_ms >= HANDSHAKE_TIMEOUT_MS){
         send_notification(ERROR, "HS Retry...");
-        gpio_put(ACK_PIN, 0);
+        gpio_put(REQ_PIN, 0);
         return false;
     }
 
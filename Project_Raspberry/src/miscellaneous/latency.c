@@ -0,0 +1,177 @@
+#include "latency.h"
+#include "histogram.h"
+#include "log.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "pico/stdlib.h"
+#include <inttypes.h>
+#include <string.h>
+
+// Histograma de uma etapa; escrito por task_handshake, lido pelo diagnóstico
+typedef struct {
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint32_t histogram[LATENCY_HISTOGRAM_BUCKETS];
+} latency_stage_t;
+
+static const char *const stage_names[LATENCY_STAGES] = {
+    "sample>analyze",
+    "analyze>publish",
+    "publish>pick",
+    "pick>request",
+    "request>ack",
+    "sample>ack"
+};
+
+static latency_stage_t stages[LATENCY_STAGES];
+
+/**
+ * @brief Identificador da última amostra iniciada (apenas task_sensors escreve).
+ */
+static uint32_t last_id = 0;
+
+/**
+ * @brief Identificador da última amostra concluída e amostras substituídas no
+ * mailbox antes de chegarem ao FPGA (lacunas entre identificadores concluídos).
+ */
+static uint32_t last_completed_id = 0;
+static uint32_t superseded = 0;
+
+/**
+ * @brief Registra uma duração em uma etapa.
+ * @note Chamada em seção crítica.
+ * * @param stage A etapa.
+ * @param duration_us A duração.
+ */
+static void record(latency_stage_t *stage, uint32_t duration_us){
+    if(stage->count == 0 || duration_us < stage->min_us) stage->min_us = duration_us;
+    if(duration_us > stage->max_us) stage->max_us = duration_us;
+    stage->histogram[histogram_bucket(duration_us, LATENCY_HISTOGRAM_BUCKETS)]++;
+    stage->count++;
+}
+
+/**
+ * @brief Inicia o rastro de uma nova amostra, com um identificador próprio.
+ * @note Chamada por um único produtor (task_sensors).
+ * * @param trace O rastro (normalmente dentro de normalized_sensors_data_t).
+ * @param sampled_us Instante (time_us_32) da amostra que decidiu os alertas (sensor_pipeline_t).
+ */
+void latency_begin(latency_trace_t *trace, uint32_t sampled_us){
+    memset(trace, 0, sizeof(*trace));
+
+    if(++last_id == 0) last_id = 1; // 0 marks an untraced sample
+    trace->id = last_id;
+
+    latency_mark_at(trace, LATENCY_SAMPLED, sampled_us);
+}
+
+/**
+ * @brief Marca a passagem da amostra por um ponto, no instante atual.
+ * * @param trace O rastro.
+ * @param point O ponto.
+ */
+void latency_mark(latency_trace_t *trace, latency_point_t point){
+    latency_mark_at(trace, point, time_us_32());
+}
+
+/**
+ * @brief Marca a passagem da amostra por um ponto em um instante dado.
+ * @note Útil quando o instante foi medido antes (ou, no host, simulado).
+ * * @param trace O rastro.
+ * @param point O ponto.
+ * @param at_us O instante (time_us_32).
+ */
+void latency_mark_at(latency_trace_t *trace, latency_point_t point, uint32_t at_us){
+    if(trace->id == 0 || point >= LATENCY_POINTS) return;
+
+    trace->at_us[point] = at_us;
+    trace->reached |= (uint8_t)(1u << point);
+}
+
+/**
+ * @brief Soma um rastro concluído aos histogramas de cada etapa.
+ * @note Cada etapa é o intervalo entre dois pontos consecutivos alcançados; a
+ * última é do valor amostrado até o ACK. As diferenças são feitas em 32 bits,
+ * de forma que a volta de time_us_32 não afeta o resultado.
+ * * @param trace O rastro, com LATENCY_ACKNOWLEDGED marcado.
+ */
+void latency_complete(const latency_trace_t *trace){
+    if(trace->id == 0) return;
+
+    taskENTER_CRITICAL();
+    for(uint8_t point = 1; point < LATENCY_POINTS; point++){
+        uint8_t both = (uint8_t)((1u << (point - 1)) | (1u << point));
+        if((trace->reached & both) != both) continue;
+
+        record(&stages[point - 1], trace->at_us[point] - trace->at_us[point - 1]);
+    }
+
+    uint8_t ends = (uint8_t)((1u << LATENCY_SAMPLED) | (1u << LATENCY_ACKNOWLEDGED));
+    if((trace->reached & ends) == ends){
+        record(&stages[LATENCY_END_TO_END], trace->at_us[LATENCY_ACKNOWLEDGED] - trace->at_us[LATENCY_SAMPLED]);
+    }
+
+    if(last_completed_id != 0 && trace->id - last_completed_id > 1){
+        superseded += trace->id - last_completed_id - 1;
+    }
+    last_completed_id = trace->id;
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief Copia as estatísticas de uma etapa.
+ * @note Pode ser chamada de qualquer task; a cópia é feita em seção crítica.
+ * * @param stage Índice da etapa (0 a LATENCY_STAGES - 1; LATENCY_END_TO_END é a total).
+ * @param stats Ponteiro onde as estatísticas serão escritas.
+ * @return true se o índice é válido, false caso contrário.
+ */
+bool latency_get_stats(uint8_t stage, latency_stats_t *stats){
+    if(stage >= LATENCY_STAGES) return false;
+    const latency_stage_t *source = &stages[stage];
+
+    taskENTER_CRITICAL();
+    stats->name = stage_names[stage];
+    stats->count = source->count;
+    stats->min_us = source->min_us;
+    stats->max_us = source->max_us;
+    stats->p50_us = histogram_percentile(source->histogram, LATENCY_HISTOGRAM_BUCKETS, source->count, source->max_us, 50);
+    stats->p90_us = histogram_percentile(source->histogram, LATENCY_HISTOGRAM_BUCKETS, source->count, source->max_us, 90);
+    stats->p99_us = histogram_percentile(source->histogram, LATENCY_HISTOGRAM_BUCKETS, source->count, source->max_us, 99);
+    taskEXIT_CRITICAL();
+
+    return true;
+}
+
+/**
+ * @brief Quantidade de amostras substituídas no mailbox antes de chegarem ao FPGA.
+ */
+uint32_t latency_superseded(void){
+    return superseded;
+}
+
+/**
+ * @brief Zera os histogramas de todas as etapas.
+ */
+void latency_reset_stats(void){
+    taskENTER_CRITICAL();
+    memset(stages, 0, sizeof(stages));
+    superseded = 0;
+    last_completed_id = 0;
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief Imprime no console (canal de diagnóstico) as latências de cada etapa.
+ */
+void latency_print_stats(void){
+    latency_stats_t stats;
+
+    log_text("[Latency] samples superseded before the FPGA: %" PRIu32 "\n", latency_superseded());
+
+    for(uint8_t i = 0; latency_get_stats(i, &stats); i++){
+        log_text("  %-15s n %" PRIu32 " | %" PRIu32 "-%" PRIu32 " us (p50 %" PRIu32 ", p90 %" PRIu32 ", p99 %" PRIu32 ")\n",
+                 stats.name, stats.count, stats.min_us, stats.max_us,
+                 stats.p50_us, stats.p90_us, stats.p99_us);
+    }
+}
\ No newline at end of file
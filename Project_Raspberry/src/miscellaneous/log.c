@@ -0,0 +1,111 @@
+#include "log.h"
+#include "core_ring.h"
+#include "pico/stdlib.h"
+#include "pico/platform.h"
+#include "hardware/sync.h"
+#include <stdarg.h>
+#include <stdio.h>
+
+static log_record_t records[NUM_CORES][LOG_RING_SIZE];
+
+/**
+ * @brief Anéis do log diferido, um por core; o consumidor é task_log.
+ */
+static core_ring_t rings = CORE_RING_INIT(records);
+
+/**
+ * @brief Registra uma mensagem no log diferido, sem formatar e sem bloquear.
+ * @note Pode ser chamada de tasks e interrupções, em qualquer core. Cada core
+ * escreve apenas no seu próprio anel (core_ring), com as interrupções
+ * desabilitadas durante a cópia do registro. Com o anel cheio, o registro é
+ * descartado e contado (log_dropped).
+ * * @param id O identificador da mensagem (log_messages.def).
+ * @param argc A quantidade de argumentos (até LOG_MAX_ARGS).
+ * @param arg0 Primeiro argumento.
+ * @param arg1 Segundo argumento.
+ * @param arg2 Terceiro argumento.
+ */
+void log_event(log_id_t id, uint8_t argc, uint32_t arg0, uint32_t arg1, uint32_t arg2){
+    uint32_t timestamp_us = time_us_32();
+    uint32_t saved_irq = save_and_disable_interrupts();
+
+    uint8_t core = (uint8_t)get_core_num();
+    log_record_t *record = core_ring_claim(&rings, core);
+    if(record){
+        *record = (log_record_t){
+            .id = (uint16_t)id,
+            .argc = argc > LOG_MAX_ARGS ? LOG_MAX_ARGS : argc,
+            .core = core,
+            .timestamp_us = timestamp_us,
+            .args = { arg0, arg1, arg2 }
+        };
+        core_ring_publish(&rings, core);
+    }
+
+    restore_interrupts(saved_irq);
+}
+
+/**
+ * @brief Retira o registro mais antigo de um dos anéis.
+ * @note Deve haver um único consumidor (task_log). Os anéis são lidos de forma
+ * alternada; a ordem global é reconstruída no host pelos instantes.
+ * * @param record Ponteiro onde o registro será copiado.
+ * @return true se havia um registro, false se os anéis estão vazios.
+ */
+bool log_take(log_record_t *record){
+    return core_ring_take(&rings, record);
+}
+
+/**
+ * @brief Quantidade de registros descartados por anel cheio em um core.
+ * * @param core O core.
+ */
+uint32_t log_dropped(uint8_t core){
+    return core_ring_dropped(&rings, core);
+}
+
+/**
+ * @brief Monta o quadro binário de um registro para o console.
+ * * @param record O registro.
+ * @param frame Ponteiro onde o quadro será escrito.
+ */
+void log_frame(const log_record_t *record, log_frame_t *frame){
+    frame->sync[0] = LOG_FRAME_SYNC_0;
+    frame->sync[1] = LOG_FRAME_SYNC_1;
+    frame->record = *record;
+
+    const uint8_t *bytes = (const uint8_t *)record;
+    uint8_t checksum = 0;
+    for(size_t i = 0; i < sizeof(log_record_t); i++) checksum += bytes[i];
+    frame->checksum = checksum;
+}
+
+/**
+ * @brief Escreve texto formatado no console como um quadro de texto.
+ * @note Substitui o printf nos relatórios (diagnóstico, latências, captura): o
+ * texto não se mistura aos bytes dos quadros binários, e tools/log_decode.c o
+ * devolve como veio. Cada chamada vira um quadro completo, escrito de uma vez
+ * (como os de task_log); o texto além de LOG_TEXT_MAX bytes é cortado. Bloqueia
+ * no USB como o printf, então não deve ser chamada de interrupções.
+ * * @param format O formato (printf).
+ */
+void log_text(const char *format, ...){
+    uint8_t frame[LOG_TEXT_FRAME_SIZE(LOG_TEXT_MAX) + 1]; // + vsnprintf's terminator
+
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf((char *)&frame[3], LOG_TEXT_MAX + 1, format, args);
+    va_end(args);
+    if(written <= 0) return;
+
+    uint8_t length = (uint8_t)(written > LOG_TEXT_MAX ? LOG_TEXT_MAX : written);
+    frame[0] = LOG_FRAME_SYNC_0;
+    frame[1] = LOG_TEXT_SYNC_1;
+    frame[2] = length;
+
+    uint8_t checksum = 0;
+    for(size_t i = 2; i < 3u + length; i++) checksum += frame[i];
+    frame[3 + length] = checksum;
+
+    stdio_put_string((const char *)frame, LOG_TEXT_FRAME_SIZE(length), false, false);
+}
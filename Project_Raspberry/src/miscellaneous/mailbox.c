@@ -0,0 +1,84 @@
+#include "mailbox.h"
+#include "hardware/sync.h"
+#include <string.h>
+
+/**
+ * @brief Inicializa uma caixa de último valor.
+ * @note Os dois buffers (de 'size' bytes cada) pertencem à caixa enquanto ela existir.
+ * * @param mailbox Ponteiro para a caixa.
+ * @param buffer_a Primeiro buffer do valor.
+ * @param buffer_b Segundo buffer do valor.
+ * @param size Tamanho do valor em bytes.
+ */
+void mailbox_init(mailbox_t *mailbox, void *buffer_a, void *buffer_b, size_t size){
+    mailbox->sequence = 0;
+    mailbox->buffers[0] = buffer_a;
+    mailbox->buffers[1] = buffer_b;
+    mailbox->size = size;
+}
+
+/**
+ * @brief Publica um novo valor (apenas um escritor por caixa).
+ * @note O valor é escrito no buffer que não contém a última publicação, entre
+ * dois incrementos do contador (ímpar durante a escrita). Não usa o kernel nem
+ * desabilita interrupções; as barreiras (DMB) garantem a ordem das escritas
+ * vista pelo outro core.
+ * * @param mailbox Ponteiro para a caixa.
+ * @param value Ponteiro para o valor a ser copiado.
+ */
+void mailbox_publish(mailbox_t *mailbox, const void *value){
+    uint32_t sequence = mailbox->sequence;
+    uint32_t next = (sequence >> 1) + 1; // publication being written
+
+    mailbox->sequence = sequence + 1;
+    __dmb();
+
+    memcpy(mailbox->buffers[next & 1], value, mailbox->size);
+
+    __dmb();
+    mailbox->sequence = sequence + 2;
+}
+
+/**
+ * @brief Copia o último valor publicado, sem bloquear o escritor.
+ * @note O leitor copia o buffer da última publicação completa e confere o
+ * contador: a cópia só é refeita se o escritor começou a sobrescrever esse mesmo
+ * buffer (duas publicações depois), o que não ocorre com escritas periódicas.
+ * * @param mailbox Ponteiro para a caixa.
+ * @param value Ponteiro onde o valor será copiado.
+ * @param publication Ponteiro onde o número da publicação lida será escrito (opcional).
+ * @return true se já houve ao menos uma publicação, false caso contrário
+ * ('value' não é alterado).
+ */
+bool mailbox_read(const mailbox_t *mailbox, void *value, uint32_t *publication){
+    uint32_t before;
+    uint32_t current;
+
+    do {
+        before = mailbox->sequence;
+        current = before >> 1; // last complete publication
+        if(current == 0) return false;
+
+        __dmb();
+        memcpy(value, mailbox->buffers[current & 1], mailbox->size);
+        __dmb();
+
+        // The buffer of 'current' is rewritten only when publication current + 2 starts
+    } while(mailbox->sequence - before >= ((before & 1) ? 2u : 3u));
+
+    if(publication) *publication = current;
+    return true;
+}
+
+/**
+ * @brief Copia o último valor apenas se ele é mais novo que o último lido.
+ * * @param mailbox Ponteiro para a caixa.
+ * @param value Ponteiro onde o valor será copiado.
+ * @param last_publication Número da última publicação lida por este leitor
+ * (iniciado em 0); é atualizado pela função.
+ * @return true se havia um valor novo, false caso contrário.
+ */
+bool mailbox_read_if_new(const mailbox_t *mailbox, void *value, uint32_t *last_publication){
+    if((mailbox->sequence >> 1) == *last_publication) return false;
+    return mailbox_read(mailbox, value, last_publication);
+}
\ No newline at end of file
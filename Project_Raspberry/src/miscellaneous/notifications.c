@@ -1,18 +1,134 @@
 #include "notifications.h"
+#include "hardware/sync.h"
+#include <string.h>
 
 /**
- * @brief Envia uma notificação para a fila de notificações do FreeRTOS.
- * @note Esta é uma função wrapper que formata a estrutura 'notification_t'
- * e a envia para a fila global 'queue_notifications' de forma segura
- * (com timeout de 50ms).
+ * @brief Notificações pendentes, da mais antiga para a mais nova.
+ */
+static notification_t pending[NOTIFICATIONS_RING_SIZE];
+static uint8_t pending_count = 0;
+
+/**
+ * @brief Contadores de envio, agrupamento e descarte.
+ */
+static notifications_stats_t counters = {0};
+
+/**
+ * @brief Spinlock de hardware que protege o anel entre os dois cores.
+ */
+static spin_lock_t *notifications_lock = NULL;
+
+/**
+ * @brief Remove a notificação pendente de uma posição, mantendo a ordem das demais.
+ * * @param index A posição a ser removida.
+ */
+static void remove_pending(uint8_t index){
+    memmove(&pending[index], &pending[index + 1], (pending_count - index - 1) * sizeof(notification_t));
+    pending_count--;
+}
+
+/**
+ * @brief Inicializa o anel de notificações, reservando um spinlock de hardware.
+ * @note Deve ser chamada antes de qualquer envio (antes de criar as tasks).
+ * * @return true se o spinlock foi reservado, false caso contrário.
+ */
+bool notifications_init(void){
+    int lock_number = spin_lock_claim_unused(false);
+    if(lock_number < 0) return false;
+
+    notifications_lock = spin_lock_init(lock_number);
+    return true;
+}
+
+/**
+ * @brief Envia uma notificação para o anel de notificações, sem bloquear.
+ * @note Pode ser chamada por qualquer task, de qualquer core. A seção protegida
+ * (spinlock de hardware, interrupções desabilitadas no core atual) dura apenas
+ * a busca em NOTIFICATIONS_RING_SIZE posições; o kernel não é chamado e o
+ * remetente nunca espera pelo consumidor. O display é acordado após a seção.
+ * - Uma notificação idêntica (tipo e mensagem) ainda pendente é agrupada,
+ * incrementando o seu contador de repetições.
+ * - Com o anel cheio, a notificação pendente mais antiga de severidade menor
+ * (INFO < ALERT < ERROR) é descartada para dar lugar à nova; se não houver
+ * nenhuma, a nova é descartada.
  * * @param type O tipo de notificação (INFO, ALERT, ERROR).
- * @param message Uma string (char*) contendo a mensagem da notificação.
+ * @param message Uma string (char*) contendo a mensagem da notificação (deve
+ * permanecer válida, normalmente um literal).
  */
 void send_notification(notification_type_t type, char *message){
-    notification_t notification = {
+    if(!notifications_lock) return;
+
+    uint32_t saved_irq = spin_lock_blocking(notifications_lock);
+    counters.sent++;
+
+    for(uint8_t i = 0; i < pending_count; i++){
+        if(pending[i].type == type && strcmp(pending[i].message, message) == 0){
+            if(pending[i].count < UINT16_MAX) pending[i].count++;
+            counters.coalesced++;
+            spin_unlock(notifications_lock, saved_irq);
+            notify_display(DISPLAY_EVENT_NOTIFICATION);
+            return;
+        }
+    }
+
+    if(pending_count == NOTIFICATIONS_RING_SIZE){
+        uint8_t victim = NOTIFICATIONS_RING_SIZE;
+        for(uint8_t i = 0; i < pending_count; i++){
+            if(pending[i].type < type && (victim == NOTIFICATIONS_RING_SIZE || pending[i].type < pending[victim].type)){
+                victim = i;
+            }
+        }
+
+        counters.dropped++;
+        if(victim == NOTIFICATIONS_RING_SIZE){
+            spin_unlock(notifications_lock, saved_irq);
+            return;
+        }
+        remove_pending(victim);
+    }
+
+    pending[pending_count++] = (notification_t){
         .type = type,
-        .message = message
+        .message = message,
+        .count = 1
     };
 
-    xQueueSend(queue_notifications, &notification, pdMS_TO_TICKS(50));
+    spin_unlock(notifications_lock, saved_irq);
+    notify_display(DISPLAY_EVENT_NOTIFICATION);
+}
+
+/**
+ * @brief Retira a notificação pendente mais antiga, sem bloquear.
+ * * @param notification Ponteiro onde a notificação será copiada.
+ * @return true se havia uma notificação pendente, false caso contrário.
+ */
+bool receive_notification(notification_t *notification){
+    if(!notifications_lock) return false;
+
+    uint32_t saved_irq = spin_lock_blocking(notifications_lock);
+
+    bool available = pending_count > 0;
+    if(available){
+        *notification = pending[0];
+        remove_pending(0);
+    }
+
+    spin_unlock(notifications_lock, saved_irq);
+    return available;
+}
+
+/**
+ * @brief Copia os contadores do anel de notificações.
+ * * @param stats Ponteiro onde os contadores serão escritos.
+ */
+void notifications_get_stats(notifications_stats_t *stats){
+    if(!notifications_lock){
+        *stats = (notifications_stats_t){0};
+        return;
+    }
+
+    uint32_t saved_irq = spin_lock_blocking(notifications_lock);
+    *stats = counters;
+    stats->pending = pending_count;
+    spin_unlock(notifications_lock, saved_irq);
 }
\ No newline at end of file
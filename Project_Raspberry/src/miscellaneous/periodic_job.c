@@ -0,0 +1,178 @@
+#include "periodic_job.h"
+#include "histogram.h"
+#include "log.h"
+#include <inttypes.h>
+#include <string.h>
+
+/**
+ * @brief Jobs registrados, para leitura das estatísticas em tempo de execução.
+ */
+static periodic_job_t *jobs[PERIODIC_JOB_MAX_JOBS];
+static uint8_t jobs_count = 0;
+
+/**
+ * @brief Calcula um percentil do tempo de resposta de um job.
+ * * @param job Ponteiro para o job.
+ * @param percent O percentil desejado (1 a 100).
+ */
+static uint32_t response_percentile(const periodic_job_t *job, uint32_t percent){
+    return histogram_percentile(job->histogram, PERIODIC_JOB_HISTOGRAM_BUCKETS,
+                                job->cycles, job->response_max_us, percent);
+}
+
+/**
+ * @brief Inicializa um job periódico e o registra para consulta das estatísticas.
+ * @note Deve ser chamada pela própria task antes do laço principal.
+ * * @param job Ponteiro para o job (deve permanecer válido enquanto a task existir).
+ * @param name Nome exibido nas estatísticas.
+ * @param period_ms Período de liberação em milissegundos.
+ * @param deadline_ms Prazo relativo à liberação esperada, em milissegundos.
+ * @return true se o job foi registrado, false se a tabela está cheia (o job
+ * continua funcionando, apenas não aparece nas estatísticas).
+ */
+bool periodic_job_init(periodic_job_t *job, const char *name, uint32_t period_ms, uint32_t deadline_ms){
+    memset(job, 0, sizeof(*job));
+    job->name = name;
+    job->period_ms = period_ms;
+    job->deadline_us = deadline_ms * 1000;
+    job->jitter_min_us = UINT32_MAX;
+    job->response_min_us = UINT32_MAX;
+
+    bool registered = false;
+    taskENTER_CRITICAL();
+    if(jobs_count < PERIODIC_JOB_MAX_JOBS){
+        jobs[jobs_count++] = job;
+        registered = true;
+    }
+    taskEXIT_CRITICAL();
+
+    return registered;
+}
+
+/**
+ * @brief Altera o período a partir da próxima liberação.
+ * * @param job Ponteiro para o job.
+ * @param period_ms Novo período em milissegundos.
+ */
+void periodic_job_set_period(periodic_job_t *job, uint32_t period_ms){
+    if(period_ms == 0) return;
+    job->period_ms = period_ms;
+}
+
+/**
+ * @brief Marca o início de um ciclo e registra o atraso de liberação (jitter).
+ * @note A primeira chamada define a referência dos instantes de liberação.
+ * * @param job Ponteiro para o job.
+ */
+void periodic_job_release(periodic_job_t *job){
+    uint64_t now = time_us_64();
+
+    if(!job->started){
+        job->started = true;
+        job->last_wake = xTaskGetTickCount();
+        job->release_us = now;
+    }
+
+    // vTaskDelayUntil wakes on a tick boundary, up to one tick before the expected
+    // instant in microseconds; that boundary is the release
+    if(now < job->release_us) job->release_us = now;
+
+    uint32_t jitter = (uint32_t)(now - job->release_us);
+
+    taskENTER_CRITICAL();
+    if(jitter < job->jitter_min_us) job->jitter_min_us = jitter;
+    if(jitter > job->jitter_max_us) job->jitter_max_us = jitter;
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief Encerra o ciclo: registra o tempo de resposta e bloqueia até a próxima liberação.
+ * @note O tempo de resposta é medido a partir da liberação esperada (inclui o
+ * jitter). As liberações seguem instantes absolutos (vTaskDelayUntil), de forma
+ * que a duração variável do trabalho não acumula desvio no período. Se o ciclo
+ * passou do instante da próxima liberação, ela ocorre imediatamente e o atraso
+ * aparece no jitter do ciclo seguinte.
+ * * @param job Ponteiro para o job.
+ */
+void periodic_job_wait(periodic_job_t *job){
+    uint32_t response = (uint32_t)(time_us_64() - job->release_us);
+
+    taskENTER_CRITICAL();
+    job->cycles++;
+    if(response > job->deadline_us) job->deadline_misses++;
+    if(response < job->response_min_us) job->response_min_us = response;
+    if(response > job->response_max_us) job->response_max_us = response;
+    job->histogram[histogram_bucket(response, PERIODIC_JOB_HISTOGRAM_BUCKETS)]++;
+    taskEXIT_CRITICAL();
+
+    job->release_us += (uint64_t)job->period_ms * 1000;
+    vTaskDelayUntil(&job->last_wake, pdMS_TO_TICKS(job->period_ms));
+}
+
+/**
+ * @brief Zera as estatísticas de um job (por exemplo, após ajustar os períodos).
+ * * @param job Ponteiro para o job.
+ */
+void periodic_job_reset_stats(periodic_job_t *job){
+    taskENTER_CRITICAL();
+    job->cycles = 0;
+    job->deadline_misses = 0;
+    job->jitter_min_us = UINT32_MAX;
+    job->jitter_max_us = 0;
+    job->response_min_us = UINT32_MAX;
+    job->response_max_us = 0;
+    memset(job->histogram, 0, sizeof(job->histogram));
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief Retorna a quantidade de jobs registrados.
+ */
+uint8_t periodic_job_count(void){
+    return jobs_count;
+}
+
+/**
+ * @brief Copia as estatísticas de um job registrado.
+ * @note Pode ser chamada de qualquer task; a cópia é feita em seção crítica.
+ * * @param index Índice do job (0 a periodic_job_count() - 1).
+ * @param stats Ponteiro onde as estatísticas serão escritas.
+ * @return true se o índice é válido, false caso contrário.
+ */
+bool periodic_job_get_stats(uint8_t index, periodic_job_stats_t *stats){
+    if(index >= jobs_count) return false;
+    periodic_job_t *job = jobs[index];
+
+    taskENTER_CRITICAL();
+    stats->name = job->name;
+    stats->period_ms = job->period_ms;
+    stats->deadline_us = job->deadline_us;
+    stats->cycles = job->cycles;
+    stats->deadline_misses = job->deadline_misses;
+    stats->jitter_min_us = job->cycles ? job->jitter_min_us : 0;
+    stats->jitter_max_us = job->jitter_max_us;
+    stats->response_min_us = job->cycles ? job->response_min_us : 0;
+    stats->response_max_us = job->response_max_us;
+    stats->response_p50_us = response_percentile(job, 50);
+    stats->response_p90_us = response_percentile(job, 90);
+    stats->response_p99_us = response_percentile(job, 99);
+    taskEXIT_CRITICAL();
+
+    return true;
+}
+
+/**
+ * @brief Imprime no console as estatísticas de todos os jobs registrados.
+ */
+void periodic_job_print_stats(void){
+    periodic_job_stats_t stats;
+
+    for(uint8_t i = 0; periodic_job_get_stats(i, &stats); i++){
+        log_text("[%s] period %" PRIu32 " ms | cycles %" PRIu32 " | misses %" PRIu32 " | jitter %" PRIu32 "-%" PRIu32 " us | "
+                 "response %" PRIu32 "-%" PRIu32 " us (p50 %" PRIu32 ", p90 %" PRIu32 ", p99 %" PRIu32 ")\n",
+                 stats.name, stats.period_ms, stats.cycles, stats.deadline_misses,
+                 stats.jitter_min_us, stats.jitter_max_us,
+                 stats.response_min_us, stats.response_max_us,
+                 stats.response_p50_us, stats.response_p90_us, stats.response_p99_us);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+#include "rtos_memory.h"
+
+/**
+ * @brief Memória estática das tasks do kernel (idle de cada core e timer).
+ * @note Com configSUPPORT_STATIC_ALLOCATION, o kernel pede ao aplicativo a pilha
+ * e o TCB das tasks que ele mesmo cria.
+ */
+static StaticTask_t idle_task_buffer;
+static StackType_t idle_task_stack[configMINIMAL_STACK_SIZE];
+
+#if configNUMBER_OF_CORES > 1
+static StaticTask_t passive_idle_task_buffers[configNUMBER_OF_CORES - 1];
+static StackType_t passive_idle_task_stacks[configNUMBER_OF_CORES - 1][configMINIMAL_STACK_SIZE];
+#endif
+
+static StaticTask_t timer_task_buffer;
+static StackType_t timer_task_stack[configTIMER_TASK_STACK_DEPTH];
+
+/**
+ * @brief Fornece a memória da task idle do Core 0.
+ */
+void vApplicationGetIdleTaskMemory(StaticTask_t **task_buffer, StackType_t **stack_buffer,
+                                   configSTACK_DEPTH_TYPE *stack_size){
+    *task_buffer = &idle_task_buffer;
+    *stack_buffer = idle_task_stack;
+    *stack_size = configMINIMAL_STACK_SIZE;
+}
+
+#if configNUMBER_OF_CORES > 1
+/**
+ * @brief Fornece a memória das tasks idle passivas (demais cores, kernel SMP).
+ * * @param index Índice da task idle passiva (0 para o Core 1).
+ */
+void vApplicationGetPassiveIdleTaskMemory(StaticTask_t **task_buffer, StackType_t **stack_buffer,
+                                          configSTACK_DEPTH_TYPE *stack_size, BaseType_t index){
+    *task_buffer = &passive_idle_task_buffers[index];
+    *stack_buffer = passive_idle_task_stacks[index];
+    *stack_size = configMINIMAL_STACK_SIZE;
+}
+#endif
+
+/**
+ * @brief Fornece a memória da task de serviço dos timers.
+ */
+void vApplicationGetTimerTaskMemory(StaticTask_t **task_buffer, StackType_t **stack_buffer,
+                                    configSTACK_DEPTH_TYPE *stack_size){
+    *task_buffer = &timer_task_buffer;
+    *stack_buffer = timer_task_stack;
+    *stack_size = configTIMER_TASK_STACK_DEPTH;
+}
+
+/**
+ * @brief Indica se uma task é uma das tasks idle do kernel (de qualquer core).
+ * @note O handle de uma task estática é o próprio buffer do seu TCB.
+ * * @param task O handle da task.
+ */
+bool rtos_memory_is_idle_task(TaskHandle_t task){
+    if(task == (TaskHandle_t)&idle_task_buffer) return true;
+
+#if configNUMBER_OF_CORES > 1
+    for(uint8_t i = 0; i < configNUMBER_OF_CORES - 1; i++){
+        if(task == (TaskHandle_t)&passive_idle_task_buffers[i]) return true;
+    }
+#endif
+
+    return false;
+}
\ No newline at end of file
@@ -0,0 +1,114 @@
+#include "sample_estimator.h"
+
+/**
+ * @brief Inicializa o estimador de um canal.
+ * @note O estado só é definido pela primeira amostra recebida (sample_estimator_update).
+ * * @param estimator Ponteiro para o estimador.
+ * @param measurement_noise Variância de uma conversão isolada, em códigos do ADC² (Q16.16).
+ * @param gate Limite de rejeição de outliers, em desvios-padrão da inovação (Q16.16).
+ * @param max_rejects Outliers consecutivos a partir dos quais o estimador aceita
+ * a leitura como mudança real e reinicia nela.
+ * @param window Janela equivalente, em amostras (veja sample_estimator_set_window).
+ */
+void sample_estimator_init(sample_estimator_t *estimator, fixed_t measurement_noise, fixed_t gate,
+                           uint8_t max_rejects, uint8_t window){
+    estimator->estimate = 0;
+    estimator->variance = measurement_noise;
+    estimator->measurement_noise = measurement_noise;
+    estimator->gate = gate;
+    estimator->max_rejects = max_rejects;
+    estimator->rejects = 0;
+    estimator->ready = false;
+
+    sample_estimator_set_window(estimator, window);
+}
+
+/**
+ * @brief Ajusta o ruído de processo para que o estimador equivalha a uma média de 'window' amostras.
+ * @note Em regime, o filtro de Kalman de passeio aleatório converge para uma média
+ * exponencial de ganho K, com K² / (1 - K) = Q / R. Escolhendo K = 2 / (N + 1),
+ * a variância da estimativa para um sinal estável é R / N, a mesma da média de
+ * N amostras, e o ruído de processo fica Q = 4R / (N² - 1). Cada nova conversão
+ * atualiza a estimativa, sem precisar de N amostras novas por leitura.
+ * * @param estimator Ponteiro para o estimador.
+ * @param window Janela equivalente, em amostras (mínimo 2).
+ */
+void sample_estimator_set_window(sample_estimator_t *estimator, uint8_t window){
+    if(window < 2) window = 2;
+
+    int64_t divisor = (int64_t)window * window - 1;
+    estimator->process_noise = fixed_saturate((4 * (int64_t)estimator->measurement_noise) / divisor);
+}
+
+/**
+ * @brief Incorpora uma nova conversão à estimativa.
+ * @note Leituras cuja inovação excede 'gate' desvios-padrão são descartadas; após
+ * 'max_rejects' descartes seguidos, a estimativa é reiniciada na nova leitura
+ * (degrau real no sinal, e não ruído). Todo o cálculo é feito em ponto fixo.
+ * * @param estimator Ponteiro para o estimador.
+ * @param sample A nova amostra bruta do ADC.
+ * @return true se a amostra foi aceita, false se foi descartada como outlier.
+ */
+bool sample_estimator_update(sample_estimator_t *estimator, int16_t sample){
+    fixed_t measurement = FIXED_FROM_INT(sample);
+
+    if(!estimator->ready){
+        estimator->estimate = measurement;
+        estimator->variance = estimator->measurement_noise;
+        estimator->ready = true;
+        return true;
+    }
+
+    // Prediction: the signal may have drifted since the last sample
+    fixed_t variance = fixed_add(estimator->variance, estimator->process_noise);
+    fixed_t innovation_variance = fixed_add(variance, estimator->measurement_noise);
+
+    // Outlier gate: innovation² > gate² * S, compared in Q16 with the innovation in Q8
+    int64_t innovation = (int64_t)measurement - estimator->estimate;
+    int64_t innovation_q8 = innovation / (1 << (FIXED_FRACTION_BITS / 2));
+    int64_t limit = ((int64_t)fixed_mul(estimator->gate, estimator->gate) * innovation_variance) >> FIXED_FRACTION_BITS;
+    if(innovation_q8 * innovation_q8 > limit){
+        if(++estimator->rejects < estimator->max_rejects){
+            estimator->variance = variance;
+            return false;
+        }
+
+        estimator->estimate = measurement;
+        estimator->variance = estimator->measurement_noise;
+        estimator->rejects = 0;
+        return true;
+    }
+    estimator->rejects = 0;
+
+    // Correction
+    fixed_t gain = fixed_div(variance, innovation_variance);
+    estimator->estimate = fixed_saturate(estimator->estimate + ((innovation * gain) >> FIXED_FRACTION_BITS));
+    estimator->variance = fixed_mul(FIXED_ONE - gain, variance);
+
+    return true;
+}
+
+/**
+ * @brief Indica se o estimador já recebeu ao menos uma amostra.
+ * * @param estimator Ponteiro para o estimador.
+ */
+bool sample_estimator_is_ready(const sample_estimator_t *estimator){
+    return estimator->ready;
+}
+
+/**
+ * @brief Retorna a estimativa atual, arredondada para um código do ADC.
+ * * @param estimator Ponteiro para o estimador.
+ * @return O código estimado, ou 0 se ainda não houve amostras.
+ */
+int16_t sample_estimator_value(const sample_estimator_t *estimator){
+    return (int16_t)(((int64_t)estimator->estimate + (FIXED_ONE / 2)) >> FIXED_FRACTION_BITS);
+}
+
+/**
+ * @brief Retorna a variância atual da estimativa, em códigos do ADC² (Q16.16).
+ * * @param estimator Ponteiro para o estimador.
+ */
+fixed_t sample_estimator_variance(const sample_estimator_t *estimator){
+    return estimator->variance;
+}
\ No newline at end of file
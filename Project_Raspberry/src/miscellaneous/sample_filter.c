@@ -0,0 +1,146 @@
+#include "sample_filter.h"
+#include <string.h>
+
+/**
+ * @brief Busca binária pela primeira posição do vetor ordenado com valor >= 'value'.
+ * * @param sorted Vetor ordenado (crescente).
+ * @param size Quantidade de elementos do vetor.
+ * @param value Valor procurado.
+ * @return O índice de inserção/ocorrência de 'value'.
+ */
+static uint8_t lower_bound(const int16_t *sorted, uint8_t size, int16_t value){
+    uint8_t low = 0;
+    uint8_t high = size;
+
+    while(low < high){
+        uint8_t mid = (low + high) / 2;
+        if(sorted[mid] < value) low = mid + 1;
+        else high = mid;
+    }
+
+    return low;
+}
+
+/**
+ * @brief Quantidade de amostras descartadas de cada lado para o tamanho atual da janela.
+ * @note Enquanto a janela enche, o corte é proporcional à quantidade de amostras.
+ * * @param filter Ponteiro para o filtro.
+ */
+static uint8_t current_trim(const sample_filter_t *filter){
+    return (uint8_t)((filter->size * filter->trim) / filter->window);
+}
+
+/**
+ * @brief Recalcula as somas das extremidades descartadas percorrendo o vetor ordenado.
+ * @note Usada apenas enquanto a janela ainda não encheu; com a janela cheia as
+ * somas são atualizadas incrementalmente em sample_filter_push().
+ * * @param filter Ponteiro para o filtro.
+ */
+static void refresh_trim_sums(sample_filter_t *filter){
+    uint8_t trim = current_trim(filter);
+
+    filter->low_sum = 0;
+    filter->high_sum = 0;
+    for(uint8_t i = 0; i < trim; i++){
+        filter->low_sum += filter->sorted[i];
+        filter->high_sum += filter->sorted[filter->size - 1 - i];
+    }
+}
+
+/**
+ * @brief Inicializa um filtro de janela deslizante (mediana e média aparada).
+ * * @param filter Ponteiro para o filtro a ser inicializado.
+ * @param window Tamanho da janela (1 a SAMPLE_FILTER_MAX_WINDOW).
+ * @param trim Amostras descartadas de cada lado na média aparada (2 * trim < window).
+ * @return true se os parâmetros são válidos, false caso contrário.
+ */
+bool sample_filter_init(sample_filter_t *filter, uint8_t window, uint8_t trim){
+    if(!filter || window == 0 || window > SAMPLE_FILTER_MAX_WINDOW || 2 * trim >= window) return false;
+
+    memset(filter, 0, sizeof(*filter));
+    filter->window = window;
+    filter->trim = trim;
+
+    return true;
+}
+
+/**
+ * @brief Insere uma nova amostra, descartando a mais antiga quando a janela está cheia.
+ * @note A posição no vetor ordenado é encontrada por busca binária (O(log n)
+ * comparações) e o deslocamento é um único memmove de no máximo 64 bytes.
+ * A soma total e as somas das extremidades são ajustadas apenas pelos
+ * elementos que entram ou saem das regiões descartadas, sem percorrer a janela.
+ * * @param filter Ponteiro para o filtro.
+ * @param sample A nova amostra bruta.
+ */
+void sample_filter_push(sample_filter_t *filter, int16_t sample){
+    uint8_t window = filter->window;
+    int16_t *sorted = filter->sorted;
+
+    if(filter->size < window){
+        uint8_t position = lower_bound(sorted, filter->size, sample);
+        memmove(&sorted[position + 1], &sorted[position], (filter->size - position) * sizeof(int16_t));
+        sorted[position] = sample;
+        filter->size++;
+        filter->sum += sample;
+
+        filter->ring[filter->head] = sample;
+        filter->head = (filter->head + 1) % window;
+
+        refresh_trim_sums(filter);
+        return;
+    }
+
+    uint8_t trim = filter->trim;
+    int16_t oldest = filter->ring[filter->head];
+
+    // Removes the oldest sample: the neighbour of a trimmed region takes its place
+    uint8_t position = lower_bound(sorted, window, oldest);
+    if(position < trim) filter->low_sum += sorted[trim] - oldest;
+    if(position >= window - trim) filter->high_sum += sorted[window - trim - 1] - oldest;
+    memmove(&sorted[position], &sorted[position + 1], (window - 1 - position) * sizeof(int16_t));
+
+    // Inserts the new sample: it pushes the border element out of a trimmed region
+    position = lower_bound(sorted, window - 1, sample);
+    if(position < trim) filter->low_sum += sample - sorted[trim - 1];
+    if(position >= window - trim) filter->high_sum += sample - sorted[window - 1 - trim];
+    memmove(&sorted[position + 1], &sorted[position], (window - 1 - position) * sizeof(int16_t));
+    sorted[position] = sample;
+
+    filter->sum += sample - oldest;
+    filter->ring[filter->head] = sample;
+    filter->head = (filter->head + 1) % window;
+}
+
+/**
+ * @brief Retorna a quantidade de amostras presentes na janela.
+ * * @param filter Ponteiro para o filtro.
+ */
+uint8_t sample_filter_count(const sample_filter_t *filter){
+    return filter->size;
+}
+
+/**
+ * @brief Retorna a mediana da janela em O(1).
+ * @note Para janelas de tamanho par, retorna a menor das duas amostras centrais.
+ * * @param filter Ponteiro para o filtro.
+ * @return A mediana, ou 0 se a janela estiver vazia.
+ */
+int16_t sample_filter_median(const sample_filter_t *filter){
+    if(filter->size == 0) return 0;
+    return filter->sorted[(filter->size - 1) / 2];
+}
+
+/**
+ * @brief Retorna a média aparada da janela em O(1).
+ * @note Descarta 'trim' amostras de cada extremidade (proporcionalmente enquanto
+ * a janela não está cheia) e calcula a média das restantes.
+ * * @param filter Ponteiro para o filtro.
+ * @return A média aparada, ou 0 se a janela estiver vazia.
+ */
+int16_t sample_filter_trimmed_mean(const sample_filter_t *filter){
+    if(filter->size == 0) return 0;
+
+    int32_t kept = filter->size - 2 * current_trim(filter);
+    return (int16_t)((filter->sum - filter->low_sum - filter->high_sum) / kept);
+}
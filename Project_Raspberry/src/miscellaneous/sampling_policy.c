@@ -0,0 +1,109 @@
+#include "sampling_policy.h"
+#include "sensor_configs.h"
+#include "sensor_analyzer.h"
+
+/**
+ * @brief Nível atual de relaxamento da amostragem (Q16.16, 0 = mais rápido, 1 = mais lento).
+ * @note Começa em 0 para que o sistema inicie no perfil mais rápido.
+ */
+static fixed_t relax_level = 0;
+
+/**
+ * @brief Nível fixado por sampling_policy_pin(), ou SAMPLING_POLICY_ADAPTIVE.
+ */
+static fixed_t pinned_level = SAMPLING_POLICY_ADAPTIVE;
+
+/**
+ * @brief Calcula a folga de um valor em relação a uma faixa [min, max].
+ * * @param value O valor medido.
+ * @param min_value Limite inferior da faixa.
+ * @param max_value Limite superior da faixa.
+ * @return A distância ao limite mais próximo dividida por meia faixa
+ * (1 no centro, 0 no limite, negativa fora da faixa).
+ */
+static fixed_t band_margin(fixed_t value, fixed_t min_value, fixed_t max_value){
+    fixed_t distance = fixed_sub(value, min_value);
+    fixed_t upper_distance = fixed_sub(max_value, value);
+    if(upper_distance < distance) distance = upper_distance;
+
+    return fixed_div(distance, (max_value - min_value) / 2);
+}
+
+/**
+ * @brief Interpola linearmente entre dois inteiros conforme um nível Q16.16 em [0, 1].
+ */
+static uint32_t ramp(uint32_t min_value, uint32_t max_value, fixed_t level){
+    return min_value + (uint32_t)(((uint64_t)(max_value - min_value) * (uint32_t)level + (FIXED_ONE / 2)) >> FIXED_FRACTION_BITS);
+}
+
+/**
+ * @brief Calcula a menor folga entre todos os sensores e os seus limites de alerta.
+ * @note Temperatura e pH usam as faixas de sensor_configs.h; o TDS usa a folga
+ * relativa ao limite dinâmico de analyzer_get_max_tds().
+ * * @param data Estrutura (sensors_data_t) com os valores atuais.
+ * @return A menor folga (Q16.16): 1 no centro da faixa, 0 no limite, negativa em alerta.
+ */
+fixed_t sampling_policy_margin(sensors_data_t data){
+    fixed_t margin = band_margin(data.temperature, MIN_TEMPERATURE_CELSIUS, MAX_TEMPERATURE_CELSIUS);
+
+    fixed_t ph_margin = band_margin(data.ph, MIN_PH, MAX_PH);
+    if(ph_margin < margin) margin = ph_margin;
+
+    ppm_t max_tds = analyzer_get_max_tds(data);
+    if(max_tds > 0){
+        fixed_t tds_margin = fixed_div(fixed_sub(max_tds, data.tds), max_tds);
+        if(tds_margin < margin) margin = tds_margin;
+    }
+
+    return margin;
+}
+
+/**
+ * @brief Escolhe os parâmetros de amostragem do próximo ciclo a partir das leituras atuais.
+ * @note Abaixo de SAMPLING_ALERT_MARGIN usa o perfil mais rápido (menor período,
+ * janelas curtas e taxa máxima do ADC); acima de SAMPLING_CALM_MARGIN, o mais
+ * lento. Entre os dois, período e janelas variam linearmente. A aceleração é
+ * imediata, mas o relaxamento avança no máximo SAMPLING_RELAX_STEP por ciclo,
+ * evitando oscilação quando a leitura fica perto da transição.
+ * * @param data Estrutura (sensors_data_t) com os valores atuais.
+ * @return O perfil de amostragem a ser aplicado.
+ */
+sampling_profile_t sampling_policy_update(sensors_data_t data){
+    fixed_t margin = sampling_policy_margin(data);
+
+    fixed_t target = 0;
+    if(margin >= SAMPLING_CALM_MARGIN) target = FIXED_ONE;
+    else if(margin > SAMPLING_ALERT_MARGIN)
+        target = fixed_div(margin - SAMPLING_ALERT_MARGIN, SAMPLING_CALM_MARGIN - SAMPLING_ALERT_MARGIN);
+
+    if(pinned_level != SAMPLING_POLICY_ADAPTIVE) relax_level = pinned_level;
+    else if(target < relax_level) relax_level = target;
+    else if(target - relax_level > SAMPLING_RELAX_STEP) relax_level += SAMPLING_RELAX_STEP;
+    else relax_level = target;
+
+    sampling_profile_t profile = {
+        .margin = margin,
+        .interval_ms = ramp(SAMPLING_MIN_INTERVAL_MS, SAMPLING_MAX_INTERVAL_MS, relax_level),
+        .ph_window = ramp(SAMPLING_PH_MIN_WINDOW, SAMPLING_PH_MAX_WINDOW, relax_level),
+        .tds_window = ramp(SAMPLING_TDS_MIN_WINDOW, SAMPLING_TDS_MAX_WINDOW, relax_level),
+        .adc_rate_sps = relax_level >= FIXED_ONE ? SAMPLING_CALM_ADC_RATE_SPS : SAMPLING_ACTIVE_ADC_RATE_SPS
+    };
+
+    return profile;
+}
+
+/**
+ * @brief Fixa o nível de relaxamento, independente das leituras (avaliação e gravação de capturas).
+ * @note Com SAMPLING_POLICY_ADAPTIVE a política volta a seguir a folga, a partir
+ * do perfil mais rápido, como no boot.
+ * * @param level Nível em [0, 1] (Q16.16, 0 = mais rápido), ou SAMPLING_POLICY_ADAPTIVE.
+ */
+void sampling_policy_pin(fixed_t level){
+    if(level != SAMPLING_POLICY_ADAPTIVE){
+        if(level < 0) level = 0;
+        if(level > FIXED_ONE) level = FIXED_ONE;
+    }
+
+    pinned_level = level;
+    relax_level = 0;
+}
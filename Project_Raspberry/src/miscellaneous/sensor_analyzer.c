@@ -1,6 +1,7 @@
 #include "sensor_analyzer.h"
 #include "sensor_configs.h"
 #include "notifications.h"
+#include "telemetry.h"
 
 /**
  * @brief Armazena o estado normalizado (alertas) da leitura anterior.
@@ -30,27 +31,39 @@ bool analyzer_is_ph_alert(ph_t ph){
 }
 
 /**
- * @brief Verifica se o TDS está acima do limite máximo permitido.
+ * @brief Calcula o limite máximo de TDS para as condições atuais.
  * @note O limite máximo de TDS é dinâmico e depende dos valores
  * atuais de temperatura e pH, conforme as faixas definidas.
+ * Todo o cálculo é feito em ponto fixo (Q16.16).
  * * @param data Estrutura (sensors_data_t) contendo os valores brutos
- * de tds, ph e temperatura.
- * @return true se o TDS estiver acima do limite máximo calculado,
- * false caso contrário.
+ * de ph e temperatura.
+ * @return O limite máximo de TDS em PPM.
  */
-bool analyzer_is_tds_alert(sensors_data_t data){
+ppm_t analyzer_get_max_tds(sensors_data_t data){
     ppm_t max_tds = MAX_DEFAULT_TDS;
 
     if (data.temperature >= MIN_TEMPERATURE_CELSIUS && data.temperature <= MAX_TEMPERATURE_CELSIUS) {
         if (data.ph >= MIN_PH && data.ph < (MIN_PH + PH_FACTOR))
-            max_tds = (-16.67f * data.temperature) + 1300.0f;
+            max_tds = fixed_add(fixed_mul(FIXED_FROM_FLOAT(-16.67f), data.temperature), FIXED_FROM_FLOAT(1300.0f));
         if (data.ph >= (MIN_PH + PH_FACTOR) && data.ph < (MIN_PH + (PH_FACTOR * 3)))
-            max_tds = (-33.33f * data.temperature) + 1575.0f;
+            max_tds = fixed_add(fixed_mul(FIXED_FROM_FLOAT(-33.33f), data.temperature), FIXED_FROM_FLOAT(1575.0f));
         if (data.ph >= (MIN_PH + (PH_FACTOR * 3)) && data.ph <= MAX_PH)
-            max_tds = (-16.67f * data.temperature) + 950.0f;
+            max_tds = fixed_add(fixed_mul(FIXED_FROM_FLOAT(-16.67f), data.temperature), FIXED_FROM_FLOAT(950.0f));
     }
 
-    return (data.tds > max_tds);
+    return max_tds;
+}
+
+/**
+ * @brief Verifica se o TDS está acima do limite máximo permitido.
+ * @note O limite é calculado por analyzer_get_max_tds().
+ * * @param data Estrutura (sensors_data_t) contendo os valores brutos
+ * de tds, ph e temperatura.
+ * @return true se o TDS estiver acima do limite máximo calculado,
+ * false caso contrário.
+ */
+bool analyzer_is_tds_alert(sensors_data_t data){
+    return (data.tds > analyzer_get_max_tds(data));
 }
 
 /**
@@ -69,19 +82,28 @@ void analyzer_init(void){
  * @brief Processa os dados brutos dos sensores e gera dados normalizados (alertas).
  * @note Esta função converte os valores dos sensores em estados binários (alerta/normal)
  * e compara com o estado anterior (prev_normalized_data) para enviar
- * notificações apenas na transição de normal para alerta.
+ * notificações apenas na transição de normal para alerta. Toda mudança de estado
+ * (entrada ou saída do alerta) também é registrada na telemetria.
  * * @param data Estrutura (sensors_data_t) com os valores brutos atuais dos sensores.
  * @return Uma estrutura (normalized_sensors_data_t) com os estados
  * binários de alerta para cada sensor.
  */
 normalized_sensors_data_t analyzer_process_data(sensors_data_t data){
-    normalized_sensors_data_t new_data;
+    normalized_sensors_data_t new_data = {0};
 
     new_data.temperature = analyzer_is_temperature_alert(data.temperature);
     new_data.ph = analyzer_is_ph_alert(data.ph);
     new_data.tds = analyzer_is_tds_alert(data);
     new_data.button_state = data.button_state;
 
+    // Every state change (raised or cleared) goes to the telemetry stream
+    if (new_data.temperature != prev_normalized_data.temperature)
+        telemetry_alert(TELEMETRY_SENSOR_TEMPERATURE, new_data.temperature, data.temperature);
+    if (new_data.ph != prev_normalized_data.ph)
+        telemetry_alert(TELEMETRY_SENSOR_PH, new_data.ph, data.ph);
+    if (new_data.tds != prev_normalized_data.tds)
+        telemetry_alert(TELEMETRY_SENSOR_TDS, new_data.tds, data.tds);
+
     if (new_data.temperature && !prev_normalized_data.temperature) {
         if (data.temperature < MIN_TEMPERATURE_CELSIUS) {
             send_notification(ALERT, "Temp Low!");
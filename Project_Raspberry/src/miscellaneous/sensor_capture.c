@@ -0,0 +1,130 @@
+#include "sensor_capture.h"
+#include "log.h"
+#include "pico/time.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+/**
+ * @brief Registros capturados, em ordem de chegada.
+ */
+static capture_record_t records[CAPTURE_MAX_RECORDS];
+
+/**
+ * @brief Quantidade de registros em 'records'.
+ */
+static size_t records_count = 0;
+
+/**
+ * @brief Indica se a captura está em andamento.
+ */
+static volatile bool capture_active = false;
+
+/**
+ * @brief Instante (em us desde o boot) do início da captura.
+ */
+static uint64_t capture_start_us = 0;
+
+/**
+ * @brief Descarta a captura anterior e começa a registrar as amostras brutas.
+ */
+void capture_start(void){
+    taskENTER_CRITICAL();
+    records_count = 0;
+    capture_start_us = time_us_64();
+    capture_active = true;
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief Interrompe a captura, mantendo os registros já feitos.
+ */
+void capture_stop(void){
+    capture_active = false;
+}
+
+/**
+ * @brief Indica se a captura está em andamento.
+ */
+bool capture_is_active(void){
+    return capture_active;
+}
+
+/**
+ * @brief Indica se o buffer de captura encheu (a captura para sozinha).
+ */
+bool capture_is_full(void){
+    return records_count >= CAPTURE_MAX_RECORDS;
+}
+
+/**
+ * @brief Registra uma amostra bruta, se a captura estiver ativa.
+ * @note Chamada pelos drivers a cada leitura; sem captura ativa custa apenas um teste.
+ * Quando o buffer enche, a captura é encerrada.
+ * * @param source A origem da amostra.
+ * @param channel O canal lógico do ADC ou o índice da sonda.
+ * @param raw O valor bruto lido.
+ */
+void capture_record(capture_source_t source, uint8_t channel, int16_t raw){
+    if(!capture_active) return;
+
+    uint64_t now = time_us_64();
+
+    taskENTER_CRITICAL();
+    if(capture_active && records_count < CAPTURE_MAX_RECORDS){
+        capture_record_t *record = &records[records_count++];
+        record->timestamp_us = (uint32_t)(now - capture_start_us);
+        record->source = (uint8_t)source;
+        record->channel = channel;
+        record->raw = raw;
+
+        if(records_count == CAPTURE_MAX_RECORDS) capture_active = false;
+    }
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief Dá acesso aos registros capturados.
+ * * @param records_out Ponteiro onde o endereço do primeiro registro será escrito.
+ * @return A quantidade de registros.
+ */
+size_t capture_get_records(const capture_record_t **records_out){
+    *records_out = records;
+    return records_count;
+}
+
+/**
+ * @brief Envia a captura pelo console, em linhas hexadecimais.
+ * @note O formato é "CAPTURE BEGIN <versão> <registros>", seguido de linhas com
+ * os bytes dos registros em hexadecimal (CAPTURE_DUMP_RECORDS_PER_LINE por
+ * linha) e "CAPTURE END", uma linha por quadro de texto (log_text). O texto
+ * evita que a tradução de fim de linha do stdio corrompa os dados; convertido de
+ * volta, é o vetor de capture_record_t.
+ */
+void capture_dump(void){
+    bool was_active = capture_active;
+    capture_active = false;
+
+    log_text("CAPTURE BEGIN %u %u\n", CAPTURE_VERSION, (unsigned)records_count);
+
+    const uint8_t *bytes = (const uint8_t *)records;
+    size_t line_size = CAPTURE_DUMP_RECORDS_PER_LINE * sizeof(capture_record_t);
+    size_t total = records_count * sizeof(capture_record_t);
+
+    static const char hex[] = "0123456789abcdef";
+    char line[CAPTURE_DUMP_RECORDS_PER_LINE * sizeof(capture_record_t) * 2 + 1];
+
+    for(size_t offset = 0; offset < total; offset += line_size){
+        size_t end = offset + line_size < total ? offset + line_size : total;
+        size_t length = 0;
+        for(size_t i = offset; i < end; i++){
+            line[length++] = hex[bytes[i] >> 4];
+            line[length++] = hex[bytes[i] & 0x0F];
+        }
+        line[length] = '\0';
+        log_text("%s\n", line);
+    }
+
+    log_text("CAPTURE END\n");
+
+    capture_active = was_active && !capture_is_full();
+}
\ No newline at end of file
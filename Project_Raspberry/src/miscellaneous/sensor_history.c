@@ -0,0 +1,370 @@
+#include "sensor_history.h"
+#include "log.h"
+#include "semphr.h"
+#include <inttypes.h>
+#include <string.h>
+
+#define HISTORY_SENSORS 3                                   // temperature, pH and TDS
+#define HISTORY_SECONDS_CHANNELS HISTORY_SENSORS            // mean only
+#define HISTORY_AGGREGATE_CHANNELS (HISTORY_SENSORS * 3)    // min, mean and max
+#define HISTORY_DELTA_MIN INT8_MIN
+#define HISTORY_DELTA_MAX INT8_MAX
+
+// Cabeçalho de um bloco: os pontos são de períodos consecutivos a partir de first_period
+typedef struct {
+    uint32_t first_period;
+    uint8_t count;
+} history_block_t;
+
+// Soma, mínimo e máximo das amostras do período aberto de uma camada
+typedef struct {
+    uint32_t period;
+    uint32_t count;
+    int64_t sum[HISTORY_SENSORS];
+    fixed_t min[HISTORY_SENSORS];
+    fixed_t max[HISTORY_SENSORS];
+} history_accumulator_t;
+
+// Uma camada: anel de blocos com um quadro-chave absoluto e deltas de 8 bits por canal
+typedef struct {
+    uint32_t period_s;
+    uint8_t channels;
+    uint8_t blocks;
+    history_block_t *headers;
+    int32_t *keys;                  // [blocks][channels], in quanta
+    int8_t *deltas;                 // [blocks][HISTORY_BLOCK_POINTS - 1][channels]
+
+    uint8_t oldest;
+    uint8_t newest;
+    uint8_t used;                   // blocks in the ring
+    size_t points;                  // points in the ring
+    uint32_t last_period;           // newest point, the base of the next delta
+    int32_t last[HISTORY_AGGREGATE_CHANNELS];
+
+    history_accumulator_t accumulator;
+} history_tier_state_t;
+
+static history_block_t seconds_headers[HISTORY_SECONDS_BLOCKS];
+static int32_t seconds_keys[HISTORY_SECONDS_BLOCKS * HISTORY_SECONDS_CHANNELS];
+static int8_t seconds_deltas[HISTORY_SECONDS_BLOCKS * (HISTORY_BLOCK_POINTS - 1) * HISTORY_SECONDS_CHANNELS];
+
+static history_block_t minutes_headers[HISTORY_MINUTES_BLOCKS];
+static int32_t minutes_keys[HISTORY_MINUTES_BLOCKS * HISTORY_AGGREGATE_CHANNELS];
+static int8_t minutes_deltas[HISTORY_MINUTES_BLOCKS * (HISTORY_BLOCK_POINTS - 1) * HISTORY_AGGREGATE_CHANNELS];
+
+static history_block_t hours_headers[HISTORY_HOURS_BLOCKS];
+static int32_t hours_keys[HISTORY_HOURS_BLOCKS * HISTORY_AGGREGATE_CHANNELS];
+static int8_t hours_deltas[HISTORY_HOURS_BLOCKS * (HISTORY_BLOCK_POINTS - 1) * HISTORY_AGGREGATE_CHANNELS];
+
+static history_tier_state_t tiers[HISTORY_TIERS] = {
+    [HISTORY_TIER_SECONDS] = {
+        .period_s = 1,
+        .channels = HISTORY_SECONDS_CHANNELS,
+        .blocks = HISTORY_SECONDS_BLOCKS,
+        .headers = seconds_headers,
+        .keys = seconds_keys,
+        .deltas = seconds_deltas
+    },
+    [HISTORY_TIER_MINUTES] = {
+        .period_s = 60,
+        .channels = HISTORY_AGGREGATE_CHANNELS,
+        .blocks = HISTORY_MINUTES_BLOCKS,
+        .headers = minutes_headers,
+        .keys = minutes_keys,
+        .deltas = minutes_deltas
+    },
+    [HISTORY_TIER_HOURS] = {
+        .period_s = 3600,
+        .channels = HISTORY_AGGREGATE_CHANNELS,
+        .blocks = HISTORY_HOURS_BLOCKS,
+        .headers = hours_headers,
+        .keys = hours_keys,
+        .deltas = hours_deltas
+    }
+};
+
+static const uint8_t sensor_shift[HISTORY_SENSORS] = {
+    HISTORY_TEMPERATURE_SHIFT,
+    HISTORY_PH_SHIFT,
+    HISTORY_TDS_SHIFT
+};
+
+static SemaphoreHandle_t history_mutex = NULL;
+
+static int32_t quantize(fixed_t value, uint8_t shift){
+    return (value + (1 << (shift - 1))) >> shift;
+}
+
+static fixed_t dequantize(int32_t quanta, uint8_t shift){
+    return (fixed_t)(quanta * (1 << shift));
+}
+
+/**
+ * @brief Abre um bloco com o ponto como quadro-chave, descartando o bloco mais antigo se o anel estiver cheio.
+ */
+static void start_block(history_tier_state_t *tier, uint32_t period, const int32_t *values){
+    if(tier->used == 0){
+        tier->oldest = 0;
+        tier->newest = 0;
+        tier->used = 1;
+    } else {
+        tier->newest = (tier->newest + 1) % tier->blocks;
+        if(tier->used == tier->blocks){
+            tier->points -= tier->headers[tier->oldest].count;
+            tier->oldest = (tier->oldest + 1) % tier->blocks;
+        } else {
+            tier->used++;
+        }
+    }
+
+    history_block_t *block = &tier->headers[tier->newest];
+    block->first_period = period;
+    block->count = 1;
+    memcpy(&tier->keys[tier->newest * tier->channels], values, tier->channels * sizeof(int32_t));
+}
+
+/**
+ * @brief Acrescenta um ponto: delta no bloco atual se ele vier logo após o último
+ * e couber, senão quadro-chave de um bloco novo.
+ */
+static void append_point(history_tier_state_t *tier, uint32_t period, const int32_t *values){
+    history_block_t *block = &tier->headers[tier->newest];
+    bool fits = tier->used && block->count < HISTORY_BLOCK_POINTS && period == tier->last_period + 1;
+
+    for(uint8_t ch = 0; fits && ch < tier->channels; ch++){
+        int32_t delta = values[ch] - tier->last[ch];
+        fits = delta >= HISTORY_DELTA_MIN && delta <= HISTORY_DELTA_MAX;
+    }
+
+    if(fits){
+        int8_t *deltas = &tier->deltas[(tier->newest * (HISTORY_BLOCK_POINTS - 1) + block->count - 1) * tier->channels];
+        for(uint8_t ch = 0; ch < tier->channels; ch++){
+            deltas[ch] = (int8_t)(values[ch] - tier->last[ch]);
+        }
+        block->count++;
+    } else {
+        start_block(tier, period, values);
+    }
+
+    tier->points++;
+    tier->last_period = period;
+    memcpy(tier->last, values, tier->channels * sizeof(int32_t));
+}
+
+/**
+ * @brief Grava o período fechado pelo acumulador na camada.
+ * @note Lacunas de até HISTORY_MAX_HOLD_PERIODS períodos repetem o último ponto
+ * (delta zero); lacunas maiores abrem um bloco novo, cujo first_period marca o salto.
+ */
+static void commit_period(history_tier_state_t *tier){
+    history_accumulator_t *acc = &tier->accumulator;
+    int32_t values[HISTORY_AGGREGATE_CHANNELS];
+
+    for(uint8_t s = 0; s < HISTORY_SENSORS; s++){
+        fixed_t mean = (fixed_t)(acc->sum[s] / (int64_t)acc->count);
+        if(tier->channels == HISTORY_SECONDS_CHANNELS){
+            values[s] = quantize(mean, sensor_shift[s]);
+        } else {
+            values[s * 3 + 0] = quantize(acc->min[s], sensor_shift[s]);
+            values[s * 3 + 1] = quantize(mean, sensor_shift[s]);
+            values[s * 3 + 2] = quantize(acc->max[s], sensor_shift[s]);
+        }
+    }
+
+    // Short gap: holds the previous point
+    if(tier->used && acc->period - tier->last_period <= HISTORY_MAX_HOLD_PERIODS + 1){
+        int32_t held[HISTORY_AGGREGATE_CHANNELS];
+        memcpy(held, tier->last, tier->channels * sizeof(int32_t));
+        while(tier->last_period + 1 < acc->period){
+            append_point(tier, tier->last_period + 1, held);
+        }
+    }
+
+    append_point(tier, acc->period, values);
+}
+
+/**
+ * @brief Soma uma amostra ao período aberto da camada, gravando o anterior se ele terminou.
+ */
+static void accumulate(history_tier_state_t *tier, uint32_t now_s, const fixed_t *sample){
+    history_accumulator_t *acc = &tier->accumulator;
+    uint32_t period = now_s / tier->period_s;
+
+    if(acc->count && period != acc->period) commit_period(tier);
+
+    if(acc->count == 0 || period != acc->period){
+        acc->period = period;
+        acc->count = 0;
+        for(uint8_t s = 0; s < HISTORY_SENSORS; s++){
+            acc->sum[s] = 0;
+            acc->min[s] = sample[s];
+            acc->max[s] = sample[s];
+        }
+    }
+
+    for(uint8_t s = 0; s < HISTORY_SENSORS; s++){
+        acc->sum[s] += sample[s];
+        if(sample[s] < acc->min[s]) acc->min[s] = sample[s];
+        if(sample[s] > acc->max[s]) acc->max[s] = sample[s];
+    }
+    acc->count++;
+}
+
+/**
+ * @brief Converte os canais decodificados de um ponto para history_point_t.
+ */
+static void decode_point(const history_tier_state_t *tier, uint32_t period, const int32_t *values, history_point_t *point){
+    history_value_t *out[HISTORY_SENSORS] = { &point->temperature, &point->ph, &point->tds };
+
+    point->time_s = period * tier->period_s;
+    for(uint8_t s = 0; s < HISTORY_SENSORS; s++){
+        if(tier->channels == HISTORY_SECONDS_CHANNELS){
+            fixed_t value = dequantize(values[s], sensor_shift[s]);
+            out[s]->min = value;
+            out[s]->mean = value;
+            out[s]->max = value;
+        } else {
+            out[s]->min = dequantize(values[s * 3 + 0], sensor_shift[s]);
+            out[s]->mean = dequantize(values[s * 3 + 1], sensor_shift[s]);
+            out[s]->max = dequantize(values[s * 3 + 2], sensor_shift[s]);
+        }
+    }
+}
+
+/**
+ * @brief Inicializa o histórico de sensores (memória estática, sem alocação).
+ * @note O histórico tem três camadas: média de cada segundo (~10 min), e mínimo,
+ * média e máximo de cada minuto (~24 h) e de cada hora (~8 dias). Cada camada é
+ * um anel de blocos de HISTORY_BLOCK_POINTS pontos: o primeiro é absoluto (em
+ * quanta de HISTORY_*_SHIFT) e os demais são deltas de 8 bits, ~3x menos RAM que
+ * guardar fixed_t. Um delta que não cabe, uma lacuna longa ou um bloco cheio abre
+ * um bloco novo (saltos frequentes encurtam a janela coberta); com o anel cheio,
+ * o bloco mais antigo é descartado inteiro.
+ * * @return true se o mutex do histórico foi criado.
+ */
+bool sensor_history_init(void){
+    static StaticSemaphore_t history_mutex_buffer;
+    history_mutex = xSemaphoreCreateMutexStatic(&history_mutex_buffer);
+    return history_mutex != NULL;
+}
+
+/**
+ * @brief Registra uma amostra em todas as camadas.
+ * @note Cada camada acumula as amostras do período aberto (soma, mínimo e máximo)
+ * e grava o período quando chega a primeira amostra do seguinte. Chamada pela
+ * task_sensors a cada ciclo; custo constante por amostra.
+ * * @param data Os valores processados dos sensores.
+ */
+void sensor_history_record(const sensors_data_t *data){
+    sensor_history_record_at(data, (uint32_t)(time_us_64() / 1000000));
+}
+
+/**
+ * @brief Registra uma amostra num instante dado.
+ * @note Ver sensor_history_record(). Os instantes devem ser não decrescentes.
+ * * @param data Os valores processados dos sensores.
+ * @param now_s O instante da amostra, em segundos desde o boot.
+ */
+void sensor_history_record_at(const sensors_data_t *data, uint32_t now_s){
+    if(history_mutex == NULL) return;
+
+    const fixed_t sample[HISTORY_SENSORS] = { data->temperature, data->ph, data->tds };
+
+    xSemaphoreTake(history_mutex, portMAX_DELAY);
+    for(uint8_t t = 0; t < HISTORY_TIERS; t++){
+        accumulate(&tiers[t], now_s, sample);
+    }
+    xSemaphoreGive(history_mutex);
+}
+
+/**
+ * @brief Quantidade de pontos gravados em uma camada.
+ * * @param tier A camada.
+ */
+size_t sensor_history_count(history_tier_t tier){
+    if(tier >= HISTORY_TIERS || history_mutex == NULL) return 0;
+
+    xSemaphoreTake(history_mutex, portMAX_DELAY);
+    size_t count = tiers[tier].points;
+    xSemaphoreGive(history_mutex);
+    return count;
+}
+
+/**
+ * @brief Copia os últimos pontos de uma camada, do mais antigo para o mais recente.
+ * @note O período ainda aberto não entra. Custo O(max_points + HISTORY_BLOCK_POINTS):
+ * volta pelos cabeçalhos até o bloco do primeiro ponto e decodifica dali para frente.
+ * * @param tier A camada.
+ * * @param points Vetor de saída.
+ * * @param max_points Capacidade do vetor.
+ * * @return Quantidade de pontos escritos.
+ */
+size_t sensor_history_latest(history_tier_t tier, history_point_t *points, size_t max_points){
+    if(tier >= HISTORY_TIERS || history_mutex == NULL || max_points == 0) return 0;
+
+    const history_tier_state_t *state = &tiers[tier];
+
+    xSemaphoreTake(history_mutex, portMAX_DELAY);
+
+    size_t wanted = state->points < max_points ? state->points : max_points;
+    if(wanted == 0){
+        xSemaphoreGive(history_mutex);
+        return 0;
+    }
+
+    // Walks back to the block holding the first wanted point
+    uint8_t block_index = state->newest;
+    size_t covered = state->headers[block_index].count;
+    while(covered < wanted){
+        block_index = (block_index + state->blocks - 1) % state->blocks;
+        covered += state->headers[block_index].count;
+    }
+    size_t skip = covered - wanted;
+
+    size_t written = 0;
+    int32_t values[HISTORY_AGGREGATE_CHANNELS];
+    while(written < wanted){
+        const history_block_t *block = &state->headers[block_index];
+        const int8_t *deltas = &state->deltas[block_index * (HISTORY_BLOCK_POINTS - 1) * state->channels];
+        memcpy(values, &state->keys[block_index * state->channels], state->channels * sizeof(int32_t));
+
+        for(uint8_t i = 0; i < block->count && written < wanted; i++){
+            if(i > 0){
+                for(uint8_t ch = 0; ch < state->channels; ch++){
+                    values[ch] += deltas[(i - 1) * state->channels + ch];
+                }
+            }
+            if(skip){
+                skip--;
+                continue;
+            }
+            decode_point(state, block->first_period + i, values, &points[written++]);
+        }
+
+        block_index = (block_index + 1) % state->blocks;
+    }
+
+    xSemaphoreGive(history_mutex);
+    return written;
+}
+
+/**
+ * @brief Imprime no console (canal de diagnóstico) os pontos de cada camada e o último minuto.
+ */
+void sensor_history_print_stats(void){
+    static const char *const tier_names[HISTORY_TIERS] = { "seconds", "minutes", "hours" };
+
+    log_text("[History] %s %u | %s %u | %s %u\n",
+             tier_names[HISTORY_TIER_SECONDS], (unsigned)sensor_history_count(HISTORY_TIER_SECONDS),
+             tier_names[HISTORY_TIER_MINUTES], (unsigned)sensor_history_count(HISTORY_TIER_MINUTES),
+             tier_names[HISTORY_TIER_HOURS], (unsigned)sensor_history_count(HISTORY_TIER_HOURS));
+
+    history_point_t minute;
+    if(sensor_history_latest(HISTORY_TIER_MINUTES, &minute, 1) == 0) return;
+
+    log_text("  last minute (t %" PRIu32 " s): temp %.2f/%.2f/%.2f | pH %.2f/%.2f/%.2f | TDS %.0f/%.0f/%.0f\n",
+             minute.time_s,
+             fixed_to_float(minute.temperature.min), fixed_to_float(minute.temperature.mean), fixed_to_float(minute.temperature.max),
+             fixed_to_float(minute.ph.min), fixed_to_float(minute.ph.mean), fixed_to_float(minute.ph.max),
+             fixed_to_float(minute.tds.min), fixed_to_float(minute.tds.mean), fixed_to_float(minute.tds.max));
+}
@@ -0,0 +1,117 @@
+#include "sensor_pipeline.h"
+#include "sensor_analyzer.h"
+#include "ds18b20.h"
+
+// Age after which a value no longer describes the water: several missed publications
+#define TEMPERATURE_STALE_MS (DS18B20_CONVERSION_TIME_MS * 4)
+#define ANALOG_STALE_MS (SAMPLING_MAX_INTERVAL_MS * 3)
+
+/**
+ * @brief Canais cujo último valor está velho demais (sonda desconectada, produtor parado).
+ * * @param snapshot Os últimos valores publicados.
+ * @param now_us O instante do ciclo.
+ * @return Máscara SENSOR_STALE_... dos canais velhos.
+ */
+static uint8_t stale_channels(const sensor_snapshot_t *snapshot, uint64_t now_us){
+    uint8_t stale = 0;
+    if(sensor_snapshot_age_ms(snapshot->temperature_us, now_us) > TEMPERATURE_STALE_MS) stale |= SENSOR_STALE_TEMPERATURE;
+    if(sensor_snapshot_age_ms(snapshot->ph_us, now_us) > ANALOG_STALE_MS) stale |= SENSOR_STALE_PH;
+    if(sensor_snapshot_age_ms(snapshot->tds_us, now_us) > ANALOG_STALE_MS) stale |= SENSOR_STALE_TDS;
+    return stale;
+}
+
+/**
+ * @brief Alertas dos dados normalizados como máscara (SENSOR_STALE_... e SENSOR_ALERT_BUTTON).
+ */
+static uint8_t alert_mask(const normalized_sensors_data_t *normalized_data){
+    return (normalized_data->temperature ? SENSOR_STALE_TEMPERATURE : 0) |
+           (normalized_data->ph ? SENSOR_STALE_PH : 0) |
+           (normalized_data->tds ? SENSOR_STALE_TDS : 0) |
+           (normalized_data->button_state ? SENSOR_ALERT_BUTTON : 0);
+}
+
+/**
+ * @brief Instante da amostra que decidiu os alertas do ciclo.
+ * @note Entre os canais cujo alerta mudou, vale a amostra mais antiga: a que
+ * cruzou o limite primeiro. Um canal levado a alerta por estar velho não tem
+ * amostra que o explique e conta no instante do ciclo. Sem mudança, o ciclo só
+ * confirma o estado, e vale o valor mais recente.
+ * * @param snapshot Os últimos valores publicados.
+ * @param changed Máscara dos alertas que mudaram no ciclo.
+ * @param stale Máscara SENSOR_STALE_... dos canais velhos.
+ * @param now_us O instante do ciclo.
+ */
+static uint64_t trigger_sample_us(const sensor_snapshot_t *snapshot, uint8_t changed, uint8_t stale, uint64_t now_us){
+    const uint64_t sampled_us[] = { snapshot->temperature_us, snapshot->ph_us, snapshot->tds_us, snapshot->button_us };
+
+    if(!changed){
+        uint64_t newest = snapshot->temperature_us;
+        if(snapshot->ph_us > newest) newest = snapshot->ph_us;
+        if(snapshot->tds_us > newest) newest = snapshot->tds_us;
+        return newest;
+    }
+
+    uint64_t oldest = now_us;
+    for(uint8_t i = 0; i < sizeof(sampled_us) / sizeof(sampled_us[0]); i++){
+        uint8_t bit = (uint8_t)(1u << i);
+        if(!(changed & bit) || (stale & bit)) continue;
+        if(sampled_us[i] && sampled_us[i] < oldest) oldest = sampled_us[i];
+    }
+    return oldest;
+}
+
+/**
+ * @brief Prepara o estado do processamento (e o do analisador) para um novo fluxo.
+ * * @param pipeline O estado a preparar.
+ */
+void sensor_pipeline_init(sensor_pipeline_t *pipeline){
+    *pipeline = (sensor_pipeline_t){0};
+    analyzer_init();
+}
+
+/**
+ * @brief Processa um ciclo: dos últimos valores publicados aos alertas e ao próximo perfil.
+ * @note É a mesma cadeia em task_sensors e na reprodução de capturas (sensor_replay):
+ * 1. Agrupa os valores do snapshot em 'sensors_data_t'. O botão A conta como
+ * pressionado se esteve pressionado desde o ciclo anterior, mesmo que já tenha
+ * sido solto (button_presses).
+ * 2. Gera os dados normalizados (alertas) com 'analyzer_process_data'.
+ * 3. Leva a alerta os canais sem publicação recente (TEMPERATURE_STALE_MS,
+ * ANALOG_STALE_MS): um valor velho não pode manter o FPGA em "normal".
+ * 4. Guarda em 'trigger_us' o instante da amostra que decidiu os alertas
+ * (trigger_sample_us), o início do rastro de latência até o FPGA.
+ * 5. Escolhe o perfil de amostragem do próximo ciclo ('sampling_policy_update').
+ * * @param pipeline O estado entre ciclos.
+ * @param snapshot Os últimos valores publicados (completo: sensor_snapshot_is_complete()).
+ * @param now_us O instante do ciclo, na mesma base dos campos *_us do snapshot.
+ * @param data Ponteiro onde os dados brutos serão escritos.
+ * @param normalized_data Ponteiro onde os dados normalizados serão escritos.
+ * @return O perfil de amostragem do próximo ciclo.
+ */
+sampling_profile_t sensor_pipeline_process(sensor_pipeline_t *pipeline, const sensor_snapshot_t *snapshot,
+                                           uint64_t now_us, sensors_data_t *data,
+                                           normalized_sensors_data_t *normalized_data){
+    *data = (sensors_data_t){
+        .temperature = snapshot->temperature,
+        .ph = snapshot->ph,
+        .tds = snapshot->tds,
+        .button_state = snapshot->button_state || snapshot->button_presses != pipeline->handled_presses
+    };
+    pipeline->handled_presses = snapshot->button_presses;
+
+    *normalized_data = analyzer_process_data(*data);
+
+    uint8_t stale = stale_channels(snapshot, now_us);
+    pipeline->new_stale = stale & ~pipeline->stale;
+    pipeline->stale = stale;
+
+    if(stale & SENSOR_STALE_TEMPERATURE) normalized_data->temperature = true;
+    if(stale & SENSOR_STALE_PH) normalized_data->ph = true;
+    if(stale & SENSOR_STALE_TDS) normalized_data->tds = true;
+
+    uint8_t alerts = alert_mask(normalized_data);
+    pipeline->trigger_us = trigger_sample_us(snapshot, alerts ^ pipeline->alerts, stale, now_us);
+    pipeline->alerts = alerts;
+
+    return sampling_policy_update(*data);
+}
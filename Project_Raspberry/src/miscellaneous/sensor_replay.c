@@ -0,0 +1,161 @@
+#include "sensor_replay.h"
+#include "ads1115.h"
+#include "ds18b20.h"
+#include "ph4502c.h"
+#include "tds_meter.h"
+#include "sensor_configs.h"
+#include "sensor_pipeline.h"
+#include "pico/time.h"
+
+#define REPLAY_ADC_CHANNELS 2   // pH and TDS, converted in turn by the scan engine
+
+/**
+ * @brief Compara dois conjuntos de alertas (ignorando o botão).
+ */
+static bool alerts_changed(normalized_sensors_data_t a, normalized_sensors_data_t b){
+    return a.temperature != b.temperature || a.ph != b.ph || a.tds != b.tds;
+}
+
+/**
+ * @brief Aplica as janelas dos estimadores de um perfil, como os produtores.
+ */
+static void apply_windows(sampling_profile_t profile){
+    ph4502c_set_window(profile.ph_window);
+    tds_meter_set_window(profile.tds_window);
+}
+
+/**
+ * @brief Reproduz uma captura pela cadeia real de processamento, o mais rápido possível.
+ * @note As amostras do ADC são inseridas no fluxo do motor de aquisição
+ * (ads1115_scan_inject_sample, sem voltar à captura) e as leituras do DS18B20
+ * formam a média das sondas, como em ds18b20_collect_temperature(). O tempo é o
+ * da captura. A cada ciclo, os passos dos produtores de pH e TDS (publicar só
+ * com conversões novas) e o de task_sensors (sensor_pipeline_process: alertas,
+ * canais velhos e perfil de amostragem) são executados em sequência; o período e
+ * as janelas do ciclo seguinte vêm do perfil, como ao vivo. Diferente do
+ * firmware, produtores e task_sensors não têm fases próprias dentro do ciclo.
+ * Os ciclos só começam após a primeira leitura de temperatura.
+ * @note Com 'resample', as conversões de cada canal são reduzidas à taxa de dados
+ * do perfil do ciclo (adc_rate_sps, dividida entre os canais varridos), como se o
+ * conversor tivesse sido reconfigurado: a captura deve ter sido gravada na taxa
+ * máxima (sampling_policy_pin(0)). O ruído menor de uma taxa lenta (o ADS1115
+ * integra por mais tempo) não é modelado.
+ * @note Usa o estado dos próprios drivers: ph4502c_init() e tds_meter_init() devem
+ * ter sido chamadas, e as tasks de sensores não devem estar executando ao mesmo tempo.
+ * * @param records Vetor de registros da captura, em ordem cronológica.
+ * @param count Quantidade de registros.
+ * @param resample Reduz as conversões à taxa de dados de cada perfil.
+ * @param on_alert_change Callback da linha do tempo de alertas (opcional).
+ * @param report Ponteiro onde o resultado será escrito.
+ * @return true se a captura foi reproduzida, false para parâmetros inválidos.
+ */
+bool sensor_replay_run(const capture_record_t *records, size_t count, bool resample,
+                       replay_alert_callback_t on_alert_change, replay_report_t *report){
+    if(!records || !report) return false;
+
+    int16_t probe_raw[DS18B20_MAX_DEVICES];
+    uint8_t probes_seen = 0;
+
+    // Capture time + 1: a *_us of 0 marks a value never published
+    sensor_snapshot_t snapshot = {0};
+    uint32_t ph_count = ads1115_scan_get_sample_count(PH_ADC_CHANNEL);
+    uint32_t tds_count = ads1115_scan_get_sample_count(TDS_ADC_CHANNEL);
+
+    static sensor_pipeline_t pipeline;
+    sensor_pipeline_init(&pipeline);
+
+    sampling_profile_t profile = {
+        .interval_ms = SAMPLING_MIN_INTERVAL_MS,
+        .ph_window = SAMPLING_PH_MAX_WINDOW,
+        .tds_window = SAMPLING_TDS_MAX_WINDOW,
+        .adc_rate_sps = SAMPLING_ACTIVE_ADC_RATE_SPS
+    };
+    apply_windows(profile);
+
+    normalized_sensors_data_t previous_alerts = {0};
+    uint64_t next_cycle_us = 0;
+    uint64_t next_conversion_us[ADS1115_NUM_CHANNELS] = {0};
+
+    *report = (replay_report_t){0};
+
+    uint64_t start_us = time_us_64();
+
+    for(size_t i = 0; i < count; i++){
+        const capture_record_t *record = &records[i];
+        uint64_t record_us = (uint64_t)record->timestamp_us + 1;
+
+        // Runs every processing cycle that ended before this record
+        while(snapshot.temperature_us && record_us >= next_cycle_us){
+            uint32_t samples = ads1115_scan_get_sample_count(PH_ADC_CHANNEL);
+            ph_t ph = ph4502c_read_ph();
+            if(samples != ph_count){
+                snapshot.ph = ph;
+                snapshot.ph_us = next_cycle_us;
+                ph_count = samples;
+            }
+
+            samples = ads1115_scan_get_sample_count(TDS_ADC_CHANNEL);
+            ppm_t tds = tds_meter_read_ppm(snapshot.temperature);
+            if(samples != tds_count){
+                snapshot.tds = tds;
+                snapshot.tds_us = next_cycle_us;
+                tds_count = samples;
+            }
+
+            if(sensor_snapshot_is_complete(&snapshot)){
+                sensors_data_t data;
+                normalized_sensors_data_t alerts;
+                profile = sensor_pipeline_process(&pipeline, &snapshot, next_cycle_us, &data, &alerts);
+                apply_windows(profile);
+
+                if(alerts_changed(alerts, previous_alerts)){
+                    report->alert_changes++;
+                    if(on_alert_change) on_alert_change((uint32_t)(next_cycle_us - 1), data, alerts);
+                }
+                previous_alerts = alerts;
+            }
+
+            report->cycles++;
+            next_cycle_us += (uint64_t)profile.interval_ms * 1000;
+        }
+
+        if(record->source == CAPTURE_SOURCE_ADC && record->channel < ADS1115_NUM_CHANNELS){
+            uint64_t conversion_us = (uint64_t)REPLAY_ADC_CHANNELS * 1000000 / profile.adc_rate_sps;
+            uint64_t *next_us = &next_conversion_us[record->channel];
+
+            // Conversions the slower rate would not have made are dropped (a quarter period of jitter)
+            if(!resample || record_us + conversion_us / 4 >= *next_us){
+                ads1115_scan_inject_sample(record->channel, record->raw);
+                report->adc_samples++;
+
+                *next_us += conversion_us;
+                if(*next_us + conversion_us / 4 < record_us) *next_us = record_us + conversion_us;
+            }
+        }
+        else if(record->source == CAPTURE_SOURCE_TEMPERATURE && record->channel < DS18B20_MAX_DEVICES){
+            probe_raw[record->channel] = record->raw;
+            probes_seen |= (1 << record->channel);
+
+            // Average of the probes seen so far, as in ds18b20_collect_temperature()
+            celsius_t sum = 0;
+            uint8_t probes = 0;
+            for(uint8_t probe = 0; probe < DS18B20_MAX_DEVICES; probe++){
+                if(!(probes_seen & (1 << probe))) continue;
+                sum += (celsius_t)probe_raw[probe] * (FIXED_ONE / 16);
+                probes++;
+            }
+
+            if(!snapshot.temperature_us) next_cycle_us = record_us;
+            snapshot.temperature = sum / probes;
+            snapshot.temperature_us = record_us;
+        }
+
+        report->records++;
+    }
+
+    report->elapsed_us = time_us_64() - start_us;
+    report->records_per_second = report->elapsed_us ?
+        (uint32_t)(((uint64_t)report->records * 1000000) / report->elapsed_us) : 0;
+
+    return true;
+}
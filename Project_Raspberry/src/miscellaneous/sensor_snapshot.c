@@ -0,0 +1,94 @@
+#include "sensor_snapshot.h"
+
+/**
+ * @brief Últimos valores de todos os sensores, compartilhados entre produtores e consumidores.
+ */
+static sensor_snapshot_t snapshot = {0};
+
+/**
+ * @brief Publica uma nova temperatura (produtor do DS18B20).
+ * * @param temperature A temperatura em Celsius.
+ */
+void sensor_snapshot_publish_temperature(celsius_t temperature){
+    uint64_t now = time_us_64();
+
+    taskENTER_CRITICAL();
+    snapshot.temperature = temperature;
+    snapshot.temperature_us = now;
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief Publica um novo pH (produtor do PH4502C).
+ * * @param ph O valor de pH.
+ */
+void sensor_snapshot_publish_ph(ph_t ph){
+    uint64_t now = time_us_64();
+
+    taskENTER_CRITICAL();
+    snapshot.ph = ph;
+    snapshot.ph_us = now;
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief Publica um novo TDS (produtor do medidor de TDS).
+ * * @param tds O valor de TDS em PPM.
+ */
+void sensor_snapshot_publish_tds(ppm_t tds){
+    uint64_t now = time_us_64();
+
+    taskENTER_CRITICAL();
+    snapshot.tds = tds;
+    snapshot.tds_us = now;
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief Publica o estado do botão A.
+ * @note Um pressionamento é contado mesmo que o botão já tenha sido solto quando
+ * o consumidor ler o snapshot (button_presses).
+ * * @param button_state true se o botão está pressionado.
+ * @param pressed true se um pressionamento foi confirmado desde a última publicação.
+ */
+void sensor_snapshot_publish_button(bool button_state, bool pressed){
+    uint64_t now = time_us_64();
+
+    taskENTER_CRITICAL();
+    snapshot.button_state = button_state;
+    if(pressed) snapshot.button_presses++;
+    snapshot.button_us = now;
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief Copia de forma consistente os últimos valores publicados.
+ * * @param out Ponteiro onde a cópia será escrita.
+ */
+void sensor_snapshot_read(sensor_snapshot_t *out){
+    taskENTER_CRITICAL();
+    *out = snapshot;
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief Indica se temperatura, pH e TDS já foram publicados ao menos uma vez.
+ * * @param snapshot_copy Ponteiro para uma cópia obtida com sensor_snapshot_read().
+ */
+bool sensor_snapshot_is_complete(const sensor_snapshot_t *snapshot_copy){
+    return snapshot_copy->temperature_us && snapshot_copy->ph_us && snapshot_copy->tds_us;
+}
+
+/**
+ * @brief Idade de um valor publicado, em milissegundos.
+ * * @param published_us O instante da publicação (campo *_us do snapshot).
+ * @param now_us O instante de referência (time_us_64(), ou o tempo da captura na reprodução).
+ * @return A idade em ms, ou UINT32_MAX se o valor nunca foi publicado.
+ */
+uint32_t sensor_snapshot_age_ms(uint64_t published_us, uint64_t now_us){
+    if(published_us == 0) return UINT32_MAX;
+    if(now_us <= published_us) return 0;
+
+    uint64_t age = (now_us - published_us) / 1000;
+    return age > UINT32_MAX ? UINT32_MAX : (uint32_t)age;
+}
\ No newline at end of file
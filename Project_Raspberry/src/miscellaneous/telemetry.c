@@ -0,0 +1,169 @@
+#include "telemetry.h"
+#include "core_ring.h"
+#include "pico/stdlib.h"
+#include "pico/platform.h"
+#include "hardware/sync.h"
+#include <string.h>
+
+static telemetry_record_t records[NUM_CORES][TELEMETRY_RING_SIZE];
+
+/**
+ * @brief Anéis da telemetria, um por core; o consumidor é task_log.
+ */
+static core_ring_t rings = CORE_RING_INIT(records);
+
+/**
+ * @brief Número de sequência do próximo registro de cada core; também avança com
+ * os registros descartados, então as lacunas mostram a perda.
+ */
+static uint16_t sequences[NUM_CORES];
+
+/**
+ * @brief Registra um registro de telemetria no anel do core atual, sem bloquear.
+ * @note Usa os mesmos anéis por core do log diferido (core_ring). Com o anel
+ * cheio, o registro é descartado, mas consome o seu número de sequência.
+ * * @param type O tipo do registro.
+ * @param body O corpo do registro.
+ * @param size O tamanho do corpo.
+ */
+static void push(telemetry_type_t type, const void *body, size_t size){
+#if TELEMETRY_ENABLED
+    uint32_t timestamp_us = time_us_32();
+    uint32_t saved_irq = save_and_disable_interrupts();
+
+    uint8_t core = (uint8_t)get_core_num();
+    uint16_t sequence = sequences[core]++;
+
+    telemetry_record_t *record = core_ring_claim(&rings, core);
+    if(record){
+        record->header = (telemetry_header_t){
+            .type = (uint8_t)type,
+            .core = core,
+            .sequence = sequence,
+            .timestamp_us = timestamp_us
+        };
+        memcpy(&record->body, body, size);
+        core_ring_publish(&rings, core);
+    }
+
+    restore_interrupts(saved_irq);
+#endif
+}
+
+/**
+ * @brief Registra os valores dos sensores publicados para o display.
+ * * @param data Os valores (Q16.16).
+ */
+void telemetry_sensors(const sensors_data_t *data){
+    telemetry_sensors_t body = {
+        .temperature = data->temperature,
+        .ph = data->ph,
+        .tds = data->tds,
+        .button_state = data->button_state
+    };
+    push(TELEMETRY_SENSORS, &body, sizeof(body));
+}
+
+/**
+ * @brief Registra os estados normalizados (alertas) enviados ao FPGA.
+ * * @param data Os estados.
+ */
+void telemetry_normalized(const normalized_sensors_data_t *data){
+    telemetry_normalized_t body = {
+        .flags = (data->temperature ? TELEMETRY_FLAG_TEMPERATURE : 0) |
+                 (data->ph ? TELEMETRY_FLAG_PH : 0) |
+                 (data->tds ? TELEMETRY_FLAG_TDS : 0) |
+                 (data->button_state ? TELEMETRY_FLAG_BUTTON : 0)
+    };
+    push(TELEMETRY_NORMALIZED, &body, sizeof(body));
+}
+
+/**
+ * @brief Registra a entrada ou a saída de um sensor do estado de alerta.
+ * * @param sensor O sensor.
+ * @param active true ao entrar em alerta, false ao sair.
+ * @param value A leitura que mudou o estado (Q16.16).
+ */
+void telemetry_alert(telemetry_sensor_t sensor, bool active, fixed_t value){
+    telemetry_alert_t body = {
+        .sensor = (uint8_t)sensor,
+        .active = active,
+        .value = value
+    };
+    push(TELEMETRY_ALERT, &body, sizeof(body));
+}
+
+/**
+ * @brief Registra o resultado de um handshake com o FPGA.
+ * * @param success true se o ACK foi recebido.
+ * @param attempts Quantidade de tentativas feitas.
+ */
+void telemetry_link(bool success, uint8_t attempts){
+    telemetry_link_t body = {
+        .success = success,
+        .attempts = attempts
+    };
+    push(TELEMETRY_LINK, &body, sizeof(body));
+}
+
+/**
+ * @brief Retira o registro mais antigo de um dos anéis.
+ * @note Deve haver um único consumidor (task_log).
+ * * @param record Ponteiro onde o registro será copiado.
+ * @return true se havia um registro, false se os anéis estão vazios.
+ */
+bool telemetry_take(telemetry_record_t *record){
+    return core_ring_take(&rings, record);
+}
+
+/**
+ * @brief Quantidade de registros descartados por anel cheio em um core.
+ * * @param core O core.
+ */
+uint32_t telemetry_dropped(uint8_t core){
+    return core_ring_dropped(&rings, core);
+}
+
+/**
+ * @brief Monta o quadro de um registro: 0x00 | COBS(registro + CRC-16) | 0x00.
+ * * @param record O registro.
+ * @param frame Buffer de pelo menos TELEMETRY_MAX_FRAME bytes.
+ * @return O tamanho do quadro, ou 0 para um tipo de registro desconhecido.
+ */
+size_t telemetry_encode(const telemetry_record_t *record, uint8_t *frame){
+    size_t length = telemetry_record_size(record->header.type);
+    if(length == 0) return 0;
+
+    uint8_t payload[TELEMETRY_MAX_PAYLOAD];
+    memcpy(payload, record, length);
+
+    uint16_t crc = telemetry_crc16(payload, length);
+    payload[length++] = (uint8_t)(crc & 0xFF);
+    payload[length++] = (uint8_t)(crc >> 8);
+
+    size_t out = 0;
+    frame[out++] = 0x00;
+
+    // COBS: each code byte holds the distance to the next zero
+    size_t code_index = out++;
+    uint8_t code = 1;
+    for(size_t i = 0; i < length; i++){
+        if(payload[i] == 0x00){
+            frame[code_index] = code;
+            code_index = out++;
+            code = 1;
+            continue;
+        }
+
+        frame[out++] = payload[i];
+        if(++code == 0xFF){
+            frame[code_index] = code;
+            code_index = out++;
+            code = 1;
+        }
+    }
+    frame[code_index] = code;
+
+    frame[out++] = 0x00;
+    return out;
+}
\ No newline at end of file
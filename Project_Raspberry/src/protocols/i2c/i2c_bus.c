@@ -0,0 +1,534 @@
+#include "i2c_bus.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "queue.h"
+
+#define I2C_BUS_DRAIN_TIMEOUT_US 2000 // FIFO (16 words) still on the wire after the DMA finishes
+#define I2C_BUS_END_EVENTS (I2C_IC_INTR_MASK_M_STOP_DET_BITS | I2C_IC_INTR_MASK_M_TX_ABRT_BITS)
+#define I2C_BUS_STACK_SIZE (configMINIMAL_STACK_SIZE * 2)
+
+// Gerenciador de transações de um barramento
+typedef struct {
+    i2c_inst_t *port;
+    bool ready;
+    QueueHandle_t queue;
+    TaskHandle_t task;
+    StaticQueue_t queue_buffer;
+    uint8_t queue_storage[I2C_BUS_QUEUE_LENGTH * sizeof(i2c_transaction_t *)];
+    StaticTask_t task_buffer;
+    StackType_t task_stack[I2C_BUS_STACK_SIZE];
+    int tx_channel;
+    int rx_channel;
+    uint16_t words[I2C_BUS_MAX_WORDS];  // IC_DATA_CMD words fed to the TX FIFO
+
+    uint32_t submitted;
+    uint32_t completed;
+    uint32_t failed;
+    uint32_t rejected;
+    uint32_t bytes;
+    uint8_t in_flight;
+    uint8_t max_queue_depth;
+    uint64_t busy_us;
+    uint64_t stats_start_us;
+} i2c_bus_t;
+
+/**
+ * @brief Gerenciadores dos barramentos I2C0 e I2C1.
+ */
+static i2c_bus_t buses[I2C_BUS_COUNT];
+
+/**
+ * @brief Indica se a interrupção compartilhada de DMA já foi registrada.
+ */
+static bool dma_irq_registered = false;
+
+/**
+ * @brief Retorna o gerenciador de um periférico I2C.
+ * * @param port O periférico (I2C0_PORT ou I2C1_PORT).
+ */
+static i2c_bus_t *bus_of(i2c_inst_t *port){
+    return &buses[port == I2C0_PORT ? 0 : 1];
+}
+
+/**
+ * @brief Quantidade de palavras de comando que uma transação ocupa no FIFO de transmissão.
+ * * @param transaction Ponteiro para a transação.
+ */
+static size_t transaction_words(const i2c_transaction_t *transaction){
+    switch(transaction->kind){
+        case I2C_BUS_WRITE: return transaction->tx_len;
+        case I2C_BUS_WRITE_READ: return transaction->tx_len + transaction->rx_len;
+        case I2C_BUS_COMMAND_LIST: return 2 * transaction->tx_len;
+        default: return 0;
+    }
+}
+
+/**
+ * @brief Monta as palavras do registrador IC_DATA_CMD de uma transação.
+ * @note Cada palavra carrega o byte e os bits de controle (leitura, RESTART e STOP),
+ * de forma que a transação inteira é executada pelo DMA sem intervenção da CPU.
+ * * @param bus Ponteiro para o gerenciador do barramento.
+ * @param transaction Ponteiro para a transação.
+ * @return A quantidade de palavras montadas.
+ */
+static size_t build_words(i2c_bus_t *bus, const i2c_transaction_t *transaction){
+    uint16_t *words = bus->words;
+    size_t count = 0;
+
+    switch(transaction->kind){
+        case I2C_BUS_WRITE:
+            for(size_t i = 0; i < transaction->tx_len; i++) words[count++] = transaction->tx[i];
+            break;
+
+        case I2C_BUS_WRITE_READ:
+            for(size_t i = 0; i < transaction->tx_len; i++) words[count++] = transaction->tx[i];
+            for(size_t i = 0; i < transaction->rx_len; i++){
+                words[count] = I2C_IC_DATA_CMD_CMD_BITS;
+                if(i == 0 && transaction->tx_len) words[count] |= I2C_IC_DATA_CMD_RESTART_BITS;
+                count++;
+            }
+            break;
+
+        case I2C_BUS_COMMAND_LIST:
+            for(size_t i = 0; i < transaction->tx_len; i++){
+                words[count++] = transaction->control;
+                words[count++] = transaction->tx[i] | I2C_IC_DATA_CMD_STOP_BITS;
+            }
+            break;
+    }
+
+    if(count) words[count - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+    return count;
+}
+
+/**
+ * @brief Executa uma transação com as funções bloqueantes do SDK.
+ * @note Usada antes do escalonador iniciar (inicialização dos dispositivos).
+ * * @param port O periférico I2C.
+ * @param transaction Ponteiro para a transação.
+ * @return true se todos os bytes foram reconhecidos, false caso contrário.
+ */
+static bool execute_blocking(i2c_inst_t *port, i2c_transaction_t *transaction){
+    switch(transaction->kind){
+        case I2C_BUS_WRITE:
+            return i2c_write_blocking(port, transaction->address, transaction->tx, transaction->tx_len, false) == (int)transaction->tx_len;
+
+        case I2C_BUS_WRITE_READ:
+            if(transaction->tx_len &&
+               i2c_write_blocking(port, transaction->address, transaction->tx, transaction->tx_len, true) != (int)transaction->tx_len) return false;
+            return i2c_read_blocking(port, transaction->address, transaction->rx, transaction->rx_len, false) == (int)transaction->rx_len;
+
+        case I2C_BUS_COMMAND_LIST:
+            for(size_t i = 0; i < transaction->tx_len; i++){
+                uint8_t command[2] = {transaction->control, transaction->tx[i]};
+                if(i2c_write_blocking(port, transaction->address, command, 2, false) != 2) return false;
+            }
+            return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Interrompe uma transação em andamento (erro ou tempo esgotado).
+ * * @param bus Ponteiro para o gerenciador do barramento.
+ */
+static void abort_transfer(i2c_bus_t *bus){
+    i2c_hw_t *hw = i2c_get_hw(bus->port);
+
+    hw->intr_mask = 0;
+    dma_channel_abort(bus->tx_channel);
+    dma_channel_abort(bus->rx_channel);
+    dma_channel_acknowledge_irq1(bus->tx_channel);
+
+    // Controller abort: flushes the FIFOs and releases the bus with a STOP
+    if(hw->status & I2C_IC_STATUS_MST_ACTIVITY_BITS){
+        hw->enable |= I2C_IC_ENABLE_ABORT_BITS;
+        uint64_t deadline = time_us_64() + I2C_BUS_DRAIN_TIMEOUT_US;
+        while((hw->enable & I2C_IC_ENABLE_ABORT_BITS) && time_us_64() < deadline) tight_loop_contents();
+    }
+    (void)hw->clr_tx_abrt;
+}
+
+/**
+ * @brief Indica se o controlador terminou a transação: FIFO vazio, STOP enviado e recepção copiada.
+ * @note O DMA de recepção lê o último byte logo após o STOP; a espera por ele é de
+ * poucos ciclos e limitada pelo prazo da transação.
+ * * @param bus Ponteiro para o gerenciador do barramento.
+ * @param deadline_us Prazo da transação (em us desde o boot).
+ */
+static bool transfer_drained(i2c_bus_t *bus, uint64_t deadline_us){
+    i2c_hw_t *hw = i2c_get_hw(bus->port);
+
+    if(!(hw->status & I2C_IC_STATUS_TFE_BITS) || (hw->status & I2C_IC_STATUS_MST_ACTIVITY_BITS)) return false;
+
+    while(dma_channel_is_busy(bus->rx_channel) && time_us_64() < deadline_us) tight_loop_contents();
+    return !dma_channel_is_busy(bus->rx_channel);
+}
+
+/**
+ * @brief Executa uma transação por DMA, bloqueando apenas a task do barramento.
+ * @note Um canal de DMA alimenta o FIFO de transmissão com as palavras de comando
+ * e outro esvazia o FIFO de recepção no buffer do chamador. A task dorme até a
+ * interrupção de fim do DMA de transmissão e, enquanto o FIFO ainda esvazia (no
+ * máximo 16 palavras), até a interrupção do controlador no STOP final ou no
+ * abort (NACK), antes de declarar a transação concluída.
+ * * @param bus Ponteiro para o gerenciador do barramento.
+ * @param transaction Ponteiro para a transação.
+ * @return true se todos os bytes foram reconhecidos, false caso contrário.
+ */
+static bool execute_dma(i2c_bus_t *bus, i2c_transaction_t *transaction){
+    i2c_hw_t *hw = i2c_get_hw(bus->port);
+    size_t count = build_words(bus, transaction);
+    if(count == 0) return false;
+
+    hw->enable = 0;
+    hw->tar = transaction->address;
+    hw->enable = I2C_IC_ENABLE_ENABLE_BITS;
+    hw->intr_mask = 0;
+    (void)hw->clr_tx_abrt;
+
+    if(transaction->kind == I2C_BUS_WRITE_READ && transaction->rx_len){
+        dma_channel_config config = dma_channel_get_default_config(bus->rx_channel);
+        channel_config_set_transfer_data_size(&config, DMA_SIZE_8);
+        channel_config_set_read_increment(&config, false);
+        channel_config_set_write_increment(&config, true);
+        channel_config_set_dreq(&config, i2c_get_dreq(bus->port, false));
+        dma_channel_configure(bus->rx_channel, &config, transaction->rx, &hw->data_cmd, transaction->rx_len, true);
+    }
+
+    // 16-bit writes are replicated on both halves of IC_DATA_CMD; the upper half is reserved
+    dma_channel_config config = dma_channel_get_default_config(bus->tx_channel);
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_16);
+    channel_config_set_read_increment(&config, true);
+    channel_config_set_write_increment(&config, false);
+    channel_config_set_dreq(&config, i2c_get_dreq(bus->port, true));
+
+    ulTaskNotifyTake(pdTRUE, 0);
+    dma_channel_configure(bus->tx_channel, &config, &hw->data_cmd, bus->words, count, true);
+
+    if(ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(I2C_BUS_TIMEOUT_MS)) == 0){
+        abort_transfer(bus);
+        return false;
+    }
+
+    // Sleeps while the words still in the FIFO go out. A command list sends a STOP
+    // per command, so the interrupt is armed again until the controller is idle;
+    // arming before the check means a final STOP in between is not lost
+    uint64_t deadline = time_us_64() + I2C_BUS_DRAIN_TIMEOUT_US;
+    while(true){
+        (void)hw->clr_stop_det;
+        hw->intr_mask = I2C_BUS_END_EVENTS;
+
+        if(hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS) break;
+        if(transfer_drained(bus, deadline)){
+            hw->intr_mask = 0;
+            return true;
+        }
+
+        if(ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(I2C_BUS_DRAIN_TIMEOUT_US / 1000) + 1) == 0 ||
+           time_us_64() > deadline) break;
+    }
+
+    abort_transfer(bus);
+    return false;
+}
+
+/**
+ * @brief Tratador da interrupção de DMA (fim da transmissão de uma transação).
+ * @note Apenas acorda a task do barramento correspondente.
+ */
+static void i2c_bus_dma_irq_handler(void){
+    BaseType_t higher_priority_task_woken = pdFALSE;
+
+    for(uint8_t i = 0; i < I2C_BUS_COUNT; i++){
+        i2c_bus_t *bus = &buses[i];
+        if(!bus->ready || !dma_channel_get_irq1_status(bus->tx_channel)) continue;
+
+        dma_channel_acknowledge_irq1(bus->tx_channel);
+        vTaskNotifyGiveFromISR(bus->task, &higher_priority_task_woken);
+    }
+
+    portYIELD_FROM_ISR(higher_priority_task_woken);
+}
+
+/**
+ * @brief Tratador da interrupção dos controladores I2C (STOP ou abort após o fim do DMA).
+ * @note Mascara a interrupção, rearmada pela task do barramento, e acorda a task.
+ */
+static void i2c_bus_irq_handler(void){
+    BaseType_t higher_priority_task_woken = pdFALSE;
+
+    for(uint8_t i = 0; i < I2C_BUS_COUNT; i++){
+        i2c_bus_t *bus = &buses[i];
+        if(!bus->ready) continue;
+
+        i2c_hw_t *hw = i2c_get_hw(bus->port);
+        if(!(hw->raw_intr_stat & hw->intr_mask)) continue;
+
+        hw->intr_mask = 0;
+        vTaskNotifyGiveFromISR(bus->task, &higher_priority_task_woken);
+    }
+
+    portYIELD_FROM_ISR(higher_priority_task_woken);
+}
+
+/**
+ * @brief Conclui uma transação: atualiza contadores, chama o callback e acorda o chamador.
+ * * @param bus Ponteiro para o gerenciador do barramento.
+ * @param transaction Ponteiro para a transação.
+ * @param success Resultado da execução.
+ * @param busy_us Tempo de ocupação do barramento pela transação.
+ */
+static void complete(i2c_bus_t *bus, i2c_transaction_t *transaction, bool success, uint64_t busy_us){
+    taskENTER_CRITICAL();
+    bus->in_flight = 0;
+    bus->busy_us += busy_us;
+    if(success){
+        bus->completed++;
+        bus->bytes += transaction->tx_len + transaction->rx_len;
+    }
+    else bus->failed++;
+    taskEXIT_CRITICAL();
+
+    // The transaction belongs to the caller again as soon as its status changes
+    TaskHandle_t waiter = transaction->waiter;
+    if(transaction->callback) transaction->callback(transaction, success);
+    transaction->status = success ? I2C_BUS_DONE : I2C_BUS_FAILED;
+
+    if(waiter) xTaskNotifyGiveIndexed(waiter, I2C_BUS_NOTIFY_INDEX);
+}
+
+/**
+ * @brief Função da task de um barramento I2C.
+ * @note Executa as transações da fila, uma por vez e na ordem de submissão.
+ * Enquanto o DMA transfere, a task fica bloqueada e a CPU livre para as demais.
+ * * @param params Ponteiro para o gerenciador do barramento.
+ */
+static void task_i2c_bus(void *params){
+    i2c_bus_t *bus = (i2c_bus_t *)params;
+    i2c_transaction_t *transaction;
+
+    while(true){
+        if(xQueueReceive(bus->queue, &transaction, portMAX_DELAY) != pdPASS) continue;
+
+        taskENTER_CRITICAL();
+        bus->in_flight = 1;
+        taskEXIT_CRITICAL();
+
+        uint64_t start_us = time_us_64();
+        bool success = execute_dma(bus, transaction);
+        complete(bus, transaction, success, time_us_64() - start_us);
+    }
+}
+
+/**
+ * @brief Inicializa o gerenciador de transações de um barramento I2C.
+ * @note Reserva dois canais de DMA, registra a interrupção de DMA compartilhada e a
+ * do controlador (fim da transação) e cria a task do barramento com prioridade
+ * (IDLE + 6), acima dos seus usuários.
+ * O periférico já deve ter sido configurado (i2c_init). Chamadas repetidas não
+ * têm efeito.
+ * * @param port O periférico (I2C0_PORT ou I2C1_PORT).
+ * @return true se o gerenciador está pronto, false caso contrário.
+ */
+bool i2c_bus_init(i2c_inst_t *port){
+    i2c_bus_t *bus = bus_of(port);
+    if(bus->ready) return true;
+
+    bus->port = port;
+    bus->queue = xQueueCreateStatic(I2C_BUS_QUEUE_LENGTH, sizeof(i2c_transaction_t *), bus->queue_storage, &bus->queue_buffer);
+    if(bus->queue == NULL) return false;
+
+    bus->tx_channel = dma_claim_unused_channel(false);
+    bus->rx_channel = dma_claim_unused_channel(false);
+    if(bus->tx_channel < 0 || bus->rx_channel < 0) return false;
+
+    bus->task = xTaskCreateStatic(
+        task_i2c_bus,
+        port == I2C0_PORT ? "Task I2C0" : "Task I2C1",
+        I2C_BUS_STACK_SIZE,
+        bus,
+        tskIDLE_PRIORITY + 6,
+        bus->task_stack,
+        &bus->task_buffer
+    );
+    if(bus->task == NULL) return false;
+
+    // I2C0 serves the sensors (core 0), I2C1 the display (core 1)
+    vTaskCoreAffinitySet(bus->task, port == I2C0_PORT ? (1 << 0) : (1 << 1));
+
+    if(!dma_irq_registered){
+        irq_add_shared_handler(DMA_IRQ_1, i2c_bus_dma_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        irq_set_enabled(DMA_IRQ_1, true);
+        dma_irq_registered = true;
+    }
+    dma_channel_set_irq1_enabled(bus->tx_channel, true);
+
+    // Controller interrupts stay masked until a transaction waits for its STOP
+    uint irq = i2c_get_index(port) ? I2C1_IRQ : I2C0_IRQ;
+    i2c_get_hw(port)->intr_mask = 0;
+    irq_add_shared_handler(irq, i2c_bus_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(irq, true);
+
+    bus->stats_start_us = time_us_64();
+    bus->ready = true;
+
+    return true;
+}
+
+/**
+ * @brief Enfileira uma transação, aguardando espaço na fila por até 'timeout'.
+ * @note A transação e os seus buffers devem permanecer válidos até a conclusão
+ * (i2c_bus_wait(), callback ou i2c_bus_is_busy()). As transações de um
+ * barramento são executadas na ordem de submissão.
+ * * @param port O periférico (I2C0_PORT ou I2C1_PORT).
+ * @param transaction Ponteiro para a transação.
+ * @param timeout Espera máxima por espaço na fila, em ticks (0 para não bloquear).
+ * @return true se a transação foi enfileirada, false se a fila continuou cheia, a
+ * transação ainda está pendente ou é maior que I2C_BUS_MAX_WORDS.
+ */
+bool i2c_bus_submit_wait(i2c_inst_t *port, i2c_transaction_t *transaction, TickType_t timeout){
+    i2c_bus_t *bus = bus_of(port);
+    size_t words = transaction_words(transaction);
+
+    if(!bus->ready || transaction->status == I2C_BUS_PENDING || words == 0 || words > I2C_BUS_MAX_WORDS){
+        taskENTER_CRITICAL();
+        bus->rejected++;
+        taskEXIT_CRITICAL();
+        return false;
+    }
+
+    transaction->waiter = xTaskGetCurrentTaskHandle();
+    transaction->status = I2C_BUS_PENDING;
+
+    if(xQueueSend(bus->queue, &transaction, timeout) != pdPASS){
+        transaction->status = I2C_BUS_IDLE;
+        taskENTER_CRITICAL();
+        bus->rejected++;
+        taskEXIT_CRITICAL();
+        return false;
+    }
+
+    taskENTER_CRITICAL();
+    bus->submitted++;
+    uint8_t depth = (uint8_t)uxQueueMessagesWaiting(bus->queue) + bus->in_flight;
+    if(depth > bus->max_queue_depth) bus->max_queue_depth = depth;
+    taskEXIT_CRITICAL();
+
+    return true;
+}
+
+/**
+ * @brief Enfileira uma transação sem bloquear.
+ * @note Ver i2c_bus_submit_wait().
+ * * @param port O periférico (I2C0_PORT ou I2C1_PORT).
+ * @param transaction Ponteiro para a transação.
+ * @return true se a transação foi enfileirada, false caso contrário.
+ */
+bool i2c_bus_submit(i2c_inst_t *port, i2c_transaction_t *transaction){
+    return i2c_bus_submit_wait(port, transaction, 0);
+}
+
+/**
+ * @brief Aguarda a conclusão de uma transação.
+ * @note A task que submeteu a transação dorme até ser notificada pela task do
+ * barramento; qualquer outra task verifica o estado a cada tick.
+ * * @param transaction Ponteiro para a transação.
+ * @param timeout Tempo máximo de espera em ticks (portMAX_DELAY para esperar sempre).
+ * @return true se a transação foi concluída com sucesso, false em caso de falha
+ * ou tempo esgotado (a transação pode continuar pendente).
+ */
+bool i2c_bus_wait(i2c_transaction_t *transaction, TickType_t timeout){
+    if(transaction->waiter != xTaskGetCurrentTaskHandle()){
+        TickType_t start = xTaskGetTickCount();
+        while(transaction->status == I2C_BUS_PENDING){
+            if(timeout != portMAX_DELAY && xTaskGetTickCount() - start >= timeout) return false;
+            vTaskDelay(1);
+        }
+        return transaction->status == I2C_BUS_DONE;
+    }
+
+    while(transaction->status == I2C_BUS_PENDING){
+        if(ulTaskNotifyTakeIndexed(I2C_BUS_NOTIFY_INDEX, pdTRUE, timeout) == 0 &&
+           transaction->status == I2C_BUS_PENDING) return false;
+    }
+
+    return transaction->status == I2C_BUS_DONE;
+}
+
+/**
+ * @brief Executa uma transação e aguarda o resultado.
+ * @note Antes do escalonador iniciar, ou se o gerenciador não foi inicializado,
+ * usa as funções bloqueantes do SDK. Não deve ser chamada de um callback de transação.
+ * * @param port O periférico (I2C0_PORT ou I2C1_PORT).
+ * @param transaction Ponteiro para a transação.
+ * @return true se a transação foi concluída com sucesso, false caso contrário.
+ */
+bool i2c_bus_transfer(i2c_inst_t *port, i2c_transaction_t *transaction){
+    if(!bus_of(port)->ready || xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED){
+        bool success = execute_blocking(port, transaction);
+        transaction->status = success ? I2C_BUS_DONE : I2C_BUS_FAILED;
+        return success;
+    }
+
+    // Every transaction ends within I2C_BUS_TIMEOUT_MS, so both waits are bounded
+    if(!i2c_bus_submit_wait(port, transaction, portMAX_DELAY)) return false;
+    return i2c_bus_wait(transaction, portMAX_DELAY);
+}
+
+/**
+ * @brief Indica se uma transação ainda está na fila ou em execução.
+ * * @param transaction Ponteiro para a transação.
+ */
+bool i2c_bus_is_busy(const i2c_transaction_t *transaction){
+    return transaction->status == I2C_BUS_PENDING;
+}
+
+/**
+ * @brief Copia os contadores de um barramento.
+ * @note A utilização é a fração do tempo, desde a inicialização ou o último
+ * i2c_bus_reset_stats(), em que o barramento esteve executando transações.
+ * * @param port O periférico (I2C0_PORT ou I2C1_PORT).
+ * @param stats Ponteiro onde os contadores serão escritos.
+ * @return true se o gerenciador está pronto, false caso contrário.
+ */
+bool i2c_bus_get_stats(i2c_inst_t *port, i2c_bus_stats_t *stats){
+    i2c_bus_t *bus = bus_of(port);
+    if(!bus->ready) return false;
+
+    taskENTER_CRITICAL();
+    stats->submitted = bus->submitted;
+    stats->completed = bus->completed;
+    stats->failed = bus->failed;
+    stats->rejected = bus->rejected;
+    stats->bytes = bus->bytes;
+    stats->queue_depth = (uint8_t)uxQueueMessagesWaiting(bus->queue) + bus->in_flight;
+    stats->max_queue_depth = bus->max_queue_depth;
+    stats->busy_us = bus->busy_us;
+    stats->elapsed_us = time_us_64() - bus->stats_start_us;
+    taskEXIT_CRITICAL();
+
+    stats->utilization_percent = stats->elapsed_us ? (uint8_t)((stats->busy_us * 100) / stats->elapsed_us) : 0;
+
+    return true;
+}
+
+/**
+ * @brief Zera os contadores de um barramento.
+ * * @param port O periférico (I2C0_PORT ou I2C1_PORT).
+ */
+void i2c_bus_reset_stats(i2c_inst_t *port){
+    i2c_bus_t *bus = bus_of(port);
+
+    taskENTER_CRITICAL();
+    bus->submitted = 0;
+    bus->completed = 0;
+    bus->failed = 0;
+    bus->rejected = 0;
+    bus->bytes = 0;
+    bus->max_queue_depth = 0;
+    bus->busy_us = 0;
+    bus->stats_start_us = time_us_64();
+    taskEXIT_CRITICAL();
+}
\ No newline at end of file
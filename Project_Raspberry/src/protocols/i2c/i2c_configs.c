@@ -1,5 +1,7 @@
 #include "i2c_configs.h"
+#include "i2c_bus.h"
 #include "pico/stdlib.h"
+#include "log.h"
 
 static void i2c_configs(i2c_inst_t *i2c_port, uint sda_pin, uint scl_pin, uint baudrate) {
     i2c_init(i2c_port, baudrate);
@@ -7,6 +9,9 @@ static void i2c_configs(i2c_inst_t *i2c_port, uint sda_pin, uint scl_pin, uint b
     gpio_set_function(scl_pin, GPIO_FUNC_I2C);
     gpio_pull_up(sda_pin);
     gpio_pull_up(scl_pin);
+
+    // Transactions on this bus go through its DMA transaction manager
+    if(!i2c_bus_init(i2c_port)) LOG1(LOG_ERROR_I2C_BUS, i2c_port == I2C0_PORT ? 0 : 1);
 }
 
 /**
@@ -0,0 +1,302 @@
+#include "onewire.h"
+#include "hardware/gpio.h"
+#include <string.h>
+
+/**
+ * @brief Força o barramento para nível baixo (pino como saída em 0).
+ * * @param bus Ponteiro para a estrutura onewire_t.
+ */
+static inline void line_low(onewire_t *bus){
+    gpio_set_dir(bus->pin, GPIO_OUT);
+}
+
+/**
+ * @brief Libera o barramento (pino como entrada), deixando o pull-up elevar a linha.
+ * * @param bus Ponteiro para a estrutura onewire_t.
+ */
+static inline void line_release(onewire_t *bus){
+    gpio_set_dir(bus->pin, GPIO_IN);
+}
+
+/**
+ * @brief Callback do alarme de hardware que avança a máquina de slots.
+ * @note Executa em contexto de interrupção. Ao final da sequência, libera o
+ * semáforo 'done' para acordar a task que iniciou a transferência.
+ * * @param id Identificador do alarme (não utilizado).
+ * @param user_data Ponteiro para a estrutura onewire_t.
+ * @return O atraso (em us) até o próximo passo, ou 0 para encerrar o alarme.
+ */
+static int64_t onewire_alarm_callback(alarm_id_t id, void *user_data){
+    onewire_t *bus = (onewire_t *)user_data;
+
+    uint32_t delay_us = onewire_step(bus);
+    if(delay_us) return delay_us;
+
+    BaseType_t higher_priority_task_woken = pdFALSE;
+    xSemaphoreGiveFromISR(bus->done, &higher_priority_task_woken);
+    portYIELD_FROM_ISR(higher_priority_task_woken);
+
+    return 0;
+}
+
+/**
+ * @brief Inicializa um barramento 1-Wire em um pino GPIO.
+ * @note O pino é emulado como dreno aberto: o nível de saída fica fixo em 0 e
+ * apenas a direção é alternada. É necessário um resistor de pull-up externo.
+ * * @param bus Ponteiro para a estrutura onewire_t a ser inicializada.
+ * @param pin O número do pino GPIO do barramento.
+ * @return true se a inicialização foi bem-sucedida, false caso contrário.
+ */
+bool onewire_init(onewire_t *bus, uint pin){
+    if(!bus) return false;
+
+    memset(bus, 0, sizeof(*bus));
+    bus->pin = pin;
+    bus->state = ONEWIRE_STATE_IDLE;
+
+    bus->done = xSemaphoreCreateBinaryStatic(&bus->done_buffer);
+    if(bus->done == NULL) return false;
+
+    gpio_init(pin);
+    gpio_put(pin, 0);
+    line_release(bus);
+
+    return true;
+}
+
+/**
+ * @brief Executa um passo da máquina de slots 1-Wire.
+ * @note Fases longas (reset, parte baixa do bit 0 e o restante de cada slot)
+ * são aguardadas pelo alarme de hardware; apenas as janelas curtas (< 15us)
+ * de escrita do bit 1 e de amostragem da leitura são feitas com espera ativa.
+ * Independente do hardware de alarme, pode ser chamada diretamente para simular o barramento.
+ * * @param bus Ponteiro para a estrutura onewire_t.
+ * @return O tempo (em us) até o próximo passo, ou 0 quando a sequência terminou.
+ */
+uint32_t onewire_step(onewire_t *bus){
+    switch(bus->state){
+        case ONEWIRE_STATE_RESET:
+            line_low(bus);
+            bus->state = ONEWIRE_STATE_RESET_RELEASE;
+            return ONEWIRE_RESET_LOW_US;
+
+        case ONEWIRE_STATE_RESET_RELEASE:
+            line_release(bus);
+            bus->state = ONEWIRE_STATE_RESET_PRESENCE;
+            return ONEWIRE_PRESENCE_SAMPLE_US;
+
+        case ONEWIRE_STATE_RESET_PRESENCE:
+            bus->presence = !gpio_get(bus->pin); // The device pulls the line low to signal presence
+            bus->state = ONEWIRE_STATE_SLOT;
+            return ONEWIRE_RESET_RECOVERY_US;
+
+        case ONEWIRE_STATE_SLOT: {
+            size_t index = bus->bit_index;
+
+            // Write slots (LSB first)
+            if(index < bus->tx_bits){
+                bool bit_state = (bus->tx_buffer[index / 8] >> (index % 8)) & 1;
+
+                line_low(bus);
+                if(!bit_state){
+                    bus->state = ONEWIRE_STATE_WRITE_ZERO_RELEASE;
+                    return ONEWIRE_WRITE_ZERO_LOW_US;
+                }
+
+                busy_wait_us_32(ONEWIRE_WRITE_ONE_LOW_US);
+                line_release(bus);
+                bus->bit_index++;
+                return ONEWIRE_SLOT_US - ONEWIRE_WRITE_ONE_LOW_US + ONEWIRE_RECOVERY_US;
+            }
+
+            // Read slots (LSB first)
+            index -= bus->tx_bits;
+            if(index < bus->rx_bits){
+                line_low(bus);
+                busy_wait_us_32(ONEWIRE_READ_LOW_US);
+                line_release(bus);
+                busy_wait_us_32(ONEWIRE_READ_SAMPLE_US);
+
+                if(gpio_get(bus->pin)) bus->rx_buffer[index / 8] |= (1 << (index % 8));
+                else bus->rx_buffer[index / 8] &= ~(1 << (index % 8));
+
+                bus->bit_index++;
+                return ONEWIRE_SLOT_US - ONEWIRE_READ_LOW_US - ONEWIRE_READ_SAMPLE_US + ONEWIRE_RECOVERY_US;
+            }
+
+            bus->state = ONEWIRE_STATE_IDLE;
+            return 0;
+        }
+
+        case ONEWIRE_STATE_WRITE_ZERO_RELEASE:
+            line_release(bus);
+            bus->bit_index++;
+            bus->state = ONEWIRE_STATE_SLOT;
+            return ONEWIRE_SLOT_US - ONEWIRE_WRITE_ZERO_LOW_US + ONEWIRE_RECOVERY_US;
+
+        case ONEWIRE_STATE_IDLE:
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief Executa uma sequência 1-Wire (reset opcional, escrita e leitura de bits)
+ * dirigida por alarmes de hardware, bloqueando a task chamadora sem ocupar a CPU.
+ * @note A task aguarda no semáforo do barramento; os demais processos do core
+ * continuam executando entre os slots.
+ * * @param bus Ponteiro para a estrutura onewire_t.
+ * @param reset Se true, a sequência começa com um pulso de reset/presença.
+ * @param tx Bits a serem escritos (LSB first); pode ser NULL se tx_bits for 0.
+ * @param tx_bits Quantidade de bits a escrever.
+ * @param rx Buffer para os bits lidos (LSB first); pode ser NULL se rx_bits for 0.
+ * @param rx_bits Quantidade de bits a ler.
+ * @return true se a sequência terminou (e houve pulso de presença, quando solicitado reset),
+ * false em caso de timeout, erro ou perda do alarme de início, ou ausência de dispositivo.
+ */
+bool onewire_transfer_bits(onewire_t *bus, bool reset, const uint8_t *tx, size_t tx_bits, uint8_t *rx, size_t rx_bits){
+    if(!bus || bus->state != ONEWIRE_STATE_IDLE) return false;
+
+    bus->tx_buffer = tx;
+    bus->rx_buffer = rx;
+    bus->tx_bits = tx ? tx_bits : 0;
+    bus->rx_bits = rx ? rx_bits : 0;
+    bus->bit_index = 0;
+    bus->presence = false;
+    bus->state = reset ? ONEWIRE_STATE_RESET : ONEWIRE_STATE_SLOT;
+
+    xSemaphoreTake(bus->done, 0); // Discards a completion left by a previous timeout
+
+    // Never fired inline: the first step would run in task context, outside the slot timing.
+    // 0 means the start instant was already missed; the sequence is not started
+    bus->alarm = add_alarm_in_us(ONEWIRE_START_DELAY_US, onewire_alarm_callback, bus, false);
+    if(bus->alarm <= 0){
+        bus->state = ONEWIRE_STATE_IDLE;
+        return false;
+    }
+
+    if(xSemaphoreTake(bus->done, pdMS_TO_TICKS(ONEWIRE_TIMEOUT_MS)) != pdTRUE){
+        cancel_alarm(bus->alarm);
+        bus->state = ONEWIRE_STATE_IDLE;
+        line_release(bus);
+        return false;
+    }
+
+    return !reset || bus->presence;
+}
+
+/**
+ * @brief Versão orientada a bytes de onewire_transfer_bits().
+ * * @param bus Ponteiro para a estrutura onewire_t.
+ * @param reset Se true, a sequência começa com um pulso de reset/presença.
+ * @param tx Bytes a serem escritos (podem ser NULL se tx_len for 0).
+ * @param tx_len Quantidade de bytes a escrever.
+ * @param rx Buffer para os bytes lidos (pode ser NULL se rx_len for 0).
+ * @param rx_len Quantidade de bytes a ler.
+ * @return O mesmo que onewire_transfer_bits().
+ */
+bool onewire_transfer(onewire_t *bus, bool reset, const uint8_t *tx, size_t tx_len, uint8_t *rx, size_t rx_len){
+    return onewire_transfer_bits(bus, reset, tx, tx_len * 8, rx, rx_len * 8);
+}
+
+/**
+ * @brief Calcula o CRC8 Dallas/Maxim (polinômio x^8 + x^5 + x^4 + 1) de um bloco de bytes.
+ * @note Aplicado a um bloco que termina com o próprio CRC (ROM ou Scratchpad), o resultado é 0.
+ * * @param data Ponteiro para os bytes.
+ * @param len Quantidade de bytes.
+ * @return O CRC8 calculado.
+ */
+uint8_t onewire_crc8(const uint8_t *data, size_t len){
+    uint8_t crc = 0;
+
+    for(size_t i = 0; i < len; i++){
+        uint8_t byte_val = data[i];
+        for(int bit = 0; bit < 8; bit++){
+            uint8_t mix = (crc ^ byte_val) & 0x01;
+            crc >>= 1;
+            if(mix) crc ^= 0x8C;
+            byte_val >>= 1;
+        }
+    }
+
+    return crc;
+}
+
+/**
+ * @brief Reinicia o estado da busca de ROM para começar pelo primeiro dispositivo.
+ * * @param search Ponteiro para a estrutura onewire_search_t.
+ */
+void onewire_search_reset(onewire_search_t *search){
+    memset(search, 0, sizeof(*search));
+}
+
+/**
+ * @brief Encontra o próximo dispositivo do barramento pelo algoritmo Search ROM.
+ * @note A cada bit da ROM, todos os dispositivos respondem o bit e o seu complemento;
+ * quando ambos são 0 há uma discrepância, e o caminho escolhido alterna entre as
+ * chamadas até percorrer toda a árvore de ROMs.
+ * * @param bus Ponteiro para a estrutura onewire_t.
+ * @param search Estado da busca (iniciado com onewire_search_reset()).
+ * @param rom Buffer de ONEWIRE_ROM_SIZE bytes onde a ROM encontrada será escrita.
+ * @return true se um novo dispositivo com CRC válido foi encontrado, false ao
+ * terminar a busca (search->last_device fica true) ou em caso de erro no barramento.
+ */
+bool onewire_search_next(onewire_t *bus, onewire_search_t *search, uint8_t *rom){
+    if(search->last_device) return false;
+
+    const uint8_t command = ONEWIRE_CMD_SEARCH_ROM;
+    if(!onewire_transfer(bus, true, &command, 1, NULL, 0)){
+        onewire_search_reset(search);
+        return false;
+    }
+
+    uint8_t last_zero = 0;
+
+    for(uint8_t bit = 1; bit <= ONEWIRE_ROM_SIZE * 8; bit++){
+        uint8_t byte_index = (bit - 1) / 8;
+        uint8_t bit_mask = 1 << ((bit - 1) % 8);
+
+        // Reads the bit and its complement
+        uint8_t answer = 0;
+        if(!onewire_transfer_bits(bus, false, NULL, 0, &answer, 2)) return false;
+
+        bool id_bit = answer & 0x01;
+        bool complement_bit = answer & 0x02;
+        bool direction;
+
+        if(id_bit && complement_bit){
+            // No device answered
+            onewire_search_reset(search);
+            return false;
+        }
+
+        if(id_bit != complement_bit){
+            direction = id_bit;
+        } else {
+            // Discrepancy: every remaining device does not share this bit
+            if(bit < search->last_discrepancy) direction = (search->rom[byte_index] & bit_mask) != 0;
+            else direction = (bit == search->last_discrepancy);
+
+            if(!direction) last_zero = bit;
+        }
+
+        if(direction) search->rom[byte_index] |= bit_mask;
+        else search->rom[byte_index] &= ~bit_mask;
+
+        // Selects the path: devices whose bit differs go idle until the next reset
+        uint8_t direction_bit = direction;
+        if(!onewire_transfer_bits(bus, false, &direction_bit, 1, NULL, 0)) return false;
+    }
+
+    // A corrupted ROM leaves the search state unusable: it restarts from the first device
+    if(onewire_crc8(search->rom, ONEWIRE_ROM_SIZE) != 0){
+        onewire_search_reset(search);
+        return false;
+    }
+
+    search->last_discrepancy = last_zero;
+    search->last_device = (last_zero == 0);
+
+    memcpy(rom, search->rom, ONEWIRE_ROM_SIZE);
+    return true;
+}
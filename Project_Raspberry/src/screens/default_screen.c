@@ -21,15 +21,15 @@ void show_default_screen(sensors_data_t latest_data) {
     print_text_center(&oled, text, line);
     line += LINE_WITH_MARGIN;
         
-    snprintf(text, sizeof(text), "PH: %.2f", latest_data.ph);
+    snprintf(text, sizeof(text), "PH: %.2f", fixed_to_float(latest_data.ph));
     print_text_left(&oled, text, line);
     line+= LINE_WITH_MARGIN;
         
-    snprintf(text, sizeof(text), "PPM: %.2f", latest_data.tds);
+    snprintf(text, sizeof(text), "PPM: %.2f", fixed_to_float(latest_data.tds));
     print_text_left(&oled, text, line);
     line+= LINE_WITH_MARGIN;
 
-    snprintf(text, sizeof(text), "Temp: %.2f ºC", latest_data.temperature);
+    snprintf(text, sizeof(text), "Temp: %.2f ºC", fixed_to_float(latest_data.temperature));
     print_text_left(&oled, text, line);
     
     oled_render(&oled);
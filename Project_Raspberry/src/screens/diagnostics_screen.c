@@ -0,0 +1,50 @@
+#include "diagnostics_screen.h"
+#include "oled_prints.h"
+
+#define LINE_ONE 0
+#define FIRST_TASK_LINE 5
+
+/**
+ * @brief Exibe a tela de diagnóstico no OLED.
+ * @note Mostra a carga de cada core, as trocas de contexto por segundo, o menor
+ * espaço livre do heap, as notificações agrupadas e descartadas desde o boot e as
+ * tasks mais ocupadas (nome, % da CPU e palavras livres na pilha), a partir da
+ * última amostra de 'diagnostics_sample'.
+ * * @param diagnostics A última amostra de diagnóstico.
+ */
+void show_diagnostics_screen(const diagnostics_t *diagnostics) {
+    oled_clear(&oled);
+
+    char title[] = "DIAGNOSTICS";
+    print_text_center(&oled, title, LINE_ONE);
+
+    char text[17];
+    uint32_t window_ms = diagnostics->window_us / 1000;
+
+    snprintf(text, sizeof(text), "C0 %3u%% C1 %3u%%",
+             (diagnostics->core_load_permille[0] + 5) / 10, (diagnostics->core_load_permille[1] + 5) / 10);
+    print_text_left(&oled, text, 1);
+
+    snprintf(text, sizeof(text), "CS/s %lu %lu",
+             window_ms ? (unsigned long)(diagnostics->context_switches[0] * 1000 / window_ms) : 0UL,
+             window_ms ? (unsigned long)(diagnostics->context_switches[1] * 1000 / window_ms) : 0UL);
+    print_text_left(&oled, text, 2);
+
+    snprintf(text, sizeof(text), "Heap min %luK", (unsigned long)(diagnostics->heap_min_free / 1024));
+    print_text_left(&oled, text, 3);
+
+    snprintf(text, sizeof(text), "Ntf C%lu D%lu", (unsigned long)diagnostics->notifications.coalesced,
+             (unsigned long)diagnostics->notifications.dropped);
+    print_text_left(&oled, text, 4);
+
+    uint8_t line = FIRST_TASK_LINE;
+    for(uint8_t i = 0; i < diagnostics->task_count && line < OLED_PAGES; i++, line++){
+        const diagnostics_task_t *task = &diagnostics->tasks[i];
+
+        snprintf(text, sizeof(text), "%-8.8s%3u%%%4u", task->name,
+                 (task->cpu_permille + 5) / 10, task->stack_free_words);
+        print_text_left(&oled, text, line);
+    }
+
+    oled_render(&oled);
+}
\ No newline at end of file
@@ -7,7 +7,8 @@
  * @brief Exibe a tela de notificações no OLED.
  * @note Esta tela limpa o display, mostra um título e lista as
  * notificações mais recentes (até MAX_NOTIFICATIONS), prefixando
- * cada mensagem com seu tipo (IN, AL, ER).
+ * cada mensagem com seu tipo (IN, AL, ER). Notificações agrupadas
+ * trocam o ':' pelo número de repetições (ou '+' a partir de 10).
  * * @param latest_notifications Um ponteiro para um array de estruturas
  * (notification_t) contendo as notificações a serem exibidas.
  */
@@ -18,26 +19,30 @@ void show_notifications_screen(notification_t *latest_notifications) {
     print_text_center(&oled, title, LINE_ONE);
 
     for(uint8_t i = 0; i < MAX_NOTIFICATIONS; i++){
-        char type[10];
+        char *type;
 
         // Convert type to string
         switch(latest_notifications[i].type) {
             case INFO:
-                snprintf(type, sizeof(type), "IN: ");
+                type = "IN";
                 break;
             case ALERT:
-                snprintf(type, sizeof(type), "AL: ");
+                type = "AL";
                 break;
             case ERROR:
-                snprintf(type, sizeof(type), "ER: ");
+                type = "ER";
                 break;
             default:
-                snprintf(type, sizeof(type), "UN: ");
+                type = "UN";
                 break;
         }
 
+        // Repetition marker: ':' once, the count up to 9, '+' beyond
+        uint16_t count = latest_notifications[i].count;
+        char marker = count <= 1 ? ':' : (count < 10 ? (char)('0' + count) : '+');
+
         char text[16];
-        snprintf(text, sizeof(text), "%s%s", type, latest_notifications[i].message);
+        snprintf(text, sizeof(text), "%s%c %s", type, marker, latest_notifications[i].message);
 
         print_text_left(&oled, text, i + 2);
     }
@@ -22,7 +22,7 @@ void show_ph_screen(sensors_data_t latest_data) {
     if(analyzer_is_ph_alert(latest_data.ph)) snprintf(unit_and_state, sizeof(unit_and_state), "(pH) I ALERT");
     else snprintf(unit_and_state, sizeof(unit_and_state), "(pH) I NORMAL");
 
-    snprintf(sensor_value, sizeof(sensor_value), "%.2f", latest_data.ph);
+    snprintf(sensor_value, sizeof(sensor_value), "%.2f", fixed_to_float(latest_data.ph));
 
     uint8_t line = LINE_ONE;
 
@@ -23,7 +23,7 @@ void show_temperature_screen(sensors_data_t latest_data) {
         snprintf(unit_and_state, sizeof(unit_and_state), "(ºC) I ALERT");
     else snprintf(unit_and_state, sizeof(unit_and_state), "(ºC) I NORMAL");
 
-    snprintf(sensor_value, sizeof(sensor_value), "%.2f", latest_data.temperature);
+    snprintf(sensor_value, sizeof(sensor_value), "%.2f", fixed_to_float(latest_data.temperature));
 
     uint8_t line = LINE_ONE;
 
@@ -0,0 +1,117 @@
+# Firmware sources and include folders, shared by the Pico build (src/CMakeLists.txt)
+# and the Linux host build (host/CMakeLists.txt)
+set(FILTERCORE_SRC_DIR ${CMAKE_CURRENT_LIST_DIR})
+
+# Paths to the includes folders
+set(COMPONENTS_PATH ${FILTERCORE_SRC_DIR}/../lib/components)
+set(MISCELLANEOUS_PATH ${FILTERCORE_SRC_DIR}/../lib/miscellaneous)
+set(PROTOCOLS_PATH ${FILTERCORE_SRC_DIR}/../lib/protocols)
+set(SCREENS_PATH ${FILTERCORE_SRC_DIR}/../lib/screens)
+set(TASKS_PATH ${FILTERCORE_SRC_DIR}/../lib/tasks)
+
+# Grouping of sources by component
+#ANALOGIC
+set(ANALOG_COMPONENT_SOURCES
+    ${FILTERCORE_SRC_DIR}/components/analog/ds18b20.c
+    ${FILTERCORE_SRC_DIR}/components/analog/ph4502c.c
+    ${FILTERCORE_SRC_DIR}/components/analog/tds_meter.c
+)
+
+#DIGITAL
+set(DIGITAL_COMPONENT_SOURCES
+    ${FILTERCORE_SRC_DIR}/components/digital/buttons.c
+)
+
+#I2C
+set(I2C_PROTOCOL_SOURCES
+    ${FILTERCORE_SRC_DIR}/protocols/i2c/i2c_configs.c
+    ${FILTERCORE_SRC_DIR}/protocols/i2c/i2c_bus.c
+)
+
+set(I2C_COMPONENT_SOURCES
+    ${FILTERCORE_SRC_DIR}/components/i2c/ads1115.c
+)
+
+#1-WIRE
+set(ONEWIRE_PROTOCOL_SOURCES
+    ${FILTERCORE_SRC_DIR}/protocols/onewire/onewire.c
+)
+
+#OLED
+set(OLED_COMPONENT_SOURCES
+    ${FILTERCORE_SRC_DIR}/components/oled/oled_display.c
+    ${FILTERCORE_SRC_DIR}/components/oled/oled_environment.c
+    ${FILTERCORE_SRC_DIR}/components/oled/oled_prints.c
+    ${FILTERCORE_SRC_DIR}/components/oled/ssd1306_text.c
+)
+
+# Screen grouping for OLED
+set(SCREENS_SOURCES
+    ${FILTERCORE_SRC_DIR}/screens/default_screen.c
+    ${FILTERCORE_SRC_DIR}/screens/ph_screen.c
+    ${FILTERCORE_SRC_DIR}/screens/tds_screen.c
+    ${FILTERCORE_SRC_DIR}/screens/temperature_screen.c
+    ${FILTERCORE_SRC_DIR}/screens/notifications_screen.c
+    ${FILTERCORE_SRC_DIR}/screens/diagnostics_screen.c
+)
+
+# Grouping sources by tasks
+set(TASK_SOURCES
+    ${FILTERCORE_SRC_DIR}/tasks/task_diagnostics.c
+    ${FILTERCORE_SRC_DIR}/tasks/task_display.c
+    ${FILTERCORE_SRC_DIR}/tasks/task_handshake.c
+    ${FILTERCORE_SRC_DIR}/tasks/task_log.c
+    ${FILTERCORE_SRC_DIR}/tasks/task_pagination.c
+    ${FILTERCORE_SRC_DIR}/tasks/task_producers.c
+    ${FILTERCORE_SRC_DIR}/tasks/task_sensors.c
+)
+
+# Grouping of various sources
+set(MISCELLANEOUS_SOURCES
+    ${FILTERCORE_SRC_DIR}/miscellaneous/notifications.c
+    ${FILTERCORE_SRC_DIR}/miscellaneous/handshake.c
+    ${FILTERCORE_SRC_DIR}/miscellaneous/sensor_analyzer.c
+    ${FILTERCORE_SRC_DIR}/miscellaneous/sample_estimator.c
+    ${FILTERCORE_SRC_DIR}/miscellaneous/sampling_policy.c
+    ${FILTERCORE_SRC_DIR}/miscellaneous/periodic_job.c
+    ${FILTERCORE_SRC_DIR}/miscellaneous/sensor_capture.c
+    ${FILTERCORE_SRC_DIR}/miscellaneous/sensor_replay.c
+    ${FILTERCORE_SRC_DIR}/miscellaneous/sensor_snapshot.c
+    ${FILTERCORE_SRC_DIR}/miscellaneous/sensor_pipeline.c
+    ${FILTERCORE_SRC_DIR}/miscellaneous/sensor_history.c
+    ${FILTERCORE_SRC_DIR}/miscellaneous/mailbox.c
+    ${FILTERCORE_SRC_DIR}/miscellaneous/rtos_memory.c
+    ${FILTERCORE_SRC_DIR}/miscellaneous/diagnostics.c
+    ${FILTERCORE_SRC_DIR}/miscellaneous/core_ring.c
+    ${FILTERCORE_SRC_DIR}/miscellaneous/log.c
+    ${FILTERCORE_SRC_DIR}/miscellaneous/telemetry.c
+    ${FILTERCORE_SRC_DIR}/miscellaneous/latency.c
+)
+
+set(FILTERCORE_SOURCES
+    ${FILTERCORE_SRC_DIR}/main.c
+    ${I2C_PROTOCOL_SOURCES}
+    ${I2C_COMPONENT_SOURCES}
+    ${ONEWIRE_PROTOCOL_SOURCES}
+    ${ANALOG_COMPONENT_SOURCES}
+    ${DIGITAL_COMPONENT_SOURCES}
+    ${OLED_COMPONENT_SOURCES}
+    ${SCREENS_SOURCES}
+    ${MISCELLANEOUS_SOURCES}
+    ${TASK_SOURCES}
+)
+
+set(FILTERCORE_INCLUDE_DIRS
+    ${FILTERCORE_SRC_DIR}
+    ${FILTERCORE_SRC_DIR}/../lib
+    ${PROTOCOLS_PATH}/i2c
+    ${PROTOCOLS_PATH}/onewire
+    ${COMPONENTS_PATH}/i2c
+    ${COMPONENTS_PATH}/analog
+    ${COMPONENTS_PATH}/digital
+    ${COMPONENTS_PATH}/oled
+    ${COMPONENTS_PATH}/oled/fonts
+    ${SCREENS_PATH}
+    ${MISCELLANEOUS_PATH}
+    ${TASKS_PATH}
+)
@@ -0,0 +1,80 @@
+#include "task_diagnostics.h"
+#include "events.h"
+#include "diagnostics.h"
+#include "periodic_job.h"
+#include "latency.h"
+#include "sensor_history.h"
+#include "log.h"
+
+#define DIAGNOSTICS_INTERVAL_MS 1000
+#define DIAGNOSTICS_DEADLINE_MS 100
+#define DIAGNOSTICS_PRINT_EVERY 5   // samples between two console reports
+#define DIAGNOSTICS_STACK_SIZE (configMINIMAL_STACK_SIZE * 2)
+
+static StaticTask_t diagnostics_task_buffer;
+static StackType_t diagnostics_task_stack[DIAGNOSTICS_STACK_SIZE];
+
+/**
+ * @brief Função da task de diagnóstico do sistema.
+ * @note Esta task é responsável por:
+ * 1. A cada DIAGNOSTICS_INTERVAL_MS, amostrar a carga por core e por task, as
+ * trocas de contexto, as marcas d'água das pilhas e o heap ('diagnostics_sample').
+ * 2. Acordar o display (DISPLAY_EVENT_DIAGNOSTICS) para a página de diagnóstico.
+ * 3. A cada DIAGNOSTICS_PRINT_EVERY amostras, imprimir a amostra (com os
+ * contadores de notificações agrupadas e descartadas), as
+ * estatísticas dos jobs periódicos, as latências por etapa, da leitura dos
+ * sensores ao ACK do FPGA, e o resumo do histórico de sensores no console, em
+ * quadros de texto (log_text) que não se misturam aos quadros binários do log.
+ * 4. Aguardar a próxima liberação periódica (periodic_job_wait).
+ * * @param params Parâmetros de inicialização da task (não utilizados).
+ */
+static void task_diagnostics(void *params){
+    LOG(LOG_STARTED_DIAGNOSTICS);
+
+    uint8_t samples = 0;
+
+    static periodic_job_t job;
+    periodic_job_init(&job, "Diagnostics", DIAGNOSTICS_INTERVAL_MS, DIAGNOSTICS_DEADLINE_MS);
+
+    while(true){
+        periodic_job_release(&job);
+
+        if(diagnostics_sample()){
+            notify_display(DISPLAY_EVENT_DIAGNOSTICS);
+
+            if(++samples >= DIAGNOSTICS_PRINT_EVERY){
+                samples = 0;
+
+                static diagnostics_t diagnostics;
+                if(diagnostics_read(&diagnostics)) diagnostics_print(&diagnostics);
+                periodic_job_print_stats();
+                latency_print_stats();
+                sensor_history_print_stats();
+            }
+        }
+
+        periodic_job_wait(&job);
+    }
+}
+
+/**
+ * @brief Cria e inicia a task de diagnóstico (task_diagnostics).
+ * @note A task é criada com prioridade baixa (IDLE + 1) e afinidade com o Core 1,
+ * longe das tasks de aquisição.
+ */
+void create_task_diagnostics(void){
+    diagnostics_init();
+
+    TaskHandle_t handle = xTaskCreateStatic(
+        task_diagnostics,
+        "Task Diagnostics",
+        DIAGNOSTICS_STACK_SIZE,
+        NULL,
+        tskIDLE_PRIORITY + 1,
+        diagnostics_task_stack,
+        &diagnostics_task_buffer
+    );
+
+    if(handle == NULL) LOG(LOG_FAILED_DIAGNOSTICS);
+    else vTaskCoreAffinitySet(handle, (1 << 1)); // Set task to run on core 1
+}
\ No newline at end of file
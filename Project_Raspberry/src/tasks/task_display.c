@@ -9,23 +9,138 @@
 #include "tds_screen.h"
 #include "temperature_screen.h"
 #include "notifications_screen.h"
+#include "diagnostics_screen.h"
 #include "notifications.h"
+#include "log.h"
+#include <string.h>
 
-#define DISPLAY_INTERVAL_MS 250
+#define DISPLAY_STARTUP_DELAY_MS 250
+#define DISPLAY_MIN_FRAME_MS 100    // minimum interval between two frames
+#define DISPLAY_REPORT_MS 1000      // frames rendered/skipped report period
+
+#define DISPLAY_EVENTS_ALL (DISPLAY_EVENT_SENSORS | DISPLAY_EVENT_PAGE | DISPLAY_EVENT_NOTIFICATION | DISPLAY_EVENT_DIAGNOSTICS)
+
+#define DISPLAY_STACK_SIZE (configMINIMAL_STACK_SIZE * 4)
+
+TaskHandle_t handle_display = NULL;
+static StaticTask_t display_task_buffer;
+static StackType_t display_task_stack[DISPLAY_STACK_SIZE];
+
+/**
+ * @brief Eventos que alteram o conteúdo visível de uma tela.
+ * * @param screen A tela exibida.
+ * @return Máscara de eventos (DISPLAY_EVENT_...).
+ */
+static uint32_t screen_events(oled_screen_t screen){
+    switch(screen){
+        case DEFAULT_SCREEN:
+        case PH_SCREEN:
+        case TDS_SCREEN:
+        case TEMPERATURE_SCREEN:
+            return DISPLAY_EVENT_PAGE | DISPLAY_EVENT_SENSORS;
+
+        case NOTIFICATIONS_SCREEN:
+            return DISPLAY_EVENT_PAGE | DISPLAY_EVENT_NOTIFICATION;
+
+        case DIAGNOSTICS_SCREEN:
+            return DISPLAY_EVENT_PAGE | DISPLAY_EVENT_DIAGNOSTICS;
+
+        default:
+            return DISPLAY_EVENT_PAGE;
+    }
+}
+
+/**
+ * @brief Move as notificações pendentes para a lista exibida.
+ * @note A mais nova fica no topo; repetições da mais nova só somam o contador.
+ * * @param latest_notifications Lista exibida (MAX_NOTIFICATIONS posições).
+ */
+static void collect_notifications(notification_t *latest_notifications){
+    notification_t notification_received;
+
+    while(receive_notification(&notification_received)){
+        if(latest_notifications[0].type == notification_received.type &&
+           strcmp(latest_notifications[0].message, notification_received.message) == 0){
+            // Same as the newest shown: just add the repetitions
+            uint32_t count = (uint32_t)latest_notifications[0].count + notification_received.count;
+            latest_notifications[0].count = count > UINT16_MAX ? UINT16_MAX : count;
+            continue;
+        }
+
+        // Shift existing notifications down
+        for(int i = MAX_NOTIFICATIONS - 1; i > 0; i--){
+            latest_notifications[i] = latest_notifications[i - 1];
+        }
+        // Add new notification at the top
+        latest_notifications[0] = notification_received;
+    }
+}
+
+/**
+ * @brief Desenha a tela atual no OLED.
+ * @note Deve ser chamada com o 'oled_mutex' obtido. Quadros idênticos ao
+ * anterior não são enviados pelo driver (oled_render).
+ * * @param screen A tela a ser desenhada.
+ * @param latest_notifications Lista de notificações exibida.
+ */
+static void draw_screen(oled_screen_t screen, notification_t *latest_notifications){
+    sensors_data_t latest_data = {0};
+    bool sensors_data_available = mailbox_read(&mailbox_sensors_data, &latest_data, NULL);
+
+    switch(screen){
+        case DEFAULT_SCREEN:
+            if(sensors_data_available) show_default_screen(latest_data);
+            break;
+
+        case PH_SCREEN:
+            if(sensors_data_available) show_ph_screen(latest_data);
+            break;
+
+        case TDS_SCREEN:
+            if(sensors_data_available) show_tds_screen(latest_data);
+            break;
+
+        case TEMPERATURE_SCREEN:
+            if(sensors_data_available) show_temperature_screen(latest_data);
+            break;
+
+        case NOTIFICATIONS_SCREEN:
+            show_notifications_screen(latest_notifications);
+            break;
+
+        case DIAGNOSTICS_SCREEN: {
+            static diagnostics_t diagnostics;
+            if(diagnostics_read(&diagnostics)) show_diagnostics_screen(&diagnostics);
+            break;
+        }
+            
+        default:
+            oled_clear(&oled);
+            print_text_center(&oled, "No data available", 3);
+            oled_render(&oled);
+            break;
+    }
+}
 
 /**
  * @brief Função da task principal para gerenciar o display OLED.
- * @note Esta task é responsável por:
- * 1. Obter o mutex do OLED para acesso seguro.
- * 2. Verificar a variável global 'current_screen' para decidir qual tela renderizar.
- * 3. Tentar ler os dados mais recentes da 'queue_sensors_data' (sem bloquear).
- * 4. Chamar a função 'show_...' apropriada para desenhar a tela.
- * 5. Na tela de notificação, consome itens da 'queue_notifications' e os exibe.
- * 6. Liberar o mutex e atrasar (vTaskDelay) antes de repetir.
+ * @note A task é dirigida por eventos (notificação direta com bits, ver
+ * notify_display): dados novos dos sensores, troca de página ou notificação nova.
+ * 1. Aguardar eventos (xTaskNotifyWait); sem eventos, a task não acorda além do
+ * relatório periódico.
+ * 2. Respeitar o intervalo mínimo entre quadros (DISPLAY_MIN_FRAME_MS); eventos
+ * recebidos nesse intervalo são agrupados no mesmo quadro. Trocas de página são
+ * desenhadas imediatamente.
+ * 3. Consumir as notificações pendentes (receive_notification), agrupando repetições.
+ * 4. Ignorar eventos que não alteram a tela atual (ex.: dados novos na tela de
+ * notificações).
+ * 5. Obter o mutex do OLED e desenhar a tela publicada (current_screen_get) com os dados de
+ * 'mailbox_sensors_data'; o driver descarta quadros idênticos ao exibido.
+ * 6. A cada DISPLAY_REPORT_MS, registrar no log quadros enviados e descartados por segundo.
  * * @param params Parâmetros de inicialização da task (não utilizados).
  */
 static void task_display(void *params) {
-    printf("[Started] | [Task 1] | [Display Printing]\n");
+    LOG(LOG_STARTED_DISPLAY);
 
     //Screen cleaning
     if(xSemaphoreTake(oled_mutex, portMAX_DELAY)){
@@ -34,62 +149,73 @@ static void task_display(void *params) {
         xSemaphoreGive(oled_mutex);
     }
 
-    vTaskDelay(pdMS_TO_TICKS(DISPLAY_INTERVAL_MS));
+    vTaskDelay(pdMS_TO_TICKS(DISPLAY_STARTUP_DELAY_MS));
 
     notification_t latest_notifications[MAX_NOTIFICATIONS];
     for(uint8_t i = 0; i < MAX_NOTIFICATIONS; i++){
-        send_notification(INFO, "No data");
+        latest_notifications[i] = (notification_t){ .type = INFO, .message = "No data", .count = 1 };
     }
 
-    // Screen selection loop
+    const TickType_t min_frame_ticks = pdMS_TO_TICKS(DISPLAY_MIN_FRAME_MS);
+    const TickType_t report_ticks = pdMS_TO_TICKS(DISPLAY_REPORT_MS);
+
+    uint32_t events = DISPLAY_EVENTS_ALL; // first frame
+    TickType_t last_frame = xTaskGetTickCount() - min_frame_ticks;
+    TickType_t last_report = xTaskGetTickCount();
+
+    uint32_t ignored_events = 0;  // wake-ups that do not change the current screen
+    uint32_t reported_rendered = 0;
+    uint32_t reported_skipped = 0;
+
     while(true){
-        if(xSemaphoreTake(oled_mutex, pdMS_TO_TICKS(100))){
-            sensors_data_t latest_data = {0};
-            bool sensors_data_available = (xQueueReceive(queue_sensors_data, &latest_data, 0) == pdPASS);
-
-            switch(current_screen){
-                case DEFAULT_SCREEN:
-                    if(sensors_data_available) show_default_screen(latest_data);
-                    break;
-
-                case PH_SCREEN:
-                    if(sensors_data_available) show_ph_screen(latest_data);
-                    break;
-
-                case TDS_SCREEN:
-                    if(sensors_data_available) show_tds_screen(latest_data);
-                    break;
-
-                case TEMPERATURE_SCREEN:
-                    if(sensors_data_available) show_temperature_screen(latest_data);
-                    break;
-
-                case NOTIFICATIONS_SCREEN:
-                    notification_t notification_received;
-
-                    while(xQueueReceive(queue_notifications, &notification_received, 0) == pdPASS){
-                        // Shift existing notifications down
-                        for(int i = MAX_NOTIFICATIONS - 1; i > 0; i--){
-                            latest_notifications[i] = latest_notifications[i - 1];
-                        }
-                        // Add new notification at the top
-                        latest_notifications[0] = notification_received;
-                    }
-
-                    show_notifications_screen(latest_notifications);
-                    break;
-                    
-                default:
-                    oled_clear(&oled);
-                    print_text_center(&oled, "No data available", 3);
-                    oled_render(&oled);
-                    break;
-            }
-
-            xSemaphoreGive(oled_mutex);
+        TickType_t now = xTaskGetTickCount();
+
+        // Frames rendered and skipped per second
+        if(now - last_report >= report_ticks){
+            uint32_t elapsed_ms = (now - last_report) * portTICK_PERIOD_MS;
+            uint32_t rendered = oled.frames_rendered;
+            uint32_t skipped = oled.frames_skipped + ignored_events;
+
+            LOG2(LOG_DISPLAY_FRAMES, (rendered - reported_rendered) * 1000 / elapsed_ms,
+                 (skipped - reported_skipped) * 1000 / elapsed_ms);
+
+            reported_rendered = rendered;
+            reported_skipped = skipped;
+            last_report = now;
+        }
+
+        if(events == 0){
+            uint32_t received = 0;
+            xTaskNotifyWait(0, UINT32_MAX, &received, report_ticks - (now - last_report));
+            events |= received;
+            continue;
         }
 
-        vTaskDelay(pdMS_TO_TICKS(DISPLAY_INTERVAL_MS));
+        // Rate limit: events arriving meanwhile are merged into this frame (page switches are immediate)
+        if(!(events & DISPLAY_EVENT_PAGE) && now - last_frame < min_frame_ticks){
+            vTaskDelay(min_frame_ticks - (now - last_frame));
+
+            uint32_t received = 0;
+            xTaskNotifyWait(0, UINT32_MAX, &received, 0);
+            events |= received;
+        }
+
+        if(events & DISPLAY_EVENT_NOTIFICATION) collect_notifications(latest_notifications);
+
+        oled_screen_t screen = current_screen_get();
+        if(!(events & screen_events(screen))){
+            ignored_events++;
+            events = 0;
+            continue;
+        }
+
+        if(!xSemaphoreTake(oled_mutex, pdMS_TO_TICKS(100))) continue; // keeps the events, retries
+
+        events = 0;
+        draw_screen(screen, latest_notifications);
+        xSemaphoreGive(oled_mutex);
+
+        last_frame = xTaskGetTickCount();
     }
 
 }
@@ -99,16 +225,16 @@ static void task_display(void *params) {
  * @note A task é criada com prioridade (IDLE + 2) e afinidade com o Core 1.
  */
 void create_task_display(void) {
-   TaskHandle_t handle;
-   BaseType_t status = xTaskCreate(
+   handle_display = xTaskCreateStatic(
        task_display,          
        "Task Display",       
-       configMINIMAL_STACK_SIZE * 4, 
+       DISPLAY_STACK_SIZE, 
        NULL,                 
        tskIDLE_PRIORITY + 2, 
-       &handle               
+       display_task_stack,
+       &display_task_buffer
    );
 
-   if(status != pdPASS || handle == NULL) printf("[Failed to create] | [Task 1] | [Display Printing]\n");
-   else vTaskCoreAffinitySet(handle, (1 << 1)); // Set task to run on core 1
+   if(handle_display == NULL) LOG(LOG_FAILED_DISPLAY);
+   else vTaskCoreAffinitySet(handle_display, (1 << 1)); // Set task to run on core 1
 }
\ No newline at end of file
@@ -1,22 +1,32 @@
 #include "task_handshake.h"
 #include "handshake.h"
 #include "notifications.h"
+#include "log.h"
+#include "telemetry.h"
+#include "latency.h"
 
-#define HANDSHAKE_INTERVAL_MS 250
+#define HANDSHAKE_STACK_SIZE (configMINIMAL_STACK_SIZE * 2)
+
+static StaticTask_t handshake_task_buffer;
+static StackType_t handshake_task_stack[HANDSHAKE_STACK_SIZE];
+
+TaskHandle_t handle_handshake = NULL;
 
 /**
  * @brief Função da task principal para comunicação via handshake com o FPGA.
  * @note Esta task é responsável por:
  * 1. Inicializar e resetar o FPGA ('reset_fpga_setup', 'handshake_setup').
- * 2. Bloquear aguardando dados na 'queue_normalized_sensors_data'.
+ * 2. Aguardar a notificação da task_sensors (notify_handshake) e ler a publicação mais
+ * recente de 'mailbox_normalized_sensors_data'; sem publicações, a task não acorda.
  * 3. Ao receber dados, executar o protocolo de handshake (Request, Wait for ACK).
  * 4. Tentar novamente (até HANDSHAKE_MAX_RETRIES) em caso de falha no ACK.
- * 5. Enviar notificações de sucesso ou falha na comunicação.
- * 6. Atrasar (vTaskDelay) antes de aguardar os próximos dados.
+ * 5. Enviar notificações de sucesso ou falha na comunicação e registrar o resultado
+ * e as tentativas na telemetria.
+ * 6. Concluir o rastro de latência da amostra (da leitura do sensor ao ACK).
  * * @param params Parâmetros de inicialização da task (não utilizados).
  */
 static void task_handshake(void *params){
-    printf("[Started] | [Task 4] | [Handshake]\n");
+    LOG(LOG_STARTED_HANDSHAKE);
 
     // Reset FPGA setup
     reset_fpga_setup();
@@ -25,18 +35,29 @@ static void task_handshake(void *params){
     handshake_setup();
 
     normalized_sensors_data_t data;
+    uint32_t last_publication = 0;
 
     while(true){
-        // Get data from the normalized data queue
-        if(xQueueReceive(queue_normalized_sensors_data, &data, portMAX_DELAY)){
+        // Sleeps until task_sensors publishes
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        // Get the normalized data, if it was published again since the last handshake
+        if(mailbox_read_if_new(&mailbox_normalized_sensors_data, &data, &last_publication)){
+            latency_mark(&data.trace, LATENCY_PICKED);
+
             bool success = false;
+            uint8_t attempts = 0;
             
             for(int retry = 1; retry <= HANDSHAKE_MAX_RETRIES && !success; retry++){
+                attempts++;
+
                 // Submit request
                 handshake_request(data);
+                if(retry == 1) latency_mark(&data.trace, LATENCY_REQUESTED);
 
                 // Wait for ACK
                 if(!handshake_acknowledge()) continue;
+                latency_mark(&data.trace, LATENCY_ACKNOWLEDGED);
                 
                 // Complete transaction
                 success = true;
@@ -46,10 +67,12 @@ static void task_handshake(void *params){
                 handshake_await_ack_lower();
             }
 
+            telemetry_link(success, attempts);
+            if(success) latency_complete(&data.trace);
+
             if(!success) send_notification(ERROR, "HS Failed!");
             else send_notification(INFO, "HS Success!");
         }
-        vTaskDelay(pdMS_TO_TICKS(HANDSHAKE_INTERVAL_MS));
     }
 }
 
@@ -58,16 +81,16 @@ static void task_handshake(void *params){
  * @note A task é criada com prioridade (IDLE + 2) e afinidade com o Core 1.
  */
 void create_task_handshake(void){
-    TaskHandle_t handle;
-    BaseType_t status = xTaskCreate(
+    handle_handshake = xTaskCreateStatic(
         task_handshake,          
         "Task Handshake",       
-        configMINIMAL_STACK_SIZE * 2, 
+        HANDSHAKE_STACK_SIZE, 
         NULL,                 
         tskIDLE_PRIORITY + 2, 
-        &handle               
+        handshake_task_stack,
+        &handshake_task_buffer
     );
 
-    if(status != pdPASS || handle == NULL) printf("[Failed to create] | [Task 4] | [Handshake]\n");
-    else vTaskCoreAffinitySet(handle, (1 << 1)); // Set task to run on core 1
+    if(handle_handshake == NULL) LOG(LOG_FAILED_HANDSHAKE);
+    else vTaskCoreAffinitySet(handle_handshake, (1 << 1)); // Set task to run on core 1
 }
\ No newline at end of file
@@ -0,0 +1,101 @@
+#include "task_log.h"
+#include "events.h"
+#include "log.h"
+#include "telemetry.h"
+#include "pico/platform.h"
+#include "periodic_job.h"
+
+#define LOG_INTERVAL_MS 50
+#define LOG_DEADLINE_MS 50
+#define LOG_STACK_SIZE (configMINIMAL_STACK_SIZE * 2)
+
+static StaticTask_t log_task_buffer;
+static StackType_t log_task_stack[LOG_STACK_SIZE];
+
+/**
+ * @brief Escreve um registro no console como quadro binário (sem tradução de CR/LF).
+ * * @param record O registro.
+ */
+static void write_record(const log_record_t *record){
+    log_frame_t frame;
+    log_frame(record, &frame);
+    stdio_put_string((const char *)&frame, sizeof(frame), false, false);
+}
+
+/**
+ * @brief Escreve um registro de telemetria no console como quadro COBS.
+ * * @param record O registro.
+ */
+static void write_telemetry(const telemetry_record_t *record){
+    uint8_t frame[TELEMETRY_MAX_FRAME];
+    size_t length = telemetry_encode(record, frame);
+    if(length > 0) stdio_put_string((const char *)frame, (int)length, false, false);
+}
+
+/**
+ * @brief Função da task que esvazia o log diferido.
+ * @note Esta task é responsável por:
+ * 1. A cada LOG_INTERVAL_MS, retirar todos os registros dos anéis (log_take) e
+ * escrevê-los no console em binário; o texto é reconstruído no host
+ * (tools/log_decode.c, com a mesma tabela log_messages.def).
+ * 2. Retirar os registros de telemetria (telemetry_take) e escrevê-los como quadros
+ * COBS delimitados por 0x00 (tools/telemetry_decode.cpp). É a dona do console USB:
+ * log e telemetria nunca se intercalam no meio de um quadro. Os relatórios de
+ * texto (log_text) também saem em quadros inteiros, um por escrita.
+ * 3. Registrar a quantidade de descartes de log de cada core quando ela muda; os
+ * descartes de telemetria aparecem no host como lacunas na sequência.
+ * 4. Aguardar a próxima liberação periódica (periodic_job_wait).
+ * @note Apenas esta task bloqueia no USB CDC; quem registra nunca formata nem espera.
+ * * @param params Parâmetros de inicialização da task (não utilizados).
+ */
+static void task_log(void *params){
+    uint32_t reported_dropped[NUM_CORES] = {0};
+
+    static periodic_job_t job;
+    periodic_job_init(&job, "Log", LOG_INTERVAL_MS, LOG_DEADLINE_MS);
+
+    while(true){
+        periodic_job_release(&job);
+
+        log_record_t record;
+        while(log_take(&record)) write_record(&record);
+
+#if TELEMETRY_ENABLED
+        telemetry_record_t telemetry;
+        while(telemetry_take(&telemetry)) write_telemetry(&telemetry);
+#endif
+
+        for(uint8_t core = 0; core < NUM_CORES; core++){
+            uint32_t dropped = log_dropped(core);
+            if(dropped == reported_dropped[core]) continue;
+
+            LOG2(LOG_DROPPED, core, dropped - reported_dropped[core]);
+            reported_dropped[core] = dropped;
+        }
+
+        periodic_job_wait(&job);
+    }
+}
+
+/**
+ * @brief Cria e inicia a task do log diferido (task_log).
+ * @note A task é criada com prioridade baixa (IDLE + 1) e afinidade com o Core 1.
+ * Registros feitos antes do escalonador (erros de inicialização) ficam nos anéis
+ * até a primeira liberação.
+ */
+void create_task_log(void){
+    LOG1(LOG_BOOT, LOG_MESSAGES_COUNT);
+
+    TaskHandle_t handle = xTaskCreateStatic(
+        task_log,
+        "Task Log",
+        LOG_STACK_SIZE,
+        NULL,
+        tskIDLE_PRIORITY + 1,
+        log_task_stack,
+        &log_task_buffer
+    );
+
+    if(handle == NULL) log_text("[Failed to create] | [Task 6] | [Log]\n");
+    else vTaskCoreAffinitySet(handle, (1 << 1)); // Set task to run on core 1
+}
\ No newline at end of file
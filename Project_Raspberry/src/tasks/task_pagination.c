@@ -2,64 +2,62 @@
 #include "events.h"
 #include "buttons.h"
 #include "oled_environment.h"
+#include "log.h"
 
+#define PAGINATION_STACK_SIZE (configMINIMAL_STACK_SIZE * 2)
 
-#define PAGINATION_INTERVAL_MS 125
+static StaticTask_t pagination_task_buffer;
+static StackType_t pagination_task_stack[PAGINATION_STACK_SIZE];
 
 /**
  * @brief Função da task para gerenciar a paginação do display.
- * @note Esta task monitora o botão B (com debounce simples/detecção de borda)
- * para circular entre as telas.
- * 1. Lê o estado do botão B.
- * 2. Se o botão for pressionado (transição de solto para pressionado),
- * incrementa a variável global 'current_screen'.
- * 3. Usa o operador módulo (%) para garantir que 'current_screen'
- * retorne a 0 após a última tela (TOTAL_SCREENS).
- * 4. Atrasar (vTaskDelay) antes de repetir.
+ * @note O botão B é tratado por interrupção de borda com debounce por alarme de
+ * hardware (button_enable_events); a task fica bloqueada até um evento.
+ * 1. Aguardar a notificação de um pressionamento confirmado do botão B.
+ * 2. Avançar a tela publicada (current_screen_set), voltando a 0 após a
+ * última tela (TOTAL_SCREENS).
+ * 3. Acordar o display (DISPLAY_EVENT_PAGE), que redesenha imediatamente.
  * * @param params Parâmetros de inicialização da task (não utilizados).
  */
 static void task_pagination(void *params){
-    printf("[Started] | [Task 3] | [Display Pagination]\n");
-
-    bool pressioned = false;
+    LOG(LOG_STARTED_PAGINATION);
 
     while(true){
-        bool button_state = get_button_b();
-
-        vTaskDelay(pdMS_TO_TICKS(10));
+        uint32_t events = 0;
+        xTaskNotifyWait(0, UINT32_MAX, &events, portMAX_DELAY);
 
-        if(button_state && !pressioned){
-            pressioned = true;
-
-            current_screen = (current_screen + 1) % TOTAL_SCREENS;
-        }
-        else if(!button_state && pressioned){
-            pressioned = false;
+        if(events & BUTTON_EVENT_PRESSED){
+            current_screen_set((current_screen_get() + 1) % TOTAL_SCREENS);
+            notify_display(DISPLAY_EVENT_PAGE);
         }
-    
-        vTaskDelay(pdMS_TO_TICKS(PAGINATION_INTERVAL_MS));
     }
 
 }
 
 /**
  * @brief Cria e inicia a task de paginação (task_pagination).
- * @note Inicializa o botão B antes de criar a task.
+ * @note Inicializa o botão B antes de criar a task e o entrega a ela por interrupção.
  * A task é criada com prioridade (IDLE + 3) e afinidade com o Core 0.
  */
 void create_task_pagination(void){
     init_button_b();
 
-    TaskHandle_t handle;
-    BaseType_t status = xTaskCreate(
+    TaskHandle_t handle = xTaskCreateStatic(
         task_pagination,          
         "Task Pagination",       
-        configMINIMAL_STACK_SIZE * 2, 
+        PAGINATION_STACK_SIZE, 
         NULL,                 
         tskIDLE_PRIORITY + 3, 
-        &handle               
+        pagination_task_stack,
+        &pagination_task_buffer
     );
 
-    if(status != pdPASS || handle == NULL) printf("[Failed to create] | [Task 3] | [Display Pagination]\n");
-    else vTaskCoreAffinitySet(handle, (1 << 0)); // Set task to run on core 0
+    if(handle == NULL){
+        LOG(LOG_FAILED_PAGINATION);
+        return;
+    }
+
+    vTaskCoreAffinitySet(handle, (1 << 0)); // Set task to run on core 0
+
+    if(!button_enable_events(BUTTON_B, handle)) LOG1(LOG_ERROR_BUTTON_IRQ, BUTTON_B);
 }
\ No newline at end of file
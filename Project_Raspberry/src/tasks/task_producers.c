@@ -0,0 +1,228 @@
+#include "task_producers.h"
+#include "events.h"
+#include "ds18b20.h"
+#include "ph4502c.h"
+#include "tds_meter.h"
+#include "ads1115.h"
+#include "buttons.h"
+#include "sensor_configs.h"
+#include "sensor_snapshot.h"
+#include "periodic_job.h"
+#include "log.h"
+
+#define TEMPERATURE_PERIOD_MS 100   // polls the 750 ms conversion
+#define TEMPERATURE_DEADLINE_MS 50
+
+#define PRODUCERS_COUNT 4
+#define PRODUCER_STACK_SIZE (configMINIMAL_STACK_SIZE * 2)
+
+// Memória estática de uma task produtora
+typedef struct {
+    StaticTask_t task_buffer;
+    StackType_t stack[PRODUCER_STACK_SIZE];
+} producer_memory_t;
+
+static producer_memory_t producers_memory[PRODUCERS_COUNT];
+static uint8_t producers_count = 0;
+
+/**
+ * @brief Perfil de amostragem atual, definido por task_sensors e aplicado por cada produtor.
+ */
+static sampling_profile_t profile = {
+    .interval_ms = SAMPLING_MIN_INTERVAL_MS,
+    .ph_window = SAMPLING_PH_MAX_WINDOW,
+    .tds_window = SAMPLING_TDS_MAX_WINDOW,
+    .adc_rate_sps = SAMPLING_ACTIVE_ADC_RATE_SPS
+};
+
+/**
+ * @brief Copia o perfil de amostragem atual.
+ */
+static sampling_profile_t current_profile(void){
+    taskENTER_CRITICAL();
+    sampling_profile_t copy = profile;
+    taskEXIT_CRITICAL();
+
+    return copy;
+}
+
+/**
+ * @brief Função da task produtora de temperatura (DS18B20).
+ * @note Verifica periodicamente, sem bloquear, se a conversão em segundo plano
+ * terminou; ao terminar, publica a média das sondas e inicia a próxima. A
+ * temperatura é atualizada no ritmo natural do sensor (~750 ms).
+ * * @param params Parâmetros de inicialização da task (não utilizados).
+ */
+static void task_temperature_producer(void *params){
+    // Looks for every probe on the 1-Wire bus
+    LOG1(LOG_DS18B20_PROBES, ds18b20_scan());
+    ds18b20_start_conversion();
+
+    static periodic_job_t job;
+    periodic_job_init(&job, "Temperature", TEMPERATURE_PERIOD_MS, TEMPERATURE_DEADLINE_MS);
+
+    while(true){
+        periodic_job_release(&job);
+
+        if(ds18b20_is_conversion_ready()){
+            celsius_t temperature;
+            if(ds18b20_collect_temperature(&temperature)) sensor_snapshot_publish_temperature(temperature);
+            ds18b20_start_conversion();
+        }
+
+        periodic_job_wait(&job);
+    }
+}
+
+/**
+ * @brief Função da task produtora de pH.
+ * @note Publica apenas quando o motor de aquisição entregou conversões novas do
+ * canal, de forma que a idade do valor reflete a última amostra real.
+ * * @param params Parâmetros de inicialização da task (não utilizados).
+ */
+static void task_ph_producer(void *params){
+    uint32_t last_count = 0;
+
+    static periodic_job_t job;
+    periodic_job_init(&job, "pH", SAMPLING_MIN_INTERVAL_MS, SAMPLING_MIN_INTERVAL_MS);
+
+    while(true){
+        periodic_job_release(&job);
+
+        sampling_profile_t current = current_profile();
+        ph4502c_set_window(current.ph_window);
+
+        uint32_t count = ads1115_scan_get_sample_count(PH_ADC_CHANNEL);
+        ph_t ph = ph4502c_read_ph();
+        if(count != last_count){
+            sensor_snapshot_publish_ph(ph);
+            last_count = count;
+        }
+
+        periodic_job_set_period(&job, current.interval_ms);
+        periodic_job_wait(&job);
+    }
+}
+
+/**
+ * @brief Função da task produtora de TDS.
+ * @note A compensação usa a última temperatura publicada; nada é publicado
+ * antes da primeira leitura de temperatura.
+ * * @param params Parâmetros de inicialização da task (não utilizados).
+ */
+static void task_tds_producer(void *params){
+    uint32_t last_count = 0;
+
+    static periodic_job_t job;
+    periodic_job_init(&job, "TDS", SAMPLING_MIN_INTERVAL_MS, SAMPLING_MIN_INTERVAL_MS);
+
+    while(true){
+        periodic_job_release(&job);
+
+        sampling_profile_t current = current_profile();
+        tds_meter_set_window(current.tds_window);
+
+        sensor_snapshot_t snapshot;
+        sensor_snapshot_read(&snapshot);
+
+        uint32_t count = ads1115_scan_get_sample_count(TDS_ADC_CHANNEL);
+        if(snapshot.temperature_us){
+            ppm_t tds = tds_meter_read_ppm(snapshot.temperature);
+            if(count != last_count){
+                sensor_snapshot_publish_tds(tds);
+                last_count = count;
+            }
+        }
+
+        periodic_job_set_period(&job, current.interval_ms);
+        periodic_job_wait(&job);
+    }
+}
+
+/**
+ * @brief Função da task produtora do botão A.
+ * @note O botão é tratado por interrupção de borda com debounce por alarme de
+ * hardware; a task só acorda quando um pressionamento ou soltura é confirmado
+ * e publica o estado confirmado, contando cada pressionamento.
+ * * @param params Parâmetros de inicialização da task (não utilizados).
+ */
+static void task_button_producer(void *params){
+    sensor_snapshot_publish_button(button_is_pressed(BUTTON_A), false);
+
+    while(true){
+        uint32_t events = 0;
+        xTaskNotifyWait(0, UINT32_MAX, &events, portMAX_DELAY);
+        sensor_snapshot_publish_button(button_is_pressed(BUTTON_A), events & BUTTON_EVENT_PRESSED);
+    }
+}
+
+/**
+ * @brief Cria uma task produtora com alta prioridade (IDLE + 4) no Core 0.
+ * @note A pilha e o TCB vêm de 'producers_memory' (PRODUCERS_COUNT posições).
+ * * @param function A função da task.
+ * @param name O nome da task.
+ * @return O handle da task, ou NULL em caso de falha.
+ */
+static TaskHandle_t create_producer(TaskFunction_t function, const char *name){
+    TaskHandle_t handle = NULL;
+    if(producers_count < PRODUCERS_COUNT){
+        producer_memory_t *memory = &producers_memory[producers_count++];
+        handle = xTaskCreateStatic(
+            function,
+            name,
+            PRODUCER_STACK_SIZE,
+            NULL,
+            tskIDLE_PRIORITY + 4,
+            memory->stack,
+            &memory->task_buffer
+        );
+    }
+
+    if(handle == NULL){
+        LOG1(LOG_FAILED_PRODUCER, producers_count);
+        return NULL;
+    }
+
+    vTaskCoreAffinitySet(handle, (1 << 0)); // Set task to run on core 0
+    return handle;
+}
+
+/**
+ * @brief Define o perfil de amostragem aplicado pelos produtores de pH e TDS.
+ * @note Chamada por task_sensors a cada ciclo. A taxa do ADC é aplicada aqui; as
+ * janelas e os períodos, por cada produtor no início do seu próximo ciclo.
+ * * @param new_profile O perfil escolhido por sampling_policy_update().
+ */
+void producers_apply_profile(sampling_profile_t new_profile){
+    taskENTER_CRITICAL();
+    profile = new_profile;
+    taskEXIT_CRITICAL();
+
+    ads1115_scan_set_data_rate(new_profile.adc_rate_sps);
+}
+
+/**
+ * @brief Inicializa os sensores e cria uma task produtora para cada um.
+ * @note Cada produtor tem o seu próprio período e publica no snapshot de últimos
+ * valores (sensor_snapshot), com o instante da publicação:
+ * - Temperatura: a cada conversão do DS18B20 (verificada a cada TEMPERATURE_PERIOD_MS).
+ * - pH e TDS: no período do perfil de amostragem atual.
+ * - Botão A: a cada pressionamento ou soltura confirmado (interrupção).
+ */
+void create_task_producers(void){
+    init_button_a();
+    if(!ds18b20_init()) LOG(LOG_ERROR_DS18B20);
+
+    // pH and TDS channels are sampled in the background by the ADS1115 acquisition engine
+    if(!ads1115_scan_init()) LOG(LOG_ERROR_ADS1115);
+    else LOG1(LOG_ADS1115_CONVERTERS, ads1115_get_device_count());
+    ph4502c_init();
+    tds_meter_init();
+
+    create_producer(task_temperature_producer, "Task Temperature");
+    create_producer(task_ph_producer, "Task pH");
+    create_producer(task_tds_producer, "Task TDS");
+
+    TaskHandle_t button_producer = create_producer(task_button_producer, "Task Button A");
+    if(button_producer && !button_enable_events(BUTTON_A, button_producer)) LOG1(LOG_ERROR_BUTTON_IRQ, BUTTON_A);
+}
\ No newline at end of file
@@ -1,74 +1,149 @@
 #include "task_sensors.h"
+#include "task_producers.h"
 #include "events.h"
-#include "ds18b20.h"
-#include "ph4502c.h"
-#include "tds_meter.h"
-#include "buttons.h"
 #include "notifications.h"
-#include "sensor_analyzer.h"
+#include "sensor_pipeline.h"
+#include "sampling_policy.h"
+#include "sensor_snapshot.h"
+#include "sensor_history.h"
+#include "periodic_job.h"
+#include "sensor_capture.h"
+#include "sensor_configs.h"
+#include "log.h"
+#include "telemetry.h"
+#include "latency.h"
 
-#define SENSORS_INTERVAL_MS 125
+#define SENSORS_DEADLINE_MS SAMPLING_MIN_INTERVAL_MS
+#define SENSORS_STACK_SIZE (configMINIMAL_STACK_SIZE * 2)
+
+static StaticTask_t sensors_task_buffer;
+static StackType_t sensors_task_stack[SENSORS_STACK_SIZE];
+
+/**
+ * @brief Avisa quando um canal fica sem publicação recente (já levado a alerta pelo pipeline).
+ * * @param pipeline O estado do processamento após o ciclo.
+ */
+static void report_stale_channels(const sensor_pipeline_t *pipeline){
+    if(!pipeline->new_stale) return;
+
+    LOG1(LOG_SENSOR_STALE, pipeline->stale);
+    if(pipeline->new_stale & SENSOR_STALE_TEMPERATURE) send_notification(ERROR, "Temp Stale!");
+    if(pipeline->new_stale & SENSOR_STALE_PH) send_notification(ERROR, "pH Stale!");
+    if(pipeline->new_stale & SENSOR_STALE_TDS) send_notification(ERROR, "TDS Stale!");
+}
 
 /**
- * @brief Função da task principal para leitura e processamento de sensores.
+ * @brief Função da task principal de processamento dos sensores.
  * @note Esta task é responsável por:
- * 1. Ler os valores de todos os sensores (Temperatura, pH, TDS) e do botão A.
- * 2. Agrupar os dados brutos na estrutura 'sensors_data_t'.
- * 3. Chamar 'analyzer_process_data' para gerar dados normalizados (alertas).
- * 4. Enviar os dados brutos para 'queue_sensors_data' (para o display).
- * 5. Enviar os dados normalizados para 'queue_normalized_sensors_data' (para o handshake).
- * 6. Atrasar (vTaskDelay) antes de repetir.
+ * 1. Copiar os últimos valores publicados pelos produtores (sensor_snapshot).
+ * Cada sensor é lido pela sua própria task produtora (task_producers), no seu
+ * próprio ritmo; nada é processado antes de temperatura, pH e TDS existirem.
+ * 2. Processar o ciclo com 'sensor_pipeline_process' (a mesma cadeia da reprodução
+ * de capturas): dados brutos em 'sensors_data_t', alertas de 'analyzer_process_data',
+ * canais sem publicação recente levados a alerta e o perfil de amostragem seguinte.
+ * 3. Iniciar o rastro de latência da amostra (latency.h), concluído no ACK do FPGA,
+ * e avisar os canais que ficaram sem publicação.
+ * 4. Publicar os dados brutos em 'mailbox_sensors_data' e acordar o display.
+ * 5. Publicar os dados normalizados em 'mailbox_normalized_sensors_data' (para o handshake)
+ * e registrar a amostra no histórico de tendências (sensor_history).
+ * 6. Aplicar o perfil de amostragem (período, janelas dos estimadores e taxa do
+ * ADC, conforme a proximidade dos limites de alerta) nos produtores.
+ * 7. Aguardar a próxima liberação (periodic_job_wait), em instantes absolutos
+ * separados pelo período escolhido.
  * * @param params Parâmetros de inicialização da task (não utilizados).
  */
 static void task_sensors(void *params) {
-    printf("[Started] | [Task 2] | [Sensors Reading]\n");
+    LOG(LOG_STARTED_SENSORS);
+
+#if SENSOR_CAPTURE_ENABLED
+    bool capture_dumped = false;
+    capture_start();
+#endif
+
+    static sensor_pipeline_t pipeline;
+    sensor_pipeline_init(&pipeline);
+
+    static periodic_job_t job;
+    periodic_job_init(&job, "Sensors", SAMPLING_MIN_INTERVAL_MS, SENSORS_DEADLINE_MS);
 
     while(true){
-        celsius_t temperature = ds18b20_read_temperature();
-        ph_t ph = ph4502c_read_ph();
-        ppm_t tds = tds_meter_read_ppm(temperature);
-        bool button_state = get_button_a();
+        periodic_job_release(&job);
+
+        sensor_snapshot_t snapshot;
+        sensor_snapshot_read(&snapshot);
 
-        sensors_data_t data = {
-            .temperature = temperature,
-            .ph = ph,
-            .tds = tds,
-            .button_state = button_state
-        };
+        // Waits for the first temperature, pH and TDS values
+        if(!sensor_snapshot_is_complete(&snapshot)){
+            periodic_job_wait(&job);
+            continue;
+        }
 
-        normalized_sensors_data_t normalized_data = analyzer_process_data(data);
+        sensors_data_t data;
+        normalized_sensors_data_t normalized_data;
+        sampling_profile_t profile = sensor_pipeline_process(&pipeline, &snapshot, time_us_64(), &data,
+                                                             &normalized_data);
+        report_stale_channels(&pipeline);
+
+        // Latency trace: from the sample that decided the alerts to the FPGA ACK (task_handshake)
+        latency_begin(&normalized_data.trace, (uint32_t)pipeline.trigger_us);
+        latency_mark(&normalized_data.trace, LATENCY_ANALYZED);
 
         // Manual activation notification
-        if(button_state) send_notification(INFO, "Manual Start");
+        if(data.button_state) send_notification(INFO, "Manual Start");
+
+        // Publishing sensor data (latest value, no kernel call)
+        mailbox_publish(&mailbox_sensors_data, &data);
+        notify_display(DISPLAY_EVENT_SENSORS);
 
-        // Sending sensor data to the queue
-        xQueueOverwrite(queue_sensors_data, &data);
+        // Publishing normalized data
+        latency_mark(&normalized_data.trace, LATENCY_PUBLISHED);
+        mailbox_publish(&mailbox_normalized_sensors_data, &normalized_data);
+        notify_handshake();
 
-        // Sending normalized data to the queue
-        xQueueOverwrite(queue_normalized_sensors_data, &normalized_data);
+        // Binary telemetry for the host (drained by task_log)
+        telemetry_sensors(&data);
+        telemetry_normalized(&normalized_data);
 
-        vTaskDelay(pdMS_TO_TICKS(SENSORS_INTERVAL_MS));
+        // Trend history (1 s, 1 min and 1 h tiers)
+        sensor_history_record(&data);
+
+        // Faster and shorter windows near the alert limits, slower when calm
+        producers_apply_profile(profile);
+
+#if SENSOR_CAPTURE_ENABLED
+        if(!capture_dumped && capture_is_full()){
+            capture_dump();
+            capture_dumped = true;
+        }
+#endif
+
+        periodic_job_set_period(&job, profile.interval_ms);
+        periodic_job_wait(&job);
     }
 }
 
 /**
- * @brief Cria e inicia a task de leitura de sensores (task_sensors).
- * @note Inicializa o botão A antes de criar a task.
+ * @brief Cria e inicia a task de processamento de sensores (task_sensors).
+ * @note Os sensores (botão A, DS18B20 e motor de aquisição do ADS1115) são
+ * inicializados pelas tasks produtoras (create_task_producers), criadas aqui,
+ * depois do histórico de sensores (sensor_history_init).
  * A task é criada com alta prioridade (IDLE + 4) e afinidade com o Core 0.
  */
 void create_task_sensors(void) {
-    init_button_a();
+    if(!sensor_history_init()) LOG(LOG_ERROR_HISTORY);
+
+    create_task_producers();
 
-    TaskHandle_t handle;
-    BaseType_t status = xTaskCreate(
+    TaskHandle_t handle = xTaskCreateStatic(
         task_sensors,          
         "Task Sensors",       
-        configMINIMAL_STACK_SIZE * 2, 
+        SENSORS_STACK_SIZE, 
         NULL,                 
         tskIDLE_PRIORITY + 4, 
-        &handle               
+        sensors_task_stack,
+        &sensors_task_buffer
     );
 
-    if(status != pdPASS || handle == NULL) printf("[Failed to create] | [Task 2] | [Sensors Reading]\n");
+    if(handle == NULL) LOG(LOG_FAILED_SENSORS);
     else vTaskCoreAffinitySet(handle, (1 << 0)); // Set task to run on core 0
 }
\ No newline at end of file
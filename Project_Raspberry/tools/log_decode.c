@@ -0,0 +1,179 @@
+/**
+ * @file log_decode.c
+ * @brief Decodificador (host) do log diferido do firmware.
+ * @note Lê o console USB em binário (stdin) e escreve texto (stdout). Os quadros
+ * do log (log_frame_t) são convertidos com a tabela de log_messages.def, gerada
+ * na compilação pelo mesmo X-macro usado no firmware; os quadros de texto
+ * (log_text: relatórios de diagnóstico, latências, captura) saem como vieram.
+ * O resto do console (telemetria, texto de antes do log) passa sem alteração.
+ *
+ * Compilação e uso:
+ *   cc -O2 -I../lib/miscellaneous -o log_decode log_decode.c
+ *   ./log_decode < /dev/ttyACM0
+ */
+#include "log.h"
+#include <stdio.h>
+#include <ctype.h>
+
+static const char *const formats[LOG_MESSAGES_COUNT] = {
+#define LOG_MESSAGE(id, format) [id] = format,
+#include "log_messages.def"
+#undef LOG_MESSAGE
+};
+
+/**
+ * @brief Imprime um registro formatando cada argumento conforme a sua conversão.
+ * @note Conversões de ponto flutuante recebem os bits crus de log_float(); as
+ * inteiras, a palavra de 32 bits (com sinal para %d/%i).
+ * * @param record O registro.
+ */
+static void print_record(const log_record_t *record){
+    printf("[%10lu us | core %u] ", (unsigned long)record->timestamp_us, record->core);
+
+    if(record->id >= LOG_MESSAGES_COUNT || !formats[record->id]){
+        printf("<unknown log id %u>\n", record->id);
+        return;
+    }
+
+    const char *format = formats[record->id];
+    uint8_t arg = 0;
+
+    while(*format){
+        if(*format != '%'){
+            putchar(*format++);
+            continue;
+        }
+        if(format[1] == '%'){
+            putchar('%');
+            format += 2;
+            continue;
+        }
+
+        // Single conversion: %[flags][width][.precision][length]conversion
+        char spec[32];
+        size_t length = 0;
+        spec[length++] = *format++;
+        while(*format && !isalpha((unsigned char)*format) && length < sizeof(spec) - 3) spec[length++] = *format++;
+        while(*format == 'l' || *format == 'h' || *format == 'z') format++; // arguments are 32-bit words
+        char conversion = *format ? *format++ : 'u';
+
+        uint32_t value = arg < record->argc ? record->args[arg] : 0;
+        arg++;
+
+        if(strchr("fFeEgGaA", conversion)){
+            float number;
+            memcpy(&number, &value, sizeof(number));
+            spec[length++] = conversion;
+            spec[length] = '\0';
+            printf(spec, (double)number);
+        }
+        else if(conversion == 'd' || conversion == 'i'){
+            spec[length++] = conversion;
+            spec[length] = '\0';
+            printf(spec, (int)(int32_t)value);
+        }
+        else if(strchr("uxXoc", conversion)){
+            spec[length++] = conversion;
+            spec[length] = '\0';
+            printf(spec, (unsigned)value);
+        }
+        else{
+            printf("<%%%c>", conversion);
+        }
+    }
+    putchar('\n');
+
+    if(record->id == LOG_BOOT && record->args[0] != LOG_MESSAGES_COUNT){
+        printf("[log_decode] warning: firmware has %u messages, this table %u (rebuild log_decode)\n",
+               (unsigned)record->args[0], (unsigned)LOG_MESSAGES_COUNT);
+    }
+}
+
+static uint8_t frame[LOG_TEXT_FRAME_SIZE(LOG_TEXT_MAX) > sizeof(log_frame_t) ?
+                     LOG_TEXT_FRAME_SIZE(LOG_TEXT_MAX) : sizeof(log_frame_t)];
+static size_t length = 0;
+
+/**
+ * @brief Se os bytes acumulados ainda podem ser o começo de um quadro (sincronismo completo).
+ */
+static bool starts_frame(void){
+    if(length >= 1 && frame[0] != LOG_FRAME_SYNC_0) return false;
+    if(length >= 2 && frame[1] != LOG_FRAME_SYNC_1 && frame[1] != LOG_TEXT_SYNC_1) return false;
+    if(length >= 3 && frame[1] == LOG_TEXT_SYNC_1 && frame[2] > LOG_TEXT_MAX) return false;
+    return true;
+}
+
+/**
+ * @brief Tamanho do quadro acumulado, ou 0 enquanto o cabeçalho não chegou.
+ */
+static size_t frame_size(void){
+    if(length < 2) return 0;
+    if(frame[1] == LOG_FRAME_SYNC_1) return sizeof(log_frame_t);
+    return length < 3 ? 0 : LOG_TEXT_FRAME_SIZE(frame[2]);
+}
+
+/**
+ * @brief Confere a soma de um quadro completo e o imprime.
+ * * @param size O tamanho do quadro (frame_size()).
+ * @return false se a soma não confere (não era um quadro).
+ */
+static bool decode_frame(size_t size){
+    uint8_t checksum = 0;
+
+    if(frame[1] == LOG_TEXT_SYNC_1){
+        for(size_t i = 2; i < size - 1; i++) checksum += frame[i];
+        if(checksum != frame[size - 1]) return false;
+
+        fwrite(&frame[3], 1, frame[2], stdout);
+        return true;
+    }
+
+    log_frame_t decoded;
+    memcpy(&decoded, frame, sizeof(decoded));
+
+    const uint8_t *bytes = (const uint8_t *)&decoded.record;
+    for(size_t i = 0; i < sizeof(log_record_t); i++) checksum += bytes[i];
+    if(checksum != decoded.checksum) return false;
+
+    print_record(&decoded.record);
+    return true;
+}
+
+/**
+ * @brief Emite o primeiro byte acumulado como texto e descarta-o.
+ */
+static void skip_byte(void){
+    fwrite(frame, 1, 1, stdout);
+    memmove(frame, frame + 1, --length);
+}
+
+int main(void){
+    int c;
+
+    while((c = getchar()) != EOF){
+        frame[length++] = (uint8_t)c;
+
+        // Anything that is not a frame is console text. After a bad frame the
+        // rest is rescanned for the next full sync, one byte at a time
+        while(length > 0){
+            if(!starts_frame()){
+                skip_byte();
+                continue;
+            }
+
+            size_t size = frame_size();
+            if(size == 0 || length < size) break;
+
+            if(decode_frame(size)){
+                length = 0;
+            }
+            else{
+                skip_byte();
+            }
+        }
+        fflush(stdout);
+    }
+
+    fwrite(frame, 1, length, stdout);
+    return 0;
+}
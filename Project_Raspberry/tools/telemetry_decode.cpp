@@ -0,0 +1,218 @@
+/**
+ * @file telemetry_decode.cpp
+ * @brief Decodificador (host) da telemetria binária do firmware.
+ * @note Lê o console USB em binário (stdin), separa os quadros pelos delimitadores
+ * 0x00, desfaz o COBS, confere o CRC-16 e escreve um registro por linha em CSV
+ * (stdout). Bytes fora de quadros (log diferido, texto) contam como ruído.
+ * No stderr, a cada REPORT_INTERVAL_US de tempo do dispositivo e no fim da
+ * entrada: quadros válidos, erros, quadros perdidos (lacunas na sequência de
+ * cada core, que cobrem tanto o anel cheio quanto perdas no USB) e a taxa
+ * sustentada de registros por segundo.
+ *
+ * Compilação e uso:
+ *   c++ -std=c++17 -O2 -I../lib/miscellaneous -o telemetry_decode telemetry_decode.cpp
+ *   ./telemetry_decode < /dev/ttyACM0 > telemetry.csv
+ */
+#include "telemetry_format.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+constexpr uint64_t REPORT_INTERVAL_US = 5000000;
+constexpr size_t MAX_CORES = 2;
+
+struct core_state_t {
+    bool seen = false;
+    uint16_t last_sequence = 0;
+    uint32_t last_timestamp_us = 0;
+    uint64_t elapsed_us = 0;        // device time, unwrapped from the 32-bit timestamps
+};
+
+struct stats_t {
+    uint64_t frames = 0;
+    uint64_t crc_errors = 0;        // well-formed frame, wrong CRC: corrupted on the way
+    uint64_t noise_bytes = 0;       // bytes between zeros that are not a frame (log, text)
+    uint64_t dropped = 0;
+    uint64_t last_report_us = 0;
+    core_state_t cores[MAX_CORES];
+};
+
+/**
+ * @brief Desfaz o COBS de um quadro (sem os delimitadores).
+ * * @param in Os bytes codificados.
+ * @param out Os bytes decodificados.
+ * @return false se a codificação for inválida.
+ */
+bool cobs_decode(const std::vector<uint8_t> &in, std::vector<uint8_t> &out){
+    out.clear();
+
+    size_t i = 0;
+    while(i < in.size()){
+        uint8_t code = in[i++];
+        if(code == 0 || i + code - 1 > in.size()) return false;
+
+        out.insert(out.end(), in.begin() + i, in.begin() + i + code - 1);
+        i += code - 1;
+
+        // A code below 0xFF stands for a zero, except after the last block
+        if(code < 0xFF && i < in.size()) out.push_back(0x00);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Tempo do dispositivo (maior entre os cores) desde o primeiro registro.
+ */
+uint64_t device_elapsed_us(const stats_t &stats){
+    uint64_t elapsed = 0;
+    for(const core_state_t &core : stats.cores) if(core.elapsed_us > elapsed) elapsed = core.elapsed_us;
+    return elapsed;
+}
+
+/**
+ * @brief Imprime o resumo da decodificação no stderr.
+ */
+void report(const stats_t &stats, const char *label){
+    uint64_t elapsed_us = device_elapsed_us(stats);
+    double rate = elapsed_us ? stats.frames * 1e6 / (double)elapsed_us : 0.0;
+    uint64_t expected = stats.frames + stats.dropped;
+
+    std::fprintf(stderr,
+        "[%s] frames %llu | dropped %llu (%.2f%%) | crc errors %llu | noise bytes %llu | %.1f records/s over %.1f s\n",
+        label,
+        (unsigned long long)stats.frames,
+        (unsigned long long)stats.dropped,
+        expected ? 100.0 * stats.dropped / (double)expected : 0.0,
+        (unsigned long long)stats.crc_errors,
+        (unsigned long long)stats.noise_bytes,
+        rate,
+        elapsed_us / 1e6);
+}
+
+/**
+ * @brief Atualiza a sequência e o tempo do core do registro.
+ * @note A sequência (16 bits) avança mesmo quando o firmware descarta um registro,
+ * então a diferença para a anterior, menos um, é a quantidade perdida.
+ */
+void track(stats_t &stats, const telemetry_header_t &header){
+    if(header.core >= MAX_CORES) return;
+    core_state_t &core = stats.cores[header.core];
+
+    if(core.seen){
+        stats.dropped += (uint16_t)(header.sequence - core.last_sequence - 1);
+        core.elapsed_us += (uint32_t)(header.timestamp_us - core.last_timestamp_us);
+    }
+
+    core.seen = true;
+    core.last_sequence = header.sequence;
+    core.last_timestamp_us = header.timestamp_us;
+}
+
+double fixed_to_double(int32_t value){
+    return value / 65536.0;
+}
+
+/**
+ * @brief Escreve um registro como linha CSV; colunas sem valor ficam vazias.
+ */
+void print_record(const telemetry_record_t &record){
+    const telemetry_header_t &header = record.header;
+    std::printf("%u,%u,%u,%lu,", header.type, header.core, header.sequence, (unsigned long)header.timestamp_us);
+
+    switch(header.type){
+        case TELEMETRY_SENSORS: {
+            const telemetry_sensors_t &body = record.body.sensors;
+            std::printf("sensors,%.3f,%.3f,%.1f,%u,,,,,,\n",
+                fixed_to_double(body.temperature), fixed_to_double(body.ph), fixed_to_double(body.tds), body.button_state);
+            break;
+        }
+        case TELEMETRY_NORMALIZED:
+            std::printf("normalized,,,,,%u,,,,,\n", record.body.normalized.flags);
+            break;
+        case TELEMETRY_ALERT: {
+            static const char *const sensors[] = {"temperature", "ph", "tds"};
+            const telemetry_alert_t &body = record.body.alert;
+            std::printf("alert,,,,,,%s,%u,%.3f,,\n",
+                body.sensor < 3 ? sensors[body.sensor] : "unknown", body.active, fixed_to_double(body.value));
+            break;
+        }
+        case TELEMETRY_LINK:
+            std::printf("link,,,,,,,,,%u,%u\n", record.body.link.success, record.body.link.attempts);
+            break;
+    }
+}
+
+/**
+ * @brief Valida e processa um quadro completo (sem os delimitadores).
+ * @note Um trecho com COBS inválido ou tamanho diferente do esperado para o tipo
+ * não é telemetria (log diferido, texto) e conta como ruído; apenas um quadro bem
+ * formado com CRC errado conta como erro de CRC.
+ */
+void handle_frame(stats_t &stats, const std::vector<uint8_t> &encoded){
+    std::vector<uint8_t> payload;
+    if(!cobs_decode(encoded, payload) || payload.size() < sizeof(telemetry_header_t) + TELEMETRY_CRC_SIZE){
+        stats.noise_bytes += encoded.size();
+        return;
+    }
+
+    size_t length = payload.size() - TELEMETRY_CRC_SIZE;
+    if(telemetry_record_size(payload[0]) != length){
+        stats.noise_bytes += encoded.size();
+        return;
+    }
+
+    uint16_t crc = (uint16_t)(payload[length] | (payload[length + 1] << 8));
+    if(telemetry_crc16(payload.data(), length) != crc){
+        stats.crc_errors++;
+        return;
+    }
+
+    telemetry_record_t record;
+    std::memset(&record, 0, sizeof(record));
+    std::memcpy(&record, payload.data(), length);
+
+    stats.frames++;
+    track(stats, record.header);
+    print_record(record);
+
+    uint64_t elapsed_us = device_elapsed_us(stats);
+    if(elapsed_us - stats.last_report_us >= REPORT_INTERVAL_US){
+        std::fflush(stdout);
+        report(stats, "progress");
+        stats.last_report_us = elapsed_us;
+    }
+}
+
+} // namespace
+
+int main(){
+    stats_t stats;
+    std::vector<uint8_t> frame;
+
+    std::printf("type,core,sequence,timestamp_us,kind,temperature,ph,tds,button,flags,sensor,active,value,success,attempts\n");
+
+    int byte;
+    while((byte = std::getchar()) != EOF){
+        if(byte != 0x00){
+            frame.push_back((uint8_t)byte);
+
+            // Longer than any frame: text or log between two zeros
+            if(frame.size() > TELEMETRY_MAX_FRAME){
+                stats.noise_bytes += frame.size();
+                frame.clear();
+            }
+            continue;
+        }
+
+        // A zero closes the current frame (two in a row between consecutive frames)
+        if(!frame.empty()) handle_frame(stats, frame);
+        frame.clear();
+    }
+
+    std::fflush(stdout);
+    report(stats, "total");
+    return 0;
+}
\ No newline at end of file